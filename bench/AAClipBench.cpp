@@ -242,6 +242,68 @@ private:
     typedef Benchmark INHERITED;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// This bench clips to a large concave polygon, like the outline of a map region. On the GPU
+// an AA clip like this is usually drawn into a software mask. If the clip moves each loop the
+// mask is redrawn every time, otherwise it is drawn once and then found in the clip mask cache.
+class ConcaveAAClipBench : public Benchmark {
+    SkString fName;
+    SkPath   fClipPath;
+    SkRect   fDrawRect;
+    bool     fMoving;
+
+    static const int kPoints = 200;
+
+public:
+    ConcaveAAClipBench(bool moving) : fMoving(moving) {
+        fName.printf("aaclip_concave_%s", moving ? "moving" : "static");
+
+        SkRandom rand;
+        const SkScalar step = 2 * SK_ScalarPI / kPoints;
+        for (int i = 0; i < kPoints; ++i) {
+            SkScalar radius = rand.nextRangeScalar(150, 300);
+            SkPoint pt = SkPoint::Make(320 + radius * SkScalarCos(i * step),
+                                       320 + radius * SkScalarSin(i * step));
+            if (0 == i) {
+                fClipPath.moveTo(pt);
+            } else {
+                fClipPath.lineTo(pt);
+            }
+        }
+        fClipPath.close();
+        fDrawRect.set(0, 0, 640, 640);
+    }
+
+protected:
+    virtual const char* onGetName() { return fName.c_str(); }
+    virtual void onDraw(const int loops, SkCanvas* canvas) {
+        SkPaint paint;
+        this->setupPaint(&paint);
+
+        if (!fMoving) {
+            // one clip for all the loops, so the mask can be reused
+            canvas->save();
+            canvas->clipPath(fClipPath, SkRegion::kReplace_Op, true);
+        }
+        for (int i = 0; i < loops; ++i) {
+            if (fMoving) {
+                canvas->save();
+                canvas->translate((i % 2) == 0 ? SK_Scalar1 : 0, 0);
+                canvas->clipPath(fClipPath, SkRegion::kReplace_Op, true);
+            }
+            canvas->drawRect(fDrawRect, paint);
+            if (fMoving) {
+                canvas->restore();
+            }
+        }
+        if (!fMoving) {
+            canvas->restore();
+        }
+    }
+private:
+    typedef Benchmark INHERITED;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return SkNEW_ARGS(AAClipBuilderBench, (false, false)); )
@@ -255,3 +317,5 @@ DEF_BENCH( return SkNEW_ARGS(AAClipBench, (true, false)); )
 DEF_BENCH( return SkNEW_ARGS(AAClipBench, (true, true)); )
 DEF_BENCH( return SkNEW_ARGS(NestedAAClipBench, (false)); )
 DEF_BENCH( return SkNEW_ARGS(NestedAAClipBench, (true)); )
+DEF_BENCH( return SkNEW_ARGS(ConcaveAAClipBench, (false)); )
+DEF_BENCH( return SkNEW_ARGS(ConcaveAAClipBench, (true)); )
@@ -0,0 +1,268 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBlitMask.h"
+#include "SkBlitRow.h"
+#include "SkColorPriv.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkUtils.h"
+
+/*
+ *  Times the N32 and 565 row procs picked by the factories (i.e. the best one this CPU supports)
+ *  on a long row, so each proc's throughput can be tracked on its own.
+ */
+
+enum SrcAlpha {
+    kOpaque_SrcAlpha,
+    kTransparent_SrcAlpha,
+    kMixed_SrcAlpha,
+};
+
+static const char* gSrcAlphaNames[] = { "opaque", "transparent", "mixed" };
+
+static const int kPixels = 1024;
+
+static void fill_src(SkPMColor src[], SrcAlpha srcAlpha) {
+    SkRandom rand;
+    for (int i = 0; i < kPixels; ++i) {
+        unsigned a;
+        switch (srcAlpha) {
+            case kOpaque_SrcAlpha:      a = 0xFF; break;
+            case kTransparent_SrcAlpha: a = 0;    break;
+            default:                    a = rand.nextU() & 0xFF; break;
+        }
+        src[i] = SkPreMultiplyARGB(a, rand.nextU() & 0xFF, rand.nextU() & 0xFF,
+                                   rand.nextU() & 0xFF);
+    }
+}
+
+class BlitRow32Bench : public Benchmark {
+public:
+    BlitRow32Bench(unsigned flags, SrcAlpha srcAlpha)
+        : fFlags(flags)
+        , fAlpha(flags & SkBlitRow::kGlobalAlpha_Flag32 ? 0x80 : 0xFF) {
+        static const char* gFlagNames[] = { "s32_opaque", "s32_blend", "s32a_opaque",
+                                            "s32a_blend" };
+        fName.printf("blitrow32_%s_%s", gFlagNames[flags], gSrcAlphaNames[srcAlpha]);
+        fill_src(fSrc, srcAlpha);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        fProc = SkBlitRow::Factory32(fFlags);
+        sk_memset32(fDst, 0xFF808080, kPixels);
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            fProc(fDst, fSrc, kPixels, fAlpha);
+        }
+    }
+
+private:
+    unsigned            fFlags;
+    U8CPU               fAlpha;
+    SkBlitRow::Proc32   fProc;
+    SkString            fName;
+    SkPMColor           fSrc[kPixels];
+    SkPMColor           fDst[kPixels];
+
+    typedef Benchmark INHERITED;
+};
+
+class BlitRowColor32Bench : public Benchmark {
+public:
+    BlitRowColor32Bench() {
+        fill_src(fSrc, kMixed_SrcAlpha);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return "blitrow32_color";
+    }
+
+    void onPreDraw() override {
+        fProc = SkBlitRow::ColorProcFactory();
+        sk_memset32(fDst, 0xFF808080, kPixels);
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        const SkPMColor color = SkPreMultiplyARGB(0x80, 0x40, 0xC0, 0x20);
+        for (int i = 0; i < loops; ++i) {
+            fProc(fDst, fSrc, kPixels, color);
+        }
+    }
+
+private:
+    SkBlitRow::ColorProc fProc;
+    SkPMColor            fSrc[kPixels];
+    SkPMColor            fDst[kPixels];
+
+    typedef Benchmark INHERITED;
+};
+
+class BlitRow16Bench : public Benchmark {
+public:
+    BlitRow16Bench(unsigned flags, SrcAlpha srcAlpha)
+        : fFlags(flags)
+        , fAlpha(flags & SkBlitRow::kGlobalAlpha_Flag ? 0x80 : 0xFF) {
+        static const char* gFlagNames[] = { "s32_opaque", "s32_blend", "s32a_opaque",
+                                            "s32a_blend" };
+        fName.printf("blitrow16_%s%s_%s", gFlagNames[flags & 3],
+                     flags & SkBlitRow::kDither_Flag ? "_dither" : "", gSrcAlphaNames[srcAlpha]);
+        fill_src(fSrc, srcAlpha);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        fProc = SkBlitRow::Factory16(fFlags);
+        sk_memset16(fDst, 0x7BEF, kPixels);
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            fProc(fDst, fSrc, kPixels, fAlpha, 0, i);
+        }
+    }
+
+private:
+    unsigned            fFlags;
+    U8CPU               fAlpha;
+    SkBlitRow::Proc16   fProc;
+    SkString            fName;
+    SkPMColor           fSrc[kPixels];
+    uint16_t            fDst[kPixels];
+
+    typedef Benchmark INHERITED;
+};
+
+class BlitRowColor16Bench : public Benchmark {
+public:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return "blitrow16_color";
+    }
+
+    void onPreDraw() override {
+        fProc = SkBlitRow::ColorFactory16(SkBlitRow::kDither_Flag);
+        sk_memset16(fDst, 0x7BEF, kPixels);
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        const SkPMColor color = SkPreMultiplyARGB(0x80, 0x40, 0xC0, 0x20);
+        for (int i = 0; i < loops; ++i) {
+            fProc(fDst, color, kPixels, 0, i);
+        }
+    }
+
+private:
+    SkBlitRow::ColorProc16 fProc;
+    uint16_t               fDst[kPixels];
+
+    typedef Benchmark INHERITED;
+};
+
+class BlitMaskA8Bench : public Benchmark {
+    enum {
+        kW = 256,
+        kH = 16,
+    };
+public:
+    BlitMaskA8Bench() {
+        SkRandom rand;
+        for (int i = 0; i < kW * kH; ++i) {
+            // Like antialiased glyphs: mostly empty or full coverage, some partial edges.
+            uint32_t r = rand.nextU();
+            fMask[i] = (r & 3) == 0 ? 0 : (r & 3) == 1 ? 0xFF : SkToU8(r >> 24);
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return "blitmask_a8_color";
+    }
+
+    void onPreDraw() override {
+        fProc = SkBlitMask::ColorFactory(kN32_SkColorType, SkMask::kA8_Format, kColor);
+        sk_memset32(fDst, 0xFF808080, kW * kH);
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            fProc(fDst, kW * sizeof(SkPMColor), fMask, kW, kColor, kW, kH);
+        }
+    }
+
+private:
+    static const SkColor kColor = 0xFF3080C0;
+
+    SkBlitMask::ColorProc fProc;
+    uint8_t               fMask[kW * kH];
+    SkPMColor             fDst[kW * kH];
+
+    typedef Benchmark INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+DEF_BENCH( return SkNEW_ARGS(BlitRow32Bench, (SkBlitRow::kSrcPixelAlpha_Flag32,
+                                              kOpaque_SrcAlpha)); )
+DEF_BENCH( return SkNEW_ARGS(BlitRow32Bench, (SkBlitRow::kSrcPixelAlpha_Flag32,
+                                              kTransparent_SrcAlpha)); )
+DEF_BENCH( return SkNEW_ARGS(BlitRow32Bench, (SkBlitRow::kSrcPixelAlpha_Flag32,
+                                              kMixed_SrcAlpha)); )
+DEF_BENCH( return SkNEW_ARGS(BlitRow32Bench, (SkBlitRow::kGlobalAlpha_Flag32,
+                                              kOpaque_SrcAlpha)); )
+DEF_BENCH( return SkNEW_ARGS(BlitRow32Bench, (SkBlitRow::kGlobalAlpha_Flag32 |
+                                              SkBlitRow::kSrcPixelAlpha_Flag32,
+                                              kMixed_SrcAlpha)); )
+DEF_BENCH( return SkNEW(BlitRowColor32Bench); )
+DEF_BENCH( return SkNEW(BlitMaskA8Bench); )
+
+DEF_BENCH( return SkNEW_ARGS(BlitRow16Bench, (SkBlitRow::kGlobalAlpha_Flag,
+                                              kOpaque_SrcAlpha)); )
+DEF_BENCH( return SkNEW_ARGS(BlitRow16Bench, (SkBlitRow::kGlobalAlpha_Flag |
+                                              SkBlitRow::kSrcPixelAlpha_Flag,
+                                              kMixed_SrcAlpha)); )
+DEF_BENCH( return SkNEW_ARGS(BlitRow16Bench, (SkBlitRow::kGlobalAlpha_Flag |
+                                              SkBlitRow::kDither_Flag,
+                                              kOpaque_SrcAlpha)); )
+DEF_BENCH( return SkNEW_ARGS(BlitRow16Bench, (SkBlitRow::kGlobalAlpha_Flag |
+                                              SkBlitRow::kSrcPixelAlpha_Flag |
+                                              SkBlitRow::kDither_Flag,
+                                              kMixed_SrcAlpha)); )
+DEF_BENCH( return SkNEW(BlitRowColor16Bench); )
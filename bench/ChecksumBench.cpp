@@ -10,6 +10,7 @@
 #include "SkMD5.h"
 #include "SkRandom.h"
 #include "SkSHA1.h"
+#include "SkString.h"
 #include "SkTemplates.h"
 
 enum ChecksumType {
@@ -17,6 +18,8 @@ enum ChecksumType {
     kMD5_ChecksumType,
     kSHA1_ChecksumType,
     kMurmur3_ChecksumType,
+    kHash_ChecksumType,
+    kHashPortable_ChecksumType,
 };
 
 class ComputeChecksumBench : public Benchmark {
@@ -26,9 +29,13 @@ class ComputeChecksumBench : public Benchmark {
     };
     uint32_t    fData[U32COUNT];
     ChecksumType fType;
+    size_t      fBytes;
+    SkString    fName;
 
 public:
-    ComputeChecksumBench(ChecksumType type) : fType(type) {
+    // bytes < SIZE measures the short keys typical of descriptors and cache keys.
+    ComputeChecksumBench(ChecksumType type, size_t bytes = SIZE) : fType(type), fBytes(bytes) {
+        SkASSERT(bytes <= SIZE);
         SkRandom rand;
         for (int i = 0; i < U32COUNT; ++i) {
             fData[i] = rand.nextU();
@@ -42,13 +49,19 @@ public:
 protected:
     virtual const char* onGetName() {
         switch (fType) {
-            case kChecksum_ChecksumType: return "compute_checksum";
-            case kMD5_ChecksumType: return "compute_md5";
-            case kSHA1_ChecksumType: return "compute_sha1";
-            case kMurmur3_ChecksumType: return "compute_murmur3";
+            case kChecksum_ChecksumType: fName.set("compute_checksum"); break;
+            case kMD5_ChecksumType: fName.set("compute_md5"); break;
+            case kSHA1_ChecksumType: fName.set("compute_sha1"); break;
+            case kMurmur3_ChecksumType: fName.set("compute_murmur3"); break;
+            case kHash_ChecksumType: fName.set("compute_hash"); break;
+            case kHashPortable_ChecksumType: fName.set("compute_hash_portable"); break;
 
             default: SK_CRASH(); return "";
         }
+        if (fBytes != SIZE) {
+            fName.appendf("_%d", (int)fBytes);
+        }
+        return fName.c_str();
     }
 
     virtual void onDraw(const int loops, SkCanvas*) {
@@ -77,7 +90,19 @@ protected:
             } break;
             case kMurmur3_ChecksumType: {
                 for (int i = 0; i < loops; i++) {
-                    volatile uint32_t result = SkChecksum::Murmur3(fData, sizeof(fData));
+                    volatile uint32_t result = SkChecksum::Murmur3(fData, fBytes);
+                    sk_ignore_unused_variable(result);
+                }
+            }break;
+            case kHash_ChecksumType: {
+                for (int i = 0; i < loops; i++) {
+                    volatile uint32_t result = SkChecksum::Hash(fData, fBytes);
+                    sk_ignore_unused_variable(result);
+                }
+            }break;
+            case kHashPortable_ChecksumType: {
+                for (int i = 0; i < loops; i++) {
+                    volatile uint32_t result = SkChecksum::HashPortable(fData, fBytes);
                     sk_ignore_unused_variable(result);
                 }
             }break;
@@ -95,3 +120,10 @@ DEF_BENCH( return new ComputeChecksumBench(kChecksum_ChecksumType); )
 DEF_BENCH( return new ComputeChecksumBench(kMD5_ChecksumType); )
 DEF_BENCH( return new ComputeChecksumBench(kSHA1_ChecksumType); )
 DEF_BENCH( return new ComputeChecksumBench(kMurmur3_ChecksumType); )
+DEF_BENCH( return new ComputeChecksumBench(kHash_ChecksumType); )
+DEF_BENCH( return new ComputeChecksumBench(kHashPortable_ChecksumType); )
+
+DEF_BENCH( return new ComputeChecksumBench(kMurmur3_ChecksumType, 32); )
+DEF_BENCH( return new ComputeChecksumBench(kHash_ChecksumType, 32); )
+DEF_BENCH( return new ComputeChecksumBench(kMurmur3_ChecksumType, 96); )
+DEF_BENCH( return new ComputeChecksumBench(kHash_ChecksumType, 96); )
@@ -21,14 +21,26 @@ class DeferredSurfaceCopyBench : public Benchmark {
         kSurfaceHeight = 1000,
     };
 public:
-    DeferredSurfaceCopyBench(bool discardableContents) {
-        fDiscardableContents = discardableContents;
+    enum Mode {
+        kDiscardable_Mode,
+        kNonDiscardable_Mode,
+        // Only a small part of the surface changes between snapshots.
+        kPartial_Mode,
+    };
+
+    DeferredSurfaceCopyBench(Mode mode) {
+        fMode = mode;
     }
 
 protected:
     const char* onGetName() override {
-        return fDiscardableContents ? "DeferredSurfaceCopy_discardable" :
-            "DeferredSurfaceCopy_nonDiscardable";
+        switch (fMode) {
+            case kDiscardable_Mode:     return "DeferredSurfaceCopy_discardable";
+            case kNonDiscardable_Mode:  return "DeferredSurfaceCopy_nonDiscardable";
+            case kPartial_Mode:         return "DeferredSurfaceCopy_partial";
+        }
+        SkFAIL("unknown mode");
+        return NULL;
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
@@ -37,7 +49,11 @@ protected:
         SkImageInfo info = SkImageInfo::MakeN32Premul(kSurfaceWidth, kSurfaceHeight);
         const SkRect fullCanvasRect = SkRect::MakeWH(
             SkIntToScalar(kSurfaceWidth), SkIntToScalar(kSurfaceHeight));
-        SkAutoTUnref<SkSurface> surface(canvas->newSurface(info));
+        // The partial mode is what reusing the pixels of released snapshots is for.
+        const SkSurfaceProps props(kPartial_Mode == fMode ?
+                                   SkSurfaceProps::kReuseSnapshotPixels_Flag : 0,
+                                   kUnknown_SkPixelGeometry);
+        SkAutoTUnref<SkSurface> surface(canvas->newSurface(info, &props));
 
         // newSurface() can return NULL for several reasons, so we need to check
         if (NULL == surface.get()) {
@@ -47,11 +63,29 @@ protected:
 
         SkAutoTUnref<SkDeferredCanvas> drawingCanvas(SkDeferredCanvas::Create(surface));
 
+        if (kPartial_Mode == fMode) {
+            drawingCanvas->clear(0);
+            for (int iteration = 0; iteration < loops; iteration++) {
+                SkAutoTUnref<SkImage> image(drawingCanvas->newImageSnapshot());
+                SkPaint paint;
+                paint.setColor(0xFF000000 | (iteration * 0x10101));
+                // Wander around so we don't always land in the same spot.
+                const int i = iteration % 9;
+                drawingCanvas->drawRect(SkRect::MakeXYWH(SkIntToScalar(100 * i),
+                                                         SkIntToScalar(100 * i),
+                                                         SkIntToScalar(50),
+                                                         SkIntToScalar(50)), paint);
+                // Trigger copy on write, which should only touch the changed area.
+                drawingCanvas->flush();
+            }
+            return;
+        }
+
         for (int iteration = 0; iteration < loops; iteration++) {
             drawingCanvas->clear(0);
             SkAutoTUnref<SkImage> image(drawingCanvas->newImageSnapshot());
             SkPaint paint;
-            if (!fDiscardableContents) {
+            if (kNonDiscardable_Mode == fMode) {
                 // If paint is not opaque, prior canvas contents are
                 // not discardable because they are needed for compositing.
                 paint.setAlpha(127);
@@ -63,12 +97,13 @@ protected:
     }
 
 private:
-    bool fDiscardableContents;
+    Mode fMode;
 
     typedef Benchmark INHERITED;
 };
 
 //////////////////////////////////////////////////////////////////////////////
 
-DEF_BENCH( return new DeferredSurfaceCopyBench(false); )
-DEF_BENCH( return new DeferredSurfaceCopyBench(true); )
+DEF_BENCH( return new DeferredSurfaceCopyBench(DeferredSurfaceCopyBench::kNonDiscardable_Mode); )
+DEF_BENCH( return new DeferredSurfaceCopyBench(DeferredSurfaceCopyBench::kDiscardable_Mode); )
+DEF_BENCH( return new DeferredSurfaceCopyBench(DeferredSurfaceCopyBench::kPartial_Mode); )
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "Resources.h"
+#include "SkMovie.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+// Decodes frames of an animated GIF, either playing them in order or seeking to random frames.
+class GifMovieBench : public Benchmark {
+public:
+    GifMovieBench(const char* filename, bool seek)
+        : fFilename(filename)
+        , fSeek(seek) {
+        fName.printf("GifMovie_%s_%s", filename, seek ? "seek" : "play");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        fMovie.reset(SkMovie::DecodeFile(GetResourcePath(fFilename).c_str()));
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        if (!fMovie) {
+            return;
+        }
+        // Every frame of the test files lasts 10ms.
+        const SkMSec duration = fMovie->duration();
+        SkRandom rand;
+        SkMSec time = 0;
+        for (int i = 0; i < loops; ++i) {
+            if (fSeek) {
+                time = rand.nextULessThan(duration / 10) * 10 + 5;
+            } else {
+                time = (time + 10) % duration;
+            }
+            fMovie->setTime(time);
+            fMovie->bitmap();
+        }
+    }
+
+private:
+    SkString                fName;
+    const char*             fFilename;
+    const bool              fSeek;
+    SkAutoTUnref<SkMovie>   fMovie;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(GifMovieBench, ("animated_radar.gif", false)); )
+DEF_BENCH( return SkNEW_ARGS(GifMovieBench, ("animated_radar.gif", true)); )
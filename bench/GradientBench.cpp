@@ -387,3 +387,50 @@ private:
 
 DEF_BENCH( return new Gradient2Bench(false); )
 DEF_BENCH( return new Gradient2Bench(true); )
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Like gradient_create, but the same few gradients are made over and over, as when a document
+// uses a handful of gradient styles throughout. Each draw makes a new shader.
+class GradientStyleBench : public Benchmark {
+public:
+    GradientStyleBench() {}
+
+protected:
+    virtual const char* onGetName() {
+        return "gradient_create_styles";
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) {
+        SkPaint paint;
+        this->setupPaint(&paint);
+
+        const SkRect r = { 0, 0, SkIntToScalar(4), SkIntToScalar(4) };
+        const SkPoint pts[] = {
+            { 0, 0 },
+            { SkIntToScalar(100), SkIntToScalar(100) },
+        };
+        const SkScalar pos[] = { 0, 0.4f, 0.6f, SK_Scalar1 };
+
+        for (int i = 0; i < loops; i++) {
+            const int style = i % kStyles;
+            SkColor colors[] = {
+                SK_ColorBLACK,
+                SkColorSetRGB(style * 16, 0x80, 0x40),
+                SK_ColorWHITE,
+                SkColorSetRGB(0x20, 0x40, style * 16) };
+            SkShader* s = SkGradientShader::CreateLinear(pts, colors, pos,
+                                                         SK_ARRAY_COUNT(colors),
+                                                         SkShader::kClamp_TileMode);
+            paint.setShader(s)->unref();
+            canvas->drawRect(r, paint);
+        }
+    }
+
+private:
+    static const int kStyles = 16;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new GradientStyleBench; )
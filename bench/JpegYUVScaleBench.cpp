@@ -0,0 +1,97 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "Resources.h"
+#include "SkBitmapScaler.h"
+#include "SkData.h"
+#include "SkImageGenerator.h"
+#include "SkString.h"
+
+// Decodes a JPEG and scales it down to a quarter of its size, the way a zoomed out map tile is
+// drawn: either decoding to RGB and scaling that ("rgb"), or decoding the YUV planes and
+// scaling those straight to RGB ("yuv").
+class JpegYUVScaleBench : public Benchmark {
+public:
+    JpegYUVScaleBench(const char* filename, bool yuv)
+        : fFilename(filename)
+        , fYUV(yuv) {
+        fName.printf("jpeg_scale_%s_%s", filename, yuv ? "yuv" : "rgb");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        fData.reset(SkData::NewFromFileName(GetResourcePath(fFilename).c_str()));
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        if (!fData) {
+            return;
+        }
+        for (int i = 0; i < loops; ++i) {
+            SkAutoTDelete<SkImageGenerator> generator(SkImageGenerator::NewFromData(fData));
+            if (!generator) {
+                return;
+            }
+            const SkImageInfo& info = generator->getInfo();
+            const float width = SkIntToScalar(info.width() / 4),
+                        height = SkIntToScalar(info.height() / 4);
+            SkBitmap scaled;
+            if (fYUV) {
+                SkISize sizes[3];
+                if (!generator->getYUV8Planes(sizes, NULL, NULL, NULL)) {
+                    return;
+                }
+                size_t rowBytes[3], totalSize = 0;
+                for (int j = 0; j < 3; ++j) {
+                    rowBytes[j] = sizes[j].width();
+                    totalSize += rowBytes[j] * sizes[j].height();
+                }
+                fStorage.reset(totalSize);
+                void* planes[3];
+                planes[0] = fStorage.get();
+                planes[1] = (uint8_t*)planes[0] + rowBytes[0] * sizes[0].height();
+                planes[2] = (uint8_t*)planes[1] + rowBytes[1] * sizes[1].height();
+                SkYUVColorSpace colorSpace;
+                if (!generator->getYUV8Planes(sizes, planes, rowBytes, &colorSpace)) {
+                    return;
+                }
+                SkBitmapScaler::ResizeYUV(&scaled, sizes, planes, rowBytes, colorSpace,
+                                          SkBitmapScaler::RESIZE_BEST, width, height);
+            } else {
+                SkBitmap decoded;
+                decoded.allocPixels(info);
+                if (SkImageGenerator::kSuccess !=
+                        generator->getPixels(info, decoded.getPixels(), decoded.rowBytes())) {
+                    return;
+                }
+                SkBitmapScaler::Resize(&scaled, decoded, SkBitmapScaler::RESIZE_BEST,
+                                       width, height);
+            }
+        }
+    }
+
+private:
+    SkString                fName;
+    const char*             fFilename;
+    const bool              fYUV;
+    SkAutoTUnref<SkData>    fData;
+    SkAutoMalloc            fStorage;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new JpegYUVScaleBench("mandrill_512_q075.jpg", false); )
+DEF_BENCH( return new JpegYUVScaleBench("mandrill_512_q075.jpg", true); )
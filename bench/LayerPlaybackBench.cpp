@@ -0,0 +1,109 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "Benchmark.h"
+#include "SkBBHFactory.h"
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+#include "SkRRect.h"
+#include "SkString.h"
+
+// Like a map tile: a few hundred labels, each group of halo, icon and text drawn in an opacity
+// layer, redrawn while the view scrolls by whole pixels.  "cached" draws through
+// SkCanvas::drawPicture(), which composites the layers cached by the raster device; "plain"
+// plays the picture back directly, rendering every layer each time.  The resource cache gets a
+// browser sized budget while the bench runs.
+class LayerPlaybackBench : public Benchmark {
+public:
+    LayerPlaybackBench(bool cached) : fCached(cached), fOldCacheLimit(0) {
+        fName.printf("layer_playback_%s", cached ? "cached" : "plain");
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kRaster_Backend;
+    }
+
+    void onPreDraw() override {
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        const uint32_t flags = SkPictureRecorder::kComputeSaveLayerInfo_RecordFlag;
+        SkCanvas* canvas = recorder.beginRecording(1024, 1024, &factory, flags);
+
+        SkPaint background;
+        background.setColor(0xFFF0EDE5);
+        canvas->drawPaint(background);
+
+        SkRandom rand;
+        SkPaint layerPaint;
+        layerPaint.setAlpha(0xC0);
+        SkPaint halo, icon, text;
+        halo.setAntiAlias(true);
+        halo.setColor(SK_ColorWHITE);
+        icon.setAntiAlias(true);
+        text.setAntiAlias(true);
+        text.setTextSize(12);
+        for (int i = 0; i < 300; ++i) {
+            const SkScalar x = rand.nextRangeScalar(0, 960),
+                           y = rand.nextRangeScalar(0, 1000);
+            SkScalar xpos[5];
+            for (int j = 0; j < 5; ++j) {
+                xpos[j] = x + 18 + j * 8;
+            }
+            SkRRect rrect;
+            rrect.setRectXY(SkRect::MakeXYWH(x, y, 64, 18), 4, 4);
+            canvas->saveLayer(NULL, &layerPaint);
+                canvas->drawRRect(rrect, halo);
+                icon.setColor(rand.nextU() | 0xFF000000);
+                canvas->drawCircle(x + 9, y + 9, 6, icon);
+                canvas->drawPosTextH("Label", 5, xpos, y + 13, text);
+            canvas->restore();
+        }
+        fPicture.reset(recorder.endRecording());
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fOldCacheLimit = SkGraphics::SetResourceCacheTotalByteLimit(kCacheLimit);
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        SkGraphics::SetResourceCacheTotalByteLimit(fOldCacheLimit);
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            canvas->save();
+            canvas->translate(-SkIntToScalar(i % 16), -SkIntToScalar(i % 16));
+            if (fCached) {
+                canvas->drawPicture(fPicture);
+            } else {
+                fPicture->playback(canvas);
+            }
+            canvas->restore();
+        }
+    }
+
+private:
+    static const size_t kCacheLimit = 32 * 1024 * 1024;
+
+    SkString                fName;
+    bool                    fCached;
+    size_t                  fOldCacheLimit;
+    SkAutoTUnref<SkPicture> fPicture;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new LayerPlaybackBench(true); )
+DEF_BENCH( return new LayerPlaybackBench(false); )
@@ -16,6 +16,9 @@
 #define SMALL   SkIntToScalar(2)
 #define REAL    1.5f
 #define BIG     SkIntToScalar(10)
+// Radii around and well past the crossover to the O(1) van Herk/Gil-Werman path.
+#define MEDIUM  SkIntToScalar(6)
+#define LARGE    SkIntToScalar(40)
 
 enum MorphologyType {
     kErode_MT,
@@ -90,6 +93,12 @@ DEF_BENCH( return new MorphologyBench(SMALL, kDilate_MT); )
 DEF_BENCH( return new MorphologyBench(BIG, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(BIG, kDilate_MT); )
 
+DEF_BENCH( return new MorphologyBench(MEDIUM, kErode_MT); )
+DEF_BENCH( return new MorphologyBench(MEDIUM, kDilate_MT); )
+
+DEF_BENCH( return new MorphologyBench(LARGE, kErode_MT); )
+DEF_BENCH( return new MorphologyBench(LARGE, kDilate_MT); )
+
 DEF_BENCH( return new MorphologyBench(REAL, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(REAL, kDilate_MT); )
 
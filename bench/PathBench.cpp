@@ -213,6 +213,110 @@ private:
     typedef PathBench INHERITED;
 };
 
+// Draws paths that are made for the draw and never drawn again, as when a caller builds its
+// paths on the fly. Whatever is cached for them is never used.
+class OneShotPathBench : public Benchmark {
+    SkString fName;
+    bool     fStroke;
+public:
+    OneShotPathBench(bool stroke) : fStroke(stroke) {
+        fName.printf("path_%s_one_shot", stroke ? "stroke" : "fill");
+    }
+
+    static void MakePath(SkRandom* rand, SkPath* path) {
+        const SkScalar x = rand->nextRangeScalar(0, 100);
+        const SkScalar y = rand->nextRangeScalar(0, 100);
+        path->moveTo(x, y);
+        path->cubicTo(x + 20, y - 30, x + 60, y + 50, x + 80, y);
+        path->quadTo(x + 60, y + 40, x + 30, y + 30);
+        path->close();
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        if (fStroke) {
+            paint.setStyle(SkPaint::kStroke_Style);
+            paint.setStrokeWidth(5);
+        }
+
+        SkRandom rand;
+        for (int i = 0; i < loops; ++i) {
+            SkPath path;
+            MakePath(&rand, &path);
+            canvas->drawPath(path, paint);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+// Draws a downscaled bitmap, whose high quality scale is kept in SkResourceCache, between
+// batches of small one-shot paths. Anything the paths add to the cache can push the scale out,
+// which the default cache limit takes a few thousand small entries to do.
+class OneShotPathEvictionBench : public Benchmark {
+    SkBitmap fBitmap;
+
+    enum {
+        kBitmapSize = 512,
+        kPathsPerBitmap = 6000
+    };
+public:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kRaster_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return "path_one_shot_bitmap_eviction";
+    }
+
+    void onPreDraw() override {
+        fBitmap.allocN32Pixels(kBitmapSize, kBitmapSize);
+        SkCanvas canvas(fBitmap);
+        canvas.clear(SK_ColorWHITE);
+        SkPaint paint;
+        SkRandom rand;
+        for (int i = 0; i < 100; ++i) {
+            paint.setColor(rand.nextU() | 0xFF000000);
+            canvas.drawCircle(rand.nextRangeScalar(0, kBitmapSize),
+                              rand.nextRangeScalar(0, kBitmapSize), 30, paint);
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        SkPaint bitmapPaint;
+        bitmapPaint.setFilterQuality(kHigh_SkFilterQuality);
+        SkPaint paint;
+        this->setupPaint(&paint);
+
+        SkRandom rand;
+        for (int i = 0; i < loops; ++i) {
+            canvas->save();
+            canvas->scale(0.45f, 0.45f);
+            canvas->drawBitmap(fBitmap, 0, 0, &bitmapPaint);
+            canvas->restore();
+            canvas->save();
+            canvas->scale(0.25f, 0.25f);
+            for (int j = 0; j < kPathsPerBitmap; ++j) {
+                SkPath path;
+                OneShotPathBench::MakePath(&rand, &path);
+                canvas->drawPath(path, paint);
+            }
+            canvas->restore();
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 class RandomPathBench : public Benchmark {
 public:
     bool isSuitableFor(Backend backend) override {
@@ -1019,6 +1123,9 @@ DEF_BENCH( return new LongCurvedPathBench(FLAGS00); )
 DEF_BENCH( return new LongCurvedPathBench(FLAGS01); )
 DEF_BENCH( return new LongLinePathBench(FLAGS00); )
 DEF_BENCH( return new LongLinePathBench(FLAGS01); )
+DEF_BENCH( return new OneShotPathBench(false); )
+DEF_BENCH( return new OneShotPathBench(true); )
+DEF_BENCH( return new OneShotPathEvictionBench(); )
 
 DEF_BENCH( return new PathCreateBench(); )
 DEF_BENCH( return new PathCopyBench(); )
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "Benchmark.h"
+#include "Sk1DPathEffect.h"
+#include "Sk2DPathEffect.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkString.h"
+
+// Fills a polygon with a hatch pattern: small stamps, or lines, on a rotated lattice.
+class Hatch2DBench : public Benchmark {
+public:
+    Hatch2DBench(bool lines, Sk2DPathEffect::Evaluation evaluation) {
+        SkMatrix lattice;
+        lattice.setScale(8, 8);
+        lattice.postRotate(45);
+        if (lines) {
+            fEffect.reset(SkLine2DPathEffect::Create(1, lattice, evaluation));
+        } else {
+            SkPath stamp;
+            stamp.moveTo(-2, 1);
+            stamp.lineTo(0, -2);
+            stamp.lineTo(2, 1);
+            stamp.close();
+            fEffect.reset(SkPath2DPathEffect::Create(lattice, stamp, evaluation));
+        }
+        fName.printf("hatch2d_%s_%s", lines ? "line" : "path",
+                     Sk2DPathEffect::kTile_Evaluation == evaluation ? "tile" : "geometry");
+
+        // Like a zoomed in forest area: most of it is off the canvas.
+        fPath.moveTo(-900, -600);
+        fPath.lineTo(1200, -1100);
+        fPath.lineTo(1900, 700);
+        fPath.lineTo(350, 1500);
+        fPath.lineTo(-1000, 900);
+        fPath.close();
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setColor(0xFF3C7A3C);
+        paint.setPathEffect(fEffect);
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawPath(fPath, paint);
+        }
+    }
+
+private:
+    SkString                    fName;
+    SkPath                      fPath;
+    SkAutoTUnref<SkPathEffect>  fEffect;
+
+    typedef Benchmark INHERITED;
+};
+
+// Stamps a small symbol along a long curvy border.
+class Stamp1DBench : public Benchmark {
+public:
+    Stamp1DBench(SkPath1DPathEffect::Style style, SkPath1DPathEffect::Evaluation evaluation) {
+        SkPath stamp;
+        stamp.moveTo(-3, 0);
+        stamp.lineTo(0, -4);
+        stamp.lineTo(3, 0);
+        stamp.close();
+        fEffect.reset(SkPath1DPathEffect::Create(stamp, 10, 0, style, evaluation));
+        fName.printf("stamp1d_%s_%s",
+                     SkPath1DPathEffect::kRotate_Style == style ? "rotate" : "translate",
+                     SkPath1DPathEffect::kStamp_Evaluation == evaluation ? "stamp" : "geometry");
+
+        fPath.moveTo(10, 10);
+        for (int i = 1; i <= 12; ++i) {
+            fPath.quadTo(SkIntToScalar(i * 50 - 25), SkIntToScalar(i & 1 ? 300 : -100),
+                         SkIntToScalar(i * 50), 240);
+            fPath.lineTo(SkIntToScalar(i * 50), SkIntToScalar(i & 1 ? 460 : 20));
+        }
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setColor(0xFF7A3C3C);
+        paint.setPathEffect(fEffect);
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawPath(fPath, paint);
+        }
+    }
+
+private:
+    SkString                    fName;
+    SkPath                      fPath;
+    SkAutoTUnref<SkPathEffect>  fEffect;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new Hatch2DBench(false, Sk2DPathEffect::kGeometry_Evaluation); )
+DEF_BENCH( return new Hatch2DBench(false, Sk2DPathEffect::kTile_Evaluation); )
+DEF_BENCH( return new Hatch2DBench(true, Sk2DPathEffect::kGeometry_Evaluation); )
+DEF_BENCH( return new Hatch2DBench(true, Sk2DPathEffect::kTile_Evaluation); )
+
+DEF_BENCH( return new Stamp1DBench(SkPath1DPathEffect::kTranslate_Style,
+                                   SkPath1DPathEffect::kGeometry_Evaluation); )
+DEF_BENCH( return new Stamp1DBench(SkPath1DPathEffect::kTranslate_Style,
+                                   SkPath1DPathEffect::kStamp_Evaluation); )
+DEF_BENCH( return new Stamp1DBench(SkPath1DPathEffect::kRotate_Style,
+                                   SkPath1DPathEffect::kGeometry_Evaluation); )
+DEF_BENCH( return new Stamp1DBench(SkPath1DPathEffect::kRotate_Style,
+                                   SkPath1DPathEffect::kStamp_Evaluation); )
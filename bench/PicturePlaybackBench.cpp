@@ -7,6 +7,7 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
+#include "SkColorFilter.h"
 #include "SkPaint.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
@@ -134,12 +135,55 @@ private:
     typedef PicturePlaybackBench INHERITED;
 };
 
+// Lots of small rects, like the cells of a chart or the tiles of a map, all drawn with the
+// same paint apart from its color. With an xfermode or a color filter on the paint, picking
+// the blitter costs about as much as blitting the few pixels of each rect.
+class RectPlaybackBench : public PicturePlaybackBench {
+public:
+    enum Effect {
+        kNone_Effect,
+        kXfermode_Effect,
+        kColorFilter_Effect,
+    };
+
+    RectPlaybackBench(Effect effect)
+        : INHERITED(kXfermode_Effect == effect ? "rects_multiply" :
+                    kColorFilter_Effect == effect ? "rects_colorfilter" : "rects")
+        , fEffect(effect) { }
+protected:
+    void recordCanvas(SkCanvas* canvas) override {
+        SkPaint paint;
+        if (kXfermode_Effect == fEffect) {
+            paint.setXfermodeMode(SkXfermode::kMultiply_Mode);
+        } else if (kColorFilter_Effect == fEffect) {
+            SkAutoTUnref<SkColorFilter> cf(SkColorFilter::CreateModeFilter(
+                    0xFF808080, SkXfermode::kModulate_Mode));
+            paint.setColorFilter(cf);
+        }
+
+        SkRandom rand;
+        const SkScalar size = SkIntToScalar(4);
+        for (SkScalar y = 0; y < fPictureHeight; y += 2 * size) {
+            for (SkScalar x = 0; x < fPictureWidth; x += 2 * size) {
+                paint.setColor(rand.nextU() | 0xFF000000);
+                canvas->drawRect(SkRect::MakeXYWH(x, y, size, size), paint);
+            }
+        }
+    }
+private:
+    Effect fEffect;
+    typedef PicturePlaybackBench INHERITED;
+};
+
 
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new TextPlaybackBench(); )
 DEF_BENCH( return new PosTextPlaybackBench(true); )
 DEF_BENCH( return new PosTextPlaybackBench(false); )
+DEF_BENCH( return new RectPlaybackBench(RectPlaybackBench::kNone_Effect); )
+DEF_BENCH( return new RectPlaybackBench(RectPlaybackBench::kXfermode_Effect); )
+DEF_BENCH( return new RectPlaybackBench(RectPlaybackBench::kColorFilter_Effect); )
 
 // Chrome draws into small tiles with impl-side painting.
 // This benchmark measures the relative performance of our bounding-box hierarchies,
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "SkString.h"
+
+#include <stdio.h>
+
+/*
+ *  Times writing and reading back a page-like picture (boxes on whole pixels, text, and paths
+ *  with arbitrary coordinates) with and without SkPicture::kCompact_SerializeFlag.
+ */
+
+enum Encoding {
+    kPlain_Encoding,
+    kCompact_Encoding,
+    kQuantized_Encoding,
+};
+
+static const char* gEncodingNames[] = { "plain", "compact", "quantized" };
+
+static const uint32_t gEncodingFlags[] = {
+    0,
+    SkPicture::kCompact_SerializeFlag,
+    SkPicture::kCompact_SerializeFlag | SkPicture::kQuantizePoints_SerializeFlag,
+};
+
+static SkPicture* make_page() {
+    static const int kW = 1000, kH = 4000;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(kW, kH, NULL, 0);
+    SkRandom rand;
+
+    SkPaint fill, stroke, text;
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setAntiAlias(true);
+    text.setTextSize(12);
+    text.setAntiAlias(true);
+
+    for (int y = 0; y < kH; y += 40) {
+        fill.setColor(rand.nextU() | 0xFF000000);
+        canvas->drawRect(SkRect::MakeXYWH(20, SkIntToScalar(y), 960, 36), fill);
+        canvas->drawText("Hamburgefons and more", 21, 30, SkIntToScalar(y + 24), text);
+
+        SkPath path;
+        path.moveTo(rand.nextRangeF(0, kW), rand.nextRangeF(y, y + 40.0f));
+        for (int i = 0; i < 8; ++i) {
+            path.cubicTo(rand.nextRangeF(0, kW), rand.nextRangeF(y, y + 40.0f),
+                         rand.nextRangeF(0, kW), rand.nextRangeF(y, y + 40.0f),
+                         rand.nextRangeF(0, kW), rand.nextRangeF(y, y + 40.0f));
+        }
+        canvas->drawPath(path, stroke);
+
+        SkRRect rrect;
+        rrect.setRectXY(SkRect::MakeXYWH(600, y + 4.5f, 100, 30), 6, 6);
+        canvas->drawRRect(rrect, stroke);
+    }
+    return recorder.endRecording();
+}
+
+class PictureSerializeBench : public Benchmark {
+public:
+    PictureSerializeBench(Encoding encoding, bool read) : fEncoding(encoding), fRead(read) {
+        fName.printf("picture_%s_%s", read ? "deserialize" : "serialize",
+                     gEncodingNames[encoding]);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        fPicture.reset(make_page());
+        SkDynamicMemoryWStream stream;
+        fPicture->serialize(&stream, NULL, gEncodingFlags[fEncoding]);
+        fData.reset(stream.copyToData());
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            if (fRead) {
+                SkMemoryStream stream(fData);
+                SkAutoTUnref<SkPicture> picture(SkPicture::CreateFromStream(&stream));
+            } else {
+                SkDynamicMemoryWStream stream;
+                fPicture->serialize(&stream, NULL, gEncodingFlags[fEncoding]);
+            }
+        }
+    }
+
+private:
+    Encoding                fEncoding;
+    bool                    fRead;
+    SkString                fName;
+    SkAutoTUnref<SkPicture> fPicture;
+    SkAutoTUnref<SkData>    fData;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(PictureSerializeBench, (kPlain_Encoding, false)); )
+DEF_BENCH( return SkNEW_ARGS(PictureSerializeBench, (kCompact_Encoding, false)); )
+DEF_BENCH( return SkNEW_ARGS(PictureSerializeBench, (kQuantized_Encoding, false)); )
+DEF_BENCH( return SkNEW_ARGS(PictureSerializeBench, (kPlain_Encoding, true)); )
+DEF_BENCH( return SkNEW_ARGS(PictureSerializeBench, (kCompact_Encoding, true)); )
+DEF_BENCH( return SkNEW_ARGS(PictureSerializeBench, (kQuantized_Encoding, true)); )
+
+/*
+ *  Times loading the same picture from a file on disk, raw and compressed with the built-in
+ *  LZ4 codec, which is decompressed as it is parsed.  (The file is written to the working
+ *  directory and removed afterwards.)
+ */
+enum Container {
+    kRaw_Container,
+    kLZ4_Container,
+    kCompactLZ4_Container,
+};
+
+static const char* gContainerNames[] = { "raw", "lz4", "compact_lz4" };
+
+static const uint32_t gContainerFlags[] = {
+    0,
+    SkPicture::kCompressLZ4_SerializeFlag,
+    SkPicture::kCompact_SerializeFlag | SkPicture::kCompressLZ4_SerializeFlag,
+};
+
+class PictureLoadBench : public Benchmark {
+public:
+    PictureLoadBench(Container container) : fContainer(container), fWritten(false) {
+        fName.printf("picture_load_%s", gContainerNames[container]);
+        fPath.printf("%s.skp", fName.c_str());
+    }
+
+    ~PictureLoadBench() {
+        if (fWritten) {
+            remove(fPath.c_str());
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        SkAutoTUnref<SkPicture> picture(make_page());
+        SkFILEWStream file(fPath.c_str());
+        picture->serialize(&file, NULL, gContainerFlags[fContainer]);
+        fWritten = file.isValid();
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkFILEStream file(fPath.c_str());
+            SkAutoTUnref<SkPicture> picture(SkPicture::CreateFromStream(&file));
+        }
+    }
+
+private:
+    Container   fContainer;
+    SkString    fName;
+    SkString    fPath;
+    bool        fWritten;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(PictureLoadBench, (kRaw_Container)); )
+DEF_BENCH( return SkNEW_ARGS(PictureLoadBench, (kLZ4_Container)); )
+DEF_BENCH( return SkNEW_ARGS(PictureLoadBench, (kCompactLZ4_Container)); )
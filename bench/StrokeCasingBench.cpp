@@ -0,0 +1,95 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkLayerDrawLooper.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+// Draws roads the way map renderers do: each road is stroked with a wide dark casing, and then
+// again on top with a narrower light fill, through one SkLayerDrawLooper.
+class StrokeCasingBench : public Benchmark {
+public:
+    StrokeCasingBench(int layers, bool aa, bool curved)
+        : fLayers(layers)
+        , fAA(aa)
+        , fCurved(curved) {
+        fName.printf("stroke_casing_%d_%s_%s", layers, curved ? "curved" : "lines",
+                     aa ? "aa" : "bw");
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        SkRandom rand;
+        for (int i = 0; i < kRoads; ++i) {
+            SkPath& road = fRoads[i];
+            SkPoint pt = SkPoint::Make(rand.nextRangeScalar(0, 640), rand.nextRangeScalar(0, 480));
+            road.moveTo(pt);
+            for (int j = 0; j < 8; ++j) {
+                SkPoint next = pt + SkVector::Make(rand.nextRangeScalar(-60, 60),
+                                                   rand.nextRangeScalar(-60, 60));
+                if (fCurved) {
+                    road.quadTo(pt + SkVector::Make(rand.nextRangeScalar(-30, 30),
+                                                    rand.nextRangeScalar(-30, 30)), next);
+                } else {
+                    road.lineTo(next);
+                }
+                pt = next;
+            }
+        }
+
+        static const SkScalar kWidths[] = { 14, 10, 4 };
+        static const SkColor kColors[] = { 0xFF806040, 0xFFFFE080, 0xFFFFFFFF };
+
+        SkLayerDrawLooper::Builder builder;
+        SkLayerDrawLooper::LayerInfo info;
+        info.fPaintBits = SkLayerDrawLooper::kStyle_Bit;
+        info.fColorMode = SkXfermode::kSrc_Mode;
+        for (int i = 0; i < fLayers; ++i) {
+            SkPaint* paint = builder.addLayerOnTop(info);
+            paint->setStyle(SkPaint::kStroke_Style);
+            paint->setStrokeWidth(kWidths[i]);
+            paint->setStrokeCap(SkPaint::kRound_Cap);
+            paint->setStrokeJoin(SkPaint::kRound_Join);
+            paint->setColor(kColors[i]);
+        }
+        fPaint.setAntiAlias(fAA);
+        fPaint.setLooper(builder.detachLooper())->unref();
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            for (int j = 0; j < kRoads; ++j) {
+                canvas->drawPath(fRoads[j], fPaint);
+            }
+        }
+    }
+
+private:
+    enum {
+        kRoads = 20,
+    };
+    SkString fName;
+    SkPath   fRoads[kRoads];
+    SkPaint  fPaint;
+    int      fLayers;
+    bool     fAA;
+    bool     fCurved;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new StrokeCasingBench(2, true, false); )
+DEF_BENCH( return new StrokeCasingBench(2, true, true); )
+DEF_BENCH( return new StrokeCasingBench(3, true, true); )
+DEF_BENCH( return new StrokeCasingBench(2, false, true); )
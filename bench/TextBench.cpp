@@ -8,6 +8,7 @@
 
 #include "Benchmark.h"
 #include "Resources.h"
+#include "SkBlurDrawLooper.h"
 #include "SkCanvas.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
@@ -48,15 +49,18 @@ class TextBench : public Benchmark {
     FontQuality fFQ;
     bool        fDoPos;
     bool        fDoColorEmoji;
+    bool        fDoShadow;
     SkAutoTUnref<SkTypeface> fColorEmojiTypeface;
     SkPoint*    fPos;
 public:
     TextBench(const char text[], int ps,
-              SkColor color, FontQuality fq, bool doColorEmoji = false, bool doPos = false)  {
+              SkColor color, FontQuality fq, bool doColorEmoji = false, bool doPos = false,
+              bool doShadow = false)  {
         fPos = NULL;
         fFQ = fq;
         fDoPos = doPos;
         fDoColorEmoji = doColorEmoji;
+        fDoShadow = doShadow;
         fText.set(text);
 
         fPaint.setAntiAlias(kBW != fq);
@@ -64,6 +68,12 @@ public:
         fPaint.setTextSize(SkIntToScalar(ps));
         fPaint.setColor(color);
 
+        if (doShadow) {
+            // a drop shadow, as labels on maps have
+            fPaint.setLooper(SkBlurDrawLooper::Create(0x80000000, SkIntToScalar(2),
+                                                      SkIntToScalar(2), SkIntToScalar(2)))->unref();
+        }
+
         if (doColorEmoji) {
             SkASSERT(kBW == fFQ);
             SkString filename = GetResourcePath("/Funkster.ttf");
@@ -109,6 +119,9 @@ protected:
         if (fDoColorEmoji && fColorEmojiTypeface) {
             fName.append("_ColorEmoji");
         }
+        if (fDoShadow) {
+            fName.append("_shadow");
+        }
 
         return fName.c_str();
     }
@@ -174,3 +187,6 @@ DEF_BENCH( return new TextBench(STR, 16, 0x88FF0000, kBW, true); )
 
 DEF_BENCH( return new TextBench(STR, 16, 0xFF000000, kBW, true, true); )
 DEF_BENCH( return new TextBench(STR, 16, 0xFF000000, kAA, false, true); )
+
+DEF_BENCH( return new TextBench(STR, 16, 0xFF000000, kAA, false, false, true); )
+DEF_BENCH( return new TextBench(STR, 16, 0xFF000000, kAA, false, true, true); )
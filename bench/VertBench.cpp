@@ -7,14 +7,18 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkGradientShader.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkShader.h"
 #include "SkString.h"
+#include "SkTemplates.h"
 
 enum VertFlags {
-    kColors_VertFlag,
-    kTexture_VertFlag,
+    kColors_VertFlag  = 1 << 0,
+    kTexture_VertFlag = 1 << 1,
+    // Same area in many more, smaller triangles, so per-triangle costs dominate.
+    kDense_VertFlag   = 1 << 2,
 };
 
 class VertBench : public Benchmark {
@@ -22,15 +26,15 @@ class VertBench : public Benchmark {
     enum {
         W = 640,
         H = 480,
-        ROW = 20,
-        COL = 20,
-        PTS = (ROW + 1) * (COL + 1),
-        IDX = ROW * COL * 6,
     };
 
-    SkPoint fPts[PTS];
-    SkColor fColors[PTS];
-    uint16_t fIdx[IDX];
+    int fRow, fCol, fPtCount, fIdxCount;
+    SkAutoTMalloc<SkPoint> fPts;
+    SkAutoTMalloc<SkPoint> fTexs;
+    SkAutoTMalloc<SkColor> fColors;
+    SkAutoTMalloc<uint16_t> fIdx;
+    unsigned fFlags;
+    SkAutoTUnref<SkShader> fShader;
 
     static void load_2_tris(uint16_t idx[], int x, int y, int rb) {
         int n = y * rb + x;
@@ -39,40 +43,66 @@ class VertBench : public Benchmark {
     }
 
 public:
-    VertBench() {
-        const SkScalar dx = SkIntToScalar(W) / COL;
-        const SkScalar dy = SkIntToScalar(H) / COL;
+    VertBench(unsigned flags)
+        : fRow((flags & kDense_VertFlag) ? 100 : 20)
+        , fCol(fRow)
+        , fPtCount((fRow + 1) * (fCol + 1))
+        , fIdxCount(fRow * fCol * 6)
+        , fPts(fPtCount)
+        , fTexs(fPtCount)
+        , fColors(fPtCount)
+        , fIdx(fIdxCount)
+        , fFlags(flags) {
+        const SkScalar dx = SkIntToScalar(W) / fCol;
+        const SkScalar dy = SkIntToScalar(H) / fCol;
 
-        SkPoint* pts = fPts;
-        uint16_t* idx = fIdx;
+        SkPoint* pts = fPts.get();
+        uint16_t* idx = fIdx.get();
 
         SkScalar yy = 0;
-        for (int y = 0; y <= ROW; y++) {
+        for (int y = 0; y <= fRow; y++) {
             SkScalar xx = 0;
-            for (int x = 0; x <= COL; ++x) {
+            for (int x = 0; x <= fCol; ++x) {
                 pts->set(xx, yy);
                 pts += 1;
                 xx += dx;
 
-                if (x < COL && y < ROW) {
-                    load_2_tris(idx, x, y, COL + 1);
+                if (x < fCol && y < fRow) {
+                    load_2_tris(idx, x, y, fCol + 1);
                     for (int i = 0; i < 6; i++) {
-                        SkASSERT(idx[i] < PTS);
+                        SkASSERT(idx[i] < fPtCount);
                     }
                     idx += 6;
                 }
             }
             yy += dy;
         }
-        SkASSERT(PTS == pts - fPts);
-        SkASSERT(IDX == idx - fIdx);
+        SkASSERT(fPtCount == pts - fPts.get());
+        SkASSERT(fIdxCount == idx - fIdx.get());
 
         SkRandom rand;
-        for (int i = 0; i < PTS; ++i) {
+        for (int i = 0; i < fPtCount; ++i) {
             fColors[i] = rand.nextU() | (0xFF << 24);
+            // Texture coordinates that map the same way for every triangle.
+            fTexs[i] = fPts[i];
         }
 
+        const SkPoint gradPts[] = { { 0, 0 }, { SkIntToScalar(W), SkIntToScalar(H) } };
+        const SkColor gradColors[] = { SK_ColorRED, SK_ColorBLUE };
+        fShader.reset(SkGradientShader::CreateLinear(gradPts, gradColors, NULL, 2,
+                                                     SkShader::kClamp_TileMode));
+
+        // Colors alone keep the original "verts" name.
         fName.set("verts");
+        if (fFlags & kTexture_VertFlag) {
+            if (fFlags & kColors_VertFlag) {
+                fName.append("_colors");
+            }
+            fName.append("_texture");
+        }
+        if (fFlags & kDense_VertFlag) {
+            fName.append("_dense");
+        }
     }
 
 protected:
@@ -81,9 +111,16 @@ protected:
         SkPaint paint;
         this->setupPaint(&paint);
 
+        const SkPoint* texs = NULL;
+        if (fFlags & kTexture_VertFlag) {
+            paint.setShader(fShader);
+            texs = fTexs.get();
+        }
+        const SkColor* colors = (fFlags & kColors_VertFlag) ? fColors.get() : NULL;
+
         for (int i = 0; i < loops; i++) {
-            canvas->drawVertices(SkCanvas::kTriangles_VertexMode, PTS,
-                                 fPts, NULL, fColors, NULL, fIdx, IDX, paint);
+            canvas->drawVertices(SkCanvas::kTriangles_VertexMode, fPtCount,
+                                 fPts.get(), texs, colors, NULL, fIdx.get(), fIdxCount, paint);
         }
     }
 private:
@@ -92,4 +129,8 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-DEF_BENCH( return SkNEW_ARGS(VertBench, ()); )
+DEF_BENCH( return SkNEW_ARGS(VertBench, (kColors_VertFlag)); )
+DEF_BENCH( return SkNEW_ARGS(VertBench, (kTexture_VertFlag)); )
+DEF_BENCH( return SkNEW_ARGS(VertBench, (kColors_VertFlag | kTexture_VertFlag)); )
+DEF_BENCH( return SkNEW_ARGS(VertBench, (kColors_VertFlag | kDense_VertFlag)); )
+DEF_BENCH( return SkNEW_ARGS(VertBench, (kTexture_VertFlag | kDense_VertFlag)); )
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkData.h"
+#include "SkDOM.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "SkString.h"
+#include "SkXMLParser.h"
+
+enum XMLParseMode {
+    kSAX_XMLParseMode,
+    kDOM_XMLParseMode,
+    kPull_XMLParseMode,
+};
+
+// Counts elements so the work can't be optimized away.
+class CountingXMLParser : public SkXMLParser {
+public:
+    CountingXMLParser() : fCount(0) {}
+    int fCount;
+
+protected:
+    bool onStartElement(const char elem[]) override {
+        fCount += 1;
+        return false;
+    }
+    bool onAddAttribute(const char name[], const char value[]) override {
+        fCount += 1;
+        return false;
+    }
+};
+
+/*
+ *  Parses a generated SVG-like document of a few MB: a flat run of <g> groups, each holding
+ *  paths with several attributes, an occasional entity and a bit of text.
+ */
+class XMLParseBench : public Benchmark {
+public:
+    XMLParseBench(XMLParseMode mode) : fMode(mode) {
+        switch (fMode) {
+            case kSAX_XMLParseMode:  fName.set("xml_parse_sax");  break;
+            case kDOM_XMLParseMode:  fName.set("xml_parse_dom");  break;
+            case kPull_XMLParseMode: fName.set("xml_parse_pull"); break;
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        SkRandom rand;
+        SkDynamicMemoryWStream doc;
+        doc.writeText("<?xml version='1.0'?>\n<svg width='1024' height='1024'>\n");
+        for (int g = 0; g < 2000; ++g) {
+            doc.writeText(SkStringPrintf("  <g id='group%d' transform='translate(%d, %d)'>\n", g,
+                                         rand.nextULessThan(1024),
+                                         rand.nextULessThan(1024)).c_str());
+            for (int p = 0; p < 10; ++p) {
+                doc.writeText(SkStringPrintf("    <path d='M%d %d L%d %d Q%d %d %d %d Z' "
+                                             "fill='#%06x' stroke-width='%d' title='a &amp; b'/>\n",
+                                             rand.nextULessThan(100), rand.nextULessThan(100),
+                                             rand.nextULessThan(100), rand.nextULessThan(100),
+                                             rand.nextULessThan(100), rand.nextULessThan(100),
+                                             rand.nextULessThan(100), rand.nextULessThan(100),
+                                             rand.nextU() & 0xFFFFFF,
+                                             rand.nextULessThan(8)).c_str());
+            }
+            doc.writeText(SkStringPrintf("    <text>label %d</text>\n  </g>\n", g).c_str());
+        }
+        doc.writeText("</svg>\n");
+        fDoc.reset(doc.copyToData());
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            this->parse();
+        }
+    }
+
+private:
+    void parse() {
+        switch (fMode) {
+            case kSAX_XMLParseMode: {
+                CountingXMLParser parser;
+                parser.parse((const char*)fDoc->data(), fDoc->size());
+                SkASSERT(parser.fCount > 0);
+                break;
+            }
+            case kDOM_XMLParseMode: {
+                SkDOM dom;
+                SkAssertResult(dom.build((const char*)fDoc->data(), fDoc->size()));
+                break;
+            }
+            case kPull_XMLParseMode: {
+                SkMemoryStream stream(fDoc);
+                SkXMLPullParser parser(&stream);
+                while (parser.nextToken() > SkXMLPullParser::END_DOCUMENT) {}
+                break;
+            }
+        }
+    }
+
+    XMLParseMode         fMode;
+    SkString             fName;
+    SkAutoTUnref<SkData> fDoc;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(XMLParseBench, (kSAX_XMLParseMode)); )
+DEF_BENCH( return SkNEW_ARGS(XMLParseBench, (kDOM_XMLParseMode)); )
+DEF_BENCH( return SkNEW_ARGS(XMLParseBench, (kPull_XMLParseMode)); )
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "gm.h"
+#include "SkLayerDrawLooper.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+
+// Roads as map renderers draw them: a casing looper strokes each path wide and dark, and then
+// narrower and lighter on top. The casings of crossing roads overlap, and the top layer of
+// the last column is translucent.
+DEF_SIMPLE_GM(strokecasing, canvas, 600, 400) {
+    static const SkScalar kWidths[] = { 16, 11, 3 };
+    static const SkColor kColors[][3] = {
+        { 0xFF806040, 0xFFFFE080, 0xFFFFFFFF },
+        { 0xFF404040, 0xFFFFFFFF, 0x80FF0000 },
+    };
+
+    SkRandom rand;
+    SkPath roads;
+    for (int i = 0; i < 6; ++i) {
+        SkPoint pts[9];
+        for (int j = 0; j < 9; ++j) {
+            pts[j].fX = rand.nextRangeScalar(20, 180);
+            pts[j].fY = rand.nextRangeScalar(20, 360);
+        }
+        roads.moveTo(pts[0]);
+        for (int j = 1; j < 9; j += 2) {
+            roads.quadTo(pts[j], pts[j + 1]);
+        }
+    }
+
+    SkLayerDrawLooper::LayerInfo info;
+    info.fPaintBits = SkLayerDrawLooper::kStyle_Bit;
+    info.fColorMode = SkXfermode::kSrc_Mode;
+    for (int column = 0; column < 3; ++column) {
+        const int layers = 0 == column ? 2 : 3;
+        const SkColor* colors = kColors[column >> 1];
+        SkLayerDrawLooper::Builder builder;
+        for (int i = 0; i < layers; ++i) {
+            SkPaint* layer = builder.addLayerOnTop(info);
+            layer->setStyle(SkPaint::kStroke_Style);
+            layer->setStrokeWidth(kWidths[i]);
+            layer->setStrokeCap(SkPaint::kRound_Cap);
+            layer->setStrokeJoin(SkPaint::kRound_Join);
+            layer->setColor(colors[i]);
+        }
+
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setLooper(builder.detachLooper())->unref();
+        canvas->save();
+        canvas->translate(SkIntToScalar(column * 200), 0);
+        canvas->clipRect(SkRect::MakeWH(200, 400));
+        canvas->drawPath(roads, paint);
+        canvas->restore();
+    }
+}
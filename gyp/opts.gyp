@@ -12,7 +12,7 @@
 
   # Generally we shove things into one 'opts' target conditioned on platform.
   # If a particular platform needs some files built with different flags,
-  # those become separate targets: opts_ssse3, opts_sse41, opts_neon.
+  # those become separate targets: opts_ssse3, opts_sse41, opts_sse42, opts_avx2, opts_neon.
 
   'targets': [
     {
@@ -33,7 +33,7 @@
       'conditions': [
         [ '"x86" in skia_arch_type and skia_os != "ios"', {
           'cflags': [ '-msse2' ],
-          'dependencies': [ 'opts_ssse3', 'opts_sse41' ],
+          'dependencies': [ 'opts_ssse3', 'opts_sse41', 'opts_sse42', 'opts_avx2' ],
           'sources': [ '<@(sse2_sources)' ],
         }],
 
@@ -126,6 +126,46 @@
         }],
       ],
     },
+    {
+      'target_name': 'opts_sse42',
+      'product_name': 'skia_opts_sse42',
+      'type': 'static_library',
+      'standalone_static_library': 1,
+      'dependencies': [ 'core.gyp:*' ],
+      'include_dirs': [ '../src/core' ],
+      'sources': [ '<@(sse42_sources)' ],
+      'conditions': [
+        [ 'skia_os == "win"', {
+            'defines' : [ 'SK_CPU_SSE_LEVEL=42' ],
+        }],
+        [ 'not skia_android_framework', {
+          'cflags': [ '-msse4.2' ],
+        }],
+        [ 'skia_os == "mac"', {
+          'xcode_settings': { 'GCC_ENABLE_SSE42_EXTENSIONS': 'YES' },
+        }],
+      ],
+    },
+    {
+      'target_name': 'opts_avx2',
+      'product_name': 'skia_opts_avx2',
+      'type': 'static_library',
+      'standalone_static_library': 1,
+      'dependencies': [ 'core.gyp:*' ],
+      'include_dirs': [ '../src/core' ],
+      'sources': [ '<@(avx2_sources)' ],
+      'conditions': [
+        [ 'skia_os == "win"', {
+            'defines' : [ 'SK_CPU_SSE_LEVEL=52' ],
+        }],
+        [ 'not skia_android_framework', {
+          'cflags': [ '-mavx2' ],
+        }],
+        [ 'skia_os == "mac"', {
+          'xcode_settings': { 'OTHER_CPLUSPLUSFLAGS': [ '-mavx2' ] },
+        }],
+      ],
+    },
     {
       'target_name': 'opts_neon',
       'product_name': 'skia_opts_neon',
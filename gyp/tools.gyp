@@ -22,6 +22,7 @@
         'filter',
         'gpuveto',
         'lua_app',
+        'lua_batch',
         'lua_pictures',
         'imgconv',
         'pinspect',
@@ -162,7 +163,8 @@
         '../tools/skpdiff/skpdiff_util.cpp',
       ],
       'include_dirs': [
-        '../src/core/', # needed for SkTLList.h
+        '../src/core/', # needed for SkTLList.h and SkNx.h
+        '../src/utils/', # needed for SkBitmapHasher.h
         '../tools/',    # needed for picture_utils::replace_char
       ],
       'dependencies': [
@@ -332,6 +334,29 @@
         'skia_lib.gyp:skia_lib',
       ],
     },
+    {
+      'target_name': 'lua_batch',
+      'type': 'executable',
+      'sources': [
+        '../tools/lua/lua_batch.cpp',
+        '../src/utils/SkLua.cpp',
+      ],
+      'include_dirs': [
+        # Lua exposes GrReduceClip which in turn requires src/core for SkTLList
+        '../src/gpu/',
+        '../src/core/',
+      ],
+      'dependencies': [
+        'effects.gyp:effects',
+        'flags.gyp:flags',
+        'images.gyp:images',
+        'lua.gyp:lua',
+        'pdf.gyp:pdf',
+        'ports.gyp:ports',
+        'skia_lib.gyp:skia_lib',
+        'timer',
+      ],
+    },
     {
       'target_name': 'lua_pictures',
       'type': 'executable',
@@ -14,6 +14,7 @@
       ],
       'include_dirs': [
         '../include/xml',
+        '../src/core',
       ],
       'sources': [
         '../include/xml/SkBML_WXMLParser.h',
@@ -27,11 +28,10 @@
         '../src/xml/SkDOM.cpp',
         '../src/xml/SkXMLParser.cpp',
         '../src/xml/SkXMLPullParser.cpp',
+        '../src/xml/SkXMLTokenizer.cpp',
+        '../src/xml/SkXMLTokenizer.h',
         '../src/xml/SkXMLWriter.cpp',
       ],
-      'sources!': [
-          '../src/xml/SkXMLPullParser.cpp', #if 0 around class decl in header
-      ],
       'direct_dependent_settings': {
         'include_dirs': [
           '../include/xml',
@@ -80,6 +80,40 @@ public:
      */
     SkScanlineDecoder* getScanlineDecoder(const SkImageInfo& dstInfo);
 
+    /**
+     *  Prepare to decode the image into dst while its encoded data is still
+     *  arriving, e.g. from the network.
+     *
+     *  The codec's stream stands in for the data received so far: read() may
+     *  return fewer bytes than requested when the rest has not arrived yet, and
+     *  isAtEnd() only returns true once all of the data has been read. The
+     *  stream must be rewindable.
+     *
+     *  Call incrementalDecode() each time more data arrives. dst must remain
+     *  valid until the decode is complete. Calling getPixels() or
+     *  getScanlineDecoder() ends the incremental decode.
+     *
+     *  @param dstInfo Info of the destination, as in getPixels().
+     *  @return kSuccess if the decode was started, kUnimplemented if this
+     *      codec cannot decode incrementally, or another error as getPixels()
+     *      would report it.
+     */
+    Result startIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                  const Options* = NULL);
+
+    /**
+     *  Decode as much of the image passed to startIncrementalDecode() as the
+     *  data received so far allows.
+     *
+     *  @param rowsDecoded If non-NULL, set to the number of rows, from the top,
+     *      of the destination which are fully decoded and will not change.
+     *      Interlaced images have no such rows until they are complete.
+     *  @return kSuccess once the whole image is decoded, kIncompleteInput if
+     *      more data is needed, kInvalidInput if the data is corrupt, or
+     *      kInvalidParameters if no incremental decode was started.
+     */
+    Result incrementalDecode(int* rowsDecoded = NULL);
+
     /**
      *  Some images may initially report that they have alpha due to the format
      *  of the encoded data, but then never use any colors which have alpha
@@ -133,6 +167,28 @@ protected:
         return NULL;
     }
 
+    /**
+     *  Override if your codec supports incremental decoding.
+     *
+     *  Like onGetScanlineDecoder(), the implementation must call
+     *  rewindIfNeeded() and handle it as appropriate.
+     */
+    virtual Result onStartIncrementalDecode(const SkImageInfo& /* dstInfo */, void* /* dst */,
+                                            size_t /* rowBytes */, const Options&) {
+        return kUnimplemented;
+    }
+
+    /**
+     *  Only called after onStartIncrementalDecode() succeeded, and as long as
+     *  rewindIfNeeded() has not been called since. Implementations which need
+     *  to go back to the start of the stream must rewind it directly.
+     *
+     *  @param rowsDecoded Never NULL.
+     */
+    virtual Result onIncrementalDecode(int* /* rowsDecoded */) {
+        return kUnimplemented;
+    }
+
     virtual bool onReallyHasAlpha() const { return false; }
 
     enum RewindState {
@@ -171,6 +227,7 @@ private:
 #endif  //  SK_SUPPORT_LEGACY_BOOL_ONGETINFO
     SkAutoTDelete<SkStream>             fStream;
     bool                                fNeedsRewind;
+    bool                                fIncrementalDecodeStarted;
     SkAutoTDelete<SkScanlineDecoder>    fScanlineDecoder;
 
     typedef SkImageGenerator INHERITED;
@@ -120,6 +120,10 @@ protected:
     bool onWritePixels(const SkImageInfo&, const void*, size_t, int, int) override;
     void* onAccessPixels(SkImageInfo* info, size_t* rowBytes) override;
 
+    /**  PRIVATE / EXPERIMENTAL -- do not call */
+    bool EXPERIMENTAL_drawPicture(SkCanvas*, const SkPicture*, const SkMatrix*,
+                                  const SkPaint*) override;
+
     /** Called when this device is installed into a Canvas. Balanced by a call
         to unlockPixels() when the device is removed from a Canvas.
     */
@@ -1247,6 +1247,9 @@ protected:
     // notify our surface (if we have one) that we are about to draw, so it
     // can perform copy-on-write or invalidate any cached images
     void predrawNotify();
+    // same, but the draw is known to stay within the current clip and within localBounds
+    // (if not NULL), so the surface only needs to treat that part of itself as changed
+    void predrawNotify(const SkRect* localBounds);
 
 private:
     class MCRec;
@@ -34,8 +34,12 @@ public:
     void    drawPaint(const SkPaint&) const;
     void    drawPoints(SkCanvas::PointMode, size_t count, const SkPoint[],
                        const SkPaint&, bool forceUseDevice = false) const;
+    /**
+     *  If customBlitter is not null, it is given the rect instead of a blitter chosen for
+     *  fBitmap, as with drawPath().
+     */
     void    drawRect(const SkRect& prePaintRect, const SkPaint&, const SkMatrix* paintMatrix,
-                     const SkRect* postPaintRect) const;
+                     const SkRect* postPaintRect, SkBlitter* customBlitter = NULL) const;
     void    drawRect(const SkRect& rect, const SkPaint& paint) const {
         this->drawRect(rect, paint, NULL, NULL);
     }
@@ -945,6 +945,21 @@ public:
      */
     size_t readFromMemory(const void* buffer, size_t length);
 
+    /**
+     *  Like writeToMemory(), but leaves out the points, for callers that store them in their
+     *  own encoding. If the points they store are not exactly the path's (e.g. they are snapped
+     *  to a grid), pass pointsMoved, so that what the path knows about its shape (convexity,
+     *  direction, whether it is an oval) is not read back with them.
+     */
+    size_t writeToMemoryWithoutPoints(void* buffer, bool pointsMoved) const;
+    /**
+     *  Initializes the path from what writeToMemoryWithoutPoints() wrote and the points it left
+     *  out. Returns the number of bytes read, or 0 if there was not enough memory available or
+     *  pointCount is not the number of points the path was written with.
+     */
+    size_t readFromMemoryWithoutPoints(const void* buffer, size_t length, const SkPoint points[],
+                                       int pointCount);
+
     /** Returns a non-zero, globally unique value corresponding to the set of verbs
         and points in the path (but not the fill type [except on Android skbug.com/1762]).
         Each time the path is modified, a different generation ID will be returned.
@@ -992,6 +1007,10 @@ private:
      */
     void copyFields(const SkPath& that);
 
+    // Reads the points from the buffer, or if !pointsInBuffer takes them from the caller.
+    size_t readFromMemory(const void* buffer, size_t length, const SkPoint points[],
+                          int pointCount, bool pointsInBuffer);
+
     friend class Iter;
 
     friend class SkPathStroker;
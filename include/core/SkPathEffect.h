@@ -18,6 +18,7 @@
 #include "SkTDArray.h"
 
 class SkPath;
+class SkShader;
 
 /** \class SkPathEffect
 
@@ -104,6 +105,37 @@ public:
                           const SkStrokeRec&, const SkMatrix&,
                           const SkRect* cullR) const;
 
+    /** \class StampData
+
+        StampData holds the copies of one path that an 'asStamps' call
+        places along the src path.
+    */
+    class StampData {
+    public:
+        SkPath              fStamp;     // the path that is copied, always filled
+        SkTDArray<SkPoint>  fPositions; // where each copy's origin goes
+        SkTDArray<SkVector> fTangents;  // if not empty, the unit vector each copy's x-axis
+                                        // is rotated to, one per position
+    };
+
+    /**
+     *  Does applying this path effect to 'src' yield copies of a single path,
+     *  each translated (and possibly rotated) into place? If so, return them
+     *  in 'results', so the caller can rasterize the stamp once and reuse it.
+     */
+    virtual bool asStamps(StampData* results, const SkPath& src,
+                          const SkStrokeRec&, const SkRect* cullR) const;
+
+    /**
+     *  Does applying this path effect yield a pattern that repeats over the
+     *  plane, clipped to 'src'? If so, return a shader that draws that pattern
+     *  as 'paint' (its color and stroke) would under 'ctm', so the caller can
+     *  fill 'src' with it instead of drawing the pattern's geometry. Stamps
+     *  are then cut off at the edge of 'src' rather than kept whole. Returns
+     *  NULL otherwise. The caller must unref the returned shader.
+     */
+    virtual SkShader* refTileShader(const SkPaint& paint, const SkMatrix& ctm) const;
+
     /**
      *  If the PathEffect can be represented as a dash pattern, asADash will return kDash_DashType
      *  and None otherwise. If a non NULL info is passed in, the various DashInfo will be filled
@@ -175,6 +175,14 @@ public:
 
     static SkPathRef* CreateFromBuffer(SkRBuffer* buffer);
 
+    /**
+     * Reads what writeToBufferWithoutPoints() wrote, taking the points from the caller. Returns
+     * NULL if the buffer is too short or pointCount is not the number of points it was written
+     * with.
+     */
+    static SkPathRef* CreateFromBufferWithoutPoints(SkRBuffer* buffer, const SkPoint points[],
+                                                    int pointCount);
+
     /**
      * Rollsback a path ref to zero verbs and points with the assumption that the path ref will be
      * repopulated with approximately the same number of verbs and points. A new path ref is created
@@ -246,6 +254,18 @@ public:
      */
     uint32_t writeSize() const;
 
+    /**
+     * Like writeToBuffer(), but leaves out the points and bounds, for callers that store the
+     * points in their own encoding. If the points they store are not exactly these (e.g. they
+     * are snapped to a grid), pass pointsMoved so the path ref is not read back as an oval.
+     */
+    void writeToBufferWithoutPoints(SkWBuffer* buffer, bool pointsMoved) const;
+
+    /**
+     * Gets the number of bytes that would be written in writeToBufferWithoutPoints()
+     */
+    uint32_t writeSizeWithoutPoints() const;
+
     /**
      * Gets an ID that uniquely identifies the contents of the path ref. If two path refs have the
      * same ID then they have the same verbs and points. However, two path refs may have the same
@@ -276,6 +296,10 @@ private:
         SkDEBUGCODE(this->validate();)
     }
 
+    // Reads the points from the buffer, or if !pointsInBuffer takes them from the caller.
+    static SkPathRef* Read(SkRBuffer* buffer, const SkPoint points[], int pointCount,
+                           bool pointsInBuffer);
+
     void copy(const SkPathRef& ref, int additionalReserveVerbs, int additionalReservePoints);
 
     // Return true if the computed bounds are finite.
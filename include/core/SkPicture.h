@@ -138,13 +138,45 @@ public:
      */
     uint32_t uniqueID() const { return fUniqueID; }
 
+    enum SerializeFlags {
+        /**
+         *  Store the ops and flattened data packed, with small ints as varints and point arrays
+         *  delta-coded. Often much smaller, at some cost in write time. Read back as usual, but
+         *  unpacking costs about as much as reading the bytes it saves at a few hundred MB/s, so
+         *  this only makes loads faster from storage slower than that.
+         */
+        kCompact_SerializeFlag          = 1 << 0,
+        /**
+         *  With kCompact_SerializeFlag, snap path and point-array coordinates to a 1/16 grid so
+         *  they all delta-code. This is lossy.
+         */
+        kQuantizePoints_SerializeFlag   = 1 << 1,
+        /**
+         *  Compress everything after the header with the built-in LZ4 codec. Decompression is
+         *  fast and streams, so loading costs little more than reading a raw file. LZ4 is always
+         *  available, so the picture is always compressed.
+         */
+        kCompressLZ4_SerializeFlag      = 1 << 2,
+        /**
+         *  Compress everything after the header with zlib. Smaller than LZ4 but slower to read.
+         *  Needs SkFlate (the skflate target) linked in and SkFlate::RegisterStreamCodec()
+         *  called, both to write and to read. If it isn't, the picture is compressed with LZ4
+         *  instead. Takes precedence over kCompressLZ4_SerializeFlag.
+         */
+        kCompressFlate_SerializeFlag    = 1 << 3,
+    };
+
     /**
      *  Serialize to a stream. If non NULL, serializer will be used to serialize
-     *  any bitmaps in the picture.
+     *  any bitmaps in the picture. flags is a combination of SerializeFlags.
+     *
+     *  Returns the compression that was used: kCompressFlate_SerializeFlag,
+     *  kCompressLZ4_SerializeFlag, or 0 if the picture was written uncompressed.
      *
      *  TODO: Use serializer to serialize SkImages as well.
      */
-    void serialize(SkWStream*, SkPixelSerializer* serializer = NULL) const;
+    uint32_t serialize(SkWStream*, SkPixelSerializer* serializer = NULL,
+                       uint32_t flags = 0) const;
 
     /**
      *  Serialize to a buffer.
@@ -244,15 +276,18 @@ private:
     // V38: Added PictureResolution option to SkPictureImageFilter
     // V39: Added FilterLevel option to SkPictureImageFilter
     // V40: Remove UniqueID serialization from SkImageFilter.
+    // V41: Optional compact encoding (SkPictInfo::kCompact_Flag)
+    // V42: Optional whole-stream compression (SkPictInfo::kCompressed_Flag)
+    // V43: Sk2DPathEffect and SkPath1DPathEffect write their Evaluation
 
     // Note: If the picture version needs to be increased then please follow the
     // steps to generate new SKPs in (only accessible to Googlers): http://goo.gl/qATVcw
 
     // Only SKPs within the min/current picture version range (inclusive) can be read.
     static const uint32_t MIN_PICTURE_VERSION = 35;     // Produced by Chrome M39.
-    static const uint32_t CURRENT_PICTURE_VERSION = 40;
+    static const uint32_t CURRENT_PICTURE_VERSION = 43;
 
-    void createHeader(SkPictInfo* info) const;
+    void createHeader(SkPictInfo* info, uint32_t serializeFlags = 0) const;
     static bool IsValidPictInfo(const SkPictInfo& info);
 
     // Takes ownership of the SkRecord and (optional) SnapshotArray, refs the (optional) BBH.
@@ -295,6 +330,7 @@ private:
     friend class SkPictureRecorder;            // SkRecord-based constructor.
     friend class GrLayerHoister;               // access to fRecord
     friend class ReplaceDraw;
+    friend class SkRasterLayerCache;           // access to fRecord and fBBH
     friend class SkPictureUtils;
     friend class SkRecordedDrawable;
 };
@@ -54,6 +54,13 @@ public:
         kDisallowAntiAlias_Flag     = 1 << 0,
         kDisallowDither_Flag        = 1 << 1,
         kUseDistanceFieldFonts_Flag = 1 << 2,
+        /**
+         *  A raster surface that forks its pixels away from a snapshot keeps the old pixels,
+         *  and reuses them at the next fork if that snapshot is gone, copying over just the
+         *  areas drawn since. This makes snapshotting every frame cheap, but the surface then
+         *  holds two buffers of its size for as long as it lives.
+         */
+        kReuseSnapshotPixels_Flag   = 1 << 3,
     };
     SkSurfaceProps(uint32_t flags, SkPixelGeometry);
 
@@ -70,6 +77,7 @@ public:
     bool isDisallowAA() const { return SkToBool(fFlags & kDisallowAntiAlias_Flag); }
     bool isDisallowDither() const { return SkToBool(fFlags & kDisallowDither_Flag); }
     bool isUseDistanceFieldFonts() const { return SkToBool(fFlags & kUseDistanceFieldFonts_Flag); }
+    bool isReuseSnapshotPixels() const { return SkToBool(fFlags & kReuseSnapshotPixels_Flag); }
 
 private:
     SkSurfaceProps();
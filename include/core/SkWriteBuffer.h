@@ -26,8 +26,22 @@ class SkRefCntSet;
 class SkWriteBuffer {
 public:
     enum Flags {
-        kCrossProcess_Flag  = 1 << 0,
-        kValidation_Flag    = 1 << 1,
+        kCrossProcess_Flag      = 1 << 0,
+        kValidation_Flag        = 1 << 1,
+        /**
+         *  Write point arrays and paths as deltas on a grid where that is exact, for data that
+         *  will be stored with SkWriter32::Pack(). Read it back with SkReadBuffer::kCompact_Flag.
+         */
+        kCompact_Flag           = 1 << 2,
+        /** With kCompact_Flag, snap every point to a 1/16 grid so they all delta-code. Lossy. */
+        kQuantizePoints_Flag    = 1 << 3,
+    };
+
+    // How compact point arrays describe their coordinates; shared with SkReadBuffer.
+    enum {
+        kMaxPointGridShift      = 8,    // exact grids are tried from 1 down to 1/256
+        kQuantizePointGridShift = 4,    // kQuantizePoints_Flag snaps to 1/16
+        kRawPointsGrid          = 0xFF, // the coordinates are stored as plain floats
     };
 
     SkWriteBuffer(uint32_t flags = 0);
@@ -109,6 +123,10 @@ public:
 
 private:
     bool isValidating() const { return SkToBool(fFlags & kValidation_Flag); }
+    bool isCompact() const { return SkToBool(fFlags & kCompact_Flag); }
+
+    bool writeCompactPoints(const SkPoint src[], int count);
+    void writeCompactPath(const SkPath&);
 
     const uint32_t fFlags;
     SkFactorySet* fFactorySet;
@@ -235,6 +235,21 @@ public:
      *  Captures a snapshot of the data as it is right now, and return it.
      */
     SkData* snapshotAsData() const;
+
+    /**
+     *  Pack size bytes of 32-bit words (e.g. the contents of a writer) into dst for storage.
+     *  Words holding small ints, or floats that are multiples of 1/16, become 1-3 byte varints;
+     *  everything else is copied as-is. dst must hold PackedSizeBound(size) bytes. Returns the
+     *  packed size. SkReader32::Unpack() restores the exact words.
+     */
+    static size_t Pack(const void* src, size_t size, void* dst);
+
+    static size_t PackedSizeBound(size_t size) {
+        SkASSERT(SkAlign4(size) == size);
+        // At worst, a tag byte and a run count for every four words.
+        return size + (size + 15) / 8;
+    }
+
 private:
     void growToAtLeast(size_t size);
 
@@ -49,26 +49,43 @@ public:
         kStyleCount
     };
 
+    /** How the effect is applied when drawing to a raster device. */
+    enum Evaluation {
+        /** Every copy of the path is added to one result path. */
+        kGeometry_Evaluation,
+        /** The path is rasterized once per rotation and subpixel offset, and
+            the masks are blitted at each position. Overlapping copies are
+            each blended rather than merged, so paints that are translucent
+            or have an xfermode, a color filter or a translucent shader draw
+            the geometry instead. Only applies to kTranslate_Style and
+            kRotate_Style.
+        */
+        kStamp_Evaluation,
+    };
+
     /** Dash by replicating the specified path.
         @param path The path to replicate (dash)
         @param advance The space between instances of path
         @param phase distance (mod advance) along path for its initial position
         @param style how to transform path at each point (based on the current
                      position and tangent)
+        @param evaluation how to draw the copies
     */
     static SkPath1DPathEffect* Create(const SkPath& path, SkScalar advance, SkScalar phase,
-                                      Style style) {
-        return SkNEW_ARGS(SkPath1DPathEffect, (path, advance, phase, style));
+                                      Style style,
+                                      Evaluation evaluation = kGeometry_Evaluation) {
+        return SkNEW_ARGS(SkPath1DPathEffect, (path, advance, phase, style, evaluation));
     }
 
     virtual bool filterPath(SkPath*, const SkPath&,
                             SkStrokeRec*, const SkRect*) const override;
+    bool asStamps(StampData*, const SkPath&, const SkStrokeRec&, const SkRect*) const override;
 
     SK_TO_STRING_OVERRIDE()
     SK_DECLARE_PUBLIC_FLATTENABLE_DESERIALIZATION_PROCS(SkPath1DPathEffect)
 
 protected:
-    SkPath1DPathEffect(const SkPath& path, SkScalar advance, SkScalar phase, Style);
+    SkPath1DPathEffect(const SkPath& path, SkScalar advance, SkScalar phase, Style, Evaluation);
     void flatten(SkWriteBuffer&) const override;
 
     // overrides from Sk1DPathEffect
@@ -80,6 +97,7 @@ private:
     SkScalar    fAdvance;       // copied from constructor
     SkScalar    fInitialOffset; // computed from phase
     Style       fStyle;         // copied from constructor
+    Evaluation  fEvaluation;    // copied from constructor
 
     typedef Sk1DPathEffect INHERITED;
 };
@@ -8,13 +8,33 @@
 #ifndef Sk2DPathEffect_DEFINED
 #define Sk2DPathEffect_DEFINED
 
+#include "SkPaint.h"
 #include "SkPath.h"
 #include "SkPathEffect.h"
 #include "SkMatrix.h"
+#include "SkMutex.h"
+
+class SkPicture;
 
 class SK_API Sk2DPathEffect : public SkPathEffect {
 public:
+    /** How the effect is applied when drawing to a raster device. */
+    enum Evaluation {
+        /** Every lattice cell inside the path adds its geometry to the result. */
+        kGeometry_Evaluation,
+        /** One cell is drawn into a cached tile, and the path is filled with
+            that tile repeated. Cells on the edge of the path are cut off
+            rather than kept whole. Falls back to geometry when either matrix
+            has perspective, or when cells are too small or too large on the
+            device for a tile to pay off.
+        */
+        kTile_Evaluation,
+    };
+
+    ~Sk2DPathEffect() override;
+
     bool filterPath(SkPath*, const SkPath&, SkStrokeRec*, const SkRect*) const override;
+    SkShader* refTileShader(const SkPaint&, const SkMatrix& ctm) const override;
 
 protected:
     /** New virtual, to be overridden by subclasses.
@@ -34,16 +54,26 @@ protected:
     virtual void nextSpan(int u, int v, int ucount, SkPath* dst) const;
 
     const SkMatrix& getMatrix() const { return fMatrix; }
+    Evaluation getEvaluation() const { return fEvaluation; }
 
     // protected so that subclasses can call this during unflattening
-    explicit Sk2DPathEffect(const SkMatrix& mat);
+    explicit Sk2DPathEffect(const SkMatrix& mat, Evaluation = kGeometry_Evaluation);
     void flatten(SkWriteBuffer&) const override;
 
     SK_TO_STRING_OVERRIDE()
 
 private:
+    const SkPicture* refTilePicture(const SkPaint&) const;
+
     SkMatrix    fMatrix, fInverse;
     bool        fMatrixIsInvertible;
+    Evaluation  fEvaluation;
+
+    // The last tile recorded (one lattice cell, in lattice space), and the paint it was recorded
+    // for.  Guarded by fTileMutex.
+    mutable SkMutex             fTileMutex;
+    mutable const SkPicture*    fTilePicture;
+    mutable SkPaint             fTilePaint;
 
     // illegal
     Sk2DPathEffect(const Sk2DPathEffect&);
@@ -55,8 +85,9 @@ private:
 
 class SK_API SkLine2DPathEffect : public Sk2DPathEffect {
 public:
-    static SkLine2DPathEffect* Create(SkScalar width, const SkMatrix& matrix) {
-        return SkNEW_ARGS(SkLine2DPathEffect, (width, matrix));
+    static SkLine2DPathEffect* Create(SkScalar width, const SkMatrix& matrix,
+                                      Evaluation evaluation = kGeometry_Evaluation) {
+        return SkNEW_ARGS(SkLine2DPathEffect, (width, matrix, evaluation));
     }
 
     virtual bool filterPath(SkPath* dst, const SkPath& src,
@@ -66,8 +97,8 @@ public:
     SK_DECLARE_PUBLIC_FLATTENABLE_DESERIALIZATION_PROCS(SkLine2DPathEffect)
 
 protected:
-    SkLine2DPathEffect(SkScalar width, const SkMatrix& matrix)
-        : Sk2DPathEffect(matrix), fWidth(width) {}
+    SkLine2DPathEffect(SkScalar width, const SkMatrix& matrix, Evaluation evaluation)
+        : Sk2DPathEffect(matrix, evaluation), fWidth(width) {}
     void flatten(SkWriteBuffer&) const override;
 
     void nextSpan(int u, int v, int ucount, SkPath*) const override;
@@ -84,15 +115,16 @@ public:
      *  Stamp the specified path to fill the shape, using the matrix to define
      *  the latice.
      */
-    static SkPath2DPathEffect* Create(const SkMatrix& matrix, const SkPath& path) {
-        return SkNEW_ARGS(SkPath2DPathEffect, (matrix, path));
+    static SkPath2DPathEffect* Create(const SkMatrix& matrix, const SkPath& path,
+                                      Evaluation evaluation = kGeometry_Evaluation) {
+        return SkNEW_ARGS(SkPath2DPathEffect, (matrix, path, evaluation));
     }
 
     SK_TO_STRING_OVERRIDE()
     SK_DECLARE_PUBLIC_FLATTENABLE_DESERIALIZATION_PROCS(SkPath2DPathEffect)
 
 protected:
-    SkPath2DPathEffect(const SkMatrix&, const SkPath&);
+    SkPath2DPathEffect(const SkMatrix&, const SkPath&, Evaluation);
     void flatten(SkWriteBuffer&) const override;
 
     void next(const SkPoint&, int u, int v, SkPath*) const override;
@@ -26,6 +26,16 @@ public:
      *  SVG element).
      */
     static SkCanvas* Create(const SkRect& bounds, SkXMLWriter*);
+
+    static const int kFullPrecision = -1;
+    static const int kMaxPrecision  = 8;
+
+    /**
+     *  As above, but rounds coordinates to 'precision' decimal digits (at most kMaxPrecision)
+     *  and writes path data with relative commands, which makes for much smaller output.
+     *  kFullPrecision keeps the exact float values.
+     */
+    static SkCanvas* Create(const SkRect& bounds, SkXMLWriter*, int precision);
 };
 
 #endif
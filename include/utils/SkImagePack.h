@@ -0,0 +1,122 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkImagePack_DEFINED
+#define SkImagePack_DEFINED
+
+#include "SkBitmap.h"
+#include "SkData.h"
+#include "SkMutex.h"
+#include "SkPixelSerializer.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
+
+class SkWStream;
+
+/**
+ *  An image pack holds the bitmaps of a set of pictures (e.g. map tiles that share icon sprites)
+ *  once each, keyed by a hash of their pixels.  The pictures themselves only store that key.
+ *
+ *  Writing: pass one SkImagePackWriter as the serializer to SkPicture::serialize() for every
+ *  picture in the set, then write() the pack next to them.
+ *
+ *  Reading: load the pack, Register() it, and pass SkImagePack::InstallPixelRef to
+ *  SkPicture::CreateFromStream().  Images are decoded lazily, when first drawn, and every picture
+ *  that references an image shares the one decoded copy.
+ */
+class SK_API SkImagePack : public SkRefCnt {
+public:
+    SK_DECLARE_INST_COUNT(SkImagePack)
+
+    /**
+     *  Returns a pack reading from data (which it refs), or NULL if data isn't a valid pack.
+     */
+    static SkImagePack* NewFromData(SkData* data);
+
+    /**
+     *  Maps the pack in the file at path.  Returns NULL if it can't be read or isn't valid.
+     */
+    static SkImagePack* NewFromFile(const char path[]);
+
+    ~SkImagePack() override;
+
+    /** The number of distinct images in the pack. */
+    int count() const { return fCount; }
+
+    /**
+     *  If src is an image reference written by SkImagePackWriter and the image is in this pack,
+     *  sets dst to the (lazily decoded) image and returns true.
+     */
+    bool installPixelRef(const void* src, size_t length, SkBitmap* dst);
+
+    /**
+     *  Registers the pack so InstallPixelRef() resolves references against it, until it is
+     *  unregistered.  The pack is reffed while registered.
+     */
+    static void Register(SkImagePack*);
+    static void Unregister(SkImagePack*);
+
+    /**
+     *  Fits SkPicture::InstallPixelRefProc.  Image references are resolved against the registered
+     *  packs.  Anything else is an ordinary encoded image, decoded with
+     *  SkImageDecoder::DecodeMemory, as CreateFromStream() does by default.
+     */
+    static bool InstallPixelRef(const void* src, size_t length, SkBitmap* dst);
+
+    /** Returns true if src is an image reference written by SkImagePackWriter. */
+    static bool IsReference(const void* src, size_t length);
+
+private:
+    SkImagePack(SkData* data, int count);
+
+    int find(const uint8_t key[]) const;
+
+    SkAutoTUnref<SkData>        fData;
+    const int                   fCount;
+    SkMutex                     fMutex;
+    // Each image's bitmap, once something has asked for it.  Guarded by fMutex.
+    SkAutoTArray<SkBitmap>      fBitmaps;
+
+    typedef SkRefCnt INHERITED;
+};
+
+/**
+ *  Collects the bitmaps of the pictures it serializes into a pack.  Each distinct image is PNG
+ *  encoded and stored once; the pictures get a 24 byte reference instead.  Images that were
+ *  already encoded are re-encoded from their pixels, so identical images dedupe however they
+ *  were loaded.  Bitmaps that can't be encoded are left in the picture as usual.
+ */
+class SK_API SkImagePackWriter : public SkPixelSerializer {
+public:
+    SkImagePackWriter();
+    ~SkImagePackWriter() override;
+
+    /** The number of distinct images collected so far. */
+    int count() const { return fEntries.count(); }
+
+    /** The number of references handed out, i.e. bitmaps serialized through this writer. */
+    int referenceCount() const { return fReferenceCount; }
+
+    /** Writes the pack.  Returns false if the stream fails. */
+    bool write(SkWStream*) const;
+
+protected:
+    bool onUseEncodedData(const void* data, size_t len) override;
+    SkData* onEncodePixels(const SkImageInfo&, const void* pixels, size_t rowBytes) override;
+
+private:
+    struct Entry {
+        uint8_t fKey[16];
+        SkData* fEncoded;   // owned
+    };
+    SkTDArray<Entry>    fEntries;   // sorted by key
+    int                 fReferenceCount;
+
+    typedef SkPixelSerializer INHERITED;
+};
+
+#endif
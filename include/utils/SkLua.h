@@ -17,12 +17,15 @@
 struct lua_State;
 
 class SkCanvas;
+class SkImage;
 class SkMatrix;
 class SkPaint;
 class SkPath;
+class SkPicture;
 struct SkRect;
 class SkRRect;
 class SkTextBlob;
+class SkTypeface;
 
 #define SkScalarToLua(x)    SkScalarToDouble(x)
 #define SkLuaToScalar(x)    SkDoubleToScalar(x)
@@ -62,6 +65,15 @@ public:
     void pushClipStack(const SkClipStack&, const char tableKey[] = NULL);
     void pushClipStackElement(const SkClipStack::Element& element, const char tableKey[] = NULL);
     void pushTextBlob(const SkTextBlob*, const char tableKey[] = NULL);
+    void pushImage(const SkImage*, const char tableKey[] = NULL);
+    void pushPicture(const SkPicture*, const char tableKey[] = NULL);
+    void pushTypeface(SkTypeface*, const char tableKey[] = NULL);
+
+    // Return the object at the given stack index if it is of that type, or NULL. These objects are
+    // immutable, so they may be shared between lua_States running on different threads.
+    static const SkImage* ToImage(lua_State*, int index);
+    static const SkPicture* ToPicture(lua_State*, int index);
+    static SkTypeface* ToTypeface(lua_State*, int index);
 
     // This SkCanvas lua methods is declared here to benefit from SkLua's friendship with SkCanvas.
     static int lcanvas_getReducedClipStack(lua_State* L);
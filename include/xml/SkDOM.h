@@ -18,6 +18,7 @@ struct SkDOMNode;
 struct SkDOMAttr;
 
 class SkDOMParser;
+class SkStream;
 class SkXMLParser;
 
 class SkDOM {
@@ -28,13 +29,21 @@ public:
     typedef SkDOMNode Node;
     typedef SkDOMAttr Attr;
 
-    /** Returns null on failure
+    /** Returns null on failure.
+        The document is copied once into storage owned by the DOM and parsed in place, so
+        names, attribute values and text all point into that copy.
     */
     const Node* build(const char doc[], size_t len);
+    const Node* build(SkStream&);
     const Node* copy(const SkDOM& dom, const Node* node);
 
     const Node* getRootNode() const;
 
+    /** Returns the bytes allocated for the nodes, and for any strings that were copied rather
+        than referenced. The copy of the document that build() parses is not counted.
+    */
+    size_t getAllocatedSize() const { return fAlloc.totalUsed(); }
+
     SkXMLParser* beginParsing();
     const Node* finishParsing();
 
@@ -88,6 +97,9 @@ public:
     SkDEBUGCODE(static void UnitTest();)
 
 private:
+    const Node* buildInPlace(size_t len);
+
+    SkAutoMalloc               fDocument;
     SkChunkAlloc               fAlloc;
     Node*                      fRoot;
     SkAutoTDelete<SkDOMParser> fParser;
@@ -62,6 +62,12 @@ public:
     bool parse(SkStream& docStream);
     bool parse(const SkDOM&, const SkDOMNode*);
 
+    /** Like parse(doc, len), but tokenizes doc in place instead of working on a copy: the
+        strings passed to the callbacks point into doc (which is modified) and are only
+        valid for as long as doc is.
+    */
+    bool parseInPlace(char doc[], size_t len);
+
     static void GetNativeErrorString(int nativeErrorCode, SkString* str);
 
 protected:
@@ -84,13 +90,13 @@ private:
     void reportError(void* parser);
 };
 
-#if 0
 class SkXMLPullParser {
 public:
             SkXMLPullParser();
     explicit SkXMLPullParser(SkStream*);
     virtual ~SkXMLPullParser();
 
+    /** The stream is not owned; it is read to the end by setStream(). */
     SkStream*   getStream() const { return fStream; }
     SkStream*   setStream(SkStream* stream);
 
@@ -150,6 +156,5 @@ private:
     struct Impl;
     Impl*   fImpl;
 };
-#endif
 
 #endif
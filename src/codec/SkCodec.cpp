@@ -73,6 +73,7 @@ SkCodec::SkCodec(const SkImageInfo& info, SkStream* stream)
 #endif
     , fStream(stream)
     , fNeedsRewind(false)
+    , fIncrementalDecodeStarted(false)
 {}
 
 SkCodec::RewindState SkCodec::rewindIfNeeded() {
@@ -80,6 +81,8 @@ SkCodec::RewindState SkCodec::rewindIfNeeded() {
     // require a rewind.
     const bool needsRewind = fNeedsRewind;
     fNeedsRewind = true;
+    // Whatever reads the stream next replaces any incremental decode.
+    fIncrementalDecodeStarted = false;
     if (!needsRewind) {
         return kNoRewindNecessary_RewindState;
     }
@@ -91,3 +94,33 @@ SkScanlineDecoder* SkCodec::getScanlineDecoder(const SkImageInfo& dstInfo) {
     fScanlineDecoder.reset(this->onGetScanlineDecoder(dstInfo));
     return fScanlineDecoder.get();
 }
+
+SkCodec::Result SkCodec::startIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                size_t rowBytes, const Options* options) {
+    fIncrementalDecodeStarted = false;
+    if (kUnknown_SkColorType == dstInfo.colorType() ||
+        kIndex_8_SkColorType == dstInfo.colorType()) {
+        return kInvalidConversion;
+    }
+    if (NULL == dst || rowBytes < dstInfo.minRowBytes()) {
+        return kInvalidParameters;
+    }
+
+    Options optsStorage;
+    if (NULL == options) {
+        options = &optsStorage;
+    }
+    const Result result = this->onStartIncrementalDecode(dstInfo, dst, rowBytes, *options);
+    fIncrementalDecodeStarted = (kSuccess == result);
+    return result;
+}
+
+SkCodec::Result SkCodec::incrementalDecode(int* rowsDecoded) {
+    int rows = 0;
+    const Result result = fIncrementalDecodeStarted ? this->onIncrementalDecode(&rows)
+                                                    : kInvalidParameters;
+    if (rowsDecoded) {
+        *rowsDecoded = rows;
+    }
+    return result;
+}
@@ -172,6 +172,11 @@ SkGifCodec::SkGifCodec(const SkImageInfo& srcInfo, SkStream* stream,
                        GifFileType* gif)
     : INHERITED(srcInfo, stream)
     , fGif(gif)
+    , fIncrementalDst(NULL)
+    , fIncrementalRowBytes(0)
+    , fNextDecodeSize(0)
+    , fRowsDecoded(0)
+    , fIncrementalComplete(false)
 {}
 
 /*
@@ -195,6 +200,21 @@ static bool conversion_possible(const SkImageInfo& dst,
     }
 }
 
+/*
+ * Checks that the image can be decoded to dstInfo
+ */
+static SkCodec::Result check_dst_info(const SkImageInfo& dstInfo,
+                                      const SkImageInfo& srcInfo) {
+    if (dstInfo.dimensions() != srcInfo.dimensions()) {
+        return gif_error("Scaling not supported.\n", SkCodec::kInvalidScale);
+    }
+    if (!conversion_possible(dstInfo, srcInfo)) {
+        return gif_error("Cannot convert input type to output type.\n",
+                SkCodec::kInvalidConversion);
+    }
+    return SkCodec::kSuccess;
+}
+
 /*
  * Initiates the gif decode
  */
@@ -202,15 +222,41 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                                         void* dst, size_t dstRowBytes,
                                         const Options& opts, SkPMColor*, int*) {
     // Check for valid input parameters
-    if (!this->rewindIfNeeded()) {
+    const RewindState rewindState = this->rewindIfNeeded();
+    if (kCouldNotRewind_RewindState == rewindState) {
         return kCouldNotRewind;
     }
-    if (dstInfo.dimensions() != this->getInfo().dimensions()) {
-        return gif_error("Scaling not supported.\n", kInvalidScale);
+    const Result result = check_dst_info(dstInfo, this->getInfo());
+    if (kSuccess != result) {
+        return result;
     }
-    if (!conversion_possible(dstInfo, this->getInfo())) {
-        return gif_error("Cannot convert input type to output type.\n",
-                kInvalidConversion);
+    // This ends any incremental decode, which no longer needs its data.
+    fIncrementalData.reset();
+
+    // giflib has already read past the header of a rewound stream, so that
+    // needs a new reader.
+    SkAutoTCallIProc<GifFileType, CloseGif> rewoundGif(
+            kRewound_RewindState == rewindState ? open_gif(this->stream()) : NULL);
+    GifFileType* gif = fGif;
+    if (kRewound_RewindState == rewindState) {
+        if (NULL == rewoundGif) {
+            return gif_error("DGifOpen failed.\n", kCouldNotRewind);
+        }
+        gif = rewoundGif;
+    }
+    return DecodeFirstImage(gif, dstInfo, dst, dstRowBytes, opts, NULL);
+}
+
+/*
+ * Decodes the first image in the gif
+ */
+SkCodec::Result SkGifCodec::DecodeFirstImage(GifFileType* gif,
+                                             const SkImageInfo& dstInfo,
+                                             void* dst, size_t dstRowBytes,
+                                             const Options& opts,
+                                             int* rowsDecoded) {
+    if (NULL != rowsDecoded) {
+        *rowsDecoded = 0;
     }
 
     // Use this as a container to hold information about any gif extension
@@ -232,22 +278,22 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
     GifRecordType recordType;
     do {
         // Get the current record type
-        if (GIF_ERROR == DGifGetRecordType(fGif, &recordType)) {
+        if (GIF_ERROR == DGifGetRecordType(gif, &recordType)) {
             return gif_error("DGifGetRecordType failed.\n", kInvalidInput);
         }
 
         switch (recordType) {
             case IMAGE_DESC_RECORD_TYPE: {
                 // Read the image descriptor
-                if (GIF_ERROR == DGifGetImageDesc(fGif)) {
+                if (GIF_ERROR == DGifGetImageDesc(gif)) {
                     return gif_error("DGifGetImageDesc failed.\n",
                             kInvalidInput);
                 }
 
                 // If reading the image descriptor is successful, the image
                 // count will be incremented
-                SkASSERT(fGif->ImageCount >= 1);
-                SavedImage* image = &fGif->SavedImages[fGif->ImageCount - 1];
+                SkASSERT(gif->ImageCount >= 1);
+                SavedImage* image = &gif->SavedImages[gif->ImageCount - 1];
 
                 // Process the descriptor
                 const GifImageDesc& desc = image->ImageDesc;
@@ -289,10 +335,10 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                 // Allocate maximum storage to deal with invalid indices safely
                 const uint32_t maxColors = 256;
                 SkPMColor colorTable[maxColors];
-                ColorMapObject* colorMap = fGif->Image.ColorMap;
+                ColorMapObject* colorMap = gif->Image.ColorMap;
                 // If there is no local color table, use the global color table
                 if (NULL == colorMap) {
-                    colorMap = fGif->SColorMap;
+                    colorMap = gif->SColorMap;
                 }
                 if (NULL != colorMap) {
                     colorCount = colorMap->ColorCount;
@@ -308,7 +354,7 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                 }
 
                 // This is used to fill unspecified pixels in the image data.
-                uint32_t fillIndex = fGif->SBackGroundColor;
+                uint32_t fillIndex = gif->SBackGroundColor;
                 bool fillBackground = true;
                 ZeroInitialized zeroInit = opts.fZeroInitialized;
 
@@ -394,16 +440,17 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                         buffer(SkNEW_ARRAY(uint8_t, innerWidth));
 
                 // Check the interlace flag and iterate over rows of the input
-                if (fGif->Image.Interlace) {
+                if (gif->Image.Interlace) {
                     // In interlace mode, the rows of input are rearranged in
                     // the output image.  We use an iterator to take care of
                     // the rearranging.
                     SkGifInterlaceIter iter(innerHeight);
                     for (int32_t y = 0; y < innerHeight; y++) {
-                        if (GIF_ERROR == DGifGetLine(fGif, buffer.get(),
+                        if (GIF_ERROR == DGifGetLine(gif, buffer.get(),
                                 innerWidth)) {
                             // Recover from error by filling remainder of image
-                            if (fillBackground) {
+                            // unless the data for it may still arrive
+                            if (fillBackground && NULL == rowsDecoded) {
                                 memset(buffer.get(), fillIndex, innerWidth);
                                 for (; y < innerHeight; y++) {
                                     swizzler->next(buffer.get(), iter.nextY());
@@ -418,9 +465,9 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                 } else {
                     // Standard mode
                     for (int32_t y = 0; y < innerHeight; y++) {
-                        if (GIF_ERROR == DGifGetLine(fGif, buffer.get(),
+                        if (GIF_ERROR == DGifGetLine(gif, buffer.get(),
                                 innerWidth)) {
-                            if (fillBackground) {
+                            if (fillBackground && NULL == rowsDecoded) {
                                 SkPMColor* dstPtr = (SkPMColor*) SkTAddOffset
                                         <void*>(dst, y * dstRowBytes);
                                 sk_memset32(dstPtr, colorTable[fillIndex],
@@ -432,8 +479,15 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                                     y, height - 1).c_str(), kIncompleteInput);
                         }
                         swizzler->next(buffer.get());
+                        // The rows above the image were filled in already.
+                        if (NULL != rowsDecoded) {
+                            *rowsDecoded = imageTop + y + 1;
+                        }
                     }
                 }
+                if (NULL != rowsDecoded) {
+                    *rowsDecoded = height;
+                }
 
                 // FIXME: Gif files may have multiple images stored in a single
                 //        file.  This is most commonly used to enable
@@ -465,10 +519,10 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                 // Read extension data
 #if GIFLIB_MAJOR < 5
                 if (GIF_ERROR ==
-                        DGifGetExtension(fGif, &saveExt.Function, &extData)) {
+                        DGifGetExtension(gif, &saveExt.Function, &extData)) {
 #else
                 if (GIF_ERROR ==
-                        DGifGetExtension(fGif, &extFunction, &extData)) {
+                        DGifGetExtension(gif, &extFunction, &extData)) {
 #endif
                     return gif_error("Could not get extension.\n",
                             kIncompleteInput);
@@ -490,7 +544,7 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                                 kIncompleteInput);
                     }
                     // Move to the next block
-                    if (GIF_ERROR == DGifGetExtensionNext(fGif, &extData)) {
+                    if (GIF_ERROR == DGifGetExtensionNext(gif, &extData)) {
                         return gif_error("Could not get next extension.\n",
                                 kIncompleteInput);
                     }
@@ -515,3 +569,68 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
     return gif_error("Could not find any images to decode in gif file.\n",
             kInvalidInput);
 }
+
+SkCodec::Result SkGifCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo,
+                                                     void* dst, size_t dstRowBytes,
+                                                     const Options& opts) {
+    // The data is kept from the start of the stream, which NewFromStream has
+    // already read past.
+    if (kCouldNotRewind_RewindState == this->rewindIfNeeded() ||
+            !this->stream()->rewind()) {
+        return kCouldNotRewind;
+    }
+    const Result result = check_dst_info(dstInfo, this->getInfo());
+    if (kSuccess != result) {
+        return result;
+    }
+
+    fIncrementalInfo = dstInfo;
+    fIncrementalDst = dst;
+    fIncrementalRowBytes = dstRowBytes;
+    fIncrementalOptions = opts;
+    fIncrementalData.rewind();
+    fNextDecodeSize = 0;
+    fRowsDecoded = 0;
+    fIncrementalComplete = false;
+    return kSuccess;
+}
+
+SkCodec::Result SkGifCodec::onIncrementalDecode(int* rowsDecoded) {
+    if (!fIncrementalComplete) {
+        uint8_t buffer[4096];
+        size_t bytes;
+        while ((bytes = this->stream()->read(buffer, sizeof(buffer))) > 0) {
+            fIncrementalData.append(SkToInt(bytes), buffer);
+        }
+
+        // Each decode starts over from the beginning of the data, so wait
+        // until it has grown by half since the last one. Then all of the
+        // decodes together do no more than three times the work of one.
+        const bool atEnd = this->stream()->isAtEnd();
+        if (!atEnd && fIncrementalData.count() < fNextDecodeSize) {
+            *rowsDecoded = fRowsDecoded;
+            return kIncompleteInput;
+        }
+        fNextDecodeSize = fIncrementalData.count() + fIncrementalData.count() / 2 + 1;
+
+        SkMemoryStream data(fIncrementalData.begin(), fIncrementalData.count(), false);
+        SkAutoTCallIProc<GifFileType, CloseGif> gif(open_gif(&data));
+        if (NULL == gif) {
+            *rowsDecoded = fRowsDecoded;
+            return atEnd ? gif_error("DGifOpen failed.\n") : kIncompleteInput;
+        }
+        int rows;
+        const Result result = DecodeFirstImage(gif, fIncrementalInfo, fIncrementalDst,
+                                               fIncrementalRowBytes, fIncrementalOptions,
+                                               &rows);
+        fRowsDecoded = SkTMax(fRowsDecoded, rows);
+        if (kSuccess != result) {
+            *rowsDecoded = fRowsDecoded;
+            // Running out of data looks like an error to giflib.
+            return atEnd ? result : kIncompleteInput;
+        }
+        fIncrementalComplete = true;
+    }
+    *rowsDecoded = fRowsDecoded;
+    return kSuccess;
+}
@@ -7,6 +7,7 @@
 
 #include "SkCodec.h"
 #include "SkImageInfo.h"
+#include "SkTDArray.h"
 
 #include "gif_lib.h"
 
@@ -43,6 +44,13 @@ protected:
         return kGIF_SkEncodedFormat;
     }
 
+    /*
+     * Incremental decoding of the first image in the gif
+     */
+    Result onStartIncrementalDecode(const SkImageInfo&, void*, size_t,
+            const Options&) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
+
 private:
 
     /*
@@ -57,6 +65,16 @@ private:
      */
     static void FreeExtension(SavedImage* image);
 
+    /*
+     * Decodes the first image in the gif read by gif
+     *
+     * @param rowsDecoded If non-NULL, set to the number of rows, from the top,
+     *                    which were decoded before the data ran out
+     */
+    static Result DecodeFirstImage(GifFileType* gif, const SkImageInfo& dstInfo,
+            void* dst, size_t dstRowBytes, const Options& opts,
+            int* rowsDecoded);
+
     /*
      * Creates an instance of the decoder
      * Called only by NewFromStream
@@ -70,5 +88,17 @@ private:
 
     SkAutoTCallIProc<GifFileType, CloseGif> fGif; // owned
 
+    // Incremental decoding. giflib cannot suspend a decode until more data
+    // arrives, so the data received so far is kept in fIncrementalData and
+    // the image is decoded again from its start once that has grown enough.
+    SkImageInfo          fIncrementalInfo;
+    void*                fIncrementalDst;
+    size_t               fIncrementalRowBytes;
+    Options              fIncrementalOptions;
+    SkTDArray<uint8_t>   fIncrementalData;
+    int                  fNextDecodeSize;
+    int                  fRowsDecoded;
+    bool                 fIncrementalComplete;
+
     typedef SkCodec INHERITED;
 };
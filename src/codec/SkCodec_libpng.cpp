@@ -201,45 +201,11 @@ bool SkPngCodec::IsPng(SkStream* stream) {
     return true;
 }
 
-// Reads the header, and initializes the passed in fields, if not NULL (except
-// stream, which is passed to the read function).
-// Returns true on success, in which case the caller is responsible for calling
-// png_destroy_read_struct. If it returns false, the passed in fields (except
-// stream) are unchanged.
-static bool read_header(SkStream* stream, png_structp* png_ptrp,
-                        png_infop* info_ptrp, SkImageInfo* imageInfo) {
-    // The image is known to be a PNG. Decode enough to know the SkImageInfo.
-    png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL,
-                                                 sk_error_fn, sk_warning_fn);
-    if (!png_ptr) {
-        return false;
-    }
-
-    AutoCleanPng autoClean(png_ptr);
-
-    png_infop info_ptr = png_create_info_struct(png_ptr);
-    if (info_ptr == NULL) {
-        return false;
-    }
-
-    autoClean.setInfoPtr(info_ptr);
-
-    // FIXME: Could we use the return value of setjmp to specify the type of
-    // error?
-    if (setjmp(png_jmpbuf(png_ptr))) {
-        return false;
-    }
-
-    png_set_read_fn(png_ptr, static_cast<void*>(stream), sk_read_fn);
-
-    // FIXME: This is where the old code hooks up the Peeker. Does it need to
-    // be set this early? (i.e. where are the user chunks? early in the stream,
-    // potentially?)
-    // If it does, we need to figure out a way to set it here.
-
-    // The call to png_read_info() gives us all of the information from the
-    // PNG file before the first IDAT (image data chunk).
-    png_read_info(png_ptr, info_ptr);
+// Called once the header has been read: tells libpng how to transform the
+// image for the swizzler, and reports the SkImageInfo, if imageInfo is not
+// NULL. Returns false if the image is too big to decode.
+static bool set_up_transforms(png_structp png_ptr, png_infop info_ptr,
+                              SkImageInfo* imageInfo) {
     png_uint_32 origWidth, origHeight;
     int bitDepth, colorType;
     png_get_IHDR(png_ptr, info_ptr, &origWidth, &origHeight, &bitDepth,
@@ -335,6 +301,52 @@ static bool read_header(SkStream* stream, png_structp* png_ptrp,
         *imageInfo = SkImageInfo::Make(origWidth, origHeight, skColorType,
                                        skAlphaType);
     }
+    return true;
+}
+
+// Reads the header, and initializes the passed in fields, if not NULL (except
+// stream, which is passed to the read function).
+// Returns true on success, in which case the caller is responsible for calling
+// png_destroy_read_struct. If it returns false, the passed in fields (except
+// stream) are unchanged.
+static bool read_header(SkStream* stream, png_structp* png_ptrp,
+                        png_infop* info_ptrp, SkImageInfo* imageInfo) {
+    // The image is known to be a PNG. Decode enough to know the SkImageInfo.
+    png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL,
+                                                 sk_error_fn, sk_warning_fn);
+    if (!png_ptr) {
+        return false;
+    }
+
+    AutoCleanPng autoClean(png_ptr);
+
+    png_infop info_ptr = png_create_info_struct(png_ptr);
+    if (info_ptr == NULL) {
+        return false;
+    }
+
+    autoClean.setInfoPtr(info_ptr);
+
+    // FIXME: Could we use the return value of setjmp to specify the type of
+    // error?
+    if (setjmp(png_jmpbuf(png_ptr))) {
+        return false;
+    }
+
+    png_set_read_fn(png_ptr, static_cast<void*>(stream), sk_read_fn);
+
+    // FIXME: This is where the old code hooks up the Peeker. Does it need to
+    // be set this early? (i.e. where are the user chunks? early in the stream,
+    // potentially?)
+    // If it does, we need to figure out a way to set it here.
+
+    // The call to png_read_info() gives us all of the information from the
+    // PNG file before the first IDAT (image data chunk).
+    png_read_info(png_ptr, info_ptr);
+    if (!set_up_transforms(png_ptr, info_ptr, imageInfo)) {
+        return false;
+    }
+
     autoClean.detach();
     if (png_ptrp) {
         *png_ptrp = png_ptr;
@@ -364,6 +376,10 @@ SkPngCodec::SkPngCodec(const SkImageInfo& info, SkStream* stream,
     , fSrcConfig(SkSwizzler::kUnknown)
     , fNumberPasses(INVALID_NUMBER_PASSES)
     , fReallyHasAlpha(false)
+    , fIncrementalDst(NULL)
+    , fIncrementalRowBytes(0)
+    , fRowsDecoded(0)
+    , fIncrementalComplete(false)
 {}
 
 SkPngCodec::~SkPngCodec() {
@@ -408,7 +424,12 @@ SkCodec::Result SkPngCodec::initializeSwizzler(const SkImageInfo& requestedInfo,
         SkCodecPrintf("setjmp long jump!\n");
         return kInvalidInput;
     }
+    return this->setUpSwizzler(requestedInfo, dst, rowBytes, options);
+}
 
+SkCodec::Result SkPngCodec::setUpSwizzler(const SkImageInfo& requestedInfo,
+                                          void* dst, size_t rowBytes,
+                                          const Options& options) {
     // FIXME: We already retrieved this information. Store it in SkPngCodec?
     png_uint_32 origWidth, origHeight;
     int bitDepth, pngColorType, interlaceType;
@@ -451,6 +472,7 @@ SkCodec::Result SkPngCodec::initializeSwizzler(const SkImageInfo& requestedInfo,
 }
 
 bool SkPngCodec::handleRewind() {
+    fIncrementalDst = NULL;
     switch (this->rewindIfNeeded()) {
         case kNoRewindNecessary_RewindState:
             return true;
@@ -644,3 +666,136 @@ SkScanlineDecoder* SkPngCodec::onGetScanlineDecoder(const SkImageInfo& dstInfo)
     return SkNEW_ARGS(SkPngScanlineDecoder, (dstInfo, this));
 }
 
+
+///////////////////////////////////////////////////////////////////////////////
+// Incremental decoding
+///////////////////////////////////////////////////////////////////////////////
+
+// libpng's progressive reader is fed the data as it arrives, and calls back
+// with each row as soon as it is decoded.
+
+void SkPngCodec::InfoCallback(png_structp png_ptr, png_infop info_ptr) {
+    SkPngCodec* codec = static_cast<SkPngCodec*>(png_get_progressive_ptr(png_ptr));
+    if (!set_up_transforms(png_ptr, info_ptr, NULL) ||
+        kSuccess != codec->setUpSwizzler(codec->fIncrementalInfo, codec->fIncrementalDst,
+                                         codec->fIncrementalRowBytes,
+                                         codec->fIncrementalOptions)) {
+        png_error(png_ptr, "Could not set up the incremental decode");
+    }
+
+    if (codec->fNumberPasses > 1) {
+        // Each pass is combined into the rows of the previous ones, so
+        // interlaced images are swizzled once they are complete.
+        const int bpp = SkSwizzler::BytesPerPixel(codec->fSrcConfig);
+        codec->fInterlaceBuffer.reset(codec->fIncrementalInfo.width() *
+                                      codec->fIncrementalInfo.height() * bpp);
+    }
+}
+
+void SkPngCodec::RowCallback(png_structp png_ptr, png_bytep row, png_uint_32 rowNum, int) {
+    SkPngCodec* codec = static_cast<SkPngCodec*>(png_get_progressive_ptr(png_ptr));
+    if (codec->fNumberPasses > 1) {
+        const size_t srcRowBytes = codec->fIncrementalInfo.width() *
+                                   SkSwizzler::BytesPerPixel(codec->fSrcConfig);
+        uint8_t* base = static_cast<uint8_t*>(codec->fInterlaceBuffer.get());
+        png_progressive_combine_row(png_ptr, base + rowNum * srcRowBytes, row);
+        return;
+    }
+    if (NULL == row) {
+        return;
+    }
+    codec->fSwizzler->setDstRow(SkTAddOffset<void>(codec->fIncrementalDst,
+                                                   rowNum * codec->fIncrementalRowBytes));
+    codec->fReallyHasAlpha |= !SkSwizzler::IsOpaque(codec->fSwizzler->next(row));
+    codec->fRowsDecoded = rowNum + 1;
+}
+
+void SkPngCodec::EndCallback(png_structp png_ptr, png_infop) {
+    SkPngCodec* codec = static_cast<SkPngCodec*>(png_get_progressive_ptr(png_ptr));
+    const int height = codec->fIncrementalInfo.height();
+    if (codec->fNumberPasses > 1) {
+        const size_t srcRowBytes = codec->fIncrementalInfo.width() *
+                                   SkSwizzler::BytesPerPixel(codec->fSrcConfig);
+        const uint8_t* row = static_cast<const uint8_t*>(codec->fInterlaceBuffer.get());
+        codec->fSwizzler->setDstRow(codec->fIncrementalDst);
+        for (int y = 0; y < height; y++) {
+            codec->fReallyHasAlpha |= !SkSwizzler::IsOpaque(codec->fSwizzler->next(row));
+            row += srcRowBytes;
+        }
+        codec->fInterlaceBuffer.reset(0);
+    }
+    codec->fRowsDecoded = height;
+    codec->fIncrementalComplete = true;
+}
+
+SkCodec::Result SkPngCodec::onStartIncrementalDecode(const SkImageInfo& requestedInfo,
+                                                     void* dst, size_t rowBytes,
+                                                     const Options& options) {
+    // The progressive reader starts from the signature, so the stream has to
+    // go back to its start even if nothing was decoded yet.
+    if (kCouldNotRewind_RewindState == this->rewindIfNeeded() ||
+        !this->stream()->rewind()) {
+        return kCouldNotRewind;
+    }
+    if (requestedInfo.dimensions() != this->getInfo().dimensions()) {
+        return kInvalidScale;
+    }
+    if (!conversion_possible(requestedInfo, this->getInfo())) {
+        return kInvalidConversion;
+    }
+
+    this->destroyReadStruct();
+    png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL,
+                                                 sk_error_fn, sk_warning_fn);
+    if (!png_ptr) {
+        return kInvalidInput;
+    }
+    AutoCleanPng autoClean(png_ptr);
+    png_infop info_ptr = png_create_info_struct(png_ptr);
+    if (!info_ptr) {
+        return kInvalidInput;
+    }
+    autoClean.setInfoPtr(info_ptr);
+    if (setjmp(png_jmpbuf(png_ptr))) {
+        return kInvalidInput;
+    }
+    png_set_progressive_read_fn(png_ptr, this, InfoCallback, RowCallback, EndCallback);
+    autoClean.detach();
+    fPng_ptr = png_ptr;
+    fInfo_ptr = info_ptr;
+
+    fIncrementalInfo = requestedInfo;
+    fIncrementalDst = dst;
+    fIncrementalRowBytes = rowBytes;
+    fIncrementalOptions = options;
+    fRowsDecoded = 0;
+    fIncrementalComplete = false;
+    fNumberPasses = INVALID_NUMBER_PASSES;
+    return kSuccess;
+}
+
+SkCodec::Result SkPngCodec::onIncrementalDecode(int* rowsDecoded) {
+    if (NULL == fPng_ptr) {
+        // A previous call found the data to be corrupt.
+        return kInvalidInput;
+    }
+    if (setjmp(png_jmpbuf(fPng_ptr))) {
+        SkCodecPrintf("setjmp long jump!\n");
+        // libpng cannot carry on after an error.
+        this->destroyReadStruct();
+        *rowsDecoded = fRowsDecoded;
+        return kInvalidInput;
+    }
+
+    uint8_t buffer[4096];
+    while (!fIncrementalComplete) {
+        const size_t bytes = this->stream()->read(buffer, sizeof(buffer));
+        if (0 == bytes) {
+            break;
+        }
+        png_process_data(fPng_ptr, fInfo_ptr, buffer, bytes);
+    }
+
+    *rowsDecoded = fRowsDecoded;
+    return fIncrementalComplete ? kSuccess : kIncompleteInput;
+}
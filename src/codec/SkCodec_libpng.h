@@ -29,6 +29,8 @@ protected:
             override;
     SkEncodedFormat onGetEncodedFormat() const override { return kPNG_SkEncodedFormat; }
     SkScanlineDecoder* onGetScanlineDecoder(const SkImageInfo& dstInfo) override;
+    Result onStartIncrementalDecode(const SkImageInfo&, void*, size_t, const Options&) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
     bool onReallyHasAlpha() const override { return fReallyHasAlpha; }
 private:
     png_structp                 fPng_ptr;
@@ -42,18 +44,36 @@ private:
     int                         fNumberPasses;
     bool                        fReallyHasAlpha;
 
+    // Incremental decoding, through libpng's progressive reader. fIncrementalDst
+    // is NULL unless an incremental decode is in progress.
+    SkImageInfo                 fIncrementalInfo;
+    void*                       fIncrementalDst;
+    size_t                      fIncrementalRowBytes;
+    Options                     fIncrementalOptions;
+    int                         fRowsDecoded;
+    bool                        fIncrementalComplete;
+    SkAutoMalloc                fInterlaceBuffer;
+
     SkPngCodec(const SkImageInfo&, SkStream*, png_structp, png_infop);
     ~SkPngCodec();
 
     // Helper to set up swizzler and color table. Also calls png_read_update_info.
     Result initializeSwizzler(const SkImageInfo& requestedInfo, void* dst,
                               size_t rowBytes, const Options&);
+    // initializeSwizzler() without its own setjmp, for use inside libpng's callbacks.
+    Result setUpSwizzler(const SkImageInfo& requestedInfo, void* dst,
+                         size_t rowBytes, const Options&);
     // Calls rewindIfNeeded, and returns true if the decoder can continue.
     bool handleRewind();
     bool decodePalette(bool premultiply);
     void finish();
     void destroyReadStruct();
 
+    // libpng's progressive reader callbacks.
+    static void InfoCallback(png_structp, png_infop);
+    static void RowCallback(png_structp, png_bytep row, png_uint_32 rowNum, int pass);
+    static void EndCallback(png_structp, png_infop);
+
     friend class SkPngScanlineDecoder;
 
     typedef SkCodec INHERITED;
@@ -10,6 +10,7 @@
 #include "SkDeviceProperties.h"
 #include "SkDraw.h"
 #include "SkRasterClip.h"
+#include "SkRasterLayerCache.h"
 #include "SkShader.h"
 #include "SkSurface.h"
 
@@ -140,6 +141,20 @@ void* SkBitmapDevice::onAccessPixels(SkImageInfo* info, size_t* rowBytes) {
     return NULL;
 }
 
+bool SkBitmapDevice::EXPERIMENTAL_drawPicture(SkCanvas* canvas, const SkPicture* picture,
+                                              const SkMatrix* matrix, const SkPaint* paint) {
+#ifndef SK_IGNORE_RASTER_LAYER_HOISTING
+    // Like the GPU hoister, leave pictures drawn with a paint (i.e. inside a layer of their own)
+    // and devices without pixels (e.g. for SkNWayCanvas) to the regular playback.
+    if (paint || NULL == fBitmap.pixelRef()) {
+        return false;
+    }
+    return SkRasterLayerCache::DrawPicture(canvas, picture, matrix);
+#else
+    return false;
+#endif
+}
+
 #include "SkConfig8888.h"
 #include "SkPixelRef.h"
 
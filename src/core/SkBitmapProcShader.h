@@ -65,12 +65,13 @@ private:
     typedef SkShader INHERITED;
 };
 
-// Commonly used allocator. It currently is only used to allocate up to 3 objects. The total
-// bytes requested is calculated using one of our large shaders, its context size plus the size of
-// an Sk3DBlitter in SkDraw.cpp
+// Commonly used allocator. It currently is only used to allocate up to 4 objects: a shader
+// context and a blitter, plus the shaders SkBlitter::Choose wraps the paint in or an Sk3DBlitter.
+// The total bytes requested is calculated using one of our large shaders, its context size plus
+// the size of an Sk3DBlitter in SkDraw.cpp
 // Note that some contexts may contain other contexts (e.g. for compose shaders), but we've not
 // yet found a situation where the size below isn't big enough.
-typedef SkSmallAllocator<3, 1024> SkTBlitterAllocator;
+typedef SkSmallAllocator<4, 1024> SkTBlitterAllocator;
 
 // If alloc is non-NULL, it will be used to allocate the returned SkShader, and MUST outlive
 // the SkShader.
@@ -17,6 +17,7 @@
 #include "SkPixelRef.h"
 #include "SkImageEncoder.h"
 #include "SkResourceCache.h"
+#include "SkYUVPlanesCache.h"
 
 #if !SK_ARM_NEON_IS_NONE
 // These are defined in src/opts/SkBitmapProcState_arm_neon.cpp
@@ -112,6 +113,57 @@ static inline bool cache_size_okay(const SkBitmap& bm, const SkMatrix& invMat) {
         < (maximumAllocation * invMat.getScaleX() * invMat.getScaleY());
 }
 
+/*
+ *  Images that are still encoded and can be decoded to YUV planes (JPEGs) are scaled straight
+ *  from those, skipping the full size RGB decode.  The planes are cached, as the GPU's are, so
+ *  scaling the image to another size doesn't decode it again.
+ */
+static bool resize_yuv(SkBitmap* result, const SkBitmap& bitmap, SkScalar width, SkScalar height) {
+    SkPixelRef* pixelRef = bitmap.pixelRef();
+    if (NULL == pixelRef || bitmap.getPixels() ||
+        pixelRef->info().width() != bitmap.width() ||
+        pixelRef->info().height() != bitmap.height()) {
+        return false;
+    }
+
+    SkYUVPlanesCache::Info yuvInfo;
+    SkAutoTUnref<SkCachedData> cachedData(SkYUVPlanesCache::FindAndRef(
+            pixelRef->getGenerationID(), &yuvInfo));
+    void* planes[3];
+    if (cachedData.get()) {
+        planes[0] = (void*)cachedData->data();
+        planes[1] = (uint8_t*)planes[0] + yuvInfo.fSizeInMemory[0];
+        planes[2] = (uint8_t*)planes[1] + yuvInfo.fSizeInMemory[1];
+    } else {
+        if (!pixelRef->getYUV8Planes(yuvInfo.fSize, NULL, NULL, NULL)) {
+            return false;
+        }
+        size_t totalSize = 0;
+        for (int i = 0; i < 3; ++i) {
+            yuvInfo.fRowBytes[i] = yuvInfo.fSize[i].fWidth;
+            yuvInfo.fSizeInMemory[i] = yuvInfo.fRowBytes[i] * yuvInfo.fSize[i].fHeight;
+            totalSize += yuvInfo.fSizeInMemory[i];
+        }
+        cachedData.reset(SkResourceCache::NewCachedData(totalSize));
+        planes[0] = cachedData->writable_data();
+        planes[1] = (uint8_t*)planes[0] + yuvInfo.fSizeInMemory[0];
+        planes[2] = (uint8_t*)planes[1] + yuvInfo.fSizeInMemory[1];
+        if (!pixelRef->getYUV8Planes(yuvInfo.fSize, planes, yuvInfo.fRowBytes,
+                                     &yuvInfo.fColorSpace)) {
+            return false;
+        }
+        SkYUVPlanesCache::Add(pixelRef->getGenerationID(), cachedData, &yuvInfo);
+    }
+
+    if (yuvInfo.fSize[0].width() != bitmap.width() ||
+        yuvInfo.fSize[0].height() != bitmap.height()) {
+        return false;
+    }
+    return SkBitmapScaler::ResizeYUV(result, yuvInfo.fSize, planes, yuvInfo.fRowBytes,
+                                     yuvInfo.fColorSpace, SkBitmapScaler::RESIZE_BEST,
+                                     width, height, SkResourceCache::GetAllocator());
+}
+
 /*
  *  High quality is implemented by performing up-right scale-only filtering and then
  *  using bilerp for any remaining transformations.
@@ -149,7 +201,8 @@ void SkBitmapProcState::processHQRequest() {
     SkScalar roundedDestHeight = SkScalarRoundToScalar(trueDestHeight);
 
     if (!SkBitmapCache::Find(fOrigBitmap, roundedDestWidth, roundedDestHeight, &fScaledBitmap)) {
-        if (!SkBitmapScaler::Resize(&fScaledBitmap,
+        if (!resize_yuv(&fScaledBitmap, fOrigBitmap, roundedDestWidth, roundedDestHeight) &&
+            !SkBitmapScaler::Resize(&fScaledBitmap,
                                     fOrigBitmap,
                                     SkBitmapScaler::RESIZE_BEST,
                                     roundedDestWidth,
@@ -4,6 +4,12 @@
 #include "SkTArray.h"
 #include "SkErrorInternals.h"
 #include "SkConvolver.h"
+#include "SkColorPriv.h"
+#include "SkTemplates.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#endif
 
 // SkResizeFilter ----------------------------------------------------------------
 
@@ -311,6 +317,262 @@ bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
   return true;
 }
 
+// YUV ---------------------------------------------------------------------------
+
+namespace {
+
+// The YUV to RGB conversion is done in 16 bit fixed point: the coefficients are
+// scaled by 1 << 13 and the (offset) channels by 1 << 6, so keeping the high 16
+// bits of each product leaves 3 fractional bits. The coefficients are those of
+// GrYUVtoRGBEffect.
+struct YUVCoefficients {
+    int16_t fYOffset;
+    int16_t fY, fRV, fGU, fGV, fBU;
+};
+
+const YUVCoefficients gJPEGCoefficients   = {  0, 8192, 11485, 2819, 5850, 14516 };
+const YUVCoefficients gRec601Coefficients = { 16, 9535, 13074, 3203, 6660, 16531 };
+
+inline int mul_hi16(int a, int b) {
+    return (a * b) >> 16;
+}
+
+void yuv_to_n32_row(SkPMColor dst[], const uint8_t y[], const uint8_t u[], const uint8_t v[],
+                    int count, const YUVCoefficients& k) {
+    int i = 0;
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2 && SK_A32_SHIFT == 24 && SK_G32_SHIFT == 8
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha = _mm_set1_epi8((char)0xFF);
+    const __m128i yOffset = _mm_set1_epi16(k.fYOffset);
+    const __m128i uvOffset = _mm_set1_epi16(128);
+    const __m128i round = _mm_set1_epi16(4);
+    const __m128i cY = _mm_set1_epi16(k.fY);
+    const __m128i cRV = _mm_set1_epi16(k.fRV);
+    const __m128i cGU = _mm_set1_epi16(k.fGU);
+    const __m128i cGV = _mm_set1_epi16(k.fGV);
+    const __m128i cBU = _mm_set1_epi16(k.fBU);
+    for (; i + 8 <= count; i += 8) {
+        __m128i yy = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(y + i)), zero);
+        __m128i uu = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(u + i)), zero);
+        __m128i vv = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(v + i)), zero);
+        yy = _mm_slli_epi16(_mm_sub_epi16(yy, yOffset), 6);
+        uu = _mm_slli_epi16(_mm_sub_epi16(uu, uvOffset), 6);
+        vv = _mm_slli_epi16(_mm_sub_epi16(vv, uvOffset), 6);
+
+        yy = _mm_add_epi16(_mm_mulhi_epi16(yy, cY), round);
+        __m128i r = _mm_add_epi16(yy, _mm_mulhi_epi16(vv, cRV));
+        __m128i g = _mm_sub_epi16(_mm_sub_epi16(yy, _mm_mulhi_epi16(uu, cGU)),
+                                  _mm_mulhi_epi16(vv, cGV));
+        __m128i b = _mm_add_epi16(yy, _mm_mulhi_epi16(uu, cBU));
+
+        // packus clamps to [0, 255].
+        r = _mm_packus_epi16(_mm_srai_epi16(r, 3), zero);
+        g = _mm_packus_epi16(_mm_srai_epi16(g, 3), zero);
+        b = _mm_packus_epi16(_mm_srai_epi16(b, 3), zero);
+    #if SK_B32_SHIFT == 0
+        const __m128i lo = _mm_unpacklo_epi8(b, g), hi = _mm_unpacklo_epi8(r, alpha);
+    #else
+        const __m128i lo = _mm_unpacklo_epi8(r, g), hi = _mm_unpacklo_epi8(b, alpha);
+    #endif
+        _mm_storeu_si128((__m128i*)(dst + i),     _mm_unpacklo_epi16(lo, hi));
+        _mm_storeu_si128((__m128i*)(dst + i + 4), _mm_unpackhi_epi16(lo, hi));
+    }
+#endif
+    // Same arithmetic as above, so both give the same pixels.
+    for (; i < count; ++i) {
+        const int yy = mul_hi16((y[i] - k.fYOffset) * 64, k.fY) + 4;
+        const int uu = (u[i] - 128) * 64;
+        const int vv = (v[i] - 128) * 64;
+        const int r = (yy + mul_hi16(vv, k.fRV)) >> 3;
+        const int g = (yy - mul_hi16(uu, k.fGU) - mul_hi16(vv, k.fGV)) >> 3;
+        const int b = (yy + mul_hi16(uu, k.fBU)) >> 3;
+        dst[i] = SkPackARGB32NoCheck(0xFF, SkClampMax(r, 255), SkClampMax(g, 255),
+                                     SkClampMax(b, 255));
+    }
+}
+
+typedef SkConvolutionFilter1D::ConvolutionFixed ConvolutionFixed;
+
+const int kConvolutionRound = 1 << (SkConvolutionFilter1D::kShiftBits - 1);
+
+inline uint8_t convolution_to_byte(int accum) {
+    return SkClampMax(accum >> SkConvolutionFilter1D::kShiftBits, 255);
+}
+
+// Filters |length| rows of |count| luma values, starting at |src|, into |dst|.
+void convolve_luma_vertically(uint8_t dst[], const uint8_t* src, size_t rowBytes,
+                              const ConvolutionFixed values[], int length, int count) {
+    int x = 0;
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(kConvolutionRound);
+    for (; x + 8 <= count; x += 8) {
+        __m128i lo = round, hi = round;
+        int i = 0;
+        // Two rows at a time: madd multiplies the interleaved rows by the pair of weights.
+        for (; i + 2 <= length; i += 2) {
+            const uint8_t* row = src + i * rowBytes + x;
+            const __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)row), zero);
+            const __m128i b = _mm_unpacklo_epi8(
+                    _mm_loadl_epi64((const __m128i*)(row + rowBytes)), zero);
+            const __m128i weights = _mm_set1_epi32((uint16_t)values[i] |
+                                                   ((uint32_t)(uint16_t)values[i + 1] << 16));
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), weights));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), weights));
+        }
+        if (i < length) {
+            const __m128i a = _mm_unpacklo_epi8(
+                    _mm_loadl_epi64((const __m128i*)(src + i * rowBytes + x)), zero);
+            const __m128i weights = _mm_set1_epi32((uint16_t)values[i]);
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, zero), weights));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, zero), weights));
+        }
+        // The packs clamp to [0, 255].
+        const __m128i luma = _mm_packs_epi32(_mm_srai_epi32(lo, SkConvolutionFilter1D::kShiftBits),
+                                             _mm_srai_epi32(hi, SkConvolutionFilter1D::kShiftBits));
+        _mm_storel_epi64((__m128i*)(dst + x), _mm_packus_epi16(luma, luma));
+    }
+#endif
+    for (; x < count; ++x) {
+        int accum = kConvolutionRound;
+        for (int i = 0; i < length; ++i) {
+            accum += src[i * rowBytes + x] * values[i];
+        }
+        dst[x] = convolution_to_byte(accum);
+    }
+}
+
+// Filters a row of luma values into |count| values of |dst|.
+void convolve_luma_horizontally(uint8_t dst[], const uint8_t src[],
+                                const SkConvolutionFilter1D& filter, int count) {
+    for (int x = 0; x < count; ++x) {
+        int offset, length;
+        const ConvolutionFixed* values = filter.FilterForValue(x, &offset, &length);
+        const uint8_t* pixels = src + offset;
+        int accum = kConvolutionRound;
+        int i = 0;
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        if (length >= 8) {
+            const __m128i zero = _mm_setzero_si128();
+            __m128i sum = zero;
+            for (; i + 8 <= length; i += 8) {
+                const __m128i a = _mm_unpacklo_epi8(
+                        _mm_loadl_epi64((const __m128i*)(pixels + i)), zero);
+                sum = _mm_add_epi32(sum, _mm_madd_epi16(
+                        a, _mm_loadu_si128((const __m128i*)(values + i))));
+            }
+            sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+            sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+            accum += _mm_cvtsi128_si32(sum);
+        }
+#endif
+        for (; i < length; ++i) {
+            accum += pixels[i] * values[i];
+        }
+        dst[x] = convolution_to_byte(accum);
+    }
+}
+
+// Maps destination pixel centers onto a (subsampled) plane: returns the first
+// of the two source pixels to interpolate and the weight, out of 256, of the second.
+void bilerp_coord(int dest, int destSize, int srcSize, int* index, int* weight) {
+    float c = (dest + 0.5f) * srcSize / destSize - 0.5f;
+    c = SkTMax(0.0f, SkTMin(c, (float)(srcSize - 1)));
+    *index = SkTMin((int)c, srcSize - 1);
+    *weight = SkScalarRoundToInt((c - *index) * 256);
+}
+
+}  // namespace
+
+// static
+bool SkBitmapScaler::ResizeYUV(SkBitmap* resultPtr,
+                               const SkISize sizes[3],
+                               const void* const planes[3],
+                               const size_t rowBytes[3],
+                               SkYUVColorSpace colorSpace,
+                               ResizeMethod method,
+                               float destWidth, float destHeight,
+                               SkBitmap::Allocator* allocator) {
+    const int srcWidth = sizes[0].width(),
+              srcHeight = sizes[0].height(),
+              chromaWidth = sizes[1].width(),
+              chromaHeight = sizes[1].height();
+    if (srcWidth < 1 || srcHeight < 1 || chromaWidth < 1 || chromaHeight < 1 ||
+        sizes[1] != sizes[2] || destWidth < 1 || destHeight < 1) {
+        return false;
+    }
+
+    // The luma filters are applied by the loops below, so they need no SIMD padding.
+    SkConvolutionProcs convolveProcs = { 0, NULL, NULL, NULL, NULL };
+    SkRect destSubset = { 0, 0, destWidth, destHeight };
+    SkResizeFilter filter(ResizeMethodToAlgorithmMethod(method), srcWidth, srcHeight,
+                          destWidth, destHeight, destSubset, convolveProcs);
+    const SkConvolutionFilter1D& xFilter = filter.xFilter();
+    const SkConvolutionFilter1D& yFilter = filter.yFilter();
+    const int width = xFilter.numValues(),
+              height = yFilter.numValues();
+
+    SkBitmap result;
+    result.setInfo(SkImageInfo::MakeN32(width, height, kOpaque_SkAlphaType));
+    result.allocPixels(allocator, NULL);
+    if (!result.readyToDraw()) {
+        return false;
+    }
+
+    SkAutoTMalloc<int> chromaX(2 * width);
+    for (int x = 0; x < width; ++x) {
+        bilerp_coord(x, width, chromaWidth, &chromaX[2 * x], &chromaX[2 * x + 1]);
+    }
+
+    SkAutoTMalloc<uint8_t> lumaRow(srcWidth);
+    SkAutoTMalloc<uint8_t> yuvRows(3 * width);
+    SkAutoTMalloc<uint16_t> chromaRows(2 * chromaWidth);
+    uint8_t* yRow = yuvRows.get();
+    uint8_t* uRow = yRow + width;
+    uint8_t* vRow = uRow + width;
+    uint16_t* uLerp = chromaRows.get();
+    uint16_t* vLerp = uLerp + chromaWidth;
+    const YUVCoefficients& coefficients =
+            kRec601_SkYUVColorSpace == colorSpace ? gRec601Coefficients : gJPEGCoefficients;
+
+    for (int y = 0; y < height; ++y) {
+        // Filter the luma vertically, straight from the plane, then horizontally.
+        int offset, length;
+        const ConvolutionFixed* values = yFilter.FilterForValue(y, &offset, &length);
+        convolve_luma_vertically(lumaRow.get(), (const uint8_t*)planes[0] + offset * rowBytes[0],
+                                 rowBytes[0], values, length, srcWidth);
+        convolve_luma_horizontally(yRow, lumaRow.get(), xFilter, width);
+
+        // Bilerp the chroma: vertically into 8.8 fixed point, then horizontally.
+        int cy, cyWeight;
+        bilerp_coord(y, height, chromaHeight, &cy, &cyWeight);
+        const int cy1 = SkTMin(cy + 1, chromaHeight - 1);
+        for (int p = 0; p < 2; ++p) {
+            const uint8_t* row0 = (const uint8_t*)planes[p + 1] + cy * rowBytes[p + 1];
+            const uint8_t* row1 = (const uint8_t*)planes[p + 1] + cy1 * rowBytes[p + 1];
+            uint16_t* lerp = p ? vLerp : uLerp;
+            for (int x = 0; x < chromaWidth; ++x) {
+                lerp[x] = (row0[x] << 8) + (row1[x] - row0[x]) * cyWeight;
+            }
+        }
+        for (int x = 0; x < width; ++x) {
+            const int x0 = chromaX[2 * x],
+                      x1 = SkTMin(x0 + 1, chromaWidth - 1),
+                      w1 = chromaX[2 * x + 1],
+                      w0 = 256 - w1;
+            uRow[x] = (uLerp[x0] * w0 + uLerp[x1] * w1 + (1 << 15)) >> 16;
+            vRow[x] = (vLerp[x0] * w0 + vLerp[x1] * w1 + (1 << 15)) >> 16;
+        }
+
+        yuv_to_n32_row(result.getAddr32(0, y), yRow, uRow, vRow, width, coefficients);
+    }
+
+    *resultPtr = result;
+    resultPtr->lockPixels();
+    SkASSERT(resultPtr->getPixels());
+    return true;
+}
+
 // static -- simpler interface to the resizer; returns a default bitmap if scaling
 // fails for any reason.  This is the interface that Chrome expects.
 SkBitmap SkBitmapScaler::Resize(const SkBitmap& source,
@@ -90,6 +90,20 @@ public:
                            float dest_width, float dest_height,
                            SkBitmap::Allocator* allocator = NULL);
 
+    /** Resamples an image given as Y, U and V planes (see SkPixelRef::getYUV8Planes)
+        into an opaque N32 bitmap. Luma is filtered with |method|, chroma
+        bilinearly, and each destination row is converted to RGB as soon as it
+        is resampled, so the image is never expanded to RGB at its full size.
+      */
+    static bool ResizeYUV(SkBitmap* result,
+                          const SkISize sizes[3],
+                          const void* const planes[3],
+                          const size_t rowBytes[3],
+                          SkYUVColorSpace colorSpace,
+                          ResizeMethod method,
+                          float dest_width, float dest_height,
+                          SkBitmap::Allocator* allocator = NULL);
+
      /** Platforms can also optionally overwrite the convolution functions
         if we have SIMD versions of them.
       */
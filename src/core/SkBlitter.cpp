@@ -890,11 +890,17 @@ SkBlitter* SkBlitter::Choose(const SkBitmap& device,
         p->setColor(0);
     }
 
+    /*
+     *  The shaders we wrap the paint's color or shader in live in the allocator, so that choosing
+     *  a blitter for the same paint over and over (e.g. playing back a picture) stays off the
+     *  heap. The allocator holds their first ref, and the blitter (destroyed before them) the
+     *  other.
+     */
     if (NULL == shader) {
         if (mode) {
             // xfermodes (and filters) require shaders for our current blitters
-            shader = SkNEW_ARGS(SkColorShader, (paint->getColor()));
-            paint.writable()->setShader(shader)->unref();
+            shader = allocator->createT<SkColorShader>(paint->getColor());
+            paint.writable()->setShader(shader);
             paint.writable()->setAlpha(0xFF);
         } else if (cf) {
             // if no shader && no xfermode, we just apply the colorfilter to
@@ -908,8 +914,8 @@ SkBlitter* SkBlitter::Choose(const SkBitmap& device,
 
     if (cf) {
         SkASSERT(shader);
-        shader = SkNEW_ARGS(SkFilterShader, (shader, cf));
-        paint.writable()->setShader(shader)->unref();
+        shader = allocator->createT<SkFilterShader>(shader, cf);
+        paint.writable()->setShader(shader);
         // blitters should ignore the presence/absence of a filter, since
         // if there is one, the shader will take care of it.
     }
@@ -76,6 +76,15 @@ public:
      */
     virtual int requestRowsPreserved() const { return 1; }
 
+    /**
+     * Special method for blitters that only pass on some rows, like the ones that draw one
+     * band of a mask. If this returns true, calls for rows outside of [*top, *bottom) would be
+     * dropped, so the scan converters may skip making them. They must still step their edges
+     * through the rows above, so that the rows they do blit come out just as they would have.
+     * Returns false, and leaves top and bottom alone, if the blitter takes every row.
+     */
+    virtual bool getRowLimits(int* top, int* bottom) const { return false; }
+
     /**
      * This function allocates memory for the blitter that the blitter then owns.
      * The memory can be used by the calling function at will, but it will be
@@ -155,6 +164,10 @@ public:
         return fBlitter->requestRowsPreserved();
     }
 
+    bool getRowLimits(int* top, int* bottom) const override {
+        return fBlitter->getRowLimits(top, bottom);
+    }
+
     void* allocBlitMemory(size_t sz) override {
         return fBlitter->allocBlitMemory(sz);
     }
@@ -190,6 +203,10 @@ public:
         return fBlitter->requestRowsPreserved();
     }
 
+    bool getRowLimits(int* top, int* bottom) const override {
+        return fBlitter->getRowLimits(top, bottom);
+    }
+
     void* allocBlitMemory(size_t sz) override {
         return fBlitter->allocBlitMemory(sz);
     }
@@ -25,6 +25,9 @@ extern void blitmask_d565_opaque_mips(int width, int height, uint16_t* device,
 #if SK_ARM_NEON_IS_ALWAYS && defined(SK_CPU_LENDIAN)
     #include <arm_neon.h>
 #else
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        #include <emmintrin.h>
+    #endif
     // if we don't have neon, then our black blitter is worth the extra code
     #define USE_BLACK_BLITTER
 #endif
@@ -382,6 +385,37 @@ static U16CPU blend_compact(uint32_t src32, uint32_t dst32, unsigned scale5) {
 }
 #endif
 
+#if !(SK_ARM_NEON_IS_ALWAYS && defined(SK_CPU_LENDIAN)) && \
+        SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+// Blends 8 565 pixels towards the color whose channels are splatted in src_r, src_g and src_b,
+// by scale5 (0..32) per pixel.  This is dst + ((src - dst) * scale5 >> 5) in each channel, which
+// is exactly what blend_compact() computes on the expanded pixel.
+static inline __m128i blend_565_8_SSE2(__m128i dst, __m128i src_r, __m128i src_g,
+                                       __m128i src_b, __m128i scale5) {
+    __m128i r = _mm_srli_epi16(dst, SK_R16_SHIFT);
+    __m128i g = _mm_and_si128(_mm_srli_epi16(dst, SK_G16_SHIFT), _mm_set1_epi16(SK_G16_MASK));
+    __m128i b = _mm_and_si128(dst, _mm_set1_epi16(SK_B16_MASK));
+
+    r = _mm_add_epi16(r, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(src_r, r), scale5), 5));
+    g = _mm_add_epi16(g, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(src_g, g), scale5), 5));
+    b = _mm_add_epi16(b, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(src_b, b), scale5), 5));
+
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, SK_R16_SHIFT),
+                                     _mm_slli_epi16(g, SK_G16_SHIFT)), b);
+}
+
+// Loads 8 mask values widened to 16 bits, or returns false if they are all zero.
+static inline bool load_alpha_8_SSE2(const uint8_t* alpha, __m128i* alpha8) {
+    __m128i a = _mm_loadl_epi64((const __m128i*)alpha);
+    if (0xFFFF == _mm_movemask_epi8(_mm_cmpeq_epi8(a, _mm_setzero_si128()))) {
+        return false;
+    }
+    *alpha8 = _mm_unpacklo_epi8(a, _mm_setzero_si128());
+    return true;
+}
+#define SK_BLITTER_RGB16_SSE2
+#endif
+
 void SkRGB16_Opaque_Blitter::blitMask(const SkMask& mask,
                                       const SkIRect& clip) {
     if (mask.fFormat == SkMask::kBW_Format) {
@@ -469,6 +503,37 @@ void SkRGB16_Opaque_Blitter::blitMask(const SkMask& mask,
 #undef    UNROLL
 #elif SK_MIPS_HAS_DSP
     blitmask_d565_opaque_mips(width, height, device, deviceRB, alpha, expanded32, maskRB);
+#elif defined(SK_BLITTER_RGB16_SSE2)
+    const __m128i src_r = _mm_set1_epi16(SkGetPackedR16(fRawColor16));
+    const __m128i src_g = _mm_set1_epi16(SkGetPackedG16(fRawColor16));
+    const __m128i src_b = _mm_set1_epi16(SkGetPackedB16(fRawColor16));
+    const __m128i one = _mm_set1_epi16(1);
+    do {
+        int w = width;
+        while (w >= 8) {
+            __m128i alpha8;
+            if (load_alpha_8_SSE2(alpha, &alpha8)) {
+                // SkAlpha255To256(alpha) >> 3
+                __m128i scale5 = _mm_srli_epi16(_mm_add_epi16(alpha8, one), 3);
+                __m128i dst = _mm_loadu_si128((const __m128i*)device);
+                _mm_storeu_si128((__m128i*)device,
+                                 blend_565_8_SSE2(dst, src_r, src_g, src_b, scale5));
+            }
+            device += 8;
+            alpha += 8;
+            w -= 8;
+        }
+
+        // residuals
+        while (w > 0) {
+            *device = blend_compact(expanded32, SkExpand_rgb_16(*device),
+                                    SkAlpha255To256(*alpha++) >> 3);
+            device += 1;
+            --w;
+        }
+        device = (uint16_t*)((char*)device + deviceRB);
+        alpha += maskRB;
+    } while (--height != 0);
 #else   // non-neon code
     do {
         int w = width;
@@ -644,6 +709,42 @@ void SkRGB16_Blitter::blitMask(const SkMask& mask,
     uint32_t    color32 = fExpandedRaw16;
 
     unsigned scale256 = fScale;
+#ifdef SK_BLITTER_RGB16_SSE2
+    const __m128i src_r = _mm_set1_epi16(SkGetPackedR16(fRawColor16));
+    const __m128i src_g = _mm_set1_epi16(SkGetPackedG16(fRawColor16));
+    const __m128i src_b = _mm_set1_epi16(SkGetPackedB16(fRawColor16));
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i vscale256 = _mm_set1_epi16(scale256);
+    do {
+        int w = width;
+        while (w >= 8) {
+            __m128i alpha8;
+            if (load_alpha_8_SSE2(alpha, &alpha8)) {
+                // SkAlpha255To256(aa) * scale256 >> (8 + 3), as the high half of a product
+                // that would overflow 16 bits.
+                __m128i aa = _mm_slli_epi16(_mm_add_epi16(alpha8, one), 5);
+                __m128i scale5 = _mm_mulhi_epu16(aa, vscale256);
+                __m128i dst = _mm_loadu_si128((const __m128i*)device);
+                _mm_storeu_si128((__m128i*)device,
+                                 blend_565_8_SSE2(dst, src_r, src_g, src_b, scale5));
+            }
+            device += 8;
+            alpha += 8;
+            w -= 8;
+        }
+
+        while (w > 0) {
+            unsigned aa = *alpha++;
+            unsigned scale = SkAlpha255To256(aa) * scale256 >> (8 + 3);
+            uint32_t src32 = color32 * scale;
+            uint32_t dst32 = SkExpand_rgb_16(*device) * (32 - scale);
+            *device++ = SkCompact_rgb_16((src32 + dst32) >> 5);
+            --w;
+        }
+        device = (uint16_t*)((char*)device + deviceRB);
+        alpha += maskRB;
+    } while (--height != 0);
+#else
     do {
         int w = width;
         do {
@@ -656,6 +757,7 @@ void SkRGB16_Blitter::blitMask(const SkMask& mask,
         device = (uint16_t*)((char*)device + deviceRB);
         alpha += maskRB;
     } while (--height != 0);
+#endif
 }
 
 void SkRGB16_Blitter::blitV(int x, int y, int height, SkAlpha alpha) {
@@ -407,6 +407,25 @@ bool AutoDrawLooper::doNext(SkDrawFilter::Type drawType) {
     return true;
 }
 
+void SkCanvas::predrawNotify(const SkRect* localBounds) {
+    if (fSurfaceBase) {
+        SkIRect dirty = fMCRec->fRasterClip.getBounds();
+        if (localBounds && localBounds->isFinite() && !fMCRec->fMatrix.hasPerspective()) {
+            SkRect devBounds;
+            fMCRec->fMatrix.mapRect(&devBounds, *localBounds);
+            // antialiasing may touch one more pixel than the fast bounds promise
+            devBounds.outset(SK_Scalar1, SK_Scalar1);
+            // clamp before rounding, the bounds of a huge stroke may not fit in an int
+            if (devBounds.intersect(SkRect::Make(dirty))) {
+                devBounds.roundOut(&dirty);
+            } else {
+                dirty.setEmpty();
+            }
+        }
+        fSurfaceBase->aboutToDraw(SkSurface::kRetain_ContentChangeMode, &dirty);
+    }
+}
+
 ////////// macros to place around the internal draw calls //////////////////
 
 #define LOOPER_BEGIN_DRAWDEVICE(paint, type)                        \
@@ -416,7 +435,7 @@ bool AutoDrawLooper::doNext(SkDrawFilter::Type drawType) {
         SkDrawIter          iter(this);
 
 #define LOOPER_BEGIN(paint, type, bounds)                           \
-    this->predrawNotify();                                          \
+    this->predrawNotify(bounds);                                    \
     AutoDrawLooper  looper(this, fProps, paint, false, bounds);     \
     while (looper.next(type)) {                                     \
         SkDrawIter          iter(this);
@@ -718,8 +737,11 @@ bool SkCanvas::writePixels(const SkImageInfo& origInfo, const void* pixels, size
     // here x,y are either 0 or negative
     pixels = ((const char*)pixels - y * rowBytes - x * info.bytesPerPixel());
 
-    // Tell our owning surface to bump its generation ID
-    this->predrawNotify();
+    // Tell our owning surface to bump its generation ID (writePixels ignores the clip, so we
+    // pass the written area ourselves)
+    if (fSurfaceBase) {
+        fSurfaceBase->aboutToDraw(SkSurface::kRetain_ContentChangeMode, &target);
+    }
 
     // The device can assert that the requested area is always contained in its bounds
     return device->writePixels(info, pixels, rowBytes, target.x(), target.y());
@@ -1040,6 +1062,9 @@ const void* SkCanvas::onPeekPixels(SkImageInfo* info, size_t* rowBytes) {
 }
 
 void* SkCanvas::accessTopLayerPixels(SkImageInfo* info, size_t* rowBytes, SkIPoint* origin) {
+    // The caller may write anywhere through the returned pointer, so let our surface fork its
+    // pixels first if they're shared with a snapshot.
+    this->predrawNotify();
     void* pixels = this->onAccessTopLayerPixels(info, rowBytes);
     if (pixels && origin) {
         *origin = this->getTopDevice(false)->getOrigin();
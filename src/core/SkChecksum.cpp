@@ -0,0 +1,79 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkChecksum.h"
+#include "SkLazyFnPtr.h"
+
+static inline uint32_t rotl(uint32_t x, int r) {
+    return (x << r) | (x >> (32 - r));
+}
+
+// One Murmur3 block step, identical to the loop body of SkChecksum::Murmur3.
+static inline uint32_t murmur3_round(uint32_t hash, uint32_t k) {
+    k *= 0xcc9e2d51;
+    k = rotl(k, 15);
+    k *= 0x1b873593;
+
+    hash ^= k;
+    hash = rotl(hash, 13);
+    return hash * 5 + 0xe6546b64;
+}
+
+static inline uint32_t load32(const uint8_t* ptr) {
+    uint32_t k;
+    memcpy(&k, ptr, sizeof(k));
+    return k;
+}
+
+uint32_t SkChecksum::HashPortable(const void* data, size_t bytes, uint32_t seed) {
+    // Short keys are latency-bound on the setup and the finalizer; plain Murmur3 is as good
+    // as it gets for them.
+    if (bytes < 64) {
+        return Murmur3(data, bytes, seed);
+    }
+
+    // Each Murmur3 step depends on the previous one, so a single lane runs at the latency of
+    // its multiply/rotate chain. Four lanes fed from interleaved words are independent and
+    // keep the ALUs busy.
+    const uint8_t* ptr = (const uint8_t*)data;
+    const size_t blocks = bytes / 16;
+    uint32_t h0 = seed,
+             h1 = seed ^ 0x9e3779b9,
+             h2 = seed ^ 0x7f4a7c15,
+             h3 = seed ^ 0xf39cc060;
+    for (size_t i = 0; i < blocks; ++i) {
+        h0 = murmur3_round(h0, load32(ptr +  0));
+        h1 = murmur3_round(h1, load32(ptr +  4));
+        h2 = murmur3_round(h2, load32(ptr +  8));
+        h3 = murmur3_round(h3, load32(ptr + 12));
+        ptr += 16;
+    }
+
+    uint32_t hash = murmur3_round(h0, h1);
+    hash = murmur3_round(hash, h2);
+    hash = murmur3_round(hash, h3);
+    hash = murmur3_round(hash, SkToU32(bytes));
+
+    // The last 0-15 bytes go through regular Murmur3, seeded with the lanes.
+    return Murmur3(ptr, bytes & 15, hash);
+}
+
+namespace {
+// This method technically needs external linkage to be passed as a template parameter.
+// Since it can't be static, we hide it in an anonymous namespace instead.
+
+SkChecksumHashProc choose_hash() {
+    SkChecksumHashProc proc = SkChecksumHashGetPlatformProc();
+    return proc ? proc : SkChecksum::HashPortable;
+}
+
+}  // namespace
+
+uint32_t SkChecksum::Hash(const void* data, size_t bytes, uint32_t seed) {
+    SK_DECLARE_STATIC_LAZY_FN_PTR(SkChecksumHashProc, proc, choose_hash);
+    return proc.get()(data, bytes, seed);
+}
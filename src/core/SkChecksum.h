@@ -115,6 +115,25 @@ public:
         return Mix(hash);
     }
 
+    /**
+     *  Fast, well-mixed hash of an in-memory key, like a cache key.
+     *
+     *  On CPUs with SSE4.2 this uses the hardware CRC32C instruction; otherwise it is Murmur3,
+     *  split across four independent lanes for keys of 64 bytes or more. The result therefore
+     *  depends on the CPU: a value is only good in the process that computed it. Never persist
+     *  it, send it to another process, or compare it with one computed elsewhere; use
+     *  Murmur3() or Compute() for those.
+     *
+     *  @param data  Memory address of the data block to be processed. No alignment required.
+     *  @param bytes Size of the data block in bytes.
+     *  @param seed  Initial hash seed. (optional)
+     *  @return hash result
+     */
+    static uint32_t Hash(const void* data, size_t bytes, uint32_t seed=0);
+
+    /** The portable fallback used by Hash(), exposed for tests and benches. */
+    static uint32_t HashPortable(const void* data, size_t bytes, uint32_t seed=0);
+
     /**
      *  Compute a 32-bit checksum for a given data block
      *
@@ -180,6 +199,10 @@ public:
     }
 };
 
+// Hardware-accelerated implementation of SkChecksum::Hash, or NULL if none is available.
+typedef uint32_t (*SkChecksumHashProc)(const void* data, size_t bytes, uint32_t seed);
+SkChecksumHashProc SkChecksumHashGetPlatformProc();
+
 // SkGoodHash should usually be your first choice in hashing data.
 // It should be both reasonably fast and high quality.
 
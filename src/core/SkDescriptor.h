@@ -123,6 +123,8 @@ private:
     static uint32_t ComputeChecksum(const SkDescriptor* desc) {
         const uint32_t* ptr = (const uint32_t*)desc + 1; // skip the checksum field
         size_t len = desc->fLength - sizeof(uint32_t);
+        // Descriptors are sent to other processes (SkGPipe), so the checksum has to come out
+        // the same on every CPU, which SkChecksum::Hash() does not.
         return SkChecksum::Murmur3(ptr, len);
     }
 
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAtomics.h"
+#include "SkDevicePathCache.h"
+#include "SkMatrix.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkResourceCache.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+namespace {
+static unsigned gDevicePathKeyNamespaceLabel;
+
+struct DevicePathKey : public SkResourceCache::Key {
+    DevicePathKey(const SkPath& path, const SkMatrix& matrix, const SkPaint& paint,
+                  SkScalar resScale)
+        : fGenID(path.getGenerationID())
+    {
+        matrix.get9(fMatrix);
+        if (SkPaint::kFill_Style == paint.getStyle()) {
+            // Fills ignore the stroke parameters.
+            fWidth = fMiter = fResScale = 0;
+            fStyle = SkPaint::kFill_Style;
+        } else {
+            fWidth = paint.getStrokeWidth();
+            fMiter = paint.getStrokeMiter();
+            fResScale = resScale;
+            fStyle = (paint.getStyle() << 16) | (paint.getStrokeCap() << 8) |
+                     paint.getStrokeJoin();
+        }
+        this->init(&gDevicePathKeyNamespaceLabel, 0,
+                   sizeof(fGenID) + sizeof(fMatrix) + sizeof(fWidth) + sizeof(fMiter) +
+                   sizeof(fResScale) + sizeof(fStyle));
+    }
+
+    uint32_t fGenID;
+    SkScalar fMatrix[9];
+    SkScalar fWidth;
+    SkScalar fMiter;
+    SkScalar fResScale;
+    uint32_t fStyle;    // style, cap and join
+};
+
+struct DevicePathRec : public SkResourceCache::Rec {
+    DevicePathRec(const DevicePathKey& key, const SkPath& path)
+        : fKey(key)
+        , fPath(path)
+    {}
+
+    DevicePathKey fKey;
+    SkPath        fPath;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fPath.countPoints() * sizeof(SkPoint) + fPath.countVerbs();
+    }
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* contextPath) {
+        const DevicePathRec& rec = static_cast<const DevicePathRec&>(baseRec);
+        *static_cast<SkPath*>(contextPath) = rec.fPath;
+        return true;
+    }
+};
+} // namespace
+
+// The generation IDs seen lately, each in the slot picked by its low bits. IDs are handed out
+// in sequence, so paths made near each other do not collide. Threads race on the slots, which
+// at worst costs a path one more draw before it is cached.
+static uint32_t gSeenGenIDs[1024];
+
+bool SkDevicePathCache::SeenBefore(const SkPath& path) {
+    const uint32_t genID = path.getGenerationID();
+    uint32_t* slot = &gSeenGenIDs[genID & (SK_ARRAY_COUNT(gSeenGenIDs) - 1)];
+    if (sk_atomic_load(slot, sk_memory_order_relaxed) == genID) {
+        return true;
+    }
+    sk_atomic_store(slot, genID, sk_memory_order_relaxed);
+    return false;
+}
+
+bool SkDevicePathCache::Find(const SkPath& src, const SkMatrix& matrix, const SkPaint& paint,
+                             SkScalar resScale, SkPath* dst, SkResourceCache* localCache) {
+    if (src.isVolatile() || paint.getPathEffect() || paint.getRasterizer()) {
+        return false;
+    }
+    const bool fill = SkPaint::kFill_Style == paint.getStyle();
+    if (fill) {
+        // Polygons are transformed and set up as edges faster than they are looked up.
+        if (SkPath::kLine_SegmentMask == src.getSegmentMasks()) {
+            return false;
+        }
+    } else if (0 == paint.getStrokeWidth()) {
+        return false;
+    }
+    if (!SeenBefore(src)) {
+        return false;
+    }
+
+    DevicePathKey key(src, matrix, paint, resScale);
+    SkPath devPath;
+    if (!CHECK_LOCAL(localCache, find, Find, key, DevicePathRec::Finder, &devPath)) {
+        if (fill) {
+            src.transform(matrix, &devPath);
+        } else {
+            SkPath strokedPath;
+            if (!paint.getFillPath(src, &strokedPath, NULL, resScale)) {
+                return false;
+            }
+            strokedPath.transform(matrix, &devPath);
+        }
+        CHECK_LOCAL(localCache, add, Add, SkNEW_ARGS(DevicePathRec, (key, devPath)));
+    }
+
+    if (fill) {
+        // The generation ID does not cover the fill type.
+        devPath.setFillType(src.getFillType());
+    }
+    dst->swap(devPath);
+    return true;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkDevicePathCache_DEFINED
+#define SkDevicePathCache_DEFINED
+
+#include "SkScalar.h"
+
+class SkMatrix;
+class SkPaint;
+class SkPath;
+class SkResourceCache;
+
+/**
+ *  The raster counterpart of the path caching GPU path renderers do for non-volatile paths.
+ *
+ *  Holds the device space outline that SkDraw fills for a path: the path stroked as the paint
+ *  says, and transformed by the matrix.  Entries live in SkResourceCache, keyed by the path's
+ *  generation ID, the matrix and the stroke parameters.  A path drawn again and again the same
+ *  way is then neither stroked nor transformed again, and since the outline keeps its
+ *  generation ID from draw to draw, the edge builder reuses the edges it built for it too.
+ */
+class SkDevicePathCache {
+public:
+    /**
+     *  If src can be cached, sets dst to its device outline, to be filled, and returns true.
+     *  Otherwise returns false and leaves dst unchanged.  Volatile paths, hairlines and paints
+     *  with a path effect or rasterizer are not cached, and neither is a path the first time
+     *  it is seen, see SeenBefore().
+     *
+     *  @param resScale The resolution scale to stroke with, see SkPaint::getFillPath().
+     */
+    static bool Find(const SkPath& src, const SkMatrix& matrix, const SkPaint& paint,
+                     SkScalar resScale, SkPath* dst, SkResourceCache* localCache = NULL);
+
+    /**
+     *  Returns true if a path with this path's generation ID was passed here lately.  Otherwise
+     *  remembers the ID and returns false.  Paths drawn once, as many are, thus never cost an
+     *  entry in SkResourceCache, nor push out the entries of paths and bitmaps drawn again.
+     */
+    static bool SeenBefore(const SkPath& path);
+};
+
+#endif
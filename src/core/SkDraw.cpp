@@ -12,6 +12,7 @@
 #include "SkColorPriv.h"
 #include "SkDevice.h"
 #include "SkDeviceLooper.h"
+#include "SkDevicePathCache.h"
 #include "SkFixed.h"
 #include "SkMaskFilter.h"
 #include "SkPaint.h"
@@ -25,6 +26,7 @@
 #include "SkString.h"
 #include "SkStroke.h"
 #include "SkTextMapStateProc.h"
+#include "SkTHash.h"
 #include "SkTLazy.h"
 #include "SkUtils.h"
 #include "SkVertState.h"
@@ -792,8 +794,42 @@ static SkPoint* rect_points(SkRect& r) {
     return SkTCast<SkPoint*>(&r);
 }
 
+static void draw_rect_as_type(const SkRect& devRect, const SkPaint& paint, SkDraw::RectType rtype,
+                              const SkPoint& strokeSize, const SkRasterClip& clip,
+                              SkBlitter* blitter) {
+    // we want to "fill" if we are kFill or kStrokeAndFill, since in the latter
+    // case we are also hairline (if we've gotten to here), which devolves to
+    // effectively just kFill
+    switch (rtype) {
+        case SkDraw::kFill_RectType:
+            if (paint.isAntiAlias()) {
+                SkScan::AntiFillRect(devRect, clip, blitter);
+            } else {
+                SkScan::FillRect(devRect, clip, blitter);
+            }
+            break;
+        case SkDraw::kStroke_RectType:
+            if (paint.isAntiAlias()) {
+                SkScan::AntiFrameRect(devRect, strokeSize, clip, blitter);
+            } else {
+                SkScan::FrameRect(devRect, strokeSize, clip, blitter);
+            }
+            break;
+        case SkDraw::kHair_RectType:
+            if (paint.isAntiAlias()) {
+                SkScan::AntiHairRect(devRect, clip, blitter);
+            } else {
+                SkScan::HairRect(devRect, clip, blitter);
+            }
+            break;
+        default:
+            SkDEBUGFAIL("bad rtype");
+    }
+}
+
 void SkDraw::drawRect(const SkRect& prePaintRect, const SkPaint& paint,
-                      const SkMatrix* paintMatrix, const SkRect* postPaintRect) const {
+                      const SkMatrix* paintMatrix, const SkRect* postPaintRect,
+                      SkBlitter* customBlitter) const {
     SkDEBUGCODE(this->validate();)
 
     // nothing to draw
@@ -823,7 +859,7 @@ void SkDraw::drawRect(const SkRect& prePaintRect, const SkPaint& paint,
         SkPath  tmp;
         tmp.addRect(prePaintRect);
         tmp.setFillType(SkPath::kWinding_FillType);
-        draw.drawPath(tmp, paint, NULL, true);
+        draw.drawPath(tmp, paint, NULL, true, false, customBlitter);
         return;
     }
 
@@ -853,6 +889,12 @@ void SkDraw::drawRect(const SkRect& prePaintRect, const SkPaint& paint,
         return;
     }
 
+    // The custom blitter writes in the coordinates of fBitmap, so it can't be tiled.
+    if (customBlitter) {
+        draw_rect_as_type(devRect, paint, rtype, strokeSize, *fRC, customBlitter);
+        return;
+    }
+
     SkDeviceLooper looper(*fBitmap, *fRC, ir, paint.isAntiAlias());
     while (looper.next()) {
         SkRect localDevRect;
@@ -861,37 +903,8 @@ void SkDraw::drawRect(const SkRect& prePaintRect, const SkPaint& paint,
         looper.mapMatrix(&localMatrix, *matrix);
 
         SkAutoBlitterChoose blitterStorage(looper.getBitmap(), localMatrix, paint);
-        const SkRasterClip& clip = looper.getRC();
-        SkBlitter*          blitter = blitterStorage.get();
-
-        // we want to "fill" if we are kFill or kStrokeAndFill, since in the latter
-        // case we are also hairline (if we've gotten to here), which devolves to
-        // effectively just kFill
-        switch (rtype) {
-            case kFill_RectType:
-                if (paint.isAntiAlias()) {
-                    SkScan::AntiFillRect(localDevRect, clip, blitter);
-                } else {
-                    SkScan::FillRect(localDevRect, clip, blitter);
-                }
-                break;
-            case kStroke_RectType:
-                if (paint.isAntiAlias()) {
-                    SkScan::AntiFrameRect(localDevRect, strokeSize, clip, blitter);
-                } else {
-                    SkScan::FrameRect(localDevRect, strokeSize, clip, blitter);
-                }
-                break;
-            case kHair_RectType:
-                if (paint.isAntiAlias()) {
-                    SkScan::AntiHairRect(localDevRect, clip, blitter);
-                } else {
-                    SkScan::HairRect(localDevRect, clip, blitter);
-                }
-                break;
-            default:
-                SkDEBUGFAIL("bad rtype");
-        }
+        draw_rect_as_type(localDevRect, paint, rtype, strokeSize, looper.getRC(),
+                          blitterStorage.get());
     }
 }
 
@@ -1015,6 +1028,160 @@ static SkScalar compute_res_scale_for_stroking(const SkMatrix& matrix) {
     return 1;
 }
 
+// Path effect stamps are rasterized once for each rotation and quarter pixel offset they are
+// drawn at, and the masks blitted at each position.  A stamp is only cached the second time its
+// rotation and offset come up; along curves they rarely do, and scan converting it directly is
+// cheaper than making a mask.
+static const int      kStampSubpixelBits = 2;
+static const int      kStampAngleSteps = 4096;
+static const SkScalar kMaxStampSize = 256;
+static const int      kMaxCachedStamps = 1024;
+
+static bool rasterize_stamp(const SkPath& devPath, bool doAA, SkMask* mask) {
+    devPath.getBounds().roundOut(&mask->fBounds);
+    mask->fBounds.outset(1, 1);
+    mask->fFormat = SkMask::kA8_Format;
+    mask->fRowBytes = mask->fBounds.width();
+    const size_t size = mask->computeImageSize();
+    if (0 == size) {
+        return false;
+    }
+    mask->fImage = SkMask::AllocImage(size);
+    memset(mask->fImage, 0, size);
+
+    SkBitmap bm;
+    bm.installPixels(SkImageInfo::MakeA8(mask->fBounds.width(), mask->fBounds.height()),
+                     mask->fImage, mask->fRowBytes);
+    SkRasterClip clip;
+    clip.setRect(SkIRect::MakeWH(mask->fBounds.width(), mask->fBounds.height()));
+    SkMatrix matrix;
+    matrix.setTranslate(-SkIntToScalar(mask->fBounds.fLeft), -SkIntToScalar(mask->fBounds.fTop));
+    SkPaint paint;
+    paint.setAntiAlias(doAA);
+
+    SkDraw draw;
+    draw.fBitmap = &bm;
+    draw.fRC = &clip;
+    draw.fClip = &clip.bwRgn();
+    draw.fMatrix = &matrix;
+    draw.drawPath(devPath, paint);
+    return true;
+}
+
+// Stamps are blitted one at a time, so where they overlap they are blended twice. With an opaque
+// paint drawn src-over, that only shows along antialiased edges.
+static bool stamps_can_overlap(const SkPaint& paint) {
+    return 0xFF == paint.getAlpha() &&
+           SkXfermode::IsMode(paint.getXfermode(), SkXfermode::kSrcOver_Mode) &&
+           (NULL == paint.getShader() || paint.getShader()->isOpaque()) &&
+           NULL == paint.getColorFilter();
+}
+
+static bool draw_stamps(const SkDraw& draw, const SkPathEffect::StampData& stamps,
+                        const SkPaint& paint) {
+    const bool rotate = !stamps.fTangents.isEmpty();
+    SkASSERT(!rotate || stamps.fTangents.count() == stamps.fPositions.count());
+
+    SkMatrix linear = *draw.fMatrix;
+    linear.setTranslateX(0);
+    linear.setTranslateY(0);
+
+    // Where a stamp may reach, relative to its device position.
+    SkRect reach = stamps.fStamp.getBounds();
+    if (rotate) {
+        const SkScalar r = SkTMax(SkTMax(SkPoint::Length(reach.fLeft, reach.fTop),
+                                         SkPoint::Length(reach.fRight, reach.fTop)),
+                                  SkTMax(SkPoint::Length(reach.fLeft, reach.fBottom),
+                                         SkPoint::Length(reach.fRight, reach.fBottom)));
+        reach.setLTRB(-r, -r, r, r);
+    }
+    linear.mapRect(&reach);
+    reach.outset(SK_Scalar1, SK_Scalar1);
+    if (!(reach.width() <= kMaxStampSize && reach.height() <= kMaxStampSize)) {
+        return false;   // too big to be worth caching, or not finite
+    }
+
+    SkAutoBlitterChoose blitterChooser(*draw.fBitmap, *draw.fMatrix, paint);
+    SkBlitter* blitter = blitterChooser.get();
+    SkAAClipBlitterWrapper wrapper;
+    const SkRegion* clipRgn;
+    SkBlitter* maskBlitter = blitter;
+    if (draw.fRC->isBW()) {
+        clipRgn = &draw.fRC->bwRgn();
+    } else {
+        wrapper.init(*draw.fRC, blitter);
+        clipRgn = &wrapper.getRgn();
+        maskBlitter = wrapper.getBlitter();
+    }
+    const SkRect clipBounds = SkRect::Make(draw.fRC->getBounds());
+
+    const int kSubpixels = 1 << kStampSubpixelBits;
+    const SkScalar kSubpixelScale = SkIntToScalar(kSubpixels);
+    SkTHashMap<uint32_t, SkMask> masks;
+    SkTHashSet<uint32_t> seen;
+    SkPath devStamp;
+    for (int i = 0; i < stamps.fPositions.count(); ++i) {
+        SkPoint pos;
+        draw.fMatrix->mapPoints(&pos, &stamps.fPositions[i], 1);
+        if (!SkRect::Intersects(reach.makeOffset(pos.fX, pos.fY), clipBounds)) {
+            continue;
+        }
+
+        const int x = SkScalarRoundToInt(pos.fX * kSubpixelScale);
+        const int y = SkScalarRoundToInt(pos.fY * kSubpixelScale);
+        int angle = 0;
+        if (rotate) {
+            const SkVector& t = stamps.fTangents[i];
+            angle = SkScalarRoundToInt(SkScalarATan2(t.fY, t.fX) *
+                                       (kStampAngleSteps / (2 * SK_ScalarPI)));
+            angle &= kStampAngleSteps - 1;
+        }
+        const uint32_t key = (angle << (2 * kStampSubpixelBits)) |
+                             ((y & (kSubpixels - 1)) << kStampSubpixelBits) |
+                             (x & (kSubpixels - 1));
+
+        SkMatrix m;
+        if (rotate) {
+            SkScalar cos;
+            const SkScalar sin = SkScalarSinCos(angle * (2 * SK_ScalarPI / kStampAngleSteps),
+                                                &cos);
+            m.setSinCos(sin, cos);
+            m.postConcat(linear);
+        } else {
+            m = linear;
+        }
+
+        SkMask* mask = masks.find(key);
+        if (NULL == mask) {
+            if (masks.count() >= kMaxCachedStamps || !seen.contains(key)) {
+                seen.add(key);
+                m.postTranslate(pos.fX, pos.fY);
+                stamps.fStamp.transform(m, &devStamp);
+                if (paint.isAntiAlias()) {
+                    SkScan::AntiFillPath(devStamp, *draw.fRC, blitter);
+                } else {
+                    SkScan::FillPath(devStamp, *draw.fRC, blitter);
+                }
+                continue;
+            }
+            m.postTranslate((x & (kSubpixels - 1)) / kSubpixelScale,
+                            (y & (kSubpixels - 1)) / kSubpixelScale);
+            stamps.fStamp.transform(m, &devStamp);
+            SkMask tmp;
+            if (!rasterize_stamp(devStamp, paint.isAntiAlias(), &tmp)) {
+                continue;
+            }
+            mask = masks.set(key, tmp);
+        }
+
+        SkMask placed = *mask;
+        placed.fBounds.offset(x >> kStampSubpixelBits, y >> kStampSubpixelBits);
+        maskBlitter->blitMaskRegion(placed, *clipRgn);
+    }
+    masks.foreach([](uint32_t, SkMask* mask) { SkMask::FreeImage(mask->fImage); });
+    return true;
+}
+
 void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
                       const SkMatrix* prePathMatrix, bool pathIsMutable,
                       bool drawCoverage, SkBlitter* customBlitter) const {
@@ -1077,7 +1244,40 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         }
     }
 
-    if (paint->getPathEffect() || paint->getStyle() != SkPaint::kFill_Style) {
+    // Path effects that stamp or tile one shape can skip building a path of every copy.
+    if (paint->getPathEffect() && NULL == customBlitter && !drawCoverage &&
+            !matrix->hasPerspective() && NULL == paint->getMaskFilter() &&
+            NULL == paint->getRasterizer()) {
+        if (NULL == paint->getShader()) {
+            SkAutoTUnref<SkShader> tile(paint->getPathEffect()->refTileShader(*paint, *matrix));
+            if (tile) {
+                SkPaint* writablePaint = paint.writable();
+                writablePaint->setPathEffect(NULL);
+                writablePaint->setShader(tile);
+                writablePaint->setStyle(SkPaint::kFill_Style);
+                if (writablePaint->getFilterQuality() < kLow_SkFilterQuality) {
+                    writablePaint->setFilterQuality(kLow_SkFilterQuality);
+                }
+            }
+        }
+        if (paint->getPathEffect() && stamps_can_overlap(*paint)) {
+            SkPathEffect::StampData stamps;
+            if (paint->getPathEffect()->asStamps(&stamps, *pathPtr, SkStrokeRec(*paint), NULL) &&
+                    draw_stamps(*this, stamps, *paint)) {
+                return;
+            }
+        }
+    }
+
+    // A path drawn again and again the same way reuses its outline, and through it its edges.
+    // Paths made for this draw (with prePathMatrix) would only fill the cache.
+    SkPath cachedDevPath;
+    const bool cached = pathPtr == &origSrcPath &&
+                        SkDevicePathCache::Find(origSrcPath, *matrix, *paint,
+                                                compute_res_scale_for_stroking(*fMatrix),
+                                                &cachedDevPath);
+
+    if (!cached && (paint->getPathEffect() || paint->getStyle() != SkPaint::kFill_Style)) {
         SkRect cullRect;
         const SkRect* cullRectPtr = NULL;
         if (this->computeConservativeLocalClipBounds(&cullRect)) {
@@ -1099,11 +1299,18 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         return;
     }
 
-    // avoid possibly allocating a new path in transform if we can
-    SkPath* devPathPtr = pathIsMutable ? pathPtr : &tmpPath;
+    SkPath* devPathPtr;
+    if (cached) {
+        devPathPtr = &cachedDevPath;
+    } else {
+        // avoid possibly allocating a new path in transform if we can
+        devPathPtr = pathIsMutable ? pathPtr : &tmpPath;
 
-    // transform the path into device space
-    pathPtr->transform(*matrix, devPathPtr);
+        // transform the path into device space
+        pathPtr->transform(*matrix, devPathPtr);
+        // nobody will see this path again, so its edges are not worth caching
+        devPathPtr->setIsVolatile(true);
+    }
 
     SkBlitter* blitter = NULL;
     SkAutoBlitterChoose blitterStorage;
@@ -1914,6 +2121,9 @@ public:
     private:
         SkMatrix    fDstToUnit;
         SkPMColor   fColors[3];
+        // The inverse CTM is the same for every triangle, so it is computed once.
+        SkMatrix    fCTMInverse;
+        bool        fCTMInvertible;
 
         typedef SkShader::Context INHERITED;
     };
@@ -1950,13 +2160,10 @@ bool SkTriColorShader::TriColorShaderContext::setup(const SkPoint pts[], const S
     if (!m.invert(&im)) {
         return false;
     }
-    // We can't call getTotalInverse(), because we explicitly don't want to look at the localmatrix
-    // as our interators are intrinsically tied to the vertices, and nothing else.
-    SkMatrix ctmInv;
-    if (!this->getCTM().invert(&ctmInv)) {
+    if (!fCTMInvertible) {
         return false;
     }
-    fDstToUnit.setConcat(im, ctmInv);
+    fDstToUnit.setConcat(im, fCTMInverse);
     return true;
 }
 
@@ -1977,7 +2184,11 @@ static int ScalarTo256(SkScalar v) {
 
 SkTriColorShader::TriColorShaderContext::TriColorShaderContext(const SkTriColorShader& shader,
                                                                const ContextRec& rec)
-    : INHERITED(shader, rec) {}
+    : INHERITED(shader, rec) {
+    // We can't call getTotalInverse(), because we explicitly don't want to look at the localmatrix
+    // as our interators are intrinsically tied to the vertices, and nothing else.
+    fCTMInvertible = this->getCTM().invert(&fCTMInverse);
+}
 
 SkTriColorShader::TriColorShaderContext::~TriColorShaderContext() {}
 
@@ -2101,16 +2312,39 @@ void SkDraw::drawVertices(SkCanvas::VertexMode vmode, int count,
     VertState::Proc vertProc = state.chooseProc(vmode);
 
     if (textures || colors) {
+        const SkIRect& clipBounds = fRC->getBounds();
+        SkMatrix prevTextureM;
+        bool hasPrevTextureM = false;
         while (vertProc(&state)) {
-            if (textures) {
-                SkMatrix tempM;
-                if (texture_to_matrix(state, vertices, textures, &tempM)) {
-                    SkShader::ContextRec rec(*fBitmap, p, *fMatrix);
-                    rec.fLocalMatrix = &tempM;
-                    if (!blitter->resetShaderContext(rec)) {
-                        continue;
-                    }
+            SkPoint tmp[] = {
+                devVerts[state.f0], devVerts[state.f1], devVerts[state.f2]
+            };
+
+            // Meshes commonly map the texture the same way for every triangle (e.g. a regular
+            // grid), in which case the current shader context can be reused.
+            SkMatrix tempM;
+            const bool resetTexture = textures &&
+                                      texture_to_matrix(state, vertices, textures, &tempM) &&
+                                      !(hasPrevTextureM && tempM == prevTextureM);
+
+            if (resetTexture) {
+                // Reject triangles FillTriangle would reject before paying for a new context.
+                SkRect bounds;
+                SkIRect ibounds;
+                bounds.set(tmp, 3);
+                bounds.round(&ibounds);
+                if (ibounds.isEmpty() || !SkIRect::Intersects(ibounds, clipBounds)) {
+                    continue;
                 }
+
+                SkShader::ContextRec rec(*fBitmap, p, *fMatrix);
+                rec.fLocalMatrix = &tempM;
+                if (!blitter->resetShaderContext(rec)) {
+                    hasPrevTextureM = false;
+                    continue;
+                }
+                prevTextureM = tempM;
+                hasPrevTextureM = true;
             }
             if (colors) {
                 // Find the context for triShader.
@@ -2138,9 +2372,6 @@ void SkDraw::drawVertices(SkCanvas::VertexMode vmode, int count,
                 }
             }
 
-            SkPoint tmp[] = {
-                devVerts[state.f0], devVerts[state.f1], devVerts[state.f2]
-            };
             SkScan::FillTriangle(tmp, *fRC, blitter.get());
         }
     } else {
@@ -6,11 +6,13 @@
  * found in the LICENSE file.
  */
 #include "SkEdgeBuilder.h"
+#include "SkDevicePathCache.h"
 #include "SkPath.h"
 #include "SkEdge.h"
 #include "SkEdgeClipper.h"
 #include "SkLineClipper.h"
 #include "SkGeometry.h"
+#include "SkResourceCache.h"
 
 template <typename T> static T* typedAllocThrow(SkChunkAlloc& alloc) {
     return static_cast<T*>(alloc.allocThrow(sizeof(T)));
@@ -153,6 +155,95 @@ int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, int shift
     return SkToInt(edgePtr - fEdgeList);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ *  Edges built again from a non-volatile path with curves are kept in SkResourceCache, keyed by
+ *  the path's generation ID and the build parameters, so that a path filled again and again does
+ *  not chop and set up its curves each time. The scan converter steps the edges it is given, so
+ *  the cache holds pristine copies, packed back to back, and each build copies them out.
+ */
+namespace {
+static unsigned gEdgesKeyNamespaceLabel;
+
+struct EdgesKey : public SkResourceCache::Key {
+    EdgesKey(const SkPath& path, const SkIRect* clip, int shiftUp, bool canCullToTheRight)
+        : fGenID(path.getGenerationID())
+        , fShiftUp(shiftUp)
+        , fCanCullToTheRight(canCullToTheRight)
+        , fHasClip(NULL != clip)
+        , fClip(clip ? *clip : SkIRect::MakeEmpty())
+    {
+        this->init(&gEdgesKeyNamespaceLabel, 0, sizeof(fGenID) + sizeof(fShiftUp) +
+                   sizeof(fCanCullToTheRight) + sizeof(fHasClip) + sizeof(fClip));
+    }
+
+    uint32_t fGenID;
+    int32_t  fShiftUp;
+    int32_t  fCanCullToTheRight;
+    int32_t  fHasClip;
+    SkIRect  fClip;
+};
+
+// Only the fields a partly stepped edge still uses: a curve on its last segment is a line.
+static size_t edge_size(const SkEdge* edge) {
+    if (edge->fCurveCount > 0) {
+        return sizeof(SkQuadraticEdge);
+    }
+    if (edge->fCurveCount < 0) {
+        return sizeof(SkCubicEdge);
+    }
+    return sizeof(SkEdge);
+}
+
+struct EdgesRec : public SkResourceCache::Rec {
+    EdgesRec(const EdgesKey& key, SkEdge* const* edges, int count)
+        : fKey(key)
+        , fCount(count)
+        , fSize(0)
+    {
+        for (int i = 0; i < count; ++i) {
+            fSize += edge_size(edges[i]);
+        }
+        char* dst = (char*)fEdges.reset(fSize);
+        for (int i = 0; i < count; ++i) {
+            const size_t size = edge_size(edges[i]);
+            memcpy(dst, edges[i], size);
+            dst += size;
+        }
+    }
+
+    EdgesKey     fKey;
+    SkAutoMalloc fEdges;
+    int          fCount;
+    size_t       fSize;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fSize; }
+
+    struct Result {
+        SkChunkAlloc*       fAlloc;
+        SkTDArray<SkEdge*>* fList;
+    };
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* contextResult) {
+        const EdgesRec& rec = static_cast<const EdgesRec&>(baseRec);
+        Result* result = static_cast<Result*>(contextResult);
+
+        char* edges = (char*)result->fAlloc->allocThrow(rec.fSize);
+        memcpy(edges, rec.fEdges.get(), rec.fSize);
+        SkEdge** list = result->fList->append(rec.fCount);
+        for (int i = 0; i < rec.fCount; ++i) {
+            list[i] = reinterpret_cast<SkEdge*>(edges);
+            edges += edge_size(list[i]);
+        }
+        return true;
+    }
+};
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
 static void handle_quad(SkEdgeBuilder* builder, const SkPoint pts[3]) {
     SkPoint monoX[5];
     int n = SkChopQuadAtYExtrema(pts, monoX);
@@ -167,6 +258,26 @@ int SkEdgeBuilder::build(const SkPath& path, const SkIRect* iclip, int shiftUp,
     fList.reset();
     fShiftUp = shiftUp;
 
+    // Polygons are set up as edges about as fast as they are copied from the cache, and a path
+    // built only once would just take up room in it.
+    if (path.isVolatile() || SkPath::kLine_SegmentMask == path.getSegmentMasks() ||
+        !SkDevicePathCache::SeenBefore(path)) {
+        return this->buildEdges(path, iclip, shiftUp, canCullToTheRight);
+    }
+
+    EdgesKey key(path, iclip, shiftUp, canCullToTheRight);
+    EdgesRec::Result result = { &fAlloc, &fList };
+    if (SkResourceCache::Find(key, EdgesRec::Finder, &result)) {
+        fEdgeList = fList.begin();
+        return fList.count();
+    }
+    const int count = this->buildEdges(path, iclip, shiftUp, canCullToTheRight);
+    SkResourceCache::Add(SkNEW_ARGS(EdgesRec, (key, fEdgeList, count)));
+    return count;
+}
+
+int SkEdgeBuilder::buildEdges(const SkPath& path, const SkIRect* iclip, int shiftUp,
+                              bool canCullToTheRight) {
     if (SkPath::kLine_SegmentMask == path.getSegmentMasks()) {
         return this->buildPoly(path, iclip, shiftUp, canCullToTheRight);
     }
@@ -21,7 +21,9 @@ public:
     SkEdgeBuilder();
 
     // returns the number of built edges. The array of those edge pointers
-    // is returned from edgeList().
+    // is returned from edgeList(). Unless the path is volatile or a polygon,
+    // the edges are cached once they are built a second time, and building
+    // them again for the same path copies them.
     int build(const SkPath& path, const SkIRect* clip, int shiftUp, bool clipToTheRight);
 
     SkEdge** edgeList() { return fEdgeList; }
@@ -47,6 +49,9 @@ public:
     void addClipper(SkEdgeClipper*);
 
     int buildPoly(const SkPath& path, const SkIRect* clip, int shiftUp, bool clipToTheRight);
+
+private:
+    int buildEdges(const SkPath& path, const SkIRect* clip, int shiftUp, bool clipToTheRight);
 };
 
 #endif
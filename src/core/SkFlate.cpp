@@ -10,6 +10,7 @@
 #include "SkData.h"
 #include "SkFlate.h"
 #include "SkStream.h"
+#include "SkStreamCodec.h"
 
 namespace {
 
@@ -223,3 +224,86 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
 size_t SkDeflateWStream::bytesWritten() const {
     return fImpl->fZStream.total_in + fImpl->fInBufferIndex;
 }
+
+// Hide all zlib impl details.
+struct SkInflateStream::Impl {
+    SkStream* fIn;
+    unsigned char fInBuffer[SKDEFLATEWSTREAM_INPUT_BUFFER_SIZE];
+    z_stream fZStream;
+    bool fInitialized;
+    bool fDone;
+};
+
+SkInflateStream::SkInflateStream(SkStream* in)
+    : fImpl(SkNEW(SkInflateStream::Impl)) {
+    fImpl->fIn = in;
+    fImpl->fZStream.zalloc = &skia_alloc_func;
+    fImpl->fZStream.zfree = &skia_free_func;
+    fImpl->fZStream.opaque = NULL;
+    fImpl->fZStream.next_in = fImpl->fInBuffer;
+    fImpl->fZStream.avail_in = 0;
+    fImpl->fInitialized = in && Z_OK == inflateInit(&fImpl->fZStream);
+    fImpl->fDone = !fImpl->fInitialized;
+}
+
+SkInflateStream::~SkInflateStream() {
+    if (fImpl->fInitialized) {
+        (void)inflateEnd(&fImpl->fZStream);
+    }
+}
+
+size_t SkInflateStream::read(void* buffer, size_t size) {
+    if (NULL == buffer) {
+        // zlib has to produce the bytes anyway, so skip by reading into scratch space.
+        unsigned char scratch[SKDEFLATEWSTREAM_OUTPUT_BUFFER_SIZE];
+        size_t skipped = 0;
+        while (skipped < size) {
+            size_t n = this->read(scratch, SkTMin(size - skipped, sizeof(scratch)));
+            if (0 == n) {
+                break;
+            }
+            skipped += n;
+        }
+        return skipped;
+    }
+
+    z_stream* zStream = &fImpl->fZStream;
+    zStream->next_out = (unsigned char*)buffer;
+    zStream->avail_out = SkToUInt(size);
+    while (zStream->avail_out > 0 && !fImpl->fDone) {
+        if (0 == zStream->avail_in) {
+            // This may read past the end of the compressed data in the source stream.
+            size_t n = fImpl->fIn->read(fImpl->fInBuffer, sizeof(fImpl->fInBuffer));
+            if (0 == n) {
+                fImpl->fDone = true;
+                break;
+            }
+            zStream->next_in = fImpl->fInBuffer;
+            zStream->avail_in = SkToUInt(n);
+        }
+        int rc = inflate(zStream, Z_NO_FLUSH);
+        if (Z_OK != rc && Z_BUF_ERROR != rc) {
+            // Z_STREAM_END, or corrupt data.
+            fImpl->fDone = true;
+        }
+    }
+    return size - zStream->avail_out;
+}
+
+bool SkInflateStream::isAtEnd() const {
+    return fImpl->fDone;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static SkWStream* flate_compressor(SkWStream* dst) {
+    return SkNEW_ARGS(SkDeflateWStream, (dst));
+}
+
+static SkStream* flate_decompressor(SkStream* src) {
+    return SkNEW_ARGS(SkInflateStream, (src));
+}
+
+void SkFlate::RegisterStreamCodec() {
+    SkStreamCodec::Register(SkStreamCodec::kFlate_Type, flate_compressor, flate_decompressor);
+}
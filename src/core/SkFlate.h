@@ -42,6 +42,13 @@ public:
         putting the result into dst.  Returns false if an error occurs.
      */
     static bool Inflate(SkStream* src, SkWStream* dst);
+
+    /**
+     *  Make flate available to SkStreamCodec, so that pictures can be serialized with
+     *  SkPicture::kCompressFlate_SerializeFlag and read back.  Call it before either; calling it
+     *  again does no harm.
+     */
+    static void RegisterStreamCodec();
 };
 
 /**
@@ -72,4 +79,24 @@ private:
     SkAutoTDelete<Impl> fImpl;
 };
 
+/**
+  * Wrap a stream of Deflate data (as written by SkDeflateWStream) in this
+  * class to decompress it as it is read, without holding all of it in memory.
+  */
+class SkInflateStream : public SkStream {
+public:
+    /** Does not take ownership of the stream. */
+    SkInflateStream(SkStream*);
+
+    ~SkInflateStream();
+
+    // The SkStream interface:
+    size_t read(void*, size_t) override;
+    bool isAtEnd() const override;
+
+private:
+    struct Impl;
+    SkAutoTDelete<Impl> fImpl;
+};
+
 #endif  // SkFlate_DEFINED
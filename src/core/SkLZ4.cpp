@@ -0,0 +1,339 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkLZ4.h"
+
+// Each sequence is a token byte (literal count in the high nibble, match length - 4 in the low),
+// then any extra literal-count bytes, the literals, a little-endian 16-bit match offset and any
+// extra match-length bytes.  A count of 15 in the token continues in following bytes, each
+// adding up to 255.  The last sequence has literals only.
+static const size_t kMinMatch     = 4;
+static const size_t kLastLiterals = 5;    // the last 5 bytes are always literals
+static const size_t kMatchLimit   = 12;   // no match may start in the last 12 bytes
+static const size_t kMaxOffset    = 0xFFFF;
+
+static const int kHashBits = 13;
+
+static inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t hash4(uint32_t v) {
+    return (v * 2654435761U) >> (32 - kHashBits);
+}
+
+static inline uint8_t* write_length(uint8_t* op, size_t length) {
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = SkToU8(length);
+    return op;
+}
+
+static inline uint8_t* write_literals(uint8_t* op, const uint8_t* literals, size_t count,
+                                      uint8_t** token) {
+    *token = op++;
+    if (count >= 15) {
+        **token = 15 << 4;
+        op = write_length(op, count - 15);
+    } else {
+        **token = SkToU8(count << 4);
+    }
+    memcpy(op, literals, count);
+    return op + count;
+}
+
+size_t SkLZ4::Compress(const void* srcPtr, size_t size, void* dstPtr) {
+    SkASSERT(size <= kMaxBlockSize);
+    const uint8_t* const base = (const uint8_t*)srcPtr;
+    const uint8_t* const end = base + size;
+    const uint8_t* anchor = base;
+    uint8_t* op = (uint8_t*)dstPtr;
+    uint8_t* token;
+
+    if (size > kMatchLimit) {
+        const uint8_t* const matchStartLimit = end - kMatchLimit;
+        const uint8_t* const matchEndLimit = end - kLastLiterals;
+        // Positions fit in 16 bits since blocks are at most 64K; 0 doubles as "empty", which is
+        // harmless because every candidate is verified.
+        uint16_t table[1 << kHashBits];
+        sk_bzero(table, sizeof(table));
+
+        const uint8_t* ip = base + 1;
+        unsigned misses = 0;
+        while (ip <= matchStartLimit) {
+            const uint32_t seq = read32(ip);
+            const uint32_t h = hash4(seq);
+            const uint8_t* ref = base + table[h];
+            table[h] = SkToU16(ip - base);
+            if (ref >= ip || (size_t)(ip - ref) > kMaxOffset || read32(ref) != seq) {
+                // Skip faster through data that isn't compressing.
+                ip += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+
+            while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            }
+            const uint8_t* matchEnd = ip + kMinMatch;
+            const uint8_t* r = ref + kMinMatch;
+            while (matchEnd < matchEndLimit && *matchEnd == *r) {
+                matchEnd++;
+                r++;
+            }
+
+            op = write_literals(op, anchor, ip - anchor, &token);
+            const size_t offset = ip - ref;
+            *op++ = SkToU8(offset);
+            *op++ = SkToU8(offset >> 8);
+            const size_t extra = (matchEnd - ip) - kMinMatch;
+            if (extra >= 15) {
+                *token |= 15;
+                op = write_length(op, extra - 15);
+            } else {
+                *token |= extra;
+            }
+
+            ip = anchor = matchEnd;
+            if (ip - 2 > base) {
+                table[hash4(read32(ip - 2))] = SkToU16(ip - 2 - base);
+            }
+        }
+    }
+
+    op = write_literals(op, anchor, end - anchor, &token);
+    SkASSERT((size_t)(op - (uint8_t*)dstPtr) <= CompressBound(size));
+    return op - (uint8_t*)dstPtr;
+}
+
+// Reads the continuation bytes of a length whose nibble was 15.  Returns false if the input
+// runs out or the length can't possibly fit in the output.
+static inline bool read_length(const uint8_t** ipPtr, const uint8_t* stop, size_t limit,
+                               size_t* length) {
+    const uint8_t* ip = *ipPtr;
+    uint8_t b;
+    do {
+        if (ip >= stop) {
+            return false;
+        }
+        b = *ip++;
+        *length += b;
+        if (*length > limit) {
+            return false;
+        }
+    } while (255 == b);
+    *ipPtr = ip;
+    return true;
+}
+
+bool SkLZ4::Decompress(const void* srcPtr, size_t srcSize, void* dstPtr, size_t dstSize) {
+    const uint8_t* ip = (const uint8_t*)srcPtr;
+    const uint8_t* const ipStop = ip + srcSize;
+    uint8_t* const dst = (uint8_t*)dstPtr;
+    uint8_t* op = dst;
+    uint8_t* const opStop = dst + dstSize;
+
+    for (;;) {
+        if (ip >= ipStop) {
+            return false;
+        }
+        const unsigned token = *ip++;
+
+        size_t literals = token >> 4;
+        if (15 == literals && !read_length(&ip, ipStop, dstSize, &literals)) {
+            return false;
+        }
+        if (literals > (size_t)(ipStop - ip) || literals > (size_t)(opStop - op)) {
+            return false;
+        }
+        if (literals <= 16 && ipStop - ip >= 16 && opStop - op >= 16) {
+            memcpy(op, ip, 16);     // A fixed size copy is much cheaper, and there's room.
+        } else {
+            memcpy(op, ip, literals);
+        }
+        ip += literals;
+        op += literals;
+        if (ip == ipStop) {
+            break;
+        }
+
+        if (ipStop - ip < 2) {
+            return false;
+        }
+        const size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (0 == offset || offset > (size_t)(op - dst)) {
+            return false;
+        }
+        size_t length = token & 15;
+        if (15 == length && !read_length(&ip, ipStop, dstSize, &length)) {
+            return false;
+        }
+        length += kMinMatch;
+        if (length > (size_t)(opStop - op)) {
+            return false;
+        }
+
+        const uint8_t* ref = op - offset;
+        if (offset >= 8 && (size_t)(opStop - op) >= length + 8) {
+            // Copy 8 bytes at a time, overshooting the end; each copy only reads bytes that
+            // are already written, and the next sequence overwrites the extra.
+            uint8_t* const matchStop = op + length;
+            do {
+                memcpy(op, ref, 8);
+                op += 8;
+                ref += 8;
+            } while (op < matchStop);
+            op = matchStop;
+        } else if (offset >= length) {
+            memcpy(op, ref, length);
+            op += length;
+        } else {
+            // The match overlaps what it is writing (a repeating pattern), so go a byte at a time.
+            for (size_t i = 0; i < length; ++i) {
+                *op++ = *ref++;
+            }
+        }
+    }
+    return op == opStop;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Stream framing: each block is a u32 of its uncompressed size, then a u32 of its stored size
+// with kStoredRaw_Bit set if it didn't compress and is stored as is, then the stored bytes.
+// An uncompressed size of 0 ends the stream.
+static const uint32_t kStoredRaw_Bit = 1U << 31;
+
+SkLZ4WStream::SkLZ4WStream(SkWStream* out)
+    : fOut(out)
+    , fBlock(SkLZ4::kMaxBlockSize)
+    , fPacked(SkLZ4::CompressBound(SkLZ4::kMaxBlockSize))
+    , fUsed(0)
+    , fFlushed(0) {}
+
+SkLZ4WStream::~SkLZ4WStream() { this->finalize(); }
+
+bool SkLZ4WStream::flushBlock() {
+    if (0 == fUsed) {
+        return true;
+    }
+    const size_t packedSize = SkLZ4::Compress(fBlock.get(), fUsed, fPacked.get());
+    bool ok;
+    if (packedSize < fUsed) {
+        ok = fOut->write32(SkToU32(fUsed)) &&
+             fOut->write32(SkToU32(packedSize)) &&
+             fOut->write(fPacked.get(), packedSize);
+    } else {
+        ok = fOut->write32(SkToU32(fUsed)) &&
+             fOut->write32(SkToU32(fUsed) | kStoredRaw_Bit) &&
+             fOut->write(fBlock.get(), fUsed);
+    }
+    fFlushed += fUsed;
+    fUsed = 0;
+    return ok;
+}
+
+void SkLZ4WStream::finalize() {
+    if (!fOut) {
+        return;
+    }
+    this->flushBlock();
+    fOut->write32(0);
+    fOut = NULL;
+}
+
+bool SkLZ4WStream::write(const void* buffer, size_t size) {
+    if (!fOut) {
+        return false;
+    }
+    const uint8_t* src = (const uint8_t*)buffer;
+    while (size > 0) {
+        const size_t n = SkTMin(size, SkLZ4::kMaxBlockSize - fUsed);
+        memcpy(fBlock.get() + fUsed, src, n);
+        fUsed += n;
+        src += n;
+        size -= n;
+        if (SkLZ4::kMaxBlockSize == fUsed && !this->flushBlock()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t SkLZ4WStream::bytesWritten() const {
+    return fFlushed + fUsed;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkLZ4Stream::SkLZ4Stream(SkStream* in)
+    : fIn(in)
+    , fBlock(SkLZ4::kMaxBlockSize)
+    , fPacked(SkLZ4::CompressBound(SkLZ4::kMaxBlockSize))
+    , fSize(0)
+    , fOffset(0)
+    , fDone(false) {
+    this->nextBlock();
+}
+
+bool SkLZ4Stream::nextBlock() {
+    fSize = fOffset = 0;
+    uint32_t sizes[2];
+    if (fIn->read(&sizes[0], sizeof(uint32_t)) != sizeof(uint32_t) || 0 == sizes[0] ||
+        sizes[0] > SkLZ4::kMaxBlockSize ||
+        fIn->read(&sizes[1], sizeof(uint32_t)) != sizeof(uint32_t)) {
+        fDone = true;
+        return false;
+    }
+
+    const size_t size = sizes[0];
+    bool ok;
+    if (sizes[1] & kStoredRaw_Bit) {
+        ok = (sizes[1] & ~kStoredRaw_Bit) == size && fIn->read(fBlock.get(), size) == size;
+    } else {
+        const size_t packedSize = sizes[1];
+        ok = packedSize <= SkLZ4::CompressBound(size) &&
+             fIn->read(fPacked.get(), packedSize) == packedSize &&
+             SkLZ4::Decompress(fPacked.get(), packedSize, fBlock.get(), size);
+    }
+    if (!ok) {
+        fDone = true;
+        return false;
+    }
+    fSize = size;
+    return true;
+}
+
+size_t SkLZ4Stream::read(void* buffer, size_t size) {
+    uint8_t* dst = (uint8_t*)buffer;
+    size_t total = 0;
+    while (size > 0 && fOffset < fSize) {
+        const size_t n = SkTMin(size, fSize - fOffset);
+        if (dst) {
+            memcpy(dst, fBlock.get() + fOffset, n);
+            dst += n;
+        }
+        fOffset += n;
+        total += n;
+        size -= n;
+        // Load the next block eagerly, so isAtEnd() knows when the end marker is next.
+        if (fOffset == fSize && !fDone) {
+            this->nextBlock();
+        }
+    }
+    return total;
+}
+
+bool SkLZ4Stream::isAtEnd() const {
+    return fDone && fOffset == fSize;
+}
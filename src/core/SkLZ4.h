@@ -0,0 +1,97 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkLZ4_DEFINED
+#define SkLZ4_DEFINED
+
+#include "SkStream.h"
+#include "SkTemplates.h"
+
+/**
+ *  A small, fast LZ77 codec writing the LZ4 block format: greedy matching with a single hash
+ *  probe, so compression is a few hundred MB/s and decompression is mostly memcpy.  Ratios are
+ *  well short of flate's, which is the point: it is cheap enough to sit in front of a reader.
+ */
+class SkLZ4 {
+public:
+    /** Blocks larger than this can't be compressed in one call (match offsets are 16 bits). */
+    static const size_t kMaxBlockSize = 1 << 16;
+
+    /** Returns the largest size Compress() can produce for size bytes of input. */
+    static size_t CompressBound(size_t size) { return size + size / 255 + 16; }
+
+    /**
+     *  Compresses size bytes (at most kMaxBlockSize) from src into dst, which must have room
+     *  for CompressBound(size) bytes.  Returns the number of bytes written.
+     */
+    static size_t Compress(const void* src, size_t size, void* dst);
+
+    /**
+     *  Decompresses srcSize bytes of one block written by Compress() into exactly dstSize bytes
+     *  at dst.  Returns false if the data is malformed or does not fill dst exactly; dst may
+     *  have been partly written.
+     */
+    static bool Decompress(const void* src, size_t srcSize, void* dst, size_t dstSize);
+};
+
+/**
+ *  Compresses everything written to it into dst as a sequence of SkLZ4 blocks, each preceded
+ *  by its sizes.  Input is buffered up to SkLZ4::kMaxBlockSize at a time.
+ */
+class SkLZ4WStream : public SkWStream {
+public:
+    /** Does not take ownership of the stream. */
+    SkLZ4WStream(SkWStream*);
+
+    /** The destructor calls finalize(). */
+    ~SkLZ4WStream();
+
+    /** Writes any buffered data and the end marker.  All subsequent calls to write() will fail.
+        Subsequent calls to finalize() do nothing. */
+    void finalize();
+
+    // The SkWStream interface:
+    bool write(const void*, size_t) override;
+    size_t bytesWritten() const override;   // uncompressed bytes
+
+private:
+    bool flushBlock();
+
+    SkWStream*              fOut;
+    SkAutoTMalloc<uint8_t>  fBlock;
+    SkAutoTMalloc<uint8_t>  fPacked;
+    size_t                  fUsed;
+    size_t                  fFlushed;
+};
+
+/**
+ *  Reads what SkLZ4WStream wrote, decompressing a block at a time as it is consumed, so at most
+ *  one block of uncompressed data is held in memory.
+ */
+class SkLZ4Stream : public SkStream {
+public:
+    /** Does not take ownership of the stream. */
+    SkLZ4Stream(SkStream*);
+
+    // The SkStream interface:
+    size_t read(void* buffer, size_t size) override;
+    bool isAtEnd() const override;
+
+private:
+    bool nextBlock();
+
+    SkStream*               fIn;
+    SkAutoTMalloc<uint8_t>  fBlock;
+    SkAutoTMalloc<uint8_t>  fPacked;
+    size_t                  fSize;      // decompressed bytes in fBlock
+    size_t                  fOffset;    // bytes of fBlock already read
+    bool                    fDone;      // the end marker was reached, or the data was bad
+
+    typedef SkStream INHERITED;
+};
+
+#endif
@@ -2434,6 +2434,6 @@ uint32_t SkPaint::getHash() const {
     // so fBitfields should be 10 pointers and 6 32-bit values from the start.
     SK_COMPILE_ASSERT(offsetof(SkPaint, fBitfields) == 10 * sizeof(void*) + 6 * sizeof(uint32_t),
                       SkPaint_notPackedTightly);
-    return SkChecksum::Murmur3(reinterpret_cast<const uint32_t*>(this),
-                               offsetof(SkPaint, fBitfields) + sizeof(fBitfields));
+    return SkChecksum::Hash(reinterpret_cast<const uint32_t*>(this),
+                            offsetof(SkPaint, fBitfields) + sizeof(fBitfields));
 }
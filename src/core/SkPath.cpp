@@ -1849,7 +1849,43 @@ size_t SkPath::writeToMemory(void* storage) const {
     return buffer.pos();
 }
 
+size_t SkPath::writeToMemoryWithoutPoints(void* storage, bool pointsMoved) const {
+    SkDEBUGCODE(this->validate();)
+
+    if (NULL == storage) {
+        const int byteCount = sizeof(int32_t) + fPathRef->writeSizeWithoutPoints();
+        return SkAlign4(byteCount);
+    }
+
+    SkWBuffer   buffer(storage);
+
+    // Whatever was computed about the shape may not hold for the moved points.
+    const int convexity = pointsMoved ? (int)kUnknown_Convexity : fConvexity;
+    const int direction = pointsMoved ? (int)kUnknown_Direction : fDirection;
+    int32_t packed = (convexity << kConvexity_SerializationShift) |
+                     (fFillType << kFillType_SerializationShift) |
+                     (direction << kDirection_SerializationShift) |
+                     (fIsVolatile << kIsVolatile_SerializationShift);
+
+    buffer.write32(packed);
+
+    fPathRef->writeToBufferWithoutPoints(&buffer, pointsMoved);
+
+    buffer.padToAlign4();
+    return buffer.pos();
+}
+
 size_t SkPath::readFromMemory(const void* storage, size_t length) {
+    return this->readFromMemory(storage, length, NULL, 0, true);
+}
+
+size_t SkPath::readFromMemoryWithoutPoints(const void* storage, size_t length,
+                                           const SkPoint points[], int pointCount) {
+    return this->readFromMemory(storage, length, points, pointCount, false);
+}
+
+size_t SkPath::readFromMemory(const void* storage, size_t length, const SkPoint points[],
+                              int pointCount, bool pointsInBuffer) {
     SkRBufferWithSizeCheck buffer(storage, length);
 
     int32_t packed;
@@ -1861,10 +1897,11 @@ size_t SkPath::readFromMemory(const void* storage, size_t length) {
     fFillType = (packed >> kFillType_SerializationShift) & 0xFF;
     fDirection = (packed >> kDirection_SerializationShift) & 0x3;
     fIsVolatile = (packed >> kIsVolatile_SerializationShift) & 0x1;
-    SkPathRef* pathRef = SkPathRef::CreateFromBuffer(&buffer);
+    SkPathRef* pathRef = pointsInBuffer ? SkPathRef::CreateFromBuffer(&buffer) :
+                         SkPathRef::CreateFromBufferWithoutPoints(&buffer, points, pointCount);
 
     size_t sizeRead = 0;
-    if (buffer.isValid()) {
+    if (buffer.isValid() && pathRef) {
         fPathRef.reset(pathRef);
         SkDEBUGCODE(this->validate();)
         buffer.skipToAlign4();
@@ -22,6 +22,15 @@ bool SkPathEffect::asPoints(PointData* results, const SkPath& src,
     return false;
 }
 
+bool SkPathEffect::asStamps(StampData* results, const SkPath& src,
+                            const SkStrokeRec&, const SkRect*) const {
+    return false;
+}
+
+SkShader* SkPathEffect::refTileShader(const SkPaint&, const SkMatrix&) const {
+    return NULL;
+}
+
 SkPathEffect::DashType SkPathEffect::asADash(DashInfo* info) const {
     return kNone_DashType;
 }
@@ -108,6 +108,16 @@ void SkPathRef::CreateTransformedCopy(SkAutoTUnref<SkPathRef>* dst,
 }
 
 SkPathRef* SkPathRef::CreateFromBuffer(SkRBuffer* buffer) {
+    return Read(buffer, NULL, 0, true);
+}
+
+SkPathRef* SkPathRef::CreateFromBufferWithoutPoints(SkRBuffer* buffer, const SkPoint points[],
+                                                    int pointCount) {
+    return Read(buffer, points, pointCount, false);
+}
+
+SkPathRef* SkPathRef::Read(SkRBuffer* buffer, const SkPoint points[], int pointCount,
+                           bool pointsInBuffer) {
     SkPathRef* ref = SkNEW(SkPathRef);
     bool isOval;
     uint8_t segmentMask;
@@ -122,28 +132,34 @@ SkPathRef* SkPathRef::CreateFromBuffer(SkRBuffer* buffer) {
     segmentMask = (packed >> kSegmentMask_SerializationShift) & 0xF;
     isOval  = (packed >> kIsOval_SerializationShift) & 1;
 
-    int32_t verbCount, pointCount, conicCount;
+    int32_t verbCount, bufferPointCount, conicCount;
     if (!buffer->readU32(&(ref->fGenerationID)) ||
         !buffer->readS32(&verbCount) ||
-        !buffer->readS32(&pointCount) ||
-        !buffer->readS32(&conicCount)) {
+        !buffer->readS32(&bufferPointCount) ||
+        !buffer->readS32(&conicCount) ||
+        (!pointsInBuffer && bufferPointCount != pointCount)) {
         SkDELETE(ref);
         return NULL;
     }
 
-    ref->resetToSize(verbCount, pointCount, conicCount);
+    ref->resetToSize(verbCount, bufferPointCount, conicCount);
     SkASSERT(verbCount == ref->countVerbs());
-    SkASSERT(pointCount == ref->countPoints());
+    SkASSERT(bufferPointCount == ref->countPoints());
     SkASSERT(conicCount == ref->fConicWeights.count());
 
     if (!buffer->read(ref->verbsMemWritable(), verbCount * sizeof(uint8_t)) ||
-        !buffer->read(ref->fPoints, pointCount * sizeof(SkPoint)) ||
+        (pointsInBuffer && !buffer->read(ref->fPoints, bufferPointCount * sizeof(SkPoint))) ||
         !buffer->read(ref->fConicWeights.begin(), conicCount * sizeof(SkScalar)) ||
-        !buffer->read(&ref->fBounds, sizeof(SkRect))) {
+        (pointsInBuffer && !buffer->read(&ref->fBounds, sizeof(SkRect)))) {
         SkDELETE(ref);
         return NULL;
     }
-    ref->fBoundsIsDirty = false;
+    if (pointsInBuffer) {
+        ref->fBoundsIsDirty = false;
+    } else {
+        // The bounds (and fIsFinite) are computed when they are first asked for.
+        memcpy(ref->fPoints, points, pointCount * sizeof(SkPoint));
+    }
 
     // resetToSize clears fSegmentMask and fIsOval
     ref->fSegmentMask = segmentMask;
@@ -252,6 +268,33 @@ void SkPathRef::writeToBuffer(SkWBuffer* buffer) const {
     SkASSERT(buffer->pos() - beforePos == (size_t) this->writeSize());
 }
 
+void SkPathRef::writeToBufferWithoutPoints(SkWBuffer* buffer, bool pointsMoved) const {
+    SkDEBUGCODE(this->validate();)
+    SkDEBUGCODE(size_t beforePos = buffer->pos();)
+
+    // Whether the moved points still make an oval is anyone's guess.
+    const bool isOval = fIsOval && !pointsMoved;
+    int32_t packed = ((isOval & 1) << kIsOval_SerializationShift) |
+                     (fSegmentMask << kSegmentMask_SerializationShift);
+    buffer->write32(packed);
+
+    // See writeToBuffer() about the generation ID.
+    buffer->write32(0);
+    buffer->write32(fVerbCnt);
+    buffer->write32(fPointCnt);
+    buffer->write32(fConicWeights.count());
+    buffer->write(verbsMemBegin(), fVerbCnt * sizeof(uint8_t));
+    buffer->write(fConicWeights.begin(), fConicWeights.bytes());
+
+    SkASSERT(buffer->pos() - beforePos == (size_t) this->writeSizeWithoutPoints());
+}
+
+uint32_t SkPathRef::writeSizeWithoutPoints() const {
+    return uint32_t(5 * sizeof(uint32_t) +
+                    fVerbCnt * sizeof(uint8_t) +
+                    fConicWeights.bytes());
+}
+
 uint32_t SkPathRef::writeSize() const {
     return uint32_t(5 * sizeof(uint32_t) +
                     fVerbCnt * sizeof(uint8_t) +
@@ -15,13 +15,16 @@
 #include "SkBitmapDevice.h"
 #include "SkCanvas.h"
 #include "SkChunkAlloc.h"
+#include "SkLayerInfo.h"
 #include "SkMessageBus.h"
 #include "SkPaintPriv.h"
 #include "SkPathEffect.h"
 #include "SkPicture.h"
+#include "SkRasterLayerCache.h"
 #include "SkRegion.h"
 #include "SkShader.h"
 #include "SkStream.h"
+#include "SkStreamCodec.h"
 #include "SkTDArray.h"
 #include "SkTLogic.h"
 #include "SkTSearch.h"
@@ -273,6 +276,10 @@ SkPicture::~SkPicture() {
     SkPicture::DeletionMessage msg;
     msg.fUniqueID = this->uniqueID();
     SkMessageBus<SkPicture::DeletionMessage>::Post(msg);
+
+    if (this->EXPERIMENTAL_getAccelData(SkLayerInfo::ComputeKey())) {
+        SkRasterLayerCache::PurgePicture(this->uniqueID());
+    }
 }
 
 void SkPicture::EXPERIMENTAL_addAccelData(const SkPicture::AccelData* data) const {
@@ -399,7 +406,19 @@ SkPicture* SkPicture::Forwardport(const SkPictInfo& info, const SkPictureData* d
 
 SkPicture* SkPicture::CreateFromStream(SkStream* stream, InstallPixelRefProc proc) {
     SkPictInfo info;
-    if (!InternalOnly_StreamIsSKP(stream, &info) || !stream->readBool()) {
+    if (!InternalOnly_StreamIsSKP(stream, &info)) {
+        return NULL;
+    }
+    // A compressed picture is decompressed as it is parsed, never all at once.
+    SkAutoTDelete<SkStream> decompressor;
+    if (info.fFlags & SkPictInfo::kCompressed_Flag) {
+        decompressor.reset(SkStreamCodec::NewDecompressor(stream->readU32(), stream));
+        if (!decompressor) {
+            return NULL;
+        }
+        stream = decompressor.get();
+    }
+    if (!stream->readBool()) {
         return NULL;
     }
     SkAutoTDelete<SkPictureData> data(SkPictureData::CreateFromStream(stream, info, proc));
@@ -415,7 +434,7 @@ SkPicture* SkPicture::CreateFromBuffer(SkReadBuffer& buffer) {
     return Forwardport(info, data);
 }
 
-void SkPicture::createHeader(SkPictInfo* info) const {
+void SkPicture::createHeader(SkPictInfo* info, uint32_t serializeFlags) const {
     // Copy magic bytes at the beginning of the header
     SkASSERT(sizeof(kMagic) == 8);
     SkASSERT(sizeof(kMagic) == sizeof(info->fMagic));
@@ -431,6 +450,13 @@ void SkPicture::createHeader(SkPictInfo* info) const {
     if (8 == sizeof(void*)) {
         info->fFlags |= SkPictInfo::kPtrIs64Bit_Flag;
     }
+
+    if (serializeFlags & kCompact_SerializeFlag) {
+        info->fFlags |= SkPictInfo::kCompact_Flag;
+        if (serializeFlags & kQuantizePoints_SerializeFlag) {
+            info->fFlags |= SkPictInfo::kQuantizedPoints_Flag;
+        }
+    }
 }
 
 // This for compatibility with serialization code only.  This is not cheap.
@@ -443,19 +469,52 @@ SkPictureData* SkPicture::Backport(const SkRecord& src, const SkPictInfo& info,
     return SkNEW_ARGS(SkPictureData, (rec, info, false/*deep copy ops?*/));
 }
 
-void SkPicture::serialize(SkWStream* stream, SkPixelSerializer* pixelSerializer) const {
+uint32_t SkPicture::serialize(SkWStream* stream, SkPixelSerializer* pixelSerializer,
+                              uint32_t flags) const {
     SkPictInfo info;
-    this->createHeader(&info);
+    this->createHeader(&info, flags);
     SkAutoTDelete<SkPictureData> data(Backport(*fRecord, info, this->drawablePicts(),
                                                this->drawableCount()));
 
+    // Try the requested codecs, best compression first. Flate is only there if it has been
+    // registered, but LZ4 is built in, so any request for compression is met.
+    static const struct {
+        uint32_t fRequestFlags;
+        uint32_t fCodec;
+        uint32_t fUsedFlag;
+    } gCodecs[] = {
+        { kCompressFlate_SerializeFlag, SkStreamCodec::kFlate_Type,
+          kCompressFlate_SerializeFlag },
+        { kCompressFlate_SerializeFlag | kCompressLZ4_SerializeFlag, SkStreamCodec::kLZ4_Type,
+          kCompressLZ4_SerializeFlag },
+    };
+    // Deleting the compressor on the way out finishes the compressed data.
+    SkAutoTDelete<SkWStream> compressor;
+    uint32_t codec = 0;
+    uint32_t usedFlag = 0;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gCodecs) && !compressor; ++i) {
+        if (flags & gCodecs[i].fRequestFlags) {
+            compressor.reset(SkStreamCodec::NewCompressor(gCodecs[i].fCodec, stream));
+            if (compressor) {
+                codec = gCodecs[i].fCodec;
+                usedFlag = gCodecs[i].fUsedFlag;
+                info.fFlags |= SkPictInfo::kCompressed_Flag;
+            }
+        }
+    }
+
     stream->write(&info, sizeof(info));
+    if (compressor) {
+        stream->write32(codec);
+        stream = compressor.get();
+    }
     if (data) {
         stream->writeBool(true);
         data->serialize(stream, pixelSerializer);
     } else {
         stream->writeBool(false);
     }
+    return usedFlag;
 }
 
 void SkPicture::flatten(SkWriteBuffer& buffer) const {
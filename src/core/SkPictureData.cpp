@@ -219,15 +219,64 @@ void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
     }
 }
 
+/*
+ *  With SkPictInfo::kCompact_Flag, the op data and buffer chunks are stored as their unpacked size
+ *  followed by the output of SkWriter32::Pack(). The chunk's tag size is still its size in bytes.
+ */
+static void write_chunk(SkWStream* stream, uint32_t tag, const void* data, size_t size,
+                        bool packed) {
+    if (!packed) {
+        write_tag_size(stream, tag, size);
+        stream->write(data, size);
+        return;
+    }
+    SkAutoMalloc storage(SkWriter32::PackedSizeBound(size));
+    const size_t packedSize = SkWriter32::Pack(data, size, storage.get());
+    write_tag_size(stream, tag, sizeof(uint32_t) + packedSize);
+    stream->write32(SkToU32(size));
+    stream->write(storage.get(), packedSize);
+}
+
+static SkData* read_chunk(SkStream* stream, size_t size, bool packed) {
+    if (!packed) {
+        return SkData::NewFromStream(stream, size);
+    }
+    if (size < sizeof(uint32_t)) {
+        return NULL;
+    }
+    const size_t unpackedSize = stream->readU32();
+    const size_t packedSize = size - sizeof(uint32_t);
+    // Every word takes at least one byte packed.
+    if (unpackedSize > packedSize * sizeof(uint32_t)) {
+        return NULL;
+    }
+    SkAutoMalloc storage(packedSize);
+    if (stream->read(storage.get(), packedSize) != packedSize) {
+        return NULL;
+    }
+    SkAutoDataUnref data(SkData::NewUninitialized(unpackedSize));
+    if (!SkReader32::Unpack(storage.get(), packedSize, data->writable_data(), unpackedSize)) {
+        return NULL;
+    }
+    return data.detach();
+}
+
 void SkPictureData::serialize(SkWStream* stream,
                               SkPixelSerializer* pixelSerializer) const {
-    write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
-    stream->write(fOpData->bytes(), fOpData->size());
+    const bool compact = this->isCompact();
+    write_chunk(stream, SK_PICT_READER_TAG, fOpData->bytes(), fOpData->size(), compact);
 
     if (fPictureCount > 0) {
+        uint32_t serializeFlags = 0;
+        if (compact) {
+            serializeFlags |= SkPicture::kCompact_SerializeFlag;
+            if (fInfo.fFlags & SkPictInfo::kQuantizedPoints_Flag) {
+                serializeFlags |= SkPicture::kQuantizePoints_SerializeFlag;
+            }
+        }
         write_tag_size(stream, SK_PICT_PICTURE_TAG, fPictureCount);
         for (int i = 0; i < fPictureCount; i++) {
-            fPictureRefs[i]->serialize(stream, pixelSerializer);
+            fPictureRefs[i]->serialize(stream, pixelSerializer, serializeFlags);
         }
     }
 
@@ -237,7 +286,14 @@ void SkPictureData::serialize(SkWStream* stream,
         SkRefCntSet  typefaceSet;
         SkFactorySet factSet;
 
-        SkWriteBuffer buffer(SkWriteBuffer::kCrossProcess_Flag);
+        uint32_t bufferFlags = SkWriteBuffer::kCrossProcess_Flag;
+        if (compact) {
+            bufferFlags |= SkWriteBuffer::kCompact_Flag;
+            if (fInfo.fFlags & SkPictInfo::kQuantizedPoints_Flag) {
+                bufferFlags |= SkWriteBuffer::kQuantizePoints_Flag;
+            }
+        }
+        SkWriteBuffer buffer(bufferFlags);
         buffer.setTypefaceRecorder(&typefaceSet);
         buffer.setFactoryRecorder(&factSet);
         buffer.setPixelSerializer(pixelSerializer);
@@ -250,8 +306,8 @@ void SkPictureData::serialize(SkWStream* stream,
         WriteFactories(stream, factSet);
         WriteTypefaces(stream, typefaceSet);
 
-        write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
-        buffer.writeToStream(stream);
+        write_chunk(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.getWriter32()->contiguousArray(),
+                    buffer.bytesWritten(), compact);
     }
 
     stream->write32(SK_PICT_EOF_TAG);
@@ -287,6 +343,7 @@ static uint32_t pictInfoFlagsToReadBufferFlags(uint32_t pictInfoFlags) {
         { SkPictInfo::kCrossProcess_Flag,   SkReadBuffer::kCrossProcess_Flag },
         { SkPictInfo::kScalarIsFloat_Flag,  SkReadBuffer::kScalarIsFloat_Flag },
         { SkPictInfo::kPtrIs64Bit_Flag,     SkReadBuffer::kPtrIs64Bit_Flag },
+        { SkPictInfo::kCompact_Flag,        SkReadBuffer::kCompact_Flag },
     };
 
     uint32_t rbMask = 0;
@@ -316,7 +373,7 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(NULL == fOpData);
-            fOpData = SkData::NewFromStream(stream, size);
+            fOpData = read_chunk(stream, size, this->isCompact());
             if (!fOpData) {
                 return false;
             }
@@ -373,13 +430,13 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
+            SkAutoDataUnref storage(read_chunk(stream, size, this->isCompact()));
+            if (!storage) {
                 return false;
             }
 
             /* Should we use SkValidatingReadBuffer instead? */
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(storage->data(), storage->size());
             buffer.setFlags(pictInfoFlagsToReadBufferFlags(fInfo.fFlags));
             buffer.setVersion(fInfo.fVersion);
 
@@ -31,6 +31,9 @@ struct SkPictInfo {
         kCrossProcess_Flag      = 1 << 0,
         kScalarIsFloat_Flag     = 1 << 1,
         kPtrIs64Bit_Flag        = 1 << 2,
+        kCompact_Flag           = 1 << 3,   // chunks are packed, points delta-coded
+        kQuantizedPoints_Flag   = 1 << 4,   // points were snapped to a grid when written
+        kCompressed_Flag        = 1 << 5,   // a codec type and compressed data follow the header
     };
 
     char        fMagic[8];
@@ -142,6 +145,8 @@ private:
     bool parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
     void flattenToBuffer(SkWriteBuffer&) const;
 
+    bool isCompact() const { return SkToBool(fInfo.fFlags & SkPictInfo::kCompact_Flag); }
+
     // Only used by getBitmap() if the passed in index is SkBitmapHeap::INVALID_SLOT. This empty
     // bitmap allows playback to draw nothing and move on.
     SkBitmap fBadBitmap;
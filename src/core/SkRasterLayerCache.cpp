@@ -0,0 +1,324 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkCanvasPriv.h"
+#include "SkImageFilter.h"
+#include "SkLayerInfo.h"
+#include "SkRasterLayerCache.h"
+#include "SkRecordDraw.h"
+#include "SkRecords.h"
+#include "SkResourceCache.h"
+#include "SkTArray.h"
+
+static uint64_t layer_shared_id(uint32_t pictureID) {
+    uint64_t sharedID = SkSetFourByteTag('l', 'a', 'y', 'r');
+    return (sharedID << 32) | pictureID;
+}
+
+namespace {
+static unsigned gLayerKeyNamespaceLabel;
+
+struct LayerKey : public SkResourceCache::Key {
+public:
+    LayerKey(uint32_t pictureID, int block, const SkLayerInfo::BlockInfo& info,
+             const SkMatrix& matrix)
+        : fPictureID(pictureID)
+        , fBlock(block)
+        , fSaveLayerOpID(SkToU32(info.fSaveLayerOpID))
+        , fRestoreOpID(SkToU32(info.fRestoreOpID))
+    {
+        fMatrix[0] = matrix.getScaleX();
+        fMatrix[1] = matrix.getSkewX();
+        fMatrix[2] = matrix.getTranslateX();
+        fMatrix[3] = matrix.getSkewY();
+        fMatrix[4] = matrix.getScaleY();
+        fMatrix[5] = matrix.getTranslateY();
+        this->init(&gLayerKeyNamespaceLabel, layer_shared_id(pictureID),
+                   sizeof(fPictureID) + sizeof(fBlock) + sizeof(fSaveLayerOpID) +
+                   sizeof(fRestoreOpID) + sizeof(fMatrix));
+    }
+
+    uint32_t    fPictureID;
+    int32_t     fBlock;
+    uint32_t    fSaveLayerOpID;
+    uint32_t    fRestoreOpID;
+    SkScalar    fMatrix[6];
+};
+
+struct LayerRec : public SkResourceCache::Rec {
+    LayerRec(const LayerKey& key, const SkBitmap& bitmap)
+        : fKey(key)
+        , fBitmap(bitmap)
+    {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(fKey) + fBitmap.getSize(); }
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* contextBitmap) {
+        const LayerRec& rec = static_cast<const LayerRec&>(baseRec);
+        SkBitmap* result = (SkBitmap*)contextBitmap;
+
+        *result = rec.fBitmap;
+        result->lockPixels();
+        return SkToBool(result->getPixels());
+    }
+
+private:
+    LayerKey    fKey;
+    SkBitmap    fBitmap;
+};
+
+// A layer of the picture being drawn whose contents are ready in a bitmap.
+struct HoistedLayer {
+    unsigned            fSaveLayerOpID;
+    unsigned            fRestoreOpID;
+    const SkPaint*      fPaint;
+    SkBitmap            fBitmap;    // locked
+    SkIPoint            fOrigin;    // device space
+};
+} // namespace
+
+static bool cache_try_alloc_pixels(SkBitmap* bitmap) {
+    SkBitmap::Allocator* allocator = SkResourceCache::GetAllocator();
+
+    return NULL != allocator
+        ? allocator->allocPixelRef(bitmap, NULL)
+        : bitmap->tryAllocPixels();
+}
+
+// Computes the device space bounds of the layer's contents, or returns false if it is empty.
+static bool compute_source_rect(const SkLayerInfo::BlockInfo& info, const SkMatrix& initialMat,
+                                SkIRect* srcIR) {
+    SkRect layerRect;
+    initialMat.mapRect(&layerRect, info.fBounds);
+
+    if (!info.fSrcBounds.isEmpty()) {
+        SkMatrix totMat = initialMat;
+        totMat.preConcat(info.fPreMat);
+        totMat.preConcat(info.fLocalMat);
+
+        SkRect r;
+        totMat.mapRect(&r, info.fSrcBounds);
+        if (!layerRect.intersect(r)) {
+            return false;
+        }
+    }
+
+    *srcIR = layerRect.roundOut();
+    return !srcIR->isEmpty();
+}
+
+// Draws a picture like SkRecordDraw, but draws the hoisted layers' bitmaps in place of their
+// saveLayer/restore blocks.  Sub-pictures go through SkCanvas::drawPicture() as usual, so those
+// with layer information of their own cache their layers under their own ID.
+class SkRasterLayerCache::ReplaceDraw : public SkRecords::Draw {
+public:
+    ReplaceDraw(SkCanvas* canvas, const SkPicture* picture, const SkTArray<HoistedLayer>& layers)
+        : INHERITED(canvas, picture->drawablePicts(), NULL, picture->drawableCount())
+        , fCanvas(canvas)
+        , fPicture(picture)
+        , fLayers(layers)
+        , fIndex(0) {}
+
+    void draw() {
+        const SkRecord* record = fPicture->fRecord.get();
+        if (NULL == record) {
+            return;
+        }
+
+        SkAutoCanvasRestore saveRestore(fCanvas, true /*save now, restore at exit*/);
+
+        // As SkPicture::playback, only use the BBH if the clip doesn't hold the whole picture.
+        SkRect query = { 0, 0, 0, 0 };
+        (void)fCanvas->getClipBounds(&query);
+        const SkBBoxHierarchy* bbh = fPicture->fBBH.get();
+
+        if (bbh && !query.contains(fPicture->cullRect())) {
+            bbh->search(query, &fOps);
+
+            for (fIndex = 0; fIndex < fOps.count(); ++fIndex) {
+                record->visit<void>(fOps[fIndex], *this);
+            }
+        } else {
+            for (fIndex = 0; fIndex < (int) record->count(); ++fIndex) {
+                record->visit<void>(fIndex, *this);
+            }
+        }
+    }
+
+    // Same as Draw for all ops except SaveLayer.
+    template <typename T> void operator()(const T& r) {
+        this->INHERITED::operator()(r);
+    }
+    void operator()(const SkRecords::SaveLayer& sl) {
+        const HoistedLayer* layer = this->findLayer(fOps.count() ? fOps[fIndex] : fIndex);
+        if (layer) {
+            fCanvas->drawSprite(layer->fBitmap, layer->fOrigin.fX, layer->fOrigin.fY,
+                                layer->fPaint);
+
+            // Skip to the matching restore.
+            if (fOps.count()) {
+                while (fIndex < fOps.count() - 1 && fOps[fIndex] < layer->fRestoreOpID) {
+                    ++fIndex;
+                }
+            } else {
+                fIndex = layer->fRestoreOpID;
+            }
+        } else {
+            this->INHERITED::operator()(sl);
+        }
+    }
+
+    // Renders the layer's contents, under the matrix the layer is keyed by, into a new bitmap.
+    static bool RenderLayer(const SkPicture* picture,
+                            const SkLayerInfo::BlockInfo& info,
+                            const SkMatrix& initialMat,
+                            const SkIRect& srcIR,
+                            SkBitmap* bitmap) {
+        bitmap->setInfo(SkImageInfo::MakeN32Premul(srcIR.width(), srcIR.height()));
+        if (!cache_try_alloc_pixels(bitmap)) {
+            return false;
+        }
+        bitmap->eraseColor(SK_ColorTRANSPARENT);
+
+        SkCanvas layerCanvas(*bitmap, SkSurfaceProps(0, kUnknown_SkPixelGeometry));
+
+        SkMatrix initialCTM;
+        initialCTM.setTranslate(SkIntToScalar(-srcIR.fLeft), SkIntToScalar(-srcIR.fTop));
+        initialCTM.preConcat(initialMat);
+        initialCTM.preConcat(info.fPreMat);
+
+        layerCanvas.setMatrix(initialCTM);
+        layerCanvas.concat(info.fLocalMat);
+
+        SkRecordPartialDraw(*picture->fRecord.get(), &layerCanvas,
+                            picture->drawablePicts(), picture->drawableCount(),
+                            SkToU32(info.fSaveLayerOpID) + 1, SkToU32(info.fRestoreOpID),
+                            initialCTM);
+        return true;
+    }
+
+private:
+    const HoistedLayer* findLayer(unsigned saveLayerOpID) const {
+        for (int i = 0; i < fLayers.count(); ++i) {
+            if (fLayers[i].fSaveLayerOpID == saveLayerOpID) {
+                return &fLayers[i];
+            }
+        }
+        return NULL;
+    }
+
+    SkCanvas*                       fCanvas;
+    const SkPicture*                fPicture;
+    const SkTArray<HoistedLayer>&   fLayers;
+
+    SkTDArray<unsigned>             fOps;
+    int                             fIndex;
+
+    typedef Draw INHERITED;
+};
+
+bool SkRasterLayerCache::DrawPicture(SkCanvas* canvas, const SkPicture* picture,
+                                     const SkMatrix* matrix) {
+    SkPicture::AccelData::Key key = SkLayerInfo::ComputeKey();
+
+    const SkPicture::AccelData* data = picture->EXPERIMENTAL_getAccelData(key);
+    if (!data) {
+        return false;
+    }
+
+    const SkLayerInfo* layerInfo = static_cast<const SkLayerInfo*>(data);
+    if (0 == layerInfo->numBlocks()) {
+        return false;
+    }
+
+    SkIRect clipIR;
+    if (!canvas->getClipDeviceBounds(&clipIR)) {
+        return false;
+    }
+
+    SkMatrix initialMatrix = canvas->getTotalMatrix();
+    if (matrix) {
+        initialMatrix.preConcat(*matrix);
+    }
+    if (initialMatrix.hasPerspective()) {
+        return false;
+    }
+
+    // Layers are cached at the fractional part of the translation, and drawn offset by the rest.
+    const SkScalar tx = SkScalarFloorToScalar(initialMatrix.getTranslateX());
+    const SkScalar ty = SkScalarFloorToScalar(initialMatrix.getTranslateY());
+    SkMatrix keyMatrix = initialMatrix;
+    keyMatrix.setTranslateX(initialMatrix.getTranslateX() - tx);
+    keyMatrix.setTranslateY(initialMatrix.getTranslateY() - ty);
+    const SkIPoint offset = SkIPoint::Make(SkScalarFloorToInt(tx), SkScalarFloorToInt(ty));
+
+    // One draw only hoists as many layers as fit in half the cache, so a picture with more layers
+    // than that doesn't evict its own layers before the next draw gets to them.  The rest are
+    // drawn as usual.
+    const size_t budget = SkResourceCache::GetTotalByteLimit() / 2;
+    size_t bytesHoisted = 0;
+
+    SkTArray<HoistedLayer> layers;
+
+    for (int i = 0; i < layerInfo->numBlocks(); ++i) {
+        const SkLayerInfo::BlockInfo& info = layerInfo->block(i);
+
+        // Nested layers are drawn as part of their parent, and layers of sub-pictures when the
+        // sub-picture is drawn.  Image filters depend on the clip and are left to the regular
+        // saveLayer path.
+        if (info.fIsNested || info.fPicture || (info.fPaint && info.fPaint->getImageFilter())) {
+            continue;
+        }
+
+        SkIRect srcIR;
+        if (!compute_source_rect(info, keyMatrix, &srcIR) ||
+            !SkIRect::Intersects(srcIR.makeOffset(offset.fX, offset.fY), clipIR)) {
+            continue;
+        }
+        const int64_t bytes = sk_64_mul(srcIR.width(), srcIR.height()) * sizeof(SkPMColor);
+        if (bytes > (int64_t)(budget - bytesHoisted)) {
+            continue;
+        }
+
+        LayerKey layerKey(picture->uniqueID(), i, info, keyMatrix);
+        SkBitmap bitmap;
+        if (!SkResourceCache::Find(layerKey, LayerRec::Finder, &bitmap)) {
+            if (!ReplaceDraw::RenderLayer(picture, info, keyMatrix, srcIR, &bitmap)) {
+                continue;
+            }
+            bitmap.setImmutable();
+            SkResourceCache::Add(SkNEW_ARGS(LayerRec, (layerKey, bitmap)));
+            bitmap.lockPixels();
+        }
+
+        HoistedLayer& layer = layers.push_back();
+        layer.fSaveLayerOpID = SkToU32(info.fSaveLayerOpID);
+        layer.fRestoreOpID = SkToU32(info.fRestoreOpID);
+        layer.fPaint = info.fPaint;
+        layer.fBitmap = bitmap;
+        layer.fOrigin = SkIPoint::Make(srcIR.fLeft + offset.fX, srcIR.fTop + offset.fY);
+        bytesHoisted += (size_t)bytes;
+    }
+
+    {
+        SkAutoCanvasMatrixPaint acmp(canvas, matrix, NULL, picture->cullRect());
+
+        ReplaceDraw draw(canvas, picture, layers);
+        draw.draw();
+    }
+
+    for (int i = 0; i < layers.count(); ++i) {
+        layers[i].fBitmap.unlockPixels();
+    }
+    return true;
+}
+
+void SkRasterLayerCache::PurgePicture(uint32_t pictureID) {
+    SkResourceCache::PostPurgeSharedID(layer_shared_id(pictureID));
+}
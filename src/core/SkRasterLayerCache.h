@@ -0,0 +1,46 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRasterLayerCache_DEFINED
+#define SkRasterLayerCache_DEFINED
+
+#include "SkTypes.h"
+
+class SkCanvas;
+class SkMatrix;
+class SkPicture;
+
+/**
+ *  The raster counterpart of GrLayerHoister and GrLayerCache.
+ *
+ *  For pictures that carry an SkLayerInfo (recorded with a BBH and
+ *  SkPictureRecorder::kComputeSaveLayerInfo_RecordFlag), each top-level saveLayer/restore block
+ *  is rendered once into a bitmap held in SkResourceCache, keyed by the picture's ID, the block's
+ *  op range and the CTM.  Later playbacks composite that bitmap instead of re-rendering the block.
+ *  Only the fractional part of the CTM's translation is part of the key, so a picture that is
+ *  scrolled by whole pixels keeps hitting the cache.
+ */
+class SkRasterLayerCache {
+public:
+    /**
+     *  Draws the picture into the canvas, as SkCanvas::drawPicture() with no paint does, using
+     *  cached bitmaps for the layers that have them.  Returns false, having drawn nothing, if the
+     *  picture has no layer information.
+     */
+    static bool DrawPicture(SkCanvas*, const SkPicture*, const SkMatrix*);
+
+    /**
+     *  Purges the cached layers of the picture.  Called when a picture with layer information is
+     *  deleted.
+     */
+    static void PurgePicture(uint32_t pictureID);
+
+private:
+    class ReplaceDraw;
+};
+
+#endif
@@ -149,9 +149,66 @@ void SkReadBuffer::readRegion(SkRegion* region) {
 }
 
 void SkReadBuffer::readPath(SkPath* path) {
+    if (this->isCompact()) {
+        if (!this->readCompactPath(path)) {
+            // Like SkReader32::readPath(), skip to the end on failure.
+            fReader.skip(fReader.available());
+        }
+        return;
+    }
     fReader.readPath(path);
 }
 
+// See SkWriteBuffer::writeCompactPoints().
+bool SkReadBuffer::readCompactPoints(SkPoint points[], int count) {
+    // Either way the coordinates take 4 bytes each.
+    if (!fReader.isAvailable(sizeof(uint32_t) + count * sizeof(SkPoint))) {
+        return false;
+    }
+    const uint32_t shift = fReader.readU32();
+    if (SkWriteBuffer::kRawPointsGrid == shift) {
+        fReader.read(points, count * sizeof(SkPoint));
+        return true;
+    }
+    if (shift > SkWriteBuffer::kMaxPointGridShift) {
+        return false;
+    }
+
+    const SkScalar invScale = SK_Scalar1 / (1 << shift);
+    const int32_t* deltas = (const int32_t*)fReader.skip(2 * count * sizeof(int32_t));
+    // Accumulate unsigned so bad data can't overflow.
+    uint32_t x = 0, y = 0;
+    for (int i = 0; i < count; ++i) {
+        x += deltas[2 * i + 0];
+        y += deltas[2 * i + 1];
+        points[i].set((int32_t)x * invScale, (int32_t)y * invScale);
+    }
+    return true;
+}
+
+// See SkWriteBuffer::writeCompactPath().
+bool SkReadBuffer::readCompactPath(SkPath* path) {
+    if (!fReader.isAvailable(sizeof(int32_t))) {
+        return false;
+    }
+    const int count = fReader.readInt();
+    // Each coordinate takes at least 4 bytes, so don't allocate for more than there can be.
+    if (count < 0 || (size_t)count > fReader.available() / sizeof(SkPoint)) {
+        return false;
+    }
+    SkAutoSTMalloc<32, SkPoint> pts(count);
+    if (!this->readCompactPoints(pts.get(), count)) {
+        return false;
+    }
+    const size_t size = path->readFromMemoryWithoutPoints(fReader.peek(), fReader.available(),
+                                                          pts.get(), count);
+    if (0 == size) {
+        return false;
+    }
+    (void)fReader.skip(size);
+    return true;
+}
+
 bool SkReadBuffer::readArray(void* value, size_t size, size_t elementSize) {
     const size_t count = this->getArrayCount();
     if (count == size) {
@@ -178,6 +235,18 @@ bool SkReadBuffer::readIntArray(int32_t* values, size_t size) {
 }
 
 bool SkReadBuffer::readPointArray(SkPoint* points, size_t size) {
+    if (this->isCompact()) {
+        const size_t count = this->getArrayCount();
+        if (count == size) {
+            (void)fReader.skip(sizeof(uint32_t)); // Skip array count
+            if (this->readCompactPoints(points, SkToInt(count))) {
+                return true;
+            }
+        }
+        SkASSERT(false);
+        fReader.skip(fReader.available());
+        return false;
+    }
     return readArray(points, size, sizeof(SkPoint));
 }
 
@@ -56,6 +56,7 @@ public:
         kPictureImageFilterResolution_Version = 38,
         kPictureImageFilterLevel_Version   = 39,
         kImageFilterNoUniqueID_Version     = 40,
+        kPathEffectEvaluation_Version      = 43,
     };
 
     /**
@@ -77,6 +78,7 @@ public:
         kScalarIsFloat_Flag = 1 << 1,
         kPtrIs64Bit_Flag    = 1 << 2,
         kValidation_Flag    = 1 << 3,
+        kCompact_Flag       = 1 << 4,   // written with SkWriteBuffer::kCompact_Flag
     };
 
     void setFlags(uint32_t flags) { fFlags = flags; }
@@ -88,6 +90,7 @@ public:
     bool isScalarFloat() const { return SkToBool(fFlags & kScalarIsFloat_Flag); }
     bool isPtr64Bit() const { return SkToBool(fFlags & kPtrIs64Bit_Flag); }
     bool isValidating() const { return SkToBool(fFlags & kValidation_Flag); }
+    bool isCompact() const { return SkToBool(fFlags & kCompact_Flag); }
 
     SkReader32* getReader32() { return &fReader; }
 
@@ -217,6 +220,8 @@ protected:
 
 private:
     bool readArray(void* value, size_t size, size_t elementSize);
+    bool readCompactPoints(SkPoint points[], int count);
+    bool readCompactPath(SkPath*);
 
     uint32_t fFlags;
     int fVersion;
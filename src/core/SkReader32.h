@@ -135,6 +135,12 @@ public:
      */
     size_t readIntoString(SkString* copy);
 
+    /**
+     *  Unpack srcSize bytes written by SkWriter32::Pack() into dst, which must hold exactly the
+     *  dstSize bytes that were packed. Returns false if src is malformed or the wrong size.
+     */
+    static bool Unpack(const void* src, size_t srcSize, void* dst, size_t dstSize);
+
 private:
     template <typename T> bool readObjectFromMemory(T* obj) {
         size_t size = obj->readFromMemory(this->peek(), this->available());
@@ -52,6 +52,16 @@ public:
         SkDEBUGFAIL("How did I get here?");
     }
 
+    /// The real blitter's row limits, in supersampled coordinates.
+    bool getRowLimits(int* top, int* bottom) const override {
+        if (!fRealBlitter->getRowLimits(top, bottom)) {
+            return false;
+        }
+        *top <<= SHIFT;
+        *bottom <<= SHIFT;
+        return true;
+    }
+
 protected:
     SkBlitter*  fRealBlitter;
     /// Current y coordinate, in destination coordinates.
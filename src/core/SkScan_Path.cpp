@@ -96,8 +96,9 @@ typedef void (*PrePostProc)(SkBlitter* blitter, int y, bool isStartOfScanline);
 #define PREPOST_START   true
 #define PREPOST_END     false
 
+// Rows above blit_y are walked, to step the edges down to it, but not blitted.
 static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
-                       SkBlitter* blitter, int start_y, int stop_y,
+                       SkBlitter* blitter, int start_y, int blit_y, int stop_y,
                        PrePostProc proc, int rightClip) {
     validate_sort(prevHead->fNext);
 
@@ -105,6 +106,14 @@ static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
     // returns 1 for evenodd, -1 for winding, regardless of inverse-ness
     int windingMask = (fillType & 1) ? 1 : -1;
 
+    SkNullBlitter   nullBlitter;
+    SkBlitter*      rowBlitter = blitter;
+    PrePostProc     rowProc = proc;
+    if (curr_y < blit_y) {
+        rowBlitter = &nullBlitter;
+        rowProc = NULL;
+    }
+
     for (;;) {
         int     w = 0;
         int     left SK_INIT_TO_AVOID_WARNING;
@@ -114,8 +123,12 @@ static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
 
         validate_edges_for_y(currE, curr_y);
 
-        if (proc) {
-            proc(blitter, curr_y, PREPOST_START);    // pre-proc
+        if (curr_y == blit_y) {
+            rowBlitter = blitter;
+            rowProc = proc;
+        }
+        if (rowProc) {
+            rowProc(rowBlitter, curr_y, PREPOST_START);    // pre-proc
         }
 
         while (currE->fFirstY <= curr_y) {
@@ -128,7 +141,7 @@ static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
                 int width = x - left;
                 SkASSERT(width >= 0);
                 if (width)
-                    blitter->blitH(left, curr_y, width);
+                    rowBlitter->blitH(left, curr_y, width);
                 in_interval = false;
             } else if (!in_interval) {
                 left = x;
@@ -172,12 +185,12 @@ static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
         if (in_interval) {
             int width = rightClip - left;
             if (width > 0) {
-                blitter->blitH(left, curr_y, width);
+                rowBlitter->blitH(left, curr_y, width);
             }
         }
 
-        if (proc) {
-            proc(blitter, curr_y, PREPOST_END);    // post-proc
+        if (rowProc) {
+            rowProc(rowBlitter, curr_y, PREPOST_END);    // post-proc
         }
 
         curr_y += 1;
@@ -209,8 +222,9 @@ static bool update_edge(SkEdge* edge, int last_y) {
     return false;
 }
 
+// As with walk_edges(), rows above blit_y are walked but not blitted.
 static void walk_convex_edges(SkEdge* prevHead, SkPath::FillType,
-                              SkBlitter* blitter, int start_y, int stop_y,
+                              SkBlitter* blitter, int start_y, int blit_y, int stop_y,
                               PrePostProc proc) {
     validate_sort(prevHead->fNext);
 
@@ -227,6 +241,9 @@ static void walk_convex_edges(SkEdge* prevHead, SkPath::FillType,
     int local_top = SkMax32(leftE->fFirstY, riteE->fFirstY);
 #endif
     SkASSERT(local_top >= start_y);
+    if (local_top >= stop_y) {
+        return;     // the blitter only takes rows above the path
+    }
 
     for (;;) {
         SkASSERT(leftE->fFirstY <= stop_y);
@@ -250,16 +267,16 @@ static void walk_convex_edges(SkEdge* prevHead, SkPath::FillType,
         if (0 == (dLeft | dRite)) {
             int L = SkFixedRoundToInt(left);
             int R = SkFixedRoundToInt(rite);
-            if (L < R) {
-                count += 1;
-                blitter->blitRect(L, local_top, R - L, count);
+            int top = SkMax32(local_top, blit_y);
+            if (L < R && top <= local_bot) {
+                blitter->blitRect(L, top, R - L, local_bot - top + 1);
             }
             local_top = local_bot + 1;
         } else {
             do {
                 int L = SkFixedRoundToInt(left);
                 int R = SkFixedRoundToInt(rite);
-                if (L < R) {
+                if (L < R && local_top >= blit_y) {
                     blitter->blitH(L, local_top, R - L);
                 }
                 left += dLeft;
@@ -459,6 +476,18 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
         stop_y = clipRect->fBottom;
     }
 
+    // A blitter that takes only some rows is only given those. The edges are still built
+    // against the whole clip and walked down from the top, so those rows come out the same.
+    int blit_y = start_y;
+    int blitTop, blitBottom;
+    if (blitter->getRowLimits(&blitTop, &blitBottom)) {
+        blit_y = SkMax32(blit_y, blitTop);
+        stop_y = SkMin32(stop_y, blitBottom);
+        if (blit_y >= stop_y) {
+            return;
+        }
+    }
+
     InverseBlitter  ib;
     PrePostProc     proc = NULL;
 
@@ -470,7 +499,8 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
 
     if (path.isConvex() && (NULL == proc)) {
         SkASSERT(count >= 2);   // convex walker does not handle missing right edges
-        walk_convex_edges(&headEdge, path.getFillType(), blitter, start_y, stop_y, NULL);
+        walk_convex_edges(&headEdge, path.getFillType(), blitter, start_y, blit_y, stop_y,
+                          NULL);
     } else {
         int rightEdge;
         if (clipRect) {
@@ -479,7 +509,8 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
             rightEdge = SkScalarRoundToInt(path.getBounds().right()) << shiftEdgesUp;
         }
         
-        walk_edges(&headEdge, path.getFillType(), blitter, start_y, stop_y, proc, rightEdge);
+        walk_edges(&headEdge, path.getFillType(), blitter, start_y, blit_y, stop_y, proc,
+                   rightEdge);
     }
 }
 
@@ -673,8 +704,9 @@ static void sk_fill_triangle(const SkPoint pts[], const SkIRect* clipRect,
     if (clipRect && start_y < clipRect->fTop) {
         start_y = clipRect->fTop;
     }
-    walk_convex_edges(&headEdge, SkPath::kEvenOdd_FillType, blitter, start_y, stop_y, NULL);
-//    walk_edges(&headEdge, SkPath::kEvenOdd_FillType, blitter, start_y, stop_y, NULL);
+    walk_convex_edges(&headEdge, SkPath::kEvenOdd_FillType, blitter, start_y, start_y, stop_y,
+                      NULL);
+//    walk_edges(&headEdge, SkPath::kEvenOdd_FillType, blitter, start_y, start_y, stop_y, NULL);
 }
 
 void SkScan::FillTriangle(const SkPoint pts[], const SkRasterClip& clip,
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkLZ4.h"
+#include "SkStreamCodec.h"
+#include "SkThread.h"
+
+// Registered factories, indexed by type.
+static const uint32_t kMaxType = SkStreamCodec::kFlate_Type;
+SK_DECLARE_STATIC_MUTEX(gRegisterMutex);
+static SkStreamCodec::CompressorFactory   gCompressors[kMaxType + 1];
+static SkStreamCodec::DecompressorFactory gDecompressors[kMaxType + 1];
+
+void SkStreamCodec::Register(Type type, CompressorFactory compressor,
+                             DecompressorFactory decompressor) {
+    SkASSERT(kLZ4_Type != type && (uint32_t)type <= kMaxType);
+    SkAutoMutexAcquire lock(gRegisterMutex);
+    gCompressors[type] = compressor;
+    gDecompressors[type] = decompressor;
+}
+
+SkWStream* SkStreamCodec::NewCompressor(uint32_t type, SkWStream* dst) {
+    if (kLZ4_Type == type) {
+        return SkNEW_ARGS(SkLZ4WStream, (dst));
+    }
+    CompressorFactory factory = NULL;
+    if (type <= kMaxType) {
+        SkAutoMutexAcquire lock(gRegisterMutex);
+        factory = gCompressors[type];
+    }
+    return factory ? factory(dst) : NULL;
+}
+
+SkStream* SkStreamCodec::NewDecompressor(uint32_t type, SkStream* src) {
+    if (kLZ4_Type == type) {
+        return SkNEW_ARGS(SkLZ4Stream, (src));
+    }
+    DecompressorFactory factory = NULL;
+    if (type <= kMaxType) {
+        SkAutoMutexAcquire lock(gRegisterMutex);
+        factory = gDecompressors[type];
+    }
+    return factory ? factory(src) : NULL;
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStreamCodec_DEFINED
+#define SkStreamCodec_DEFINED
+
+#include "SkStream.h"
+
+/**
+ *  Whole-stream compression, as used by SkPicture::serialize().  SkLZ4 is built in.  Codecs that
+ *  live outside core (SkFlate, which needs zlib) are only available once they are registered,
+ *  e.g. by SkFlate::RegisterStreamCodec().
+ */
+class SkStreamCodec {
+public:
+    // These values are stored in files, so don't renumber them.
+    enum Type {
+        kLZ4_Type   = 1,
+        kFlate_Type = 2,
+    };
+
+    /**
+     *  Returns a stream that compresses what is written to it into dst, or NULL if the codec
+     *  isn't available.  Deleting the returned stream finishes the compressed data.  dst is not
+     *  owned and must outlive it.
+     */
+    static SkWStream* NewCompressor(uint32_t type, SkWStream* dst);
+
+    /**
+     *  Returns a stream that decompresses src as it is read, or NULL if the codec isn't
+     *  available.  src is not owned and must outlive it.
+     */
+    static SkStream* NewDecompressor(uint32_t type, SkStream* src);
+
+    typedef SkWStream* (*CompressorFactory)(SkWStream* dst);
+    typedef SkStream*  (*DecompressorFactory)(SkStream* src);
+
+    /**
+     *  Makes a codec from outside core available to NewCompressor() and NewDecompressor().
+     *  Registering a type again replaces its factories.  This is an explicit call rather than a
+     *  static initializer so that the codec is not dropped when linking with a static library.
+     */
+    static void Register(Type type, CompressorFactory, DecompressorFactory);
+};
+
+#endif
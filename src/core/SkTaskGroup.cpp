@@ -45,6 +45,10 @@ public:
         gGlobal->batch(fn, args, N, stride, pending);
     }
 
+    static int ThreadCount() {
+        return gGlobal ? gGlobal->fThreads.count() : 0;
+    }
+
     static void Wait(int32_t* pending) {
         if (!gGlobal) {  // If we have no threads, the work must already be done.
             SkASSERT(*pending == 0);
@@ -177,6 +181,7 @@ SkTaskGroup::Enabler::~Enabler() {
 SkTaskGroup::SkTaskGroup() : fPending(0) {}
 
 void SkTaskGroup::wait()                            { ThreadPool::Wait(&fPending); }
+int SkTaskGroup::ThreadCount()                      { return ThreadPool::ThreadCount(); }
 void SkTaskGroup::add(SkRunnable* task)             { ThreadPool::Add(task, &fPending); }
 void SkTaskGroup::add(void (*fn)(void*), void* arg) { ThreadPool::Add(fn, arg, &fPending); }
 void SkTaskGroup::batch (void (*fn)(void*), void* args, int N, size_t stride) {
@@ -39,6 +39,9 @@ public:
     // You may safely reuse this SkTaskGroup after wait() returns.
     void wait();
 
+    // How many threads SkTaskGroups run tasks on.  0 means they run on the caller's thread.
+    static int ThreadCount();
+
 private:
     typedef void(*void_fn)(void*);
 
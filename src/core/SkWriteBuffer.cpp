@@ -10,6 +10,7 @@
 #include "SkBitmap.h"
 #include "SkBitmapHeap.h"
 #include "SkData.h"
+#include "SkFloatBits.h"
 #include "SkPixelRef.h"
 #include "SkPtrRecorder.h"
 #include "SkStream.h"
@@ -106,6 +107,10 @@ void SkWriteBuffer::writePoint(const SkPoint& point) {
 
 void SkWriteBuffer::writePointArray(const SkPoint* point, uint32_t count) {
     fWriter.write32(count);
+    if (this->isCompact()) {
+        (void)this->writeCompactPoints(point, count);
+        return;
+    }
     fWriter.write(point, count * sizeof(SkPoint));
 }
 
@@ -126,9 +131,95 @@ void SkWriteBuffer::writeRegion(const SkRegion& region) {
 }
 
 void SkWriteBuffer::writePath(const SkPath& path) {
+    if (this->isCompact()) {
+        this->writeCompactPath(path);
+        return;
+    }
     fWriter.writePath(path);
 }
 
+// Grid coordinates stay below this so they convert to float and back exactly.
+static const SkScalar kMaxGridCoord = SkIntToScalar(1 << 24);
+
+// Returns true if every coordinate, scaled by 2^shift, is in range and, unless we're allowed to
+// snap it, lands exactly on an integer.
+static bool fits_grid(const SkScalar coords[], int count, int shift, bool snap) {
+    const SkScalar scale = SkIntToScalar(1 << shift);
+    for (int i = 0; i < count; ++i) {
+        const SkScalar scaled = coords[i] * scale;
+        if (!(SkScalarAbs(scaled) < kMaxGridCoord)) {   // also rejects NaN
+            return false;
+        }
+        // Comparing bits catches fractions and -0 alike.
+        if (!snap && SkFloat2Bits(SkScalarRoundToInt(scaled) / scale) != SkFloat2Bits(coords[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ *  Compact points are a grid word followed by the coordinates. If they all sit on one
+ *  power-of-two grid (or we snap them to one) the grid word is its shift and each point is stored
+ *  as the int delta from the previous one in grid units, which SkWriter32::Pack() turns into a byte
+ *  or two per coordinate. Otherwise the grid word is kRawPointsGrid and the floats follow as-is.
+ *
+ *  Returns true if the points had to be snapped.
+ */
+bool SkWriteBuffer::writeCompactPoints(const SkPoint src[], int count) {
+    const SkScalar* coords = &src[0].fX;
+    const bool snap = SkToBool(fFlags & kQuantizePoints_Flag);
+
+    // Use the coarsest grid that's exact, snapping only if there isn't one at our precision.
+    const int maxShift = snap ? kQuantizePointGridShift : kMaxPointGridShift;
+    int shift = kRawPointsGrid;
+    for (int s = 0; s <= maxShift; ++s) {
+        if (fits_grid(coords, 2 * count, s, false)) {
+            shift = s;
+            break;
+        }
+    }
+    bool snapped = false;
+    if (kRawPointsGrid == shift && snap &&
+        fits_grid(coords, 2 * count, kQuantizePointGridShift, true)) {
+        shift = kQuantizePointGridShift;
+        snapped = true;
+    }
+
+    fWriter.write32(shift);
+    if (kRawPointsGrid == shift) {
+        fWriter.write(src, count * sizeof(SkPoint));
+        return false;
+    }
+
+    const SkScalar scale = SkIntToScalar(1 << shift);
+    int32_t* deltas = (int32_t*)fWriter.reserve(2 * count * sizeof(int32_t));
+    int32_t prevX = 0, prevY = 0;
+    for (int i = 0; i < count; ++i) {
+        const int32_t x = SkScalarRoundToInt(src[i].fX * scale),
+                      y = SkScalarRoundToInt(src[i].fY * scale);
+        deltas[2 * i + 0] = x - prevX;
+        deltas[2 * i + 1] = y - prevY;
+        prevX = x;
+        prevY = y;
+    }
+    return snapped;
+}
+
+// A compact path is its point count and compact points, then the rest of the path as written by
+// SkPath::writeToMemoryWithoutPoints().
+void SkWriteBuffer::writeCompactPath(const SkPath& path) {
+    const int count = path.countPoints();
+    SkAutoSTMalloc<32, SkPoint> pts(count);
+    path.getPoints(pts.get(), count);
+    fWriter.write32(count);
+    const bool snapped = this->writeCompactPoints(pts.get(), count);
+
+    const size_t size = path.writeToMemoryWithoutPoints(NULL, snapped);
+    SkASSERT(SkAlign4(size) == size);
+    path.writeToMemoryWithoutPoints(fWriter.reserve(size), snapped);
+}
+
 size_t SkWriteBuffer::writeStream(SkStream* stream, size_t length) {
     fWriter.write32(SkToU32(length));
     size_t bytesWritten = fWriter.readFromStream(stream, length);
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkFloatBits.h"
 #include "SkReader32.h"
 #include "SkString.h"
 #include "SkWriter32.h"
@@ -79,3 +80,214 @@ void SkWriter32::growToAtLeast(size_t size) {
 SkData* SkWriter32::snapshotAsData() const {
     return SkData::NewWithCopy(fData, fUsed);
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ *  Packed words come in groups of (up to) four, each led by a byte of 2-bit tags, first word in
+ *  the low bits, saying how that word was stored. The varints are little-endian base-128.
+ *
+ *  A full group of raw words (tag byte 0xFF) is followed by a count of further raw groups that
+ *  come without tag bytes, so incompressible data like pixels barely grows.
+ */
+enum PackTag {
+    kInt_PackTag,           // zigzag varint of the word as an int32
+    kIntFloat_PackTag,      // float with an integer value: zigzag varint of that value
+    kGridFloat_PackTag,     // float on the 1/16 grid: zigzag varint of 16x its value
+    kRaw_PackTag,           // the word's 4 bytes
+};
+
+static const int kPackGridShift = 4;
+static const uint8_t kRawGroupTags = 0xFF;
+static const int kMaxRawGroupRun = 0xFF;
+// A 4 byte varint is no smaller than the raw word, so we stop at 3.
+static const int kMaxPackedVarintBytes = 3;
+static const uint32_t kMaxPackedVarint = 1 << (7 * kMaxPackedVarintBytes);
+
+static inline uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static inline float grid_to_float(int32_t value, int shift) {
+    return (float)value * (1.0f / (1 << shift));
+}
+
+// Returns true if word is a float that is exactly n / 2^shift for an n that packs small.
+// This works on the bits directly; it's the hot path for random floats.
+static bool pack_float(uint32_t word, int shift, uint32_t* packed) {
+    // With exponent e, the value times 2^shift is an integer iff the mantissa (with its implicit
+    // 1) has no bits set below 2^(23 - e - shift). We want 1 <= |n| < 2^20 so its zigzag takes
+    // at most 3 bytes; 0 is caught as an int, and -0 and denormals have no n.
+    const int e = (int)((word >> 23) & 0xFF) - 127 + shift;
+    if (e < 0 || e >= 7 * kMaxPackedVarintBytes - 1) {
+        return false;
+    }
+    const int lowBits = 23 - e;
+    const uint32_t mantissa = (word & 0x7FFFFF) | 0x800000;
+    if (mantissa & ((1 << lowBits) - 1)) {
+        return false;
+    }
+    const int32_t n = (int32_t)(mantissa >> lowBits);
+    *packed = zigzag((word >> 31) ? -n : n);
+    SkASSERT((uint32_t)SkFloat2Bits(grid_to_float(unzigzag(*packed), shift)) == word);
+    return true;
+}
+
+// Classifies word and sets *packed to its varint, if it has one.
+static PackTag pack_word(uint32_t word, uint32_t* packed) {
+    *packed = zigzag((int32_t)word);
+    if (*packed < kMaxPackedVarint) {
+        return kInt_PackTag;
+    }
+    if (pack_float(word, 0, packed)) {
+        return kIntFloat_PackTag;
+    }
+    if (pack_float(word, kPackGridShift, packed)) {
+        return kGridFloat_PackTag;
+    }
+    return kRaw_PackTag;
+}
+
+static inline uint32_t load_word(const char* words, size_t index) {
+    uint32_t word;
+    memcpy(&word, words + index * sizeof(word), sizeof(word));
+    return word;
+}
+
+size_t SkWriter32::Pack(const void* src, size_t size, void* dst) {
+    SkASSERT(SkAlign4(size) == size);
+    const char* words = (const char*)src;
+    const size_t count = size >> 2;
+    uint8_t* out = (uint8_t*)dst;
+
+    size_t i = 0;
+    while (i < count) {
+        const size_t n = SkTMin<size_t>(4, count - i);
+        PackTag tags[4];
+        uint32_t packed[4];
+        uint8_t tagByte = 0;
+        for (size_t j = 0; j < n; ++j) {
+            tags[j] = pack_word(load_word(words, i + j), &packed[j]);
+            tagByte |= tags[j] << (2 * j);
+        }
+        *out++ = tagByte;
+
+        if (kRawGroupTags == tagByte) {
+            // See how many more whole groups are raw too, and copy them all at once.
+            size_t groups = 1;
+            while (groups <= kMaxRawGroupRun && i + 4 * (groups + 1) <= count) {
+                uint32_t unused;
+                size_t j = 0;
+                while (j < 4 && kRaw_PackTag == pack_word(load_word(words, i + 4 * groups + j),
+                                                          &unused)) {
+                    ++j;
+                }
+                if (j < 4) {
+                    break;
+                }
+                ++groups;
+            }
+            *out++ = SkToU8(groups - 1);
+            memcpy(out, words + i * sizeof(uint32_t), groups * 4 * sizeof(uint32_t));
+            out += groups * 4 * sizeof(uint32_t);
+            i += groups * 4;
+            continue;
+        }
+
+        for (size_t j = 0; j < n; ++j) {
+            if (kRaw_PackTag == tags[j]) {
+                memcpy(out, words + (i + j) * sizeof(uint32_t), sizeof(uint32_t));
+                out += sizeof(uint32_t);
+            } else {
+                uint32_t value = packed[j];
+                while (value >= 0x80) {
+                    *out++ = (uint8_t)(value | 0x80);
+                    value >>= 7;
+                }
+                *out++ = (uint8_t)value;
+            }
+        }
+        i += n;
+    }
+    SkASSERT((size_t)(out - (uint8_t*)dst) <= PackedSizeBound(size));
+    return out - (uint8_t*)dst;
+}
+
+bool SkReader32::Unpack(const void* src, size_t srcSize, void* dst, size_t dstSize) {
+    if (SkAlign4(dstSize) != dstSize) {
+        return false;
+    }
+    const uint8_t* in = (const uint8_t*)src;
+    const uint8_t* stop = in + srcSize;
+    char* out = (char*)dst;
+    const size_t count = dstSize >> 2;
+
+    size_t i = 0;
+    while (i < count) {
+        if (in >= stop) {
+            return false;
+        }
+        const unsigned tags = *in++;
+        const size_t n = SkTMin<size_t>(4, count - i);
+
+        if (kRawGroupTags == tags) {
+            if (in >= stop) {
+                return false;
+            }
+            const size_t words = (1 + *in++) * 4;
+            const size_t bytes = words * sizeof(uint32_t);
+            if (words > count - i || (size_t)(stop - in) < bytes) {
+                return false;
+            }
+            memcpy(out, in, bytes);
+            in += bytes;
+            out += bytes;
+            i += words;
+            continue;
+        }
+
+        for (size_t j = 0; j < n; ++j) {
+            const unsigned tag = (tags >> (2 * j)) & 3;
+            uint32_t word;
+            if (kRaw_PackTag == tag) {
+                if (stop - in < (ptrdiff_t)sizeof(word)) {
+                    return false;
+                }
+                memcpy(&word, in, sizeof(word));
+                in += sizeof(word);
+            } else {
+                uint32_t packed = 0;
+                for (int shift = 0; ; shift += 7) {
+                    if (in >= stop || shift >= 7 * kMaxPackedVarintBytes) {
+                        return false;
+                    }
+                    const uint8_t byte = *in++;
+                    packed |= (uint32_t)(byte & 0x7F) << shift;
+                    if (!(byte & 0x80)) {
+                        break;
+                    }
+                }
+                const int32_t value = unzigzag(packed);
+                switch (tag) {
+                    case kInt_PackTag:
+                        word = value;
+                        break;
+                    case kIntFloat_PackTag:
+                        word = SkFloat2Bits(grid_to_float(value, 0));
+                        break;
+                    default:
+                        word = SkFloat2Bits(grid_to_float(value, kPackGridShift));
+                        break;
+                }
+            }
+            memcpy(out, &word, sizeof(word));
+            out += sizeof(word);
+        }
+        i += n;
+    }
+    return in == stop;
+}
@@ -32,7 +32,7 @@ bool Sk1DPathEffect::filterPath(SkPath* dst, const SkPath& src,
 ///////////////////////////////////////////////////////////////////////////////
 
 SkPath1DPathEffect::SkPath1DPathEffect(const SkPath& path, SkScalar advance,
-    SkScalar phase, Style style) : fPath(path)
+    SkScalar phase, Style style, Evaluation evaluation) : fPath(path), fEvaluation(evaluation)
 {
     if (advance <= 0 || path.isEmpty()) {
         SkDEBUGF(("SkPath1DPathEffect can't use advance <= 0\n"));
@@ -78,6 +78,36 @@ bool SkPath1DPathEffect::filterPath(SkPath* dst, const SkPath& src,
     return false;
 }
 
+bool SkPath1DPathEffect::asStamps(StampData* results, const SkPath& src,
+                                  const SkStrokeRec&, const SkRect*) const {
+    if (kStamp_Evaluation != fEvaluation || fAdvance <= 0 ||
+        (kTranslate_Style != fStyle && kRotate_Style != fStyle)) {
+        return false;
+    }
+    if (NULL == results) {
+        return true;
+    }
+
+    // The same walk as Sk1DPathEffect::filterPath() and next().
+    const bool rotate = kRotate_Style == fStyle;
+    results->fStamp = fPath;
+    SkPathMeasure meas(src, false);
+    do {
+        const SkScalar length = meas.getLength();
+        for (SkScalar distance = fInitialOffset; distance < length; distance += fAdvance) {
+            SkPoint pos;
+            SkVector tangent;
+            if (meas.getPosTan(distance, &pos, rotate ? &tangent : NULL)) {
+                *results->fPositions.append() = pos;
+                if (rotate) {
+                    *results->fTangents.append() = tangent;
+                }
+            }
+        }
+    } while (meas.nextContour());
+    return true;
+}
+
 static bool morphpoints(SkPoint dst[], const SkPoint src[], int count,
                         SkPathMeasure& meas, SkScalar dist) {
     for (int i = 0; i < count; i++) {
@@ -158,7 +188,12 @@ SkFlattenable* SkPath1DPathEffect::CreateProc(SkReadBuffer& buffer) {
         buffer.readPath(&path);
         SkScalar phase = buffer.readScalar();
         Style style = (Style)buffer.readUInt();
-        return SkPath1DPathEffect::Create(path, advance, phase, style);
+        Evaluation evaluation = kGeometry_Evaluation;
+        if (!buffer.isVersionLT(SkReadBuffer::kPathEffectEvaluation_Version) &&
+                kStamp_Evaluation == buffer.readUInt()) {
+            evaluation = kStamp_Evaluation;
+        }
+        return SkPath1DPathEffect::Create(path, advance, phase, style, evaluation);
     }
     return NULL;
 }
@@ -169,6 +204,7 @@ void SkPath1DPathEffect::flatten(SkWriteBuffer& buffer) const {
         buffer.writePath(fPath);
         buffer.writeScalar(fInitialOffset);
         buffer.writeUInt(fStyle);
+        buffer.writeUInt(fEvaluation);
     }
 }
 
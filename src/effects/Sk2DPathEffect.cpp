@@ -8,15 +8,25 @@
 
 
 #include "Sk2DPathEffect.h"
+#include "SkCanvas.h"
+#include "SkPictureRecorder.h"
 #include "SkReadBuffer.h"
+#include "SkShader.h"
 #include "SkWriteBuffer.h"
 #include "SkPath.h"
 #include "SkRegion.h"
 
-Sk2DPathEffect::Sk2DPathEffect(const SkMatrix& mat) : fMatrix(mat) {
+Sk2DPathEffect::Sk2DPathEffect(const SkMatrix& mat, Evaluation evaluation)
+    : fMatrix(mat)
+    , fEvaluation(evaluation)
+    , fTilePicture(NULL) {
     fMatrixIsInvertible = mat.invert(&fInverse);
 }
 
+Sk2DPathEffect::~Sk2DPathEffect() {
+    SkSafeUnref(fTilePicture);
+}
+
 bool Sk2DPathEffect::filterPath(SkPath* dst, const SkPath& src,
                                 SkStrokeRec*, const SkRect*) const {
     if (!fMatrixIsInvertible) {
@@ -62,6 +72,109 @@ void Sk2DPathEffect::nextSpan(int x, int y, int count, SkPath* path) const {
     } while (--count > 0);
 }
 
+// A tile only pays off when there are many cells, and each is big enough to draw into one.
+static const SkScalar kMinTileCellSize = 4;
+static const SkScalar kMaxTileCellArea = 256 * 256;
+// How many cells away a stamp may start and still reach into a tile.
+static const int kMaxTileReach = 4;
+
+SkShader* Sk2DPathEffect::refTileShader(const SkPaint& paint, const SkMatrix& ctm) const {
+    if (kTile_Evaluation != fEvaluation || !fMatrixIsInvertible ||
+        fMatrix.hasPerspective() || ctm.hasPerspective()) {
+        return NULL;
+    }
+
+    SkMatrix cellToDevice;
+    cellToDevice.setConcat(ctm, fMatrix);
+    SkVector axes[2] = { { SK_Scalar1, 0 }, { 0, SK_Scalar1 } };
+    cellToDevice.mapVectors(axes, 2);
+    const SkScalar width = axes[0].length();
+    const SkScalar height = axes[1].length();
+    if (!(width >= kMinTileCellSize && height >= kMinTileCellSize) ||
+        width * height > kMaxTileCellArea) {
+        return NULL;
+    }
+
+    SkAutoTUnref<const SkPicture> tile(this->refTilePicture(paint));
+    if (NULL == tile) {
+        return NULL;
+    }
+    const SkRect cell = SkRect::MakeWH(SK_Scalar1, SK_Scalar1);
+    return SkShader::CreatePictureShader(tile, SkShader::kRepeat_TileMode,
+                                         SkShader::kRepeat_TileMode, &fMatrix, &cell);
+}
+
+static bool same_tile_paint(const SkPaint& a, const SkPaint& b) {
+    return a.getColor() == b.getColor() &&
+           a.isAntiAlias() == b.isAntiAlias() &&
+           SkStrokeRec(a) == SkStrokeRec(b);
+}
+
+const SkPicture* Sk2DPathEffect::refTilePicture(const SkPaint& origPaint) const {
+    // The tile is opaque: the paint's alpha is applied when it is drawn.
+    SkPaint paint(origPaint);
+    paint.setAlpha(0xFF);
+
+    SkAutoMutexAcquire lock(fTileMutex);
+    if (fTilePicture && same_tile_paint(paint, fTilePaint)) {
+        return SkRef(fTilePicture);
+    }
+
+    // Run the effect over a block of cells around cell (0, 0), growing it until it includes
+    // every cell whose stamp reaches into (0, 0).  The padding covers antialiasing and hairlines,
+    // a device pixel at the smallest cell size.
+    const SkScalar pad = SK_Scalar1 / kMinTileCellSize;
+    SkPath stamps;
+    SkStrokeRec rec(paint);
+    for (int reach = 1;;) {
+        const SkRect block = SkRect::MakeLTRB(SkIntToScalar(-reach), SkIntToScalar(-reach),
+                                              SkIntToScalar(reach + 1), SkIntToScalar(reach + 1));
+        SkPath src;
+        src.addRect(block);
+        src.transform(fMatrix);
+
+        stamps.reset();
+        rec = SkStrokeRec(paint);
+        if (!this->filterPath(&stamps, src, &rec, NULL)) {
+            return NULL;
+        }
+        rec.applyToPath(&stamps, stamps);
+
+        SkPath latticeStamps;
+        stamps.transform(fInverse, &latticeStamps);
+        const SkRect& bounds = latticeStamps.getBounds();
+        const SkScalar overhang = SkTMax(SkTMax(block.fLeft - bounds.fLeft,
+                                                bounds.fRight - block.fRight),
+                                         SkTMax(block.fTop - bounds.fTop,
+                                                bounds.fBottom - block.fBottom));
+        const int needed = SkTMax(1, SkScalarCeilToInt(overhang + pad));
+        if (needed <= reach) {
+            break;
+        }
+        if (needed > kMaxTileReach) {
+            return NULL;
+        }
+        reach = needed;
+    }
+
+    SkPaint tilePaint;
+    tilePaint.setColor(paint.getColor());
+    tilePaint.setAntiAlias(paint.isAntiAlias());
+    if (rec.isHairlineStyle()) {
+        tilePaint.setStyle(SkPaint::kStroke_Style);
+    }
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(SK_Scalar1, SK_Scalar1));
+    canvas->concat(fInverse);
+    canvas->drawPath(stamps, tilePaint);
+
+    SkSafeUnref(fTilePicture);
+    fTilePicture = recorder.endRecording();
+    fTilePaint = paint;
+    return SkSafeRef(fTilePicture);
+}
+
 void Sk2DPathEffect::begin(const SkIRect& uvBounds, SkPath* dst) const {}
 void Sk2DPathEffect::next(const SkPoint& loc, int u, int v, SkPath* dst) const {}
 void Sk2DPathEffect::end(SkPath* dst) const {}
@@ -106,16 +219,26 @@ void SkLine2DPathEffect::nextSpan(int u, int v, int ucount, SkPath* dst) const {
     }
 }
 
+static Sk2DPathEffect::Evaluation read_evaluation(SkReadBuffer& buffer) {
+    if (buffer.isVersionLT(SkReadBuffer::kPathEffectEvaluation_Version)) {
+        return Sk2DPathEffect::kGeometry_Evaluation;
+    }
+    return Sk2DPathEffect::kTile_Evaluation == buffer.readUInt() ?
+            Sk2DPathEffect::kTile_Evaluation : Sk2DPathEffect::kGeometry_Evaluation;
+}
+
 SkFlattenable* SkLine2DPathEffect::CreateProc(SkReadBuffer& buffer) {
     SkMatrix matrix;
     buffer.readMatrix(&matrix);
     SkScalar width = buffer.readScalar();
-    return SkLine2DPathEffect::Create(width, matrix);
+    Evaluation evaluation = read_evaluation(buffer);
+    return SkLine2DPathEffect::Create(width, matrix, evaluation);
 }
 
 void SkLine2DPathEffect::flatten(SkWriteBuffer &buffer) const {
     buffer.writeMatrix(this->getMatrix());
     buffer.writeScalar(fWidth);
+    buffer.writeUInt(this->getEvaluation());
 }
 
 
@@ -130,8 +253,8 @@ void SkLine2DPathEffect::toString(SkString* str) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-SkPath2DPathEffect::SkPath2DPathEffect(const SkMatrix& m, const SkPath& p)
-    : INHERITED(m), fPath(p) {
+SkPath2DPathEffect::SkPath2DPathEffect(const SkMatrix& m, const SkPath& p, Evaluation evaluation)
+    : INHERITED(m, evaluation), fPath(p) {
 }
 
 SkFlattenable* SkPath2DPathEffect::CreateProc(SkReadBuffer& buffer) {
@@ -139,12 +262,14 @@ SkFlattenable* SkPath2DPathEffect::CreateProc(SkReadBuffer& buffer) {
     buffer.readMatrix(&matrix);
     SkPath path;
     buffer.readPath(&path);
-    return SkPath2DPathEffect::Create(matrix, path);
+    Evaluation evaluation = read_evaluation(buffer);
+    return SkPath2DPathEffect::Create(matrix, path, evaluation);
 }
 
 void SkPath2DPathEffect::flatten(SkWriteBuffer& buffer) const {
     buffer.writeMatrix(this->getMatrix());
     buffer.writePath(fPath);
+    buffer.writeUInt(this->getEvaluation());
 }
 
 void SkPath2DPathEffect::next(const SkPoint& loc, int u, int v,
@@ -12,6 +12,7 @@
 #include "SkWriteBuffer.h"
 #include "SkRect.h"
 #include "SkMorphology_opts.h"
+#include "SkTaskGroup.h"
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
 #include "GrInvariantOutput.h"
@@ -38,6 +39,75 @@ enum MorphDirection {
     kX, kY
 };
 
+// Below these radii the direct loop over the window is faster than the van Herk/Gil-Werman
+// setup (see MorphologyBench).  The direct loop walks across lines in the inner loop, which is
+// especially slow for the X pass.
+static const int kMinVanHerkRadiusX = 1;
+static const int kMinVanHerkRadiusY = 8;
+
+static inline SkPMColor max_pmcolor(SkPMColor c0, SkPMColor c1) {
+    return SkPackARGB32(SkMax32(SkGetPackedA32(c0), SkGetPackedA32(c1)),
+                        SkMax32(SkGetPackedR32(c0), SkGetPackedR32(c1)),
+                        SkMax32(SkGetPackedG32(c0), SkGetPackedG32(c1)),
+                        SkMax32(SkGetPackedB32(c0), SkGetPackedB32(c1)));
+}
+
+static inline SkPMColor min_pmcolor(SkPMColor c0, SkPMColor c1) {
+    return SkPackARGB32(SkMin32(SkGetPackedA32(c0), SkGetPackedA32(c1)),
+                        SkMin32(SkGetPackedR32(c0), SkGetPackedR32(c1)),
+                        SkMin32(SkGetPackedG32(c0), SkGetPackedG32(c1)),
+                        SkMin32(SkGetPackedB32(c0), SkGetPackedB32(c1)));
+}
+
+/* van Herk/Gil-Werman running max or min, O(1) per pixel for any radius.
+ * The line is padded by radius identity pixels at either end (so the window clamps to the
+ * line as in the direct loops below) and cut into blocks of 2 * radius + 1 pixels.  Every
+ * window then spans at most two blocks, and is the combination of a suffix of the first
+ * block with a prefix of the second, both of which are precomputed in one pass each.
+ */
+template<MorphDirection direction, bool isDilate>
+static void morph_van_herk(const SkPMColor* src, SkPMColor* dst,
+                           int radius, int width, int height,
+                           int srcStride, int dstStride)
+{
+    const int srcStrideX = direction == kX ? 1 : srcStride;
+    const int dstStrideX = direction == kX ? 1 : dstStride;
+    const int srcStrideY = direction == kX ? srcStride : 1;
+    const int dstStrideY = direction == kX ? dstStride : 1;
+    const SkPMColor identity = isDilate ? 0 : 0xFFFFFFFF;
+    const int blockSize = 2 * radius + 1;
+    const int paddedWidth = (width + 2 * radius + blockSize - 1) / blockSize * blockSize;
+
+    SkAutoTMalloc<SkPMColor> storage(2 * paddedWidth);
+    SkPMColor* prefix = storage.get();
+    SkPMColor* suffix = prefix + paddedWidth;
+
+    for (int y = 0; y < height; ++y) {
+        for (int i = 0; i < paddedWidth; ++i) {
+            const int x = i - radius;
+            SkPMColor c = (x < 0 || x >= width) ? identity : src[x * srcStrideX];
+            if (0 != i % blockSize) {
+                c = isDilate ? max_pmcolor(prefix[i - 1], c) : min_pmcolor(prefix[i - 1], c);
+            }
+            prefix[i] = c;
+            suffix[i] = (x < 0 || x >= width) ? identity : src[x * srcStrideX];
+        }
+        for (int i = paddedWidth - 2; i >= 0; --i) {
+            if (blockSize - 1 != i % blockSize) {
+                suffix[i] = isDilate ? max_pmcolor(suffix[i], suffix[i + 1])
+                                     : min_pmcolor(suffix[i], suffix[i + 1]);
+            }
+        }
+        for (int x = 0; x < width; ++x) {
+            // The window for x is padded [x, x + 2 * radius].
+            dst[x * dstStrideX] = isDilate ? max_pmcolor(suffix[x], prefix[x + 2 * radius])
+                                           : min_pmcolor(suffix[x], prefix[x + 2 * radius]);
+        }
+        src += srcStrideY;
+        dst += dstStrideY;
+    }
+}
+
 template<MorphDirection direction>
 static void erode(const SkPMColor* src, SkPMColor* dst,
                   int radius, int width, int height,
@@ -48,6 +118,10 @@ static void erode(const SkPMColor* src, SkPMColor* dst,
     const int srcStrideY = direction == kX ? srcStride : 1;
     const int dstStrideY = direction == kX ? dstStride : 1;
     radius = SkMin32(radius, width - 1);
+    if (radius >= (direction == kX ? kMinVanHerkRadiusX : kMinVanHerkRadiusY)) {
+        morph_van_herk<direction, false>(src, dst, radius, width, height, srcStride, dstStride);
+        return;
+    }
     const SkPMColor* upperSrc = src + radius * srcStrideX;
     for (int x = 0; x < width; ++x) {
         const SkPMColor* lp = src;
@@ -86,6 +160,10 @@ static void dilate(const SkPMColor* src, SkPMColor* dst,
     const int srcStrideY = direction == kX ? srcStride : 1;
     const int dstStrideY = direction == kX ? dstStride : 1;
     radius = SkMin32(radius, width - 1);
+    if (radius >= (direction == kX ? kMinVanHerkRadiusX : kMinVanHerkRadiusY)) {
+        morph_van_herk<direction, true>(src, dst, radius, width, height, srcStride, dstStride);
+        return;
+    }
     const SkPMColor* upperSrc = src + radius * srcStrideX;
     for (int x = 0; x < width; ++x) {
         const SkPMColor* lp = src;
@@ -114,18 +192,62 @@ static void dilate(const SkPMColor* src, SkPMColor* dst,
     }
 }
 
+// Each line (a row for procX, a column for procY) is filtered independently, so large images
+// are split into bands of lines that run in parallel.
+static const int kMorphologyBandLines = 64;
+
+struct MorphologyBand {
+    SkMorphologyImageFilter::Proc fProc;
+    const SkPMColor* fSrc;
+    SkPMColor* fDst;
+    int fRadius, fWidth, fLines, fSrcStride, fDstStride;
+
+    static void Run(MorphologyBand* band) {
+        band->fProc(band->fSrc, band->fDst, band->fRadius, band->fWidth, band->fLines,
+                    band->fSrcStride, band->fDstStride);
+    }
+};
+
+// srcLineStep and dstLineStep are the distances in pixels between consecutive lines.
+static void call_proc_banded(SkMorphologyImageFilter::Proc proc,
+                             const SkPMColor* src, SkPMColor* dst, int radius,
+                             int width, int lines, int srcStride, int dstStride,
+                             int srcLineStep, int dstLineStep) {
+    const int bandCount = (lines + kMorphologyBandLines - 1) / kMorphologyBandLines;
+    if (bandCount <= 1) {
+        proc(src, dst, radius, width, lines, srcStride, dstStride);
+        return;
+    }
+    SkAutoSTMalloc<16, MorphologyBand> bands(bandCount);
+    for (int i = 0; i < bandCount; ++i) {
+        const int firstLine = i * kMorphologyBandLines;
+        MorphologyBand& band = bands[i];
+        band.fProc = proc;
+        band.fSrc = src + firstLine * srcLineStep;
+        band.fDst = dst + firstLine * dstLineStep;
+        band.fRadius = radius;
+        band.fWidth = width;
+        band.fLines = SkMin32(kMorphologyBandLines, lines - firstLine);
+        band.fSrcStride = srcStride;
+        band.fDstStride = dstStride;
+    }
+    SkTaskGroup().batch(MorphologyBand::Run, bands.get(), bandCount);
+}
+
 static void callProcX(SkMorphologyImageFilter::Proc procX, const SkBitmap& src, SkBitmap* dst, int radiusX, const SkIRect& bounds)
 {
-    procX(src.getAddr32(bounds.left(), bounds.top()), dst->getAddr32(0, 0),
-          radiusX, bounds.width(), bounds.height(),
-          src.rowBytesAsPixels(), dst->rowBytesAsPixels());
+    call_proc_banded(procX, src.getAddr32(bounds.left(), bounds.top()), dst->getAddr32(0, 0),
+                     radiusX, bounds.width(), bounds.height(),
+                     src.rowBytesAsPixels(), dst->rowBytesAsPixels(),
+                     src.rowBytesAsPixels(), dst->rowBytesAsPixels());
 }
 
 static void callProcY(SkMorphologyImageFilter::Proc procY, const SkBitmap& src, SkBitmap* dst, int radiusY, const SkIRect& bounds)
 {
-    procY(src.getAddr32(bounds.left(), bounds.top()), dst->getAddr32(0, 0),
-          radiusY, bounds.height(), bounds.width(),
-          src.rowBytesAsPixels(), dst->rowBytesAsPixels());
+    call_proc_banded(procY, src.getAddr32(bounds.left(), bounds.top()), dst->getAddr32(0, 0),
+                     radiusY, bounds.height(), bounds.width(),
+                     src.rowBytesAsPixels(), dst->rowBytesAsPixels(),
+                     1, 1);
 }
 
 bool SkMorphologyImageFilter::filterImageGeneric(SkMorphologyImageFilter::Proc procX,
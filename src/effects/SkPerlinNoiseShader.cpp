@@ -8,6 +8,7 @@
 #include "SkDither.h"
 #include "SkPerlinNoiseShader.h"
 #include "SkColorFilter.h"
+#include "SkNx.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 #include "SkShader.h"
@@ -104,10 +105,69 @@ struct SkPerlinNoiseShader::PaintingData {
     uint8_t     fLatticeSelector[kBlockSize];
     uint16_t    fNoise[4][kBlockSize][2];
     SkPoint     fGradient[4][kBlockSize];
+    // fGradient transposed, so that the gradients of all four channels at one lattice point
+    // can be loaded as a single vector.
+    SkScalar    fGradientX[kBlockSize][4];
+    SkScalar    fGradientY[kBlockSize][4];
     SkISize     fTileSize;
     SkVector    fBaseFrequency;
     StitchData  fStitchDataInit;
 
+    // Evaluates one octave of noise for all four channels (r, g, b, a) at once.  The lattice
+    // lookups are shared by the channels; only the gradients differ.
+    Sk4f noise2D(bool stitchTiles, const StitchData& stitchData,
+                 const SkPoint& noiseVector) const {
+        struct Noise {
+            int noisePositionIntegerValue;
+            int nextNoisePositionIntegerValue;
+            SkScalar noisePositionFractionValue;
+            Noise(SkScalar component)
+            {
+                SkScalar position = component + kPerlinNoise;
+                noisePositionIntegerValue = SkScalarFloorToInt(position);
+                noisePositionFractionValue = position - SkIntToScalar(noisePositionIntegerValue);
+                nextNoisePositionIntegerValue = noisePositionIntegerValue + 1;
+            }
+        };
+        Noise noiseX(noiseVector.x());
+        Noise noiseY(noiseVector.y());
+        // If stitching, adjust lattice points accordingly.
+        if (stitchTiles) {
+            noiseX.noisePositionIntegerValue =
+                checkNoise(noiseX.noisePositionIntegerValue, stitchData.fWrapX, stitchData.fWidth);
+            noiseY.noisePositionIntegerValue =
+                checkNoise(noiseY.noisePositionIntegerValue, stitchData.fWrapY, stitchData.fHeight);
+            noiseX.nextNoisePositionIntegerValue =
+                checkNoise(noiseX.nextNoisePositionIntegerValue, stitchData.fWrapX,
+                           stitchData.fWidth);
+            noiseY.nextNoisePositionIntegerValue =
+                checkNoise(noiseY.nextNoisePositionIntegerValue, stitchData.fWrapY,
+                           stitchData.fHeight);
+        }
+        noiseX.noisePositionIntegerValue &= kBlockMask;
+        noiseY.noisePositionIntegerValue &= kBlockMask;
+        noiseX.nextNoisePositionIntegerValue &= kBlockMask;
+        noiseY.nextNoisePositionIntegerValue &= kBlockMask;
+        int i = fLatticeSelector[noiseX.noisePositionIntegerValue];
+        int j = fLatticeSelector[noiseX.nextNoisePositionIntegerValue];
+        int b00 = (i + noiseY.noisePositionIntegerValue) & kBlockMask;
+        int b10 = (j + noiseY.noisePositionIntegerValue) & kBlockMask;
+        int b01 = (i + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
+        int b11 = (j + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
+        Sk4f sx(smoothCurve(noiseX.noisePositionFractionValue));
+        Sk4f sy(smoothCurve(noiseY.noisePositionFractionValue));
+        // This is taken 1:1 from SVG spec: http://www.w3.org/TR/SVG11/filters.html#feTurbulenceElement
+        SkScalar fx = noiseX.noisePositionFractionValue;
+        SkScalar fy = noiseY.noisePositionFractionValue;
+        Sk4f u = this->dot(b00, fx, fy);                            // Offset (0,0)
+        Sk4f v = this->dot(b10, fx - SK_Scalar1, fy);               // Offset (-1,0)
+        Sk4f a = u + (v - u) * sx;
+        v = this->dot(b11, fx - SK_Scalar1, fy - SK_Scalar1);       // Offset (-1,-1)
+        u = this->dot(b01, fx, fy - SK_Scalar1);                    // Offset (0,-1)
+        Sk4f b = u + (v - u) * sx;
+        return a + (b - a) * sy;
+    }
+
 private:
 
 #if SK_SUPPORT_GPU
@@ -195,10 +255,17 @@ private:
                     fGradient[channel][i].fX + SK_Scalar1, gHalfMax16bits));
                 fNoise[channel][i][1] = SkScalarRoundToInt(SkScalarMul(
                     fGradient[channel][i].fY + SK_Scalar1, gHalfMax16bits));
+                fGradientX[i][channel] = fGradient[channel][i].fX;
+                fGradientY[i][channel] = fGradient[channel][i].fY;
             }
         }
     }
 
+    // The per-channel equivalent of fGradient[channel][index].dot(SkPoint::Make(x, y)).
+    Sk4f dot(int index, SkScalar x, SkScalar y) const {
+        return Sk4f::Load(fGradientX[index]) * Sk4f(x) + Sk4f::Load(fGradientY[index]) * Sk4f(y);
+    }
+
     // Only called once. Could be part of the constructor.
     void stitch() {
         SkScalar tileWidth  = SkIntToScalar(fTileSize.width());
@@ -313,82 +380,34 @@ void SkPerlinNoiseShader::flatten(SkWriteBuffer& buffer) const {
     buffer.writeInt(fTileSize.fHeight);
 }
 
-SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::noise2D(
-        int channel, const StitchData& stitchData, const SkPoint& noiseVector) const {
-    struct Noise {
-        int noisePositionIntegerValue;
-        int nextNoisePositionIntegerValue;
-        SkScalar noisePositionFractionValue;
-        Noise(SkScalar component)
-        {
-            SkScalar position = component + kPerlinNoise;
-            noisePositionIntegerValue = SkScalarFloorToInt(position);
-            noisePositionFractionValue = position - SkIntToScalar(noisePositionIntegerValue);
-            nextNoisePositionIntegerValue = noisePositionIntegerValue + 1;
-        }
-    };
-    Noise noiseX(noiseVector.x());
-    Noise noiseY(noiseVector.y());
-    SkScalar u, v;
+SkPMColor SkPerlinNoiseShader::PerlinNoiseShaderContext::shade(
+        const SkPoint& point, StitchData& stitchData) const {
     const SkPerlinNoiseShader& perlinNoiseShader = static_cast<const SkPerlinNoiseShader&>(fShader);
-    // If stitching, adjust lattice points accordingly.
-    if (perlinNoiseShader.fStitchTiles) {
-        noiseX.noisePositionIntegerValue =
-            checkNoise(noiseX.noisePositionIntegerValue, stitchData.fWrapX, stitchData.fWidth);
-        noiseY.noisePositionIntegerValue =
-            checkNoise(noiseY.noisePositionIntegerValue, stitchData.fWrapY, stitchData.fHeight);
-        noiseX.nextNoisePositionIntegerValue =
-            checkNoise(noiseX.nextNoisePositionIntegerValue, stitchData.fWrapX, stitchData.fWidth);
-        noiseY.nextNoisePositionIntegerValue =
-            checkNoise(noiseY.nextNoisePositionIntegerValue, stitchData.fWrapY, stitchData.fHeight);
-    }
-    noiseX.noisePositionIntegerValue &= kBlockMask;
-    noiseY.noisePositionIntegerValue &= kBlockMask;
-    noiseX.nextNoisePositionIntegerValue &= kBlockMask;
-    noiseY.nextNoisePositionIntegerValue &= kBlockMask;
-    int i =
-        fPaintingData->fLatticeSelector[noiseX.noisePositionIntegerValue];
-    int j =
-        fPaintingData->fLatticeSelector[noiseX.nextNoisePositionIntegerValue];
-    int b00 = (i + noiseY.noisePositionIntegerValue) & kBlockMask;
-    int b10 = (j + noiseY.noisePositionIntegerValue) & kBlockMask;
-    int b01 = (i + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
-    int b11 = (j + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
-    SkScalar sx = smoothCurve(noiseX.noisePositionFractionValue);
-    SkScalar sy = smoothCurve(noiseY.noisePositionFractionValue);
-    // This is taken 1:1 from SVG spec: http://www.w3.org/TR/SVG11/filters.html#feTurbulenceElement
-    SkPoint fractionValue = SkPoint::Make(noiseX.noisePositionFractionValue,
-                                          noiseY.noisePositionFractionValue); // Offset (0,0)
-    u = fPaintingData->fGradient[channel][b00].dot(fractionValue);
-    fractionValue.fX -= SK_Scalar1; // Offset (-1,0)
-    v = fPaintingData->fGradient[channel][b10].dot(fractionValue);
-    SkScalar a = SkScalarInterp(u, v, sx);
-    fractionValue.fY -= SK_Scalar1; // Offset (-1,-1)
-    v = fPaintingData->fGradient[channel][b11].dot(fractionValue);
-    fractionValue.fX = noiseX.noisePositionFractionValue; // Offset (0,-1)
-    u = fPaintingData->fGradient[channel][b01].dot(fractionValue);
-    SkScalar b = SkScalarInterp(u, v, sx);
-    return SkScalarInterp(a, b, sy);
-}
+    SkPoint newPoint;
+    fMatrix.mapPoints(&newPoint, &point, 1);
+    newPoint.fX = SkScalarRoundToScalar(newPoint.fX);
+    newPoint.fY = SkScalarRoundToScalar(newPoint.fY);
 
-SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::calculateTurbulenceValueForPoint(
-        int channel, StitchData& stitchData, const SkPoint& point) const {
-    const SkPerlinNoiseShader& perlinNoiseShader = static_cast<const SkPerlinNoiseShader&>(fShader);
     if (perlinNoiseShader.fStitchTiles) {
         // Set up TurbulenceInitial stitch values.
         stitchData = fPaintingData->fStitchDataInit;
     }
-    SkScalar turbulenceFunctionResult = 0;
-    SkPoint noiseVector(SkPoint::Make(SkScalarMul(point.x(), fPaintingData->fBaseFrequency.fX),
-                                      SkScalarMul(point.y(), fPaintingData->fBaseFrequency.fY)));
-    SkScalar ratio = SK_Scalar1;
+    // All four channels are computed together, one per lane.
+    Sk4f turbulenceFunctionResult(0);
+    SkPoint noiseVector(SkPoint::Make(SkScalarMul(newPoint.x(), fPaintingData->fBaseFrequency.fX),
+                                      SkScalarMul(newPoint.y(), fPaintingData->fBaseFrequency.fY)));
+    // 1 / 2^octave. Multiplying by it is exact, where Sk4f division may be an estimate (NEON).
+    SkScalar invRatio = SK_Scalar1;
     for (int octave = 0; octave < perlinNoiseShader.fNumOctaves; ++octave) {
-        SkScalar noise = noise2D(channel, stitchData, noiseVector);
-        turbulenceFunctionResult += SkScalarDiv(
-            (perlinNoiseShader.fType == kFractalNoise_Type) ? noise : SkScalarAbs(noise), ratio);
+        Sk4f noise = fPaintingData->noise2D(perlinNoiseShader.fStitchTiles, stitchData,
+                                            noiseVector);
+        if (perlinNoiseShader.fType != kFractalNoise_Type) {
+            noise = Sk4f::Max(noise, -noise);
+        }
+        turbulenceFunctionResult += noise * Sk4f(invRatio);
         noiseVector.fX *= 2;
         noiseVector.fY *= 2;
-        ratio *= 2;
+        invRatio *= SK_ScalarHalf;
         if (perlinNoiseShader.fStitchTiles) {
             // Update stitch values
             stitchData.fWidth  *= 2;
@@ -401,30 +420,24 @@ SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::calculateTurbulenceValue
     // The value of turbulenceFunctionResult comes from ((turbulenceFunctionResult) + 1) / 2
     // by fractalNoise and (turbulenceFunctionResult) by turbulence.
     if (perlinNoiseShader.fType == kFractalNoise_Type) {
-        turbulenceFunctionResult =
-            SkScalarMul(turbulenceFunctionResult, SK_ScalarHalf) + SK_ScalarHalf;
+        turbulenceFunctionResult = turbulenceFunctionResult * Sk4f(SK_ScalarHalf) +
+                                   Sk4f(SK_ScalarHalf);
     }
 
-    if (channel == 3) { // Scale alpha by paint value
-        turbulenceFunctionResult = SkScalarMul(turbulenceFunctionResult,
-            SkScalarDiv(SkIntToScalar(getPaintAlpha()), SkIntToScalar(255)));
-    }
+    // Scale alpha by paint value
+    turbulenceFunctionResult = turbulenceFunctionResult *
+        Sk4f(SK_Scalar1, SK_Scalar1, SK_Scalar1,
+             SkScalarDiv(SkIntToScalar(getPaintAlpha()), SkIntToScalar(255)));
 
     // Clamp result
-    return SkScalarPin(turbulenceFunctionResult, 0, SK_Scalar1);
-}
-
-SkPMColor SkPerlinNoiseShader::PerlinNoiseShaderContext::shade(
-        const SkPoint& point, StitchData& stitchData) const {
-    SkPoint newPoint;
-    fMatrix.mapPoints(&newPoint, &point, 1);
-    newPoint.fX = SkScalarRoundToScalar(newPoint.fX);
-    newPoint.fY = SkScalarRoundToScalar(newPoint.fY);
+    turbulenceFunctionResult = Sk4f::Min(Sk4f::Max(turbulenceFunctionResult, Sk4f(0)),
+                                         Sk4f(SK_Scalar1));
 
+    SkScalar turbulence[4];
+    turbulenceFunctionResult.store(turbulence);
     U8CPU rgba[4];
     for (int channel = 3; channel >= 0; --channel) {
-        rgba[channel] = SkScalarFloorToInt(255 *
-            calculateTurbulenceValueForPoint(channel, stitchData, newPoint));
+        rgba[channel] = SkScalarFloorToInt(255 * turbulence[channel]);
     }
     return SkPreMultiplyARGB(rgba[3], rgba[0], rgba[1], rgba[2]);
 }
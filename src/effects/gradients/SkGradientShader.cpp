@@ -8,6 +8,7 @@
 #include "SkGradientShaderPriv.h"
 #include "SkLinearGradient.h"
 #include "SkRadialGradient.h"
+#include "SkResourceCache.h"
 #include "SkTwoPointRadialGradient.h"
 #include "SkTwoPointConicalGradient.h"
 #include "SkSweepGradient.h"
@@ -327,12 +328,12 @@ SkGradientShaderBase::GradientShaderCache::GradientShaderCache(
     // Only initialize the cache in getCache16/32.
     fCache16 = NULL;
     fCache32 = NULL;
-    fCache16Storage = NULL;
+    fCache16PixelRef = NULL;
     fCache32PixelRef = NULL;
 }
 
 SkGradientShaderBase::GradientShaderCache::~GradientShaderCache() {
-    sk_free(fCache16Storage);
+    SkSafeUnref(fCache16PixelRef);
     SkSafeUnref(fCache32PixelRef);
 }
 
@@ -533,14 +534,19 @@ const uint16_t* SkGradientShaderBase::GradientShaderCache::getCache16() {
 
 void SkGradientShaderBase::GradientShaderCache::initCache16(GradientShaderCache* cache) {
     // double the count for dither entries
-    const int entryCount = kCache16Count * 2;
-    const size_t allocSize = sizeof(uint16_t) * entryCount;
+    const SkImageInfo info = SkImageInfo::Make(kCache16Count, 2, kRGB_565_SkColorType,
+                                               kOpaque_SkAlphaType);
 
-    SkASSERT(NULL == cache->fCache16Storage);
-    cache->fCache16Storage = (uint16_t*)sk_malloc_throw(allocSize);
-    cache->fCache16 = cache->fCache16Storage;
+    SkASSERT(NULL == cache->fCache16PixelRef);
+    cache->fCache16PixelRef = cache->refSharedTable(info, Build16bitTable);
+    cache->fCache16 = (uint16_t*)cache->fCache16PixelRef->getAddr();
+}
+
+void SkGradientShaderBase::GradientShaderCache::Build16bitTable(GradientShaderCache* cache,
+                                                                void* table) {
+    uint16_t* cache16 = (uint16_t*)table;
     if (cache->fShader.fColorCount == 2) {
-        Build16bitCache(cache->fCache16, cache->fShader.fOrigColors[0],
+        Build16bitCache(cache16, cache->fShader.fOrigColors[0],
                         cache->fShader.fOrigColors[1], kCache16Count);
     } else {
         Rec* rec = cache->fShader.fRecs;
@@ -550,7 +556,7 @@ void SkGradientShaderBase::GradientShaderCache::initCache16(GradientShaderCache*
             SkASSERT(nextIndex < kCache16Count);
 
             if (nextIndex > prevIndex)
-                Build16bitCache(cache->fCache16 + prevIndex, cache->fShader.fOrigColors[i-1],
+                Build16bitCache(cache16 + prevIndex, cache->fShader.fOrigColors[i-1],
                                 cache->fShader.fOrigColors[i], nextIndex - prevIndex + 1);
             prevIndex = nextIndex;
         }
@@ -569,10 +575,15 @@ void SkGradientShaderBase::GradientShaderCache::initCache32(GradientShaderCache*
     const SkImageInfo info = SkImageInfo::MakeN32Premul(kCache32Count, kNumberOfDitherRows);
 
     SkASSERT(NULL == cache->fCache32PixelRef);
-    cache->fCache32PixelRef = SkMallocPixelRef::NewAllocate(info, 0, NULL);
+    cache->fCache32PixelRef = cache->refSharedTable(info, Build32bitTable);
     cache->fCache32 = (SkPMColor*)cache->fCache32PixelRef->getAddr();
+}
+
+void SkGradientShaderBase::GradientShaderCache::Build32bitTable(GradientShaderCache* cache,
+                                                                void* table) {
+    SkPMColor* cache32 = (SkPMColor*)table;
     if (cache->fShader.fColorCount == 2) {
-        Build32bitCache(cache->fCache32, cache->fShader.fOrigColors[0],
+        Build32bitCache(cache32, cache->fShader.fOrigColors[0],
                         cache->fShader.fOrigColors[1], kCache32Count, cache->fCacheAlpha,
                         cache->fShader.fGradFlags);
     } else {
@@ -583,7 +594,7 @@ void SkGradientShaderBase::GradientShaderCache::initCache32(GradientShaderCache*
             SkASSERT(nextIndex < kCache32Count);
 
             if (nextIndex > prevIndex)
-                Build32bitCache(cache->fCache32 + prevIndex, cache->fShader.fOrigColors[i-1],
+                Build32bitCache(cache32 + prevIndex, cache->fShader.fOrigColors[i-1],
                                 cache->fShader.fOrigColors[i], nextIndex - prevIndex + 1,
                                 cache->fCacheAlpha, cache->fShader.fGradFlags);
             prevIndex = nextIndex;
@@ -591,6 +602,101 @@ void SkGradientShaderBase::GradientShaderCache::initCache32(GradientShaderCache*
     }
 }
 
+namespace {
+static unsigned gGradientTableKeyNamespaceLabel;
+
+// An SkResourceCache key keeps its contents right after it. How much there is depends on the
+// number of colors, so the key is put together in a block of memory.
+class GradientTableKey : SkNoncopyable {
+public:
+    GradientTableKey(const int32_t contents[], int count32)
+        : fSize(sizeof(SkResourceCache::Key) + count32 * sizeof(int32_t))
+        , fStorage((fSize + 7) >> 3) {
+        SkResourceCache::Key* key = (SkResourceCache::Key*)fStorage.get();
+        memcpy(key->writableContents(), contents, count32 * sizeof(int32_t));
+        key->init(&gGradientTableKeyNamespaceLabel, 0, count32 * sizeof(int32_t));
+    }
+
+    const SkResourceCache::Key& get() const {
+        return *(const SkResourceCache::Key*)fStorage.get();
+    }
+    size_t size() const { return fSize; }
+
+private:
+    size_t                        fSize;
+    SkAutoSTMalloc<16, uint64_t>  fStorage;     // 64bit units, since the key holds a pointer
+};
+
+struct GradientTableRec : public SkResourceCache::Rec {
+    GradientTableRec(const GradientTableKey& key, SkMallocPixelRef* table)
+        : fKeyStorage(key.size())
+        , fKeySize(key.size())
+        , fTable(SkRef(table))
+    {
+        memcpy(fKeyStorage.get(), &key.get(), key.size());
+    }
+
+    SkAutoMalloc                    fKeyStorage;
+    size_t                          fKeySize;
+    SkAutoTUnref<SkMallocPixelRef>  fTable;
+
+    const Key& getKey() const override { return *(const Key*)fKeyStorage.get(); }
+    size_t bytesUsed() const override {
+        const SkImageInfo& info = fTable->info();
+        return sizeof(*this) + fKeySize + info.getSafeSize(info.minRowBytes());
+    }
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* contextTable) {
+        const GradientTableRec& rec = static_cast<const GradientTableRec&>(baseRec);
+        *(SkMallocPixelRef**)contextTable = SkRef(rec.fTable.get());
+        return true;
+    }
+};
+} // namespace
+
+/*
+ *  Many clients make the same gradients over and over (a style used throughout a document,
+ *  say), each time as a new shader. Sharing the tables means each of them is built once. A
+ *  table is never written after it is added to SkResourceCache, so once a shader has it,
+ *  reading it takes no lock.
+ */
+SkMallocPixelRef* SkGradientShaderBase::GradientShaderCache::refSharedTable(
+        const SkImageInfo& info, BuildTableProc build) {
+    // key: [colorType + alpha + flags + numColors + colors[] + {positions[]}]
+    const int colorCount = fShader.fColorCount;
+    int count = 4 + colorCount;
+    if (colorCount > 2) {
+        count += colorCount - 1;    // fRecs[].fPos
+    }
+
+    SkAutoSTMalloc<32, int32_t> storage(count);
+    int32_t* buffer = storage.get();
+
+    *buffer++ = info.colorType();
+    // The 16bit table does not depend on alpha.
+    *buffer++ = kRGB_565_SkColorType == info.colorType() ? 0xFF : fCacheAlpha;
+    *buffer++ = fShader.fGradFlags;
+    *buffer++ = colorCount;
+    memcpy(buffer, fShader.fOrigColors, colorCount * sizeof(SkColor));
+    buffer += colorCount;
+    if (colorCount > 2) {
+        for (int i = 1; i < colorCount; i++) {
+            *buffer++ = fShader.fRecs[i].fPos;
+        }
+    }
+    SkASSERT(buffer - storage.get() == count);
+
+    GradientTableKey key(storage.get(), count);
+    SkMallocPixelRef* table;
+    if (!SkResourceCache::Find(key.get(), GradientTableRec::Finder, &table)) {
+        table = SkMallocPixelRef::NewAllocate(info, 0, NULL);
+        build(this, table->getAddr());
+        table->setImmutable();
+        SkResourceCache::Add(SkNEW_ARGS(GradientTableRec, (key, table)));
+    }
+    return table;
+}
+
 /*
  *  The gradient holds a cache for the most recent value of alpha. Successive
  *  callers with the same alpha value will share the same cache.
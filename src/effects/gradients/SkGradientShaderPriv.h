@@ -142,7 +142,7 @@ public:
         uint16_t*   fCache16;
         SkPMColor*  fCache32;
 
-        uint16_t*         fCache16Storage;    // Storage for fCache16, allocated on demand.
+        SkMallocPixelRef* fCache16PixelRef;
         SkMallocPixelRef* fCache32PixelRef;
         const unsigned    fCacheAlpha;        // The alpha value we used when we computed the cache.
                                               // Larger than 8bits so we can store uninitialized
@@ -157,6 +157,15 @@ public:
         static void initCache16(GradientShaderCache* cache);
         static void initCache32(GradientShaderCache* cache);
 
+        // The tables are shared through SkResourceCache by all gradients with the same colors,
+        // stops, flags and alpha. refSharedTable() returns the table laid out as "info", calling
+        // "build" to fill it in first if no such gradient has built it yet.
+        typedef void (*BuildTableProc)(GradientShaderCache*, void* table);
+        SkMallocPixelRef* refSharedTable(const SkImageInfo& info, BuildTableProc build);
+
+        static void Build16bitTable(GradientShaderCache* cache, void* table);
+        static void Build32bitTable(GradientShaderCache* cache, void* table);
+
         static void Build16bitCache(uint16_t[], SkColor c0, SkColor c1, int count);
         static void Build32bitCache(SkPMColor[], SkColor c0, SkColor c1, int count,
                                     U8CPU alpha, uint32_t gradFlags);
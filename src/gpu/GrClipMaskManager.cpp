@@ -1046,6 +1046,55 @@ void GrClipMaskManager::adjustStencilParams(GrStencilSettings* settings,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+namespace {
+// Everything createSoftwareClipMask() draws into each band of the mask. The element paths are
+// made up front so that the bands only read them.
+struct SWClipMaskRec {
+    GrReducedClip::InitialState         fInitialState;
+    const GrReducedClip::ElementList*   fElements;
+    SkRect                              fClipSpaceBounds;
+    SkTArray<SkPath>                    fPaths;     // one per element not drawn as a rect
+
+    static void Draw(GrSWMaskHelper* helper, void* context);
+};
+}
+
+void SWClipMaskRec::Draw(GrSWMaskHelper* helper, void* context) {
+    const SWClipMaskRec* rec = static_cast<const SWClipMaskRec*>(context);
+    helper->clear(GrReducedClip::kAllIn_InitialState == rec->fInitialState ? 0xFF : 0x00);
+    SkStrokeRec stroke(SkStrokeRec::kFill_InitStyle);
+
+    int pathIndex = 0;
+    for (GrReducedClip::ElementList::Iter iter(rec->fElements->headIter()); iter.get();
+         iter.next()) {
+        const Element* element = iter.get();
+        SkRegion::Op op = element->getOp();
+
+        if (SkRegion::kIntersect_Op == op || SkRegion::kReverseDifference_Op == op) {
+            // Intersect and reverse difference require modifying pixels outside of the geometry
+            // that is being "drawn". In both cases we erase all the pixels outside of the geometry
+            // but leave the pixels inside the geometry alone. For reverse difference we invert all
+            // the pixels before clearing the ones outside the geometry.
+            if (SkRegion::kReverseDifference_Op == op) {
+                // invert the entire scene
+                helper->draw(rec->fClipSpaceBounds, SkRegion::kXOR_Op, false, 0xFF);
+            }
+            // the path is already inverse filled
+            helper->draw(rec->fPaths[pathIndex++], stroke, SkRegion::kReplace_Op, element->isAA(),
+                         0x00);
+            continue;
+        }
+
+        // The other ops (union, xor, diff) only affect pixels inside
+        // the geometry so they can just be drawn normally
+        if (Element::kRect_Type == element->getType()) {
+            helper->draw(element->getRect(), op, element->isAA(), 0xFF);
+        } else {
+            helper->draw(rec->fPaths[pathIndex++], stroke, op, element->isAA(), 0xFF);
+        }
+    }
+}
+
 GrTexture* GrClipMaskManager::createSoftwareClipMask(int32_t elementsGenID,
                                                      GrReducedClip::InitialState initialState,
                                                      const GrReducedClip::ElementList& elements,
@@ -1070,41 +1119,29 @@ GrTexture* GrClipMaskManager::createSoftwareClipMask(int32_t elementsGenID,
     translate.setTranslate(clipToMaskOffset);
 
     helper.init(maskSpaceIBounds, &translate, false);
-    helper.clear(GrReducedClip::kAllIn_InitialState == initialState ? 0xFF : 0x00);
-    SkStrokeRec stroke(SkStrokeRec::kFill_InitStyle);
 
+    SWClipMaskRec rec;
+    rec.fInitialState = initialState;
+    rec.fElements = &elements;
+    rec.fClipSpaceBounds = SkRect::Make(clipSpaceIBounds);
     for (GrReducedClip::ElementList::Iter iter(elements.headIter()) ; iter.get(); iter.next()) {
         const Element* element = iter.get();
         SkRegion::Op op = element->getOp();
-
-        if (SkRegion::kIntersect_Op == op || SkRegion::kReverseDifference_Op == op) {
-            // Intersect and reverse difference require modifying pixels outside of the geometry
-            // that is being "drawn". In both cases we erase all the pixels outside of the geometry
-            // but leave the pixels inside the geometry alone. For reverse difference we invert all
-            // the pixels before clearing the ones outside the geometry.
-            if (SkRegion::kReverseDifference_Op == op) {
-                SkRect temp = SkRect::Make(clipSpaceIBounds);
-                // invert the entire scene
-                helper.draw(temp, SkRegion::kXOR_Op, false, 0xFF);
-            }
-            SkPath clipPath;
-            element->asPath(&clipPath);
-            clipPath.toggleInverseFillType();
-            helper.draw(clipPath, stroke, SkRegion::kReplace_Op, element->isAA(), 0x00);
-            continue;
-        }
-
-        // The other ops (union, xor, diff) only affect pixels inside
-        // the geometry so they can just be drawn normally
-        if (Element::kRect_Type == element->getType()) {
-            helper.draw(element->getRect(), op, element->isAA(), 0xFF);
-        } else {
-            SkPath path;
+        const bool inverse = SkRegion::kIntersect_Op == op ||
+                             SkRegion::kReverseDifference_Op == op;
+        if (inverse || Element::kRect_Type != element->getType()) {
+            SkPath& path = rec.fPaths.push_back();
             element->asPath(&path);
-            helper.draw(path, stroke, op, element->isAA(), 0xFF);
+            if (inverse) {
+                path.toggleInverseFillType();
+            }
+            GrSWMaskHelper::PrepareForBands(path);
         }
     }
 
+    // Large masks are drawn in bands on several threads.
+    helper.drawBanded(SWClipMaskRec::Draw, &rec);
+
     // Allocate clip mask texture
     result = this->allocMaskTexture(elementsGenID, clipSpaceIBounds, true);
     if (NULL == result) {
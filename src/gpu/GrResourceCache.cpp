@@ -41,7 +41,7 @@ GrUniqueKey::Domain GrUniqueKey::GenerateDomain() {
     return static_cast<Domain>(domain);
 }
 uint32_t GrResourceKeyHash(const uint32_t* data, size_t size) {
-    return SkChecksum::Compute(data, size);
+    return SkChecksum::Hash(data, size);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -11,9 +11,11 @@
 #include "GrDrawTargetCaps.h"
 #include "GrGpu.h"
 
+#include "SkBlitter.h"
 #include "SkData.h"
 #include "SkDistanceFieldGen.h"
 #include "SkStrokeRec.h"
+#include "SkTaskGroup.h"
 
 // TODO: try to remove this #include
 #include "GrContext.h"
@@ -96,6 +98,40 @@ static bool choose_compressed_fmt(const GrDrawTargetCaps* caps,
     return false;
 }
 
+/*
+ * Passes on just the rows of one band of the mask, and tells the scan converters so, so that
+ * they walk the rows above it without blitting them.
+ */
+class BandBlitter : public SkRectClipBlitter {
+public:
+    void init(SkBlitter* blitter, const SkIRect& band) {
+        this->INHERITED::init(blitter, band);
+        fBand = band;
+    }
+
+    bool getRowLimits(int* top, int* bottom) const override {
+        *top = fBand.fTop;
+        *bottom = fBand.fBottom;
+        return true;
+    }
+
+private:
+    SkIRect fBand;
+
+    typedef SkRectClipBlitter INHERITED;
+};
+
+/*
+ * For a helper set up by initBand(), the blitter to draw with: the one SkDraw would choose for
+ * the whole mask, limited to the band.
+ */
+SkBlitter* choose_band_blitter(const SkBitmap& bm, const SkMatrix& matrix, const SkIRect& band,
+                               const SkPaint& paint, bool drawCoverage,
+                               SkTBlitterAllocator* allocator, BandBlitter* bandBlitter) {
+    bandBlitter->init(SkBlitter::Choose(bm, matrix, paint, allocator, drawCoverage), band);
+    return bandBlitter;
+}
+
 }
 
 /**
@@ -113,7 +149,15 @@ void GrSWMaskHelper::draw(const SkRect& rect, SkRegion::Op op,
     paint.setAntiAlias(antiAlias);
     paint.setColor(SkColorSetARGB(alpha, alpha, alpha, alpha));
 
-    fDraw.drawRect(rect, paint);
+    SkTBlitterAllocator allocator;
+    BandBlitter bandBlitter;
+    SkBlitter* blitter = NULL;
+    if (!fBand.isEmpty()) {
+        blitter = choose_band_blitter(fBM, fMatrix, fBand, paint, false, &allocator,
+                                      &bandBlitter);
+    }
+
+    fDraw.drawRect(rect, paint, NULL, NULL, blitter);
 
     SkSafeUnref(mode);
 }
@@ -140,20 +184,31 @@ void GrSWMaskHelper::draw(const SkPath& path, const SkStrokeRec& stroke, SkRegio
     }
     paint.setAntiAlias(antiAlias);
 
+    const bool drawCoverage = SkRegion::kReplace_Op == op && 0xFF == alpha;
+    if (drawCoverage) {
+        SkASSERT(0xFF == paint.getAlpha());
+    } else {
+        paint.setXfermodeMode(op_to_mode(op));
+        paint.setColor(SkColorSetARGB(alpha, alpha, alpha, alpha));
+    }
+
     SkTBlitterAllocator allocator;
+    BandBlitter bandBlitter;
     SkBlitter* blitter = NULL;
     if (kBlitter_CompressionMode == fCompressionMode) {
         SkASSERT(fCompressedBuffer.get());
         blitter = SkTextureCompressor::CreateBlitterForFormat(
             fBM.width(), fBM.height(), fCompressedBuffer.get(), &allocator, fCompressedFormat);
+    } else if (!fBand.isEmpty()) {
+        // SkDraw would change the paint of a thin stroke after the blitter is chosen.
+        SkASSERT(stroke.isFillStyle());
+        blitter = choose_band_blitter(fBM, fMatrix, fBand, paint, drawCoverage, &allocator,
+                                      &bandBlitter);
     }
 
-    if (SkRegion::kReplace_Op == op && 0xFF == alpha) {
-        SkASSERT(0xFF == paint.getAlpha());
+    if (drawCoverage) {
         fDraw.drawPathCoverage(path, paint, blitter);
     } else {
-        paint.setXfermodeMode(op_to_mode(op));
-        paint.setColor(SkColorSetARGB(alpha, alpha, alpha, alpha));
         fDraw.drawPath(path, paint, blitter);
     }
 }
@@ -226,6 +281,76 @@ bool GrSWMaskHelper::init(const SkIRect& resultBounds,
     return true;
 }
 
+void GrSWMaskHelper::initBand(const GrSWMaskHelper& full, const SkIRect& band) {
+    SkASSERT(kBlitter_CompressionMode != full.fCompressionMode);
+    SkASSERT(!band.isEmpty());
+
+    fContext = full.fContext;
+    fMatrix = full.fMatrix;
+    fBM = full.fBM;
+    fBM.lockPixels();
+    fBand = band;
+
+    sk_bzero(&fDraw, sizeof(fDraw));
+
+    fRasterClip.setRect(full.fRasterClip.getBounds());
+    fDraw.fRC    = &fRasterClip;
+    fDraw.fClip  = &fRasterClip.bwRgn();
+    fDraw.fMatrix = &fMatrix;
+    fDraw.fBitmap = &fBM;
+}
+
+// Every band builds the edges and steps them down from the top of the mask, and is a task of its
+// own, so bands should not be too thin, and small masks are not worth splitting.
+static const int kMinMaskBandRows = 32;
+static const int kMinBandedMaskPixels = 256 * 256;
+
+namespace {
+struct MaskBand {
+    MaskBand() : fHelper(NULL) {}
+
+    GrSWMaskHelper           fHelper;
+    GrSWMaskHelper::DrawProc fProc;
+    void*                    fContext;
+
+    static void Run(MaskBand* band) {
+        band->fProc(&band->fHelper, band->fContext);
+    }
+};
+}
+
+void GrSWMaskHelper::drawBanded(DrawProc proc, void* context) {
+    // One band per thread, when there is more than one.
+    const int threadCount = SkTaskGroup::ThreadCount();
+    const int bandRows = SkMax32(kMinMaskBandRows,
+                                 (fBM.height() + threadCount - 1) / SkMax32(threadCount, 1));
+    const int bandCount = (fBM.height() + bandRows - 1) / bandRows;
+    // The compressing blitter writes whole blocks of the mask, so it can't be split.
+    if (threadCount < 2 || bandCount <= 1 || kBlitter_CompressionMode == fCompressionMode ||
+        fBM.width() * fBM.height() < kMinBandedMaskPixels) {
+        proc(this, context);
+        return;
+    }
+
+    // One helper per band, which draws everything "proc" draws.
+    SkAutoSTArray<16, MaskBand> bands(bandCount);
+    for (int i = 0; i < bandCount; ++i) {
+        const int top = i * bandRows;
+        const SkIRect band = SkIRect::MakeLTRB(0, top, fBM.width(),
+                                               SkMin32(top + bandRows, fBM.height()));
+        bands[i].fHelper.initBand(*this, band);
+        bands[i].fProc = proc;
+        bands[i].fContext = context;
+    }
+    SkTaskGroup().batch(MaskBand::Run, bands.get(), bandCount);
+}
+
+void GrSWMaskHelper::PrepareForBands(const SkPath& path) {
+    (void)path.getBounds();
+    (void)path.getGenerationID();
+    (void)path.isConvex();
+}
+
 /**
  * Get a texture (from the texture cache) of the correct size & format.
  */
@@ -316,6 +441,19 @@ void GrSWMaskHelper::toSDF(unsigned char* sdf) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+namespace {
+struct PathMaskRec {
+    const SkPath*      fPath;
+    const SkStrokeRec* fStroke;
+    bool               fAntiAlias;
+
+    static void Draw(GrSWMaskHelper* helper, void* context) {
+        const PathMaskRec* rec = static_cast<const PathMaskRec*>(context);
+        helper->draw(*rec->fPath, *rec->fStroke, SkRegion::kReplace_Op, rec->fAntiAlias, 0xFF);
+    }
+};
+}
+
 /**
  * Software rasterizes path to A8 mask (possibly using the context's matrix)
  * and uploads the result to a scratch texture. Returns the resulting
@@ -333,7 +471,14 @@ GrTexture* GrSWMaskHelper::DrawPathMaskToTexture(GrContext* context,
         return NULL;
     }
 
-    helper.draw(path, stroke, SkRegion::kReplace_Op, antiAlias, 0xFF);
+    // Each band would stroke the whole path again, so only fills are split.
+    if (stroke.isFillStyle()) {
+        PrepareForBands(path);
+        PathMaskRec rec = { &path, &stroke, antiAlias };
+        helper.drawBanded(PathMaskRec::Draw, &rec);
+    } else {
+        helper.draw(path, stroke, SkRegion::kReplace_Op, antiAlias, 0xFF);
+    }
 
     GrTexture* texture(helper.createTexture());
     if (!texture) {
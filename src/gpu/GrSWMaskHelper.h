@@ -43,6 +43,7 @@ class GrSWMaskHelper : SkNoncopyable {
 public:
     GrSWMaskHelper(GrContext* context)
     : fContext(context)
+    , fBand(SkIRect::MakeEmpty())
     , fCompressionMode(kNone_CompressionMode) {
     }
 
@@ -53,6 +54,26 @@ public:
     // your own texture to draw into, and not a scratch texture via getTexture().
     bool init(const SkIRect& resultBounds, const SkMatrix* matrix, bool allowCompression = true);
 
+    // Set up the internal state to draw just the rows of "band" (in mask space) of the mask
+    // that "full" was initialized for. Draws are clipped and scan converted against the whole
+    // mask, as in "full", and only the blitter is limited to the band, so the band's rows come
+    // out exactly as if "full" had drawn them. They go straight into full's bitmap, so that
+    // several helpers can fill the bands of one mask at the same time. Only fills can be
+    // drawn this way.
+    void initBand(const GrSWMaskHelper& full, const SkIRect& band);
+
+    // Fill the accumulation bitmap a band of rows at a time, one band per SkTaskGroup thread.
+    // "proc" is called once per band with a helper set up by initBand(), and should clear and draw
+    // the whole mask into it; each band keeps just its own rows. Large masks are split this
+    // way when SkTaskGroup has more than one thread, unless the helper compresses as it
+    // draws; otherwise "proc" draws the whole mask into this helper. Anything "proc" draws is
+    // read by all the bands at once, so paths must go through PrepareForBands() first.
+    typedef void (*DrawProc)(GrSWMaskHelper* helper, void* context);
+    void drawBanded(DrawProc proc, void* context);
+
+    // Compute the lazily computed state of a path, so that bands can read it concurrently.
+    static void PrepareForBands(const SkPath& path);
+
     // Draw a single rect into the accumulation bitmap using the specified op
     void draw(const SkRect& rect, SkRegion::Op op,
               bool antiAlias, uint8_t alpha);
@@ -67,9 +88,14 @@ public:
     // Convert mask generation results to a signed distance field
     void toSDF(unsigned char* sdf);
     
-    // Reset the internal bitmap
+    // Reset the internal bitmap, or just the band of it this helper draws
     void clear(uint8_t alpha) {
-        fBM.eraseColor(SkColorSetARGB(alpha, alpha, alpha, alpha));
+        const SkColor color = SkColorSetARGB(alpha, alpha, alpha, alpha);
+        if (fBand.isEmpty()) {
+            fBM.eraseColor(color);
+        } else {
+            fBM.eraseArea(fBand, color);
+        }
     }
 
     // Canonical usage utility that draws a single path and uploads it
@@ -108,6 +134,7 @@ private:
     SkBitmap        fBM;
     SkDraw          fDraw;
     SkRasterClip    fRasterClip;
+    SkIRect         fBand;          // the rows drawn by a helper set up by initBand()
 
     // This enum says whether or not we should compress the mask:
     // kNone_CompressionMode: compression is not supported on this device.
@@ -86,7 +86,7 @@ void SkSurface_Base::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y, const SkPa
     }
 }
 
-void SkSurface_Base::aboutToDraw(ContentChangeMode mode) {
+void SkSurface_Base::aboutToDraw(ContentChangeMode mode, const SkIRect* dirty) {
     this->dirtyGenerationID();
 
     SkASSERT(!fCachedCanvas || fCachedCanvas->getSurfaceBase() == this);
@@ -106,6 +106,9 @@ void SkSurface_Base::aboutToDraw(ContentChangeMode mode) {
     } else if (kDiscard_ContentChangeMode == mode) {
         this->onDiscard();
     }
+
+    // Once we may discard, the whole surface is up for grabs.
+    this->onWillDraw(kDiscard_ContentChangeMode == mode ? NULL : dirty);
 }
 
 uint32_t SkSurface_Base::newGenerationID() {
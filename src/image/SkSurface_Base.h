@@ -60,6 +60,13 @@ public:
      */
     virtual void onCopyOnWrite(ContentChangeMode) = 0;
 
+    /**
+     *  Called after any copy-on-write, right before the surface changes. dirty is the
+     *  (conservative) area of the surface that may change, or NULL if it could be all of it.
+     *  Subclasses that keep more than one backing store use this to know what to sync.
+     */
+    virtual void onWillDraw(const SkIRect* dirty) {}
+
     inline SkCanvas* getCachedCanvas();
     inline SkImage* getCachedImage(Budgeted);
 
@@ -70,7 +77,7 @@ private:
     SkCanvas*   fCachedCanvas;
     SkImage*    fCachedImage;
 
-    void aboutToDraw(ContentChangeMode mode);
+    void aboutToDraw(ContentChangeMode mode, const SkIRect* dirty = NULL);
     friend class SkCanvas;
     friend class SkSurface;
 
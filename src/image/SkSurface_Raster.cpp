@@ -10,6 +10,7 @@
 #include "SkCanvas.h"
 #include "SkDevice.h"
 #include "SkMallocPixelRef.h"
+#include "SkTemplates.h"
 
 static const size_t kIgnoreRowBytesValue = (size_t)~0;
 
@@ -28,10 +29,28 @@ public:
     virtual void onDraw(SkCanvas*, SkScalar x, SkScalar y,
                         const SkPaint*) override;
     void onCopyOnWrite(ContentChangeMode) override;
+    void onWillDraw(const SkIRect* dirty) override;
 
 private:
-    SkBitmap    fBitmap;
-    bool        fWeOwnThePixels;
+    // With SkSurfaceProps::kReuseSnapshotPixels_Flag, once a snapshot has forced us to fork our
+    // pixels, we hang on to the buffer we gave away (fSpare). When the next snapshot forces a
+    // fork, the previous one is usually gone, so instead of copying the whole surface into a
+    // fresh buffer we bring the spare up to date by copying only the tiles drawn to since the
+    // last fork, and swap. Without the flag there is no spare and nothing to track.
+    enum {
+        kTileSize = 64,
+    };
+
+    void markDirty(const SkIRect&);
+    void clearDirty();
+    void copyDirtyTiles(const SkBitmap& src, const SkBitmap& dst) const;
+
+    SkBitmap                fBitmap;
+    SkBitmap                fSpare;
+    SkAutoTMalloc<uint8_t>  fDirtyTiles;    // one byte per tile, nonzero if drawn to
+    int                     fTilesX;
+    int                     fTilesY;
+    bool                    fWeOwnThePixels;
 
     typedef SkSurface_Base INHERITED;
 };
@@ -89,6 +108,8 @@ SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, void* pixels, size_t
 {
     fBitmap.installPixels(info, pixels, rb, NULL, releaseProc, context);
     fWeOwnThePixels = false;    // We are "Direct"
+    // Snapshots of direct surfaces are copies, so we never fork and have nothing to track.
+    fTilesX = fTilesY = 0;
 }
 
 SkSurface_Raster::SkSurface_Raster(SkPixelRef* pr, const SkSurfaceProps* props)
@@ -100,6 +121,15 @@ SkSurface_Raster::SkSurface_Raster(SkPixelRef* pr, const SkSurfaceProps* props)
     fBitmap.setPixelRef(pr);
     fWeOwnThePixels = true;
 
+    if (this->props().isReuseSnapshotPixels()) {
+        fTilesX = (info.width()  + kTileSize - 1) / kTileSize;
+        fTilesY = (info.height() + kTileSize - 1) / kTileSize;
+        fDirtyTiles.reset(fTilesX * fTilesY);
+        this->clearDirty();
+    } else {
+        fTilesX = fTilesY = 0;
+    }
+
     if (!info.isOpaque()) {
         fBitmap.eraseColor(SK_ColorTRANSPARENT);
     }
@@ -127,13 +157,28 @@ void SkSurface_Raster::onCopyOnWrite(ContentChangeMode mode) {
     SkASSERT(this->getCachedImage(kNo_Budgeted));
     if (SkBitmapImageGetPixelRef(this->getCachedImage(kNo_Budgeted)) == fBitmap.pixelRef()) {
         SkASSERT(fWeOwnThePixels);
-        if (kDiscard_ContentChangeMode == mode) {
-            fBitmap.setPixelRef(NULL);
-            fBitmap.allocPixels();
+        if (fSpare.pixelRef() && fSpare.pixelRef()->unique()) {
+            // Nobody else is looking at the spare anymore. It holds our contents as of the
+            // previous fork, so only the tiles drawn since then need to be brought over.
+            if (kRetain_ContentChangeMode == mode) {
+                this->copyDirtyTiles(fBitmap, fSpare);
+            }
+            fSpare.notifyPixelsChanged();
+            fBitmap.swap(fSpare);
         } else {
-            SkBitmap prev(fBitmap);
-            prev.deepCopyTo(&fBitmap);
+            if (this->props().isReuseSnapshotPixels()) {
+                fSpare = fBitmap;
+            }
+            if (kDiscard_ContentChangeMode == mode) {
+                fBitmap.setPixelRef(NULL);
+                fBitmap.allocPixels();
+            } else {
+                SkBitmap prev(fBitmap);
+                prev.deepCopyTo(&fBitmap);
+            }
         }
+        // Both buffers are now identical (or we don't care what's in fBitmap).
+        this->clearDirty();
         // Now fBitmap is a deep copy of itself (and therefore different from
         // what is being used by the image. Next we update the canvas to use
         // this as its backend, so we can't modify the image's pixels anymore.
@@ -142,6 +187,68 @@ void SkSurface_Raster::onCopyOnWrite(ContentChangeMode mode) {
     }
 }
 
+void SkSurface_Raster::onWillDraw(const SkIRect* dirty) {
+    if (0 == fTilesX) {
+        return;     // no spare to bring up to date
+    }
+    if (dirty) {
+        this->markDirty(*dirty);
+    } else {
+        this->markDirty(SkIRect::MakeWH(fBitmap.width(), fBitmap.height()));
+    }
+}
+
+void SkSurface_Raster::markDirty(const SkIRect& dirty) {
+    SkIRect r = dirty;
+    if (!r.intersect(0, 0, fBitmap.width(), fBitmap.height())) {
+        return;
+    }
+    const int tileL = r.fLeft / kTileSize,
+              tileR = (r.fRight - 1) / kTileSize;
+    for (int ty = r.fTop / kTileSize; ty <= (r.fBottom - 1) / kTileSize; ++ty) {
+        memset(fDirtyTiles.get() + ty * fTilesX + tileL, 1, tileR - tileL + 1);
+    }
+}
+
+void SkSurface_Raster::clearDirty() {
+    if (fTilesX * fTilesY > 0) {
+        memset(fDirtyTiles.get(), 0, fTilesX * fTilesY);
+    }
+}
+
+void SkSurface_Raster::copyDirtyTiles(const SkBitmap& src, const SkBitmap& dst) const {
+    SkASSERT(src.info() == dst.info() && src.rowBytes() == dst.rowBytes());
+    SkAutoLockPixels alpSrc(src), alpDst(dst);
+    if (!src.getPixels() || !dst.getPixels()) {
+        return;
+    }
+
+    const size_t bpp = src.bytesPerPixel();
+    const int width = src.width(),
+              height = src.height();
+    for (int ty = 0; ty < fTilesY; ++ty) {
+        const uint8_t* row = fDirtyTiles.get() + ty * fTilesX;
+        const int top = ty * kTileSize,
+                  bottom = SkTMin(top + kTileSize, height);
+        int tx = 0;
+        while (tx < fTilesX) {
+            if (!row[tx]) {
+                tx++;
+                continue;
+            }
+            // Copy a whole run of dirty tiles with one memcpy per scanline.
+            const int left = tx * kTileSize;
+            while (tx < fTilesX && row[tx]) {
+                tx++;
+            }
+            const int right = SkTMin(tx * kTileSize, width);
+            for (int y = top; y < bottom; ++y) {
+                memcpy(dst.getAddr(left, y), src.getAddr(left, y), (right - left) * bpp);
+            }
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 SkSurface* SkSurface::NewRasterDirectReleaseProc(const SkImageInfo& info, void* pixels, size_t rb,
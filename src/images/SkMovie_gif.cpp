@@ -8,8 +8,10 @@
 
 
 #include "SkMovie.h"
+#include "SkAtomics.h"
 #include "SkColor.h"
 #include "SkColorPriv.h"
+#include "SkResourceCache.h"
 #include "SkStream.h"
 #include "SkTemplates.h"
 #include "SkUtils.h"
@@ -31,11 +33,73 @@ protected:
     virtual bool onGetBitmap(SkBitmap*);
 
 private:
+    int findKeyframe(int first, int last, SkBitmap* bm);
+    void addKeyframe(int index, const SkBitmap& bm);
+
     GifFileType* fGIF;
     int fCurrIndex;
     int fLastDrawIndex;
     SkBitmap fBackup;
+    SkColor fPaintingColor;
+    // Snapshots of the composited canvas are kept in the resource cache after these frames, so
+    // seeking backward doesn't have to start over from frame 0.
+    SkAutoTMalloc<bool> fIsKeyframe;
+    uint32_t fUniqueID;
+};
+
+static bool checkIfWillBeCleared(const SavedImage* frame);
+
+// Seeking replays at most this many frames past a keyframe, if the keyframe is still cached.
+static const int kKeyframeInterval = 8;
+
+static int32_t gNextMovieID;
+
+static uint64_t keyframe_shared_id(uint32_t movieID)
+{
+    uint64_t sharedID = SkSetFourByteTag('g', 'i', 'f', 'm');
+    return (sharedID << 32) | movieID;
+}
+
+namespace {
+static unsigned gKeyframeKeyNamespaceLabel;
+
+struct KeyframeKey : public SkResourceCache::Key {
+public:
+    KeyframeKey(uint32_t movieID, int32_t index)
+        : fMovieID(movieID)
+        , fIndex(index)
+    {
+        this->init(&gKeyframeKeyNamespaceLabel, keyframe_shared_id(movieID),
+                   sizeof(fMovieID) + sizeof(fIndex));
+    }
+
+    uint32_t    fMovieID;
+    int32_t     fIndex;
+};
+
+struct KeyframeRec : public SkResourceCache::Rec {
+    KeyframeRec(uint32_t movieID, int32_t index, const SkBitmap& bitmap)
+        : fKey(movieID, index)
+        , fBitmap(bitmap)
+    {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(fKey) + fBitmap.getSize(); }
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* contextBitmap) {
+        const KeyframeRec& rec = static_cast<const KeyframeRec&>(baseRec);
+        SkBitmap* result = (SkBitmap*)contextBitmap;
+
+        *result = rec.fBitmap;
+        result->lockPixels();
+        return SkToBool(result->getPixels());
+    }
+
+private:
+    KeyframeKey fKey;
+    SkBitmap    fBitmap;
 };
+} // namespace
 
 static int Decode(GifFileType* fileType, GifByteType* out, int size) {
     SkStream* stream = (SkStream*) fileType->UserData;
@@ -59,12 +123,32 @@ SkGIFMovie::SkGIFMovie(SkStream* stream)
     }
     fCurrIndex = -1;
     fLastDrawIndex = -1;
+    fPaintingColor = SK_ColorTRANSPARENT;
+    fUniqueID = sk_atomic_inc(&gNextMovieID) + 1;
+
+    if (fGIF && fGIF->ImageCount > 0) {
+        fIsKeyframe.reset(fGIF->ImageCount);
+        int lastKeyframe = -kKeyframeInterval;
+        for (int i = 0; i < fGIF->ImageCount; i++) {
+            fIsKeyframe[i] = false;
+        }
+        for (int i = 0; i < fGIF->ImageCount; i++) {
+            // The canvas after a frame that is disposed (2 or 3) isn't what that frame shows,
+            // and continuing after a frame with disposal 3 would need the backup as well.
+            if (i - lastKeyframe >= kKeyframeInterval &&
+                !checkIfWillBeCleared(&fGIF->SavedImages[i])) {
+                fIsKeyframe[i] = true;
+                lastKeyframe = i;
+            }
+        }
+    }
 }
 
 SkGIFMovie::~SkGIFMovie()
 {
     if (fGIF)
         DGifCloseFile(fGIF, NULL);
+    SkResourceCache::PostPurgeSharedID(keyframe_shared_id(fUniqueID));
 }
 
 static SkMSec savedimage_duration(const SavedImage* image)
@@ -306,7 +390,8 @@ static void disposeFrameIfNeeded(SkBitmap* bm, const SavedImage* cur, const Save
                                  SkBitmap* backup, SkColor color)
 {
     // We can skip disposal process if next frame is not transparent
-    // and completely covers current area
+    // and completely covers current area, unless next frame saves the
+    // disposed image to restore later
     bool curTrans;
     int curDisposal;
     getTransparencyAndDisposalMethod(cur, &curTrans, &curDisposal);
@@ -314,7 +399,7 @@ static void disposeFrameIfNeeded(SkBitmap* bm, const SavedImage* cur, const Save
     int nextDisposal;
     getTransparencyAndDisposalMethod(next, &nextTrans, &nextDisposal);
     if ((curDisposal == 2 || curDisposal == 3)
-        && (nextTrans || !checkIfCover(next, cur))) {
+        && (nextTrans || !checkIfCover(next, cur) || nextDisposal == 3)) {
         switch (curDisposal) {
         // restore to background color
         // -> 'background' means background under this image.
@@ -340,6 +425,54 @@ static void disposeFrameIfNeeded(SkBitmap* bm, const SavedImage* cur, const Save
     }
 }
 
+static bool cache_try_alloc_pixels(SkBitmap* bitmap)
+{
+    SkBitmap::Allocator* allocator = SkResourceCache::GetAllocator();
+
+    return NULL != allocator
+        ? allocator->allocPixelRef(bitmap, NULL)
+        : bitmap->tryAllocPixels();
+}
+
+// Returns the latest keyframe in [first, last] that is still cached, with its pixels copied
+// into bm, or -1.
+int SkGIFMovie::findKeyframe(int first, int last, SkBitmap* bm)
+{
+    for (int i = last; i >= first; i--) {
+        if (!fIsKeyframe[i]) {
+            continue;
+        }
+        SkBitmap keyframe;
+        if (SkResourceCache::Find(KeyframeKey(fUniqueID, i), KeyframeRec::Finder, &keyframe)) {
+            bool copied = keyframe.copyPixelsTo(bm->getPixels(), bm->getSize(), bm->rowBytes());
+            keyframe.unlockPixels();
+            if (copied) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+void SkGIFMovie::addKeyframe(int index, const SkBitmap& bm)
+{
+    SkBitmap keyframe;
+    if (SkResourceCache::Find(KeyframeKey(fUniqueID, index), KeyframeRec::Finder, &keyframe)) {
+        keyframe.unlockPixels();
+        return;
+    }
+
+    keyframe.setInfo(bm.info());
+    if (!cache_try_alloc_pixels(&keyframe)) {
+        return;
+    }
+    SkAutoLockPixels alp(keyframe);
+    if (bm.copyPixelsTo(keyframe.getPixels(), keyframe.getSize(), keyframe.rowBytes())) {
+        keyframe.setImmutable();
+        SkResourceCache::Add(SkNEW_ARGS(KeyframeRec, (fUniqueID, index, keyframe)));
+    }
+}
+
 bool SkGIFMovie::onGetBitmap(SkBitmap* bm)
 {
     const GifFileType* gif = fGIF;
@@ -361,6 +494,15 @@ bool SkGIFMovie::onGetBitmap(SkBitmap* bm)
         return true;
     }
 
+    int lastIndex = fCurrIndex;
+    if (lastIndex < 0) {
+        // first time
+        lastIndex = 0;
+    } else if (lastIndex > fGIF->ImageCount - 1) {
+        // this block must not be reached.
+        lastIndex = fGIF->ImageCount - 1;
+    }
+
     int startIndex = fLastDrawIndex + 1;
     if (fLastDrawIndex < 0 || !bm->readyToDraw()) {
         // first time
@@ -375,18 +517,15 @@ bool SkGIFMovie::onGetBitmap(SkBitmap* bm)
         if (!fBackup.tryAllocN32Pixels(width, height)) {
             return false;
         }
-    } else if (startIndex > fCurrIndex) {
-        // rewind to 1st frame for repeat
+    } else if (startIndex > lastIndex) {
+        // seeking backward (or looping): go back to the nearest keyframe, or the 1st frame
         startIndex = 0;
     }
 
-    int lastIndex = fCurrIndex;
-    if (lastIndex < 0) {
-        // first time
-        lastIndex = 0;
-    } else if (lastIndex > fGIF->ImageCount - 1) {
-        // this block must not be reached.
-        lastIndex = fGIF->ImageCount - 1;
+    // Start from the latest cached keyframe instead, if that skips any frames.
+    int keyframe = this->findKeyframe(0 == startIndex ? 0 : startIndex + 1, lastIndex, bm);
+    if (keyframe >= 0) {
+        startIndex = keyframe + 1;
     }
 
     SkColor bgColor = SkPackARGB32(0, 0, 0, 0);
@@ -395,8 +534,7 @@ bool SkGIFMovie::onGetBitmap(SkBitmap* bm)
         bgColor = SkColorSetARGB(0xFF, col.Red, col.Green, col.Blue);
     }
 
-    static SkColor paintingColor = SkPackARGB32(0, 0, 0, 0);
-    // draw each frames - not intelligent way
+    // Draw each frame since the start; each only touches its own rect.
     for (int i = startIndex; i <= lastIndex; i++) {
         const SavedImage* cur = &fGIF->SavedImages[i];
         if (i == 0) {
@@ -404,17 +542,17 @@ bool SkGIFMovie::onGetBitmap(SkBitmap* bm)
             int disposal;
             getTransparencyAndDisposalMethod(cur, &trans, &disposal);
             if (!trans && gif->SColorMap != NULL) {
-                paintingColor = bgColor;
+                fPaintingColor = bgColor;
             } else {
-                paintingColor = SkColorSetARGB(0, 0, 0, 0);
+                fPaintingColor = SkColorSetARGB(0, 0, 0, 0);
             }
 
-            bm->eraseColor(paintingColor);
-            fBackup.eraseColor(paintingColor);
+            bm->eraseColor(fPaintingColor);
+            fBackup.eraseColor(fPaintingColor);
         } else {
             // Dispose previous frame before move to next frame.
             const SavedImage* prev = &fGIF->SavedImages[i-1];
-            disposeFrameIfNeeded(bm, prev, cur, &fBackup, paintingColor);
+            disposeFrameIfNeeded(bm, prev, cur, &fBackup, fPaintingColor);
         }
 
         // Draw frame
@@ -423,6 +561,10 @@ bool SkGIFMovie::onGetBitmap(SkBitmap* bm)
         if (i == lastIndex || !checkIfWillBeCleared(cur)) {
             drawFrame(bm, cur, gif->SColorMap);
         }
+
+        if (fIsKeyframe[i]) {
+            this->addKeyframe(i, *bm);
+        }
     }
 
     // save index
@@ -0,0 +1,211 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBlitRow_opts_AVX2.h"
+
+// Some compilers can't compile AVX2 intrinsics.  We give them stub methods.
+// The stubs should never be called, so we make them crash just to confirm that.
+#if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX2
+void S32_Blend_BlitRow32_AVX2(SkPMColor* SK_RESTRICT, const SkPMColor* SK_RESTRICT, int, U8CPU) {
+    sk_throw();
+}
+
+void S32A_Opaque_BlitRow32_AVX2(SkPMColor* SK_RESTRICT, const SkPMColor* SK_RESTRICT, int, U8CPU) {
+    sk_throw();
+}
+
+void S32A_Blend_BlitRow32_AVX2(SkPMColor* SK_RESTRICT, const SkPMColor* SK_RESTRICT, int, U8CPU) {
+    sk_throw();
+}
+
+void Color32_AVX2(SkPMColor[], const SkPMColor[], int, SkPMColor) {
+    sk_throw();
+}
+
+void SkARGB32_A8_BlitMask_AVX2(void*, size_t, const void*, size_t, SkColor, int, int) {
+    sk_throw();
+}
+
+#else
+
+#include "SkColorPriv.h"
+#include "SkColor_opts_AVX2.h"
+#include "SkUtils.h"
+
+// Unlike the SSE2 procs, these don't bother aligning dst first: on AVX2 hardware unaligned
+// loads and stores of aligned data cost the same as aligned ones, and a split line only
+// costs a little.
+
+static inline __m256i load8(const SkPMColor* ptr) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+}
+
+static inline void store8(SkPMColor* ptr, const __m256i& v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), v);
+}
+
+void S32_Blend_BlitRow32_AVX2(SkPMColor* SK_RESTRICT dst,
+                              const SkPMColor* SK_RESTRICT src,
+                              int count, U8CPU alpha) {
+    SkASSERT(alpha <= 255);
+    unsigned src_scale = SkAlpha255To256(alpha);
+    unsigned dst_scale = 256 - src_scale;
+
+    while (count >= 8) {
+        __m256i s = SkAlphaMulQ_AVX2(load8(src), src_scale),
+                d = SkAlphaMulQ_AVX2(load8(dst), dst_scale);
+        store8(dst, _mm256_add_epi8(s, d));
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+    while (count > 0) {
+        *dst = SkAlphaMulQ(*src, src_scale) + SkAlphaMulQ(*dst, dst_scale);
+        src++;
+        dst++;
+        count--;
+    }
+}
+
+void S32A_Opaque_BlitRow32_AVX2(SkPMColor* SK_RESTRICT dst,
+                                const SkPMColor* SK_RESTRICT src,
+                                int count, U8CPU alpha) {
+    SkASSERT(alpha == 255);
+    const __m256i alphaMask = _mm256_set1_epi32(0xFF << SK_A32_SHIFT);
+
+    // As long as we can, we'll work on 32 pixels at once, like the SSE4 version does with 16.
+    while (count >= 32) {
+        __m256i s0 = load8(src +  0),
+                s1 = load8(src +  8),
+                s2 = load8(src + 16),
+                s3 = load8(src + 24);
+
+        const __m256i ORed = _mm256_or_si256(s3, _mm256_or_si256(s2, _mm256_or_si256(s1, s0)));
+        if (_mm256_testz_si256(ORed, alphaMask)) {
+            // All 32 source pixels are fully transparent.  There's nothing to do!
+        } else {
+            const __m256i ANDed =
+                    _mm256_and_si256(s3, _mm256_and_si256(s2, _mm256_and_si256(s1, s0)));
+            if (!_mm256_testc_si256(ANDed, alphaMask)) {
+                // The general slow case: do the blend for all 32 pixels.
+                s0 = SkPMSrcOver_AVX2(s0, load8(dst +  0));
+                s1 = SkPMSrcOver_AVX2(s1, load8(dst +  8));
+                s2 = SkPMSrcOver_AVX2(s2, load8(dst + 16));
+                s3 = SkPMSrcOver_AVX2(s3, load8(dst + 24));
+            }
+            // (Otherwise all 32 are opaque and there's no need to read dst or blend it.)
+            store8(dst +  0, s0);
+            store8(dst +  8, s1);
+            store8(dst + 16, s2);
+            store8(dst + 24, s3);
+        }
+        src += 32;
+        dst += 32;
+        count -= 32;
+    }
+
+    while (count >= 8) {
+        __m256i s = load8(src);
+        if (!_mm256_testz_si256(s, alphaMask)) {
+            store8(dst, SkPMSrcOver_AVX2(s, load8(dst)));
+        }
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+
+    // Wrap up the last <= 7 pixels.
+    while (count > 0) {
+        // This check is not really necessarily, but it prevents pointless autovectorization.
+        if (*src & 0xFF000000) {
+            *dst = SkPMSrcOver(*src, *dst);
+        }
+        src++;
+        dst++;
+        count--;
+    }
+}
+
+void S32A_Blend_BlitRow32_AVX2(SkPMColor* SK_RESTRICT dst,
+                               const SkPMColor* SK_RESTRICT src,
+                               int count, U8CPU alpha) {
+    SkASSERT(alpha <= 255);
+    while (count >= 8) {
+        store8(dst, SkBlendARGB32_AVX2(load8(src), load8(dst), alpha));
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+    while (count > 0) {
+        *dst = SkBlendARGB32(*src, *dst, alpha);
+        src++;
+        dst++;
+        count--;
+    }
+}
+
+void Color32_AVX2(SkPMColor dst[], const SkPMColor src[], int count, SkPMColor color) {
+    if (count <= 0) {
+        return;
+    }
+
+    if (0 == color) {
+        if (src != dst) {
+            memcpy(dst, src, count * sizeof(SkPMColor));
+        }
+        return;
+    }
+
+    unsigned colorA = SkGetPackedA32(color);
+    if (255 == colorA) {
+        sk_memset32(dst, color, count);
+        return;
+    }
+
+    unsigned scale = 256 - SkAlpha255To256(colorA);
+    const __m256i color_wide = _mm256_set1_epi32(color);
+    while (count >= 8) {
+        store8(dst, _mm256_add_epi8(color_wide, SkAlphaMulQ_AVX2(load8(src), scale)));
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+    while (count > 0) {
+        *dst = color + SkAlphaMulQ(*src, scale);
+        src += 1;
+        dst += 1;
+        count--;
+    }
+}
+
+void SkARGB32_A8_BlitMask_AVX2(void* device, size_t dstRB, const void* maskPtr,
+                               size_t maskRB, SkColor origColor,
+                               int width, int height) {
+    SkPMColor color = SkPreMultiplyColor(origColor);
+    const __m256i src_pixel = _mm256_set1_epi32(color);
+    SkPMColor* dst = (SkPMColor*)device;
+    const uint8_t* mask = (const uint8_t*)maskPtr;
+    do {
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            // Widen 8 mask bytes to 8 32-bit alphas.
+            __m128i aa = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(mask + x));
+            __m256i alpha_wide = _mm256_cvtepu8_epi32(aa);
+            if (_mm256_testz_si256(alpha_wide, alpha_wide)) {
+                continue;   // Nothing covered, dst is unchanged.
+            }
+            store8(dst + x, SkBlendARGB32_AVX2(src_pixel, load8(dst + x), alpha_wide));
+        }
+        for (; x < width; x++) {
+            dst[x] = SkBlendARGB32(color, dst[x], mask[x]);
+        }
+        dst = (SkPMColor*)((char*)dst + dstRB);
+        mask += maskRB;
+    } while (--height != 0);
+}
+
+#endif
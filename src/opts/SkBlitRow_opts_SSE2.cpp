@@ -1222,3 +1222,282 @@ void S32A_D565_Opaque_Dither_SSE2(uint16_t* SK_RESTRICT dst,
         } while (--count != 0);
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// The blending 565 procs.  Like the portable versions in core/SkBlitRow_D16.cpp,
+// these work per channel with 565 precision, so each lane is one channel of one
+// of 8 pixels.
+
+// Returns the dither values for pixels x..x+7 of row y.  The matrix is 4 wide,
+// so the same values serve every 8 pixel step along a row.
+static inline __m128i dither_values_SSE2(int x, int y) {
+    uint16_t dither_value[8];
+    for (int i = 0; i < 4; ++i) {
+#ifdef ENABLE_DITHER_MATRIX_4X4
+        dither_value[i] = gDitherMatrix_3Bit_4X4[y & 3][(x + i) & 3];
+#else
+        dither_value[i] = (gDitherMatrix_3Bit_16[y & 3] >> (((x + i) & 3) << 2)) & 0xF;
+#endif
+        dither_value[i + 4] = dither_value[i];
+    }
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(dither_value));
+}
+
+// Extracts one 8-bit channel of 8 SkPMColors into 16-bit lanes.
+template <int kShift>
+static inline __m128i get_channel_SSE2(const __m128i& src_pixel1, const __m128i& src_pixel2) {
+    __m128i c1 = _mm_srli_epi32(_mm_slli_epi32(src_pixel1, 24 - kShift), 24);
+    __m128i c2 = _mm_srli_epi32(_mm_slli_epi32(src_pixel2, 24 - kShift), 24);
+    return _mm_packs_epi32(c1, c2);
+}
+
+// SkDITHER_R32To565() etc. on 16-bit lanes.
+static inline __m128i dither_r32_to_565_SSE2(const __m128i& r, const __m128i& dither) {
+    __m128i v = _mm_sub_epi16(_mm_add_epi16(r, dither), _mm_srli_epi16(r, 5));
+    return _mm_srli_epi16(v, SK_R32_BITS - SK_R16_BITS);
+}
+
+static inline __m128i dither_g32_to_565_SSE2(const __m128i& g, const __m128i& dither) {
+    __m128i v = _mm_sub_epi16(_mm_add_epi16(g, _mm_srli_epi16(dither, 1)),
+                              _mm_srli_epi16(g, 6));
+    return _mm_srli_epi16(v, SK_G32_BITS - SK_G16_BITS);
+}
+
+static inline __m128i dither_b32_to_565_SSE2(const __m128i& b, const __m128i& dither) {
+    __m128i v = _mm_sub_epi16(_mm_add_epi16(b, dither), _mm_srli_epi16(b, 5));
+    return _mm_srli_epi16(v, SK_B32_BITS - SK_B16_BITS);
+}
+
+// SkAlphaBlend(src, dst, scale) on 16-bit lanes: dst + ((src - dst) * scale >> 8).
+// The difference times a scale of at most 256 still fits in a signed 16-bit lane.
+static inline __m128i alpha_blend_SSE2(const __m128i& src, const __m128i& dst,
+                                       const __m128i& scale) {
+    __m128i diff = _mm_mullo_epi16(_mm_sub_epi16(src, dst), scale);
+    return _mm_add_epi16(dst, _mm_srai_epi16(diff, 8));
+}
+
+static inline void unpack_565_SSE2(const __m128i& pixels, __m128i* r, __m128i* g, __m128i* b) {
+    *r = _mm_and_si128(_mm_srli_epi16(pixels, SK_R16_SHIFT), _mm_set1_epi16(SK_R16_MASK));
+    *g = _mm_and_si128(_mm_srli_epi16(pixels, SK_G16_SHIFT), _mm_set1_epi16(SK_G16_MASK));
+    *b = _mm_and_si128(_mm_srli_epi16(pixels, SK_B16_SHIFT), _mm_set1_epi16(SK_B16_MASK));
+}
+
+/* SSE2 version of S32_D565_Blend()
+ * portable version is in core/SkBlitRow_D16.cpp
+ */
+void S32_D565_Blend_SSE2(uint16_t* SK_RESTRICT dst,
+                         const SkPMColor* SK_RESTRICT src, int count,
+                         U8CPU alpha, int /*x*/, int /*y*/) {
+    SkASSERT(255 > alpha);
+
+    int scale = SkAlpha255To256(alpha);
+    const __m128i scale_wide = _mm_set1_epi16(scale);
+    while (count >= 8) {
+        __m128i src_pixel1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        __m128i src_pixel2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+        __m128i dst_pixel = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+
+        __m128i sr = _mm_srli_epi16(get_channel_SSE2<SK_R32_SHIFT>(src_pixel1, src_pixel2),
+                                    SK_R32_BITS - SK_R16_BITS);
+        __m128i sg = _mm_srli_epi16(get_channel_SSE2<SK_G32_SHIFT>(src_pixel1, src_pixel2),
+                                    SK_G32_BITS - SK_G16_BITS);
+        __m128i sb = _mm_srli_epi16(get_channel_SSE2<SK_B32_SHIFT>(src_pixel1, src_pixel2),
+                                    SK_B32_BITS - SK_B16_BITS);
+        __m128i dr, dg, db;
+        unpack_565_SSE2(dst_pixel, &dr, &dg, &db);
+
+        __m128i d_pixel = SkPackRGB16_SSE2(alpha_blend_SSE2(sr, dr, scale_wide),
+                                           alpha_blend_SSE2(sg, dg, scale_wide),
+                                           alpha_blend_SSE2(sb, db, scale_wide));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), d_pixel);
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+
+    while (count > 0) {
+        SkPMColor c = *src++;
+        SkPMColorAssert(c);
+        uint16_t d = *dst;
+        *dst++ = SkPackRGB16(
+                SkAlphaBlend(SkPacked32ToR16(c), SkGetPackedR16(d), scale),
+                SkAlphaBlend(SkPacked32ToG16(c), SkGetPackedG16(d), scale),
+                SkAlphaBlend(SkPacked32ToB16(c), SkGetPackedB16(d), scale));
+        count--;
+    }
+}
+
+/* SSE2 version of S32A_D565_Blend()
+ * portable version is in core/SkBlitRow_D16.cpp
+ */
+void S32A_D565_Blend_SSE2(uint16_t* SK_RESTRICT dst,
+                          const SkPMColor* SK_RESTRICT src, int count,
+                          U8CPU alpha, int /*x*/, int /*y*/) {
+    SkASSERT(255 > alpha);
+
+    // The portable version skips transparent src pixels, but blending them leaves dst unchanged
+    // anyway, so we needn't.
+    const __m128i zero = _mm_setzero_si128();
+    while (count >= 8) {
+        __m128i src_pixel1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        __m128i src_pixel2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+        __m128i dst_pixel = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+
+        __m128i dst_pixel1 = SkPixel16ToPixel32_SSE2(_mm_unpacklo_epi16(dst_pixel, zero));
+        __m128i dst_pixel2 = SkPixel16ToPixel32_SSE2(_mm_unpackhi_epi16(dst_pixel, zero));
+        dst_pixel1 = SkBlendARGB32_SSE2(src_pixel1, dst_pixel1, alpha);
+        dst_pixel2 = SkBlendARGB32_SSE2(src_pixel2, dst_pixel2, alpha);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                         SkPixel32ToPixel16_ToU16_SSE2(dst_pixel1, dst_pixel2));
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+
+    while (count > 0) {
+        SkPMColor sc = *src++;
+        SkPMColorAssert(sc);
+        if (sc) {
+            uint16_t dc = *dst;
+            SkPMColor res = SkBlendARGB32(sc, SkPixel16ToPixel32(dc), alpha);
+            *dst = SkPixel32ToPixel16(res);
+        }
+        dst += 1;
+        count--;
+    }
+}
+
+/* SSE2 version of S32_D565_Blend_Dither()
+ * portable version is in core/SkBlitRow_D16.cpp
+ */
+void S32_D565_Blend_Dither_SSE2(uint16_t* SK_RESTRICT dst,
+                                const SkPMColor* SK_RESTRICT src,
+                                int count, U8CPU alpha, int x, int y) {
+    SkASSERT(255 > alpha);
+
+    int scale = SkAlpha255To256(alpha);
+    if (count >= 8) {
+        const __m128i dither = dither_values_SSE2(x, y);
+        const __m128i scale_wide = _mm_set1_epi16(scale);
+        do {
+            __m128i src_pixel1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            __m128i src_pixel2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+            __m128i dst_pixel = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+
+            __m128i sr = dither_r32_to_565_SSE2(
+                    get_channel_SSE2<SK_R32_SHIFT>(src_pixel1, src_pixel2), dither);
+            __m128i sg = dither_g32_to_565_SSE2(
+                    get_channel_SSE2<SK_G32_SHIFT>(src_pixel1, src_pixel2), dither);
+            __m128i sb = dither_b32_to_565_SSE2(
+                    get_channel_SSE2<SK_B32_SHIFT>(src_pixel1, src_pixel2), dither);
+            __m128i dr, dg, db;
+            unpack_565_SSE2(dst_pixel, &dr, &dg, &db);
+
+            __m128i d_pixel = SkPackRGB16_SSE2(alpha_blend_SSE2(sr, dr, scale_wide),
+                                               alpha_blend_SSE2(sg, dg, scale_wide),
+                                               alpha_blend_SSE2(sb, db, scale_wide));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), d_pixel);
+            src += 8;
+            dst += 8;
+            count -= 8;
+            x += 8;
+        } while (count >= 8);
+    }
+
+    if (count > 0) {
+        DITHER_565_SCAN(y);
+        do {
+            SkPMColor c = *src++;
+            SkPMColorAssert(c);
+
+            int dither = DITHER_VALUE(x);
+            int sr = SkDITHER_R32To565(SkGetPackedR32(c), dither);
+            int sg = SkDITHER_G32To565(SkGetPackedG32(c), dither);
+            int sb = SkDITHER_B32To565(SkGetPackedB32(c), dither);
+
+            uint16_t d = *dst;
+            *dst++ = SkPackRGB16(SkAlphaBlend(sr, SkGetPackedR16(d), scale),
+                                 SkAlphaBlend(sg, SkGetPackedG16(d), scale),
+                                 SkAlphaBlend(sb, SkGetPackedB16(d), scale));
+            DITHER_INC_X(x);
+        } while (--count != 0);
+    }
+}
+
+/* SSE2 version of S32A_D565_Blend_Dither()
+ * portable version is in core/SkBlitRow_D16.cpp
+ */
+void S32A_D565_Blend_Dither_SSE2(uint16_t* SK_RESTRICT dst,
+                                 const SkPMColor* SK_RESTRICT src,
+                                 int count, U8CPU alpha, int x, int y) {
+    SkASSERT(255 > alpha);
+
+    int src_scale = SkAlpha255To256(alpha);
+    if (count >= 8) {
+        // As with S32A_D565_Blend_SSE2, transparent src pixels (which dither to 0) leave dst
+        // unchanged without being special-cased.
+        const __m128i dither = dither_values_SSE2(x, y);
+        const __m128i src_scale_wide = _mm_set1_epi16(src_scale);
+        const __m128i var256 = _mm_set1_epi16(256);
+        do {
+            __m128i src_pixel1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            __m128i src_pixel2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+            __m128i dst_pixel = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+
+            // SkAlpha255To256(255 - SkAlphaMul(sa, src_scale)); sa * src_scale fits in 16 bits.
+            __m128i sa = get_channel_SSE2<SK_A32_SHIFT>(src_pixel1, src_pixel2);
+            __m128i dst_scale = _mm_sub_epi16(var256,
+                    _mm_srli_epi16(_mm_mullo_epi16(sa, src_scale_wide), 8));
+
+            __m128i sr = dither_r32_to_565_SSE2(
+                    get_channel_SSE2<SK_R32_SHIFT>(src_pixel1, src_pixel2), dither);
+            __m128i sg = dither_g32_to_565_SSE2(
+                    get_channel_SSE2<SK_G32_SHIFT>(src_pixel1, src_pixel2), dither);
+            __m128i sb = dither_b32_to_565_SSE2(
+                    get_channel_SSE2<SK_B32_SHIFT>(src_pixel1, src_pixel2), dither);
+            __m128i dr, dg, db;
+            unpack_565_SSE2(dst_pixel, &dr, &dg, &db);
+
+            // (s * src_scale + d * dst_scale) >> 8, which is at most 63 * 511 for green.
+            dr = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(sr, src_scale_wide),
+                                              _mm_mullo_epi16(dr, dst_scale)), 8);
+            dg = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(sg, src_scale_wide),
+                                              _mm_mullo_epi16(dg, dst_scale)), 8);
+            db = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(sb, src_scale_wide),
+                                              _mm_mullo_epi16(db, dst_scale)), 8);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), SkPackRGB16_SSE2(dr, dg, db));
+            src += 8;
+            dst += 8;
+            count -= 8;
+            x += 8;
+        } while (count >= 8);
+    }
+
+    if (count > 0) {
+        DITHER_565_SCAN(y);
+        do {
+            SkPMColor c = *src++;
+            SkPMColorAssert(c);
+            if (c) {
+                unsigned d = *dst;
+                int sa = SkGetPackedA32(c);
+                int dst_scale = SkAlpha255To256(255 - SkAlphaMul(sa, src_scale));
+                int dither = DITHER_VALUE(x);
+
+                int sr = SkDITHER_R32To565(SkGetPackedR32(c), dither);
+                int sg = SkDITHER_G32To565(SkGetPackedG32(c), dither);
+                int sb = SkDITHER_B32To565(SkGetPackedB32(c), dither);
+
+                int dr = (sr * src_scale + SkGetPackedR16(d) * dst_scale) >> 8;
+                int dg = (sg * src_scale + SkGetPackedG16(d) * dst_scale) >> 8;
+                int db = (sb * src_scale + SkGetPackedB16(d) * dst_scale) >> 8;
+
+                *dst = SkPackRGB16(dr, dg, db);
+            }
+            dst += 1;
+            DITHER_INC_X(x);
+        } while (--count != 0);
+    }
+}
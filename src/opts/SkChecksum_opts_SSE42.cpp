@@ -0,0 +1,77 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkChecksum_opts_SSE42.h"
+
+// Some compilers can't compile SSE4.2 intrinsics.  We give them stub methods.
+// The stubs should never be called, so we make them crash just to confirm that.
+#if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_SSE42
+uint32_t SkChecksum_Hash_SSE42(const void*, size_t, uint32_t) {
+    sk_throw();
+    return 0;
+}
+
+#else
+
+#include <nmmintrin.h>      // SSE4.2 intrinsics
+#include "SkChecksum.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+    typedef uint64_t Word;
+    static inline uint32_t crc_word(uint32_t crc, Word w) {
+        return (uint32_t)_mm_crc32_u64(crc, w);
+    }
+#else
+    typedef uint32_t Word;
+    static inline uint32_t crc_word(uint32_t crc, Word w) {
+        return _mm_crc32_u32(crc, w);
+    }
+#endif
+
+static inline Word load_word(const uint8_t* ptr) {
+    Word w;
+    memcpy(&w, ptr, sizeof(w));
+    return w;
+}
+
+uint32_t SkChecksum_Hash_SSE42(const void* data, size_t bytes, uint32_t seed) {
+    const uint8_t* ptr = (const uint8_t*)data;
+    size_t left = bytes;
+    uint32_t hash = seed;
+
+    if (left >= 64) {
+        // crc32 has a latency of 3 cycles but a throughput of 1, so run three independent
+        // streams over interleaved words and fold the other two into the first at the end.
+        uint32_t b = seed ^ 0x9e3779b9,
+                 c = seed ^ 0x7f4a7c15;
+        while (left >= 3 * sizeof(Word)) {
+            hash = crc_word(hash, load_word(ptr + 0 * sizeof(Word)));
+            b    = crc_word(b,    load_word(ptr + 1 * sizeof(Word)));
+            c    = crc_word(c,    load_word(ptr + 2 * sizeof(Word)));
+            ptr  += 3 * sizeof(Word);
+            left -= 3 * sizeof(Word);
+        }
+        hash = _mm_crc32_u32(hash, b);
+        hash = _mm_crc32_u32(hash, c);
+    }
+
+    while (left >= sizeof(Word)) {
+        hash = crc_word(hash, load_word(ptr));
+        ptr  += sizeof(Word);
+        left -= sizeof(Word);
+    }
+    while (left > 0) {
+        hash = _mm_crc32_u8(hash, *ptr++);
+        left -= 1;
+    }
+
+    // CRC32C is linear, so similar keys give related CRCs.  The Murmur3 finalizer breaks that
+    // up before callers mask off the low bits for a table index.
+    return SkChecksum::Mix(hash ^ SkToU32(bytes));
+}
+
+#endif
@@ -0,0 +1,15 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkChecksum_opts_SSE42_DEFINED
+#define SkChecksum_opts_SSE42_DEFINED
+
+#include "SkTypes.h"
+
+uint32_t SkChecksum_Hash_SSE42(const void* data, size_t bytes, uint32_t seed);
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkColor_opts_AVX2_DEFINED
+#define SkColor_opts_AVX2_DEFINED
+
+#include <immintrin.h>
+
+// Eight-pixel versions of the helpers in SkColor_opts_SSE2.h.  They produce exactly the same
+// results as the SSE2 and portable versions.  Only include this from files built with AVX2.
+
+// Portable version SkAlphaMulQ is in SkColorPriv.h.
+static inline __m256i SkAlphaMulQ_AVX2(const __m256i& c, const __m256i& scale) {
+    const __m256i mask = _mm256_set1_epi32(0xFF00FF);
+    __m256i s = _mm256_or_si256(_mm256_slli_epi32(scale, 16), scale);
+
+    // uint32_t rb = ((c & mask) * scale) >> 8
+    __m256i rb = _mm256_and_si256(mask, c);
+    rb = _mm256_mullo_epi16(rb, s);
+    rb = _mm256_srli_epi16(rb, 8);
+
+    // uint32_t ag = ((c >> 8) & mask) * scale
+    __m256i ag = _mm256_srli_epi16(c, 8);
+    ag = _mm256_mullo_epi16(ag, s);
+
+    // (rb & mask) | (ag & ~mask)
+    ag = _mm256_andnot_si256(mask, ag);
+    return _mm256_or_si256(rb, ag);
+}
+
+// Fast path for SkAlphaMulQ_AVX2 with a constant scale factor.
+static inline __m256i SkAlphaMulQ_AVX2(const __m256i& c, const unsigned scale) {
+    const __m256i mask = _mm256_set1_epi32(0xFF00FF);
+    __m256i s = _mm256_set1_epi16(scale << 8); // Move scale factor to upper byte of word.
+
+    // With mulhi, red and blue values are already in the right place and
+    // don't need to be divided by 256.
+    __m256i rb = _mm256_and_si256(mask, c);
+    rb = _mm256_mulhi_epu16(rb, s);
+
+    __m256i ag = _mm256_andnot_si256(mask, c);
+    ag = _mm256_mulhi_epu16(ag, s);  // Alpha and green values are in the higher byte of each word.
+    ag = _mm256_andnot_si256(mask, ag);
+
+    return _mm256_or_si256(rb, ag);
+}
+
+static inline __m256i SkGetPackedA32_AVX2(const __m256i& src) {
+#if SK_A32_SHIFT == 24
+    return _mm256_srli_epi32(src, 24);
+#else
+    __m256i a = _mm256_slli_epi32(src, (24 - SK_A32_SHIFT));
+    return _mm256_srli_epi32(a, 24);
+#endif
+}
+
+// Portable version is SkPMSrcOver in SkColorPriv.h.
+static inline __m256i SkPMSrcOver_AVX2(const __m256i& src, const __m256i& dst) {
+    return _mm256_add_epi32(src,
+                            SkAlphaMulQ_AVX2(dst, _mm256_sub_epi32(_mm256_set1_epi32(256),
+                                                                   SkGetPackedA32_AVX2(src))));
+}
+
+// Portable version is SkBlendARGB32 in SkColorPriv.h.
+static inline __m256i SkBlendARGB32_AVX2(const __m256i& src, const __m256i& dst,
+                                         const __m256i& aa) {
+    __m256i src_scale = _mm256_add_epi32(aa, _mm256_set1_epi32(1));
+    // SkAlpha255To256(255 - SkAlphaMul(SkGetPackedA32(src), src_scale))
+    __m256i dst_scale = SkGetPackedA32_AVX2(src);
+    dst_scale = _mm256_mullo_epi16(dst_scale, src_scale);
+    dst_scale = _mm256_srli_epi16(dst_scale, 8);
+    dst_scale = _mm256_sub_epi32(_mm256_set1_epi32(256), dst_scale);
+
+    __m256i result = SkAlphaMulQ_AVX2(src, src_scale);
+    return _mm256_add_epi8(result, SkAlphaMulQ_AVX2(dst, dst_scale));
+}
+
+// Fast path for SkBlendARGB32_AVX2 with a constant alpha factor.
+static inline __m256i SkBlendARGB32_AVX2(const __m256i& src, const __m256i& dst,
+                                         const unsigned aa) {
+    unsigned alpha = SkAlpha255To256(aa);
+    __m256i src_scale = _mm256_set1_epi32(alpha);
+    // SkAlpha255To256(255 - SkAlphaMul(SkGetPackedA32(src), src_scale))
+    __m256i dst_scale = SkGetPackedA32_AVX2(src);
+    dst_scale = _mm256_mullo_epi16(dst_scale, src_scale);
+    dst_scale = _mm256_srli_epi16(dst_scale, 8);
+    dst_scale = _mm256_sub_epi32(_mm256_set1_epi32(256), dst_scale);
+
+    __m256i result = SkAlphaMulQ_AVX2(src, alpha);
+    return _mm256_add_epi8(result, SkAlphaMulQ_AVX2(dst, dst_scale));
+}
+
+#endif // SkColor_opts_AVX2_DEFINED
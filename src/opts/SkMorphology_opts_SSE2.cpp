@@ -8,6 +8,7 @@
 #include <emmintrin.h>
 #include "SkColorPriv.h"
 #include "SkMorphology_opts_SSE2.h"
+#include "SkTypes.h"
 
 /* SSE2 version of dilateX, dilateY, erodeX, erodeY.
  * portable versions are in src/effects/SkMorphologyImageFilter.cpp.
@@ -21,6 +22,87 @@ enum MorphDirection {
     kX, kY
 };
 
+// Below these radii the direct loop over the window is faster than the van Herk/Gil-Werman
+// setup (see MorphologyBench).  The direct loop walks across lines in the inner loop, which is
+// especially slow for the X pass.
+static const int kMinVanHerkRadiusX = 1;
+static const int kMinVanHerkRadiusY = 2;
+
+template<MorphType type>
+static inline __m128i morph_op(__m128i a, __m128i b) {
+    return type == kDilate ? _mm_max_epu8(a, b) : _mm_min_epu8(a, b);
+}
+
+/* van Herk/Gil-Werman running max (dilate) or min (erode), O(1) per pixel for any radius.
+ * The line is padded by radius identity pixels at either end (so the window clamps to the
+ * line as in the direct version) and cut into blocks of 2 * radius + 1 pixels.  Every window
+ * then spans at most two blocks, and is the combination of a suffix of the first block with
+ * a prefix of the second, both of which are precomputed in one pass each.
+ * Four lines are processed at once, one per 32-bit lane.
+ */
+template<MorphType type, MorphDirection direction>
+static void SkMorphVanHerk_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
+                                int width, int height, int srcStride, int dstStride)
+{
+    const int srcStrideX = direction == kX ? 1 : srcStride;
+    const int dstStrideX = direction == kX ? 1 : dstStride;
+    const int srcStrideY = direction == kX ? srcStride : 1;
+    const int dstStrideY = direction == kX ? dstStride : 1;
+    const SkPMColor identity = type == kDilate ? 0 : 0xFFFFFFFF;
+    const int blockSize = 2 * radius + 1;
+    const int paddedWidth = (width + 2 * radius + blockSize - 1) / blockSize * blockSize;
+
+    // One spare vector so the scratch space can be 16-byte aligned.
+    SkAutoMalloc storage((2 * paddedWidth + 1) * sizeof(__m128i));
+    __m128i* prefix = (__m128i*)(((uintptr_t)storage.get() + 15) & ~(uintptr_t)15);
+    __m128i* suffix = prefix + paddedWidth;
+
+    for (int y = 0; y < height; y += 4) {
+        const int lanes = SkMin32(4, height - y);
+        const SkPMColor* srcLine = src + y * srcStrideY;
+        SkPMColor* dstLine = dst + y * dstStrideY;
+
+        for (int i = 0; i < paddedWidth; ++i) {
+            const int x = i - radius;
+            __m128i pixels;
+            if (x < 0 || x >= width) {
+                pixels = _mm_set1_epi32(identity);
+            } else if (direction == kY && 4 == lanes) {
+                // The four lines are adjacent columns, so their pixels are contiguous.
+                pixels = _mm_loadu_si128((const __m128i*)(srcLine + x * srcStrideX));
+            } else {
+                const SkPMColor* p = srcLine + x * srcStrideX;
+                pixels = _mm_setr_epi32(p[0],
+                                        lanes > 1 ? p[srcStrideY] : identity,
+                                        lanes > 2 ? p[2 * srcStrideY] : identity,
+                                        lanes > 3 ? p[3 * srcStrideY] : identity);
+            }
+            prefix[i] = (0 == i % blockSize) ? pixels : morph_op<type>(prefix[i - 1], pixels);
+            suffix[i] = pixels;
+        }
+        for (int i = paddedWidth - 2; i >= 0; --i) {
+            if (blockSize - 1 != i % blockSize) {
+                suffix[i] = morph_op<type>(suffix[i], suffix[i + 1]);
+            }
+        }
+
+        for (int x = 0; x < width; ++x) {
+            // The window for x is padded [x, x + 2 * radius].
+            __m128i result = morph_op<type>(suffix[x], prefix[x + 2 * radius]);
+            SkPMColor* d = dstLine + x * dstStrideX;
+            if (direction == kY && 4 == lanes) {
+                _mm_storeu_si128((__m128i*)d, result);
+            } else {
+                SkPMColor out[4];
+                _mm_storeu_si128((__m128i*)out, result);
+                for (int lane = 0; lane < lanes; ++lane) {
+                    d[lane * dstStrideY] = out[lane];
+                }
+            }
+        }
+    }
+}
+
 template<MorphType type, MorphDirection direction>
 static void SkMorph_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
                          int width, int height, int srcStride, int dstStride)
@@ -30,6 +112,11 @@ static void SkMorph_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
     const int srcStrideY = direction == kX ? srcStride : 1;
     const int dstStrideY = direction == kX ? dstStride : 1;
     radius = SkMin32(radius, width - 1);
+    if (radius >= (direction == kX ? kMinVanHerkRadiusX : kMinVanHerkRadiusY)) {
+        SkMorphVanHerk_SSE2<type, direction>(src, dst, radius, width, height,
+                                             srcStride, dstStride);
+        return;
+    }
     const SkPMColor* upperSrc = src + radius * srcStrideX;
     for (int x = 0; x < width; ++x) {
         const SkPMColor* lp = src;
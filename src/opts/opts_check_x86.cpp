@@ -11,10 +11,13 @@
 #include "SkBitmapScaler.h"
 #include "SkBlitMask.h"
 #include "SkBlitRow.h"
+#include "SkBlitRow_opts_AVX2.h"
 #include "SkBlitRow_opts_SSE2.h"
 #include "SkBlitRow_opts_SSE4.h"
 #include "SkBlurImage_opts_SSE2.h"
 #include "SkBlurImage_opts_SSE4.h"
+#include "SkChecksum.h"
+#include "SkChecksum_opts_SSE42.h"
 #include "SkLazyPtr.h"
 #include "SkMorphology_opts.h"
 #include "SkMorphology_opts_SSE2.h"
@@ -24,8 +27,9 @@
 #include "SkXfermode.h"
 #include "SkXfermode_proccoeff.h"
 
-#if defined(_MSC_VER) && defined(_WIN64)
+#if defined(_MSC_VER)
 #include <intrin.h>
+#include <immintrin.h>  // _xgetbv
 #endif
 
 /* This file must *not* be compiled with -msse or any other optional SIMD
@@ -39,10 +43,11 @@
 #ifdef _MSC_VER
 static inline void getcpuid(int info_type, int info[4]) {
 #if defined(_WIN64)
-    __cpuid(info, info_type);
+    __cpuidex(info, info_type, 0);
 #else
     __asm {
         mov    eax, [info_type]
+        xor    ecx, ecx
         cpuid
         mov    edi, [info]
         mov    [edi], eax
@@ -57,7 +62,7 @@ static inline void getcpuid(int info_type, int info[4]) {
     asm volatile (
         "cpuid \n\t"
         : "=a"(info[0]), "=b"(info[1]), "=c"(info[2]), "=d"(info[3])
-        : "a"(info_type)
+        : "a"(info_type), "2"(0)
     );
 }
 #else
@@ -69,11 +74,44 @@ static inline void getcpuid(int info_type, int info[4]) {
         "movl %%ebx, %1   \n\t"
         "popl %%ebx       \n\t"
         : "=a"(info[0]), "=r"(info[1]), "=c"(info[2]), "=d"(info[3])
-        : "a"(info_type)
+        : "a"(info_type), "2"(0)
     );
 }
 #endif
 
+/* Returns the low 32 bits of extended control register 0, i.e. which register state the OS
+ * saves and restores on context switches.
+ */
+static inline uint32_t get_xcr0() {
+#ifdef _MSC_VER
+    return (uint32_t)_xgetbv(0);
+#else
+    uint32_t eax, edx;
+    asm volatile ( "xgetbv" : "=a"(eax), "=d"(edx) : "c"(0) );
+    return eax;
+#endif
+}
+
+/* AVX2 needs both the CPU feature bit and an OS that preserves the YMM registers. */
+static bool cpu_supports_avx2(const int cpu_info[4]) {
+    const int kOSXSAVE = 1 << 27,
+              kAVX     = 1 << 28;
+    if ((cpu_info[2] & (kOSXSAVE | kAVX)) != (kOSXSAVE | kAVX)) {
+        return false;
+    }
+    if ((get_xcr0() & 0x6) != 0x6) {  // XMM and YMM state
+        return false;
+    }
+    int max_info[4] = { 0, 0, 0, 0 };
+    getcpuid(0, max_info);
+    if (max_info[0] < 7) {
+        return false;
+    }
+    int ext_info[4] = { 0, 0, 0, 0 };
+    getcpuid(7, ext_info);
+    return (ext_info[1] & (1<<5)) != 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /* Fetch the SIMD level directly from the CPU, at run-time.
@@ -86,7 +124,9 @@ int* get_SIMD_level() {
 
     int* level = SkNEW(int);
 
-    if ((cpu_info[2] & (1<<20)) != 0) {
+    if ((cpu_info[2] & (1<<20)) != 0 && cpu_supports_avx2(cpu_info)) {
+        *level = SK_CPU_SSE_LEVEL_AVX2;
+    } else if ((cpu_info[2] & (1<<20)) != 0) {
         *level = SK_CPU_SSE_LEVEL_SSE42;
     } else if ((cpu_info[2] & (1<<19)) != 0) {
         *level = SK_CPU_SSE_LEVEL_SSE41;
@@ -198,13 +238,13 @@ void SkBitmapProcState::platformProcs() {
 
 static const SkBlitRow::Proc16 platform_16_procs[] = {
     S32_D565_Opaque_SSE2,               // S32_D565_Opaque
-    NULL,                               // S32_D565_Blend
+    S32_D565_Blend_SSE2,                // S32_D565_Blend
     S32A_D565_Opaque_SSE2,              // S32A_D565_Opaque
-    NULL,                               // S32A_D565_Blend
+    S32A_D565_Blend_SSE2,               // S32A_D565_Blend
     S32_D565_Opaque_Dither_SSE2,        // S32_D565_Opaque_Dither
-    NULL,                               // S32_D565_Blend_Dither
+    S32_D565_Blend_Dither_SSE2,         // S32_D565_Blend_Dither
     S32A_D565_Opaque_Dither_SSE2,       // S32A_D565_Opaque_Dither
-    NULL,                               // S32A_D565_Blend_Dither
+    S32A_D565_Blend_Dither_SSE2,        // S32A_D565_Blend_Dither
 };
 
 SkBlitRow::Proc16 SkBlitRow::PlatformFactory565(unsigned flags) {
@@ -217,7 +257,7 @@ SkBlitRow::Proc16 SkBlitRow::PlatformFactory565(unsigned flags) {
 
 static const SkBlitRow::ColorProc16 platform_565_colorprocs_SSE2[] = {
     Color32A_D565_SSE2,                 // Color32A_D565,
-    NULL,                               // Color32A_D565_Dither
+    Color32A_D565_SSE2,                 // Color32A_D565_Dither, which doesn't dither either
 };
 
 SkBlitRow::ColorProc16 SkBlitRow::PlatformColorFactory565(unsigned flags) {
@@ -247,7 +287,17 @@ static const SkBlitRow::Proc32 platform_32_procs_SSE4[] = {
     S32A_Blend_BlitRow32_SSE2,          // S32A_Blend,
 };
 
+static const SkBlitRow::Proc32 platform_32_procs_AVX2[] = {
+    NULL,                               // S32_Opaque,
+    S32_Blend_BlitRow32_AVX2,           // S32_Blend,
+    S32A_Opaque_BlitRow32_AVX2,         // S32A_Opaque
+    S32A_Blend_BlitRow32_AVX2,          // S32A_Blend,
+};
+
 SkBlitRow::Proc32 SkBlitRow::PlatformProcs32(unsigned flags) {
+    if (supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+        return platform_32_procs_AVX2[flags];
+    } else
     if (supports_simd(SK_CPU_SSE_LEVEL_SSE41)) {
         return platform_32_procs_SSE4[flags];
     } else
@@ -259,7 +309,9 @@ SkBlitRow::Proc32 SkBlitRow::PlatformProcs32(unsigned flags) {
 }
 
 SkBlitRow::ColorProc SkBlitRow::PlatformColorProc() {
-    if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
+    if (supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+        return Color32_AVX2;
+    } else if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
         return Color32_SSE2;
     } else {
         return NULL;
@@ -282,7 +334,8 @@ SkBlitMask::ColorProc SkBlitMask::PlatformColorProcs(SkColorType dstCT,
                 // The SSE2 version is not (yet) faster for black, so we check
                 // for that.
                 if (SK_ColorBLACK != color) {
-                    proc = SkARGB32_A8_BlitMask_SSE2;
+                    proc = supports_simd(SK_CPU_SSE_LEVEL_AVX2) ? SkARGB32_A8_BlitMask_AVX2
+                                                                : SkARGB32_A8_BlitMask_SSE2;
                 }
                 break;
             default:
@@ -337,6 +390,16 @@ SkMemcpy32Proc SkMemcpy32GetPlatformProc() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+SkChecksumHashProc SkChecksumHashGetPlatformProc() {
+    if (supports_simd(SK_CPU_SSE_LEVEL_SSE42)) {
+        return SkChecksum_Hash_SSE42;
+    } else {
+        return NULL;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 SkMorphologyImageFilter::Proc SkMorphologyGetPlatformProc(SkMorphologyProcType type) {
     if (!supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
         return NULL;
@@ -9,9 +9,16 @@
 #include "SkSVGDevice.h"
 
 SkCanvas* SkSVGCanvas::Create(const SkRect& bounds, SkXMLWriter* writer) {
+    return Create(bounds, writer, kFullPrecision);
+}
+
+SkCanvas* SkSVGCanvas::Create(const SkRect& bounds, SkXMLWriter* writer, int precision) {
     // TODO: pass full bounds to the device
     SkISize size = bounds.roundOut().size();
-    SkAutoTUnref<SkBaseDevice> device(SkSVGDevice::Create(size, writer));
+    SkAutoTUnref<SkBaseDevice> device(SkSVGDevice::Create(size, writer, precision));
+    if (!device) {
+        return NULL;
+    }
 
     return SkNEW_ARGS(SkCanvas, (device));
 }
@@ -12,11 +12,13 @@
 #include "SkChecksum.h"
 #include "SkData.h"
 #include "SkDraw.h"
+#include "SkGeometry.h"
 #include "SkImageEncoder.h"
 #include "SkPaint.h"
 #include "SkParsePath.h"
 #include "SkShader.h"
 #include "SkStream.h"
+#include "SkSVGCanvas.h"
 #include "SkTHash.h"
 #include "SkTypeface.h"
 #include "SkUtils.h"
@@ -25,10 +27,7 @@
 namespace {
 
 static SkString svg_color(SkColor color) {
-    return SkStringPrintf("rgb(%u,%u,%u)",
-                          SkColorGetR(color),
-                          SkColorGetG(color),
-                          SkColorGetB(color));
+    return SkStringPrintf("#%06x", color & 0xFFFFFF);
 }
 
 static SkScalar svg_opacity(SkColor color) {
@@ -103,6 +102,182 @@ static SkString svg_transform(const SkMatrix& t) {
     return tstr;
 }
 
+// Appends q / 10^precision, without trailing fractional zeros.
+static void append_fixed(SkString* str, int64_t q, int precision) {
+    char buffer[32];
+    char* p = buffer + sizeof(buffer);
+
+    uint64_t u = q < 0 ? -(uint64_t)q : (uint64_t)q;
+    bool hasFraction = false;
+    for (int i = 0; i < precision; ++i) {
+        unsigned digit = (unsigned)(u % 10);
+        u /= 10;
+        if (digit || hasFraction) {
+            *--p = '0' + digit;
+            hasFraction = true;
+        }
+    }
+    if (hasFraction) {
+        *--p = '.';
+    }
+    do {
+        *--p = '0' + (unsigned)(u % 10);
+        u /= 10;
+    } while (u);
+    if (q < 0) {
+        *--p = '-';
+    }
+
+    str->append(p, buffer + sizeof(buffer) - p);
+}
+
+class Quantizer {
+public:
+    explicit Quantizer(int precision) : fPrecision(precision), fScale(1) {
+        SkASSERT(precision >= 0 && precision <= SkSVGCanvas::kMaxPrecision);
+        for (int i = 0; i < precision; ++i) {
+            fScale *= 10;
+        }
+    }
+
+    int64_t quantize(SkScalar v) const {
+        double scaled = SkScalarIsFinite(v) ? floor(v * fScale + 0.5) : 0;
+        return (int64_t)SkTMax(-1e18, SkTMin(scaled, 1e18));
+    }
+
+    void append(SkString* str, int64_t q) const { append_fixed(str, q, fPrecision); }
+
+    SkScalar tolerance() const { return SkDoubleToScalar(0.5 / fScale); }
+
+private:
+    int    fPrecision;
+    double fScale;
+};
+
+// Writes SVG path data. At full precision this is just SkParsePath::ToSVGString(); otherwise
+// coordinates are rounded and written as relative commands. The deltas are taken between
+// rounded points, so the rounding error does not accumulate along the path.
+class SVGPathBuilder : SkNoncopyable {
+public:
+    SVGPathBuilder(int precision, SkString* data)
+        : fPrecision(precision)
+        , fQuantizer(SkTMax(precision, 0))
+        , fData(data)
+        , fX(0), fY(0)
+        , fStartX(0), fStartY(0)
+        , fLastCmd('\0')
+        , fNeedSep(false) {}
+
+    void append(const SkPath& path) {
+        if (fPrecision < 0) {
+            SkParsePath::ToSVGString(path, fData);
+            return;
+        }
+
+        // RawIter, since SVG's closepath already draws the closing line.
+        SkPath::RawIter iter(path);
+        SkPoint         pts[4];
+
+        for (;;) {
+            switch (iter.next(pts)) {
+                case SkPath::kMove_Verb:
+                    this->appendSegment('m', &pts[0], 1);
+                    fStartX = fX;
+                    fStartY = fY;
+                    break;
+                case SkPath::kLine_Verb:
+                    this->appendLine(pts[1]);
+                    break;
+                case SkPath::kQuad_Verb:
+                    this->appendSegment('q', &pts[1], 2);
+                    break;
+                case SkPath::kConic_Verb: {
+                    // No point in being more accurate than the rounding.
+                    const SkScalar tol = SkTMax(SK_Scalar1 / 1024, fQuantizer.tolerance());
+                    SkAutoConicToQuads quadder;
+                    const SkPoint* quadPts = quadder.computeQuads(pts, iter.conicWeight(), tol);
+                    for (int i = 0; i < quadder.countQuads(); ++i) {
+                        this->appendSegment('q', &quadPts[i*2 + 1], 2);
+                    }
+                } break;
+                case SkPath::kCubic_Verb:
+                    this->appendSegment('c', &pts[1], 3);
+                    break;
+                case SkPath::kClose_Verb:
+                    this->appendCommand('z');
+                    fX = fStartX;
+                    fY = fStartY;
+                    break;
+                case SkPath::kDone_Verb:
+                    return;
+            }
+        }
+    }
+
+private:
+    void appendCommand(char cmd) {
+        // Repeated commands can be implied; coordinate pairs following a moveto are linetos.
+        if (cmd != fLastCmd || 'z' == cmd) {
+            fData->append(&cmd, 1);
+            fNeedSep = false;
+        }
+        fLastCmd = 'm' == cmd ? 'l' : cmd;
+    }
+
+    void appendNumber(int64_t q) {
+        // A minus sign doubles as a separator.
+        if (fNeedSep && q >= 0) {
+            fData->append(" ");
+        }
+        fQuantizer.append(fData, q);
+        fNeedSep = true;
+    }
+
+    // All points of a segment are relative to the current point at its start.
+    void appendSegment(char cmd, const SkPoint pts[], int count) {
+        int64_t x0 = fX;
+        int64_t y0 = fY;
+        this->appendCommand(cmd);
+        for (int i = 0; i < count; ++i) {
+            fX = fQuantizer.quantize(pts[i].fX);
+            fY = fQuantizer.quantize(pts[i].fY);
+            this->appendNumber(fX - x0);
+            this->appendNumber(fY - y0);
+        }
+    }
+
+    void appendLine(const SkPoint& pt) {
+        int64_t x = fQuantizer.quantize(pt.fX);
+        int64_t y = fQuantizer.quantize(pt.fY);
+        if (y == fY) {
+            this->appendCommand('h');
+            this->appendNumber(x - fX);
+        } else if (x == fX) {
+            this->appendCommand('v');
+            this->appendNumber(y - fY);
+        } else {
+            this->appendCommand('l');
+            this->appendNumber(x - fX);
+            this->appendNumber(y - fY);
+        }
+        fX = x;
+        fY = y;
+    }
+
+    const int       fPrecision;
+    const Quantizer fQuantizer;
+    SkString*       fData;
+    int64_t         fX, fY;
+    int64_t         fStartX, fStartY;
+    char            fLastCmd;
+    bool            fNeedSep;
+};
+
+// The generation ID does not cover the fill type on every platform.
+static uint64_t path_key(const SkPath& path) {
+    return ((uint64_t)path.getFillType() << 32) | path.getGenerationID();
+}
+
 struct Resources {
     Resources(const SkPaint& paint)
         : fPaintServer(svg_color(paint.getColor())) {}
@@ -243,22 +418,47 @@ private:
 
 }
 
-// For now all this does is serve unique serial IDs, but it will eventually evolve to track
-// and deduplicate resources.
+// Serves unique serial IDs, and remembers the <defs> already written so that clips, gradients
+// and repeated paths are only emitted once per document.
 class SkSVGDevice::ResourceBucket : ::SkNoncopyable {
 public:
-    ResourceBucket() : fGradientCount(0), fClipCount(0), fPathCount(0), fImageCount(0) {}
-
-    SkString addLinearGradient() {
-        return SkStringPrintf("gradient_%d", fGradientCount++);
+    ResourceBucket(int precision)
+        : fPrecision(precision)
+        , fGradientCount(0)
+        , fClipCount(0)
+        , fPathCount(0)
+        , fImageCount(0) {}
+
+    int precision() const { return fPrecision; }
+
+    SkString addLinearGradient(const SkString& key) {
+        SkString id = SkStringPrintf("gradient_%d", fGradientCount++);
+        fGradients.set(key, id);
+        return id;
+    }
+    const SkString* findLinearGradient(const SkString& key) const {
+        return fGradients.find(key);
     }
 
-    SkString addClip() {
-        return SkStringPrintf("clip_%d", fClipCount++);
+    // Clips are keyed by the clip stack's gen ID, which identifies the clip state.
+    SkString addClip(int32_t clipGenID) {
+        SkString id = SkStringPrintf("clip_%d", fClipCount++);
+        fClips.set(clipGenID, id);
+        return id;
+    }
+    const SkString* findClip(int32_t clipGenID) const {
+        return fClips.find(clipGenID);
     }
 
-    SkString addPath() {
-        return SkStringPrintf("path_%d", fPathCount++);
+    // Paths are keyed by generation ID and fill type, which is all that goes into their
+    // elements.
+    SkString addPath(const SkPath& path) {
+        SkString id = SkStringPrintf("path_%d", fPathCount++);
+        fPaths.set(path_key(path), id);
+        return id;
+    }
+    const SkString* findPath(const SkPath& path) const {
+        return fPaths.find(path_key(path));
     }
 
     SkString addImage() {
@@ -266,17 +466,22 @@ public:
     }
 
 private:
-    uint32_t fGradientCount;
-    uint32_t fClipCount;
-    uint32_t fPathCount;
-    uint32_t fImageCount;
+    const int fPrecision;
+    uint32_t  fGradientCount;
+    uint32_t  fClipCount;
+    uint32_t  fPathCount;
+    uint32_t  fImageCount;
+
+    SkTHashMap<SkString, SkString> fGradients;
+    SkTHashMap<int32_t, SkString>  fClips;
+    SkTHashMap<uint64_t, SkString> fPaths;
 };
 
 class SkSVGDevice::AutoElement : ::SkNoncopyable {
 public:
-    AutoElement(const char name[], SkXMLWriter* writer)
+    AutoElement(const char name[], SkXMLWriter* writer, ResourceBucket* bucket)
         : fWriter(writer)
-        , fResourceBucket(NULL) {
+        , fResourceBucket(bucket) {
         fWriter->startElement(name);
     }
 
@@ -289,7 +494,7 @@ public:
         if (!res.fClip.isEmpty()) {
             // The clip is in device space. Apply it via a <g> wrapper to avoid local transform
             // interference.
-            fClipGroup.reset(SkNEW_ARGS(AutoElement, ("g", fWriter)));
+            fClipGroup.reset(SkNEW_ARGS(AutoElement, ("g", fWriter, fResourceBucket)));
             fClipGroup->addAttribute("clip-path",res.fClip);
         }
 
@@ -322,12 +527,25 @@ public:
         fWriter->addScalarAttribute(name, val);
     }
 
+    // Coordinates are rounded to the document's precision, unlike other scalars.
+    void addCoordAttribute(const char name[], SkScalar val) {
+        if (fResourceBucket->precision() < 0) {
+            fWriter->addScalarAttribute(name, val);
+            return;
+        }
+        SkString str;
+        Quantizer quantizer(fResourceBucket->precision());
+        quantizer.append(&str, quantizer.quantize(val));
+        fWriter->addAttribute(name, str.c_str());
+    }
+
     void addText(const SkString& text) {
         fWriter->addText(text.c_str(), text.size());
     }
 
     void addRectAttributes(const SkRect&);
     void addPathAttributes(const SkPath&);
+    void addFillRuleAttribute(const SkPath&);
     void addTextAttributes(const SkPaint&);
 
 private:
@@ -337,7 +555,8 @@ private:
 
     void addPaint(const SkPaint& paint, const Resources& resources);
 
-    SkString addLinearGradientDef(const SkShader::GradientInfo& info, const SkShader* shader);
+    SkString addLinearGradientDef(const SkShader::GradientInfo& info, const SkShader* shader,
+                                  const SkString& key);
 
     SkXMLWriter*               fWriter;
     ResourceBucket*            fResourceBucket;
@@ -384,28 +603,22 @@ void SkSVGDevice::AutoElement::addPaint(const SkPaint& paint, const Resources& r
             this->addAttribute("stroke-opacity", svg_opacity(paint.getColor()));
         }
     } else {
+        // stroke defaults to none
         SkASSERT(style == SkPaint::kFill_Style);
-        this->addAttribute("stroke", "none");
     }
 }
 
 Resources SkSVGDevice::AutoElement::addResources(const SkDraw& draw, const SkPaint& paint) {
     Resources resources(paint);
 
-    // FIXME: this is a weak heuristic and we end up with LOTS of redundant clips.
-    bool hasClip   = !draw.fClipStack->isWideOpen();
-    bool hasShader = SkToBool(paint.getShader());
-
-    if (hasClip || hasShader) {
-        AutoElement defs("defs", fWriter);
-
-        if (hasClip) {
-            this->addClipResources(draw, &resources);
-        }
+    // Clips and gradients are only written out the first time they are seen; later draws
+    // just reference the existing <defs>.
+    if (!draw.fClipStack->isWideOpen()) {
+        this->addClipResources(draw, &resources);
+    }
 
-        if (hasShader) {
-            this->addShaderResources(paint, &resources);
-        }
+    if (paint.getShader()) {
+        this->addShaderResources(paint, &resources);
     }
 
     return resources;
@@ -433,31 +646,55 @@ void SkSVGDevice::AutoElement::addShaderResources(const SkPaint& paint, Resource
     SkASSERT(grInfo.fColorCount <= grColors.count());
     SkASSERT(grInfo.fColorCount <= grOffsets.count());
 
-    resources->fPaintServer.printf("url(#%s)", addLinearGradientDef(grInfo, shader).c_str());
+    // Everything that ends up in the <linearGradient> element.
+    SkString key;
+    key.append((const char*)grInfo.fPoint, sizeof(grInfo.fPoint));
+    key.append((const char*)grInfo.fColors, grInfo.fColorCount * sizeof(SkColor));
+    key.append((const char*)grInfo.fColorOffsets, grInfo.fColorCount * sizeof(SkScalar));
+    SkScalar localMatrix[9];
+    shader->getLocalMatrix().get9(localMatrix);
+    key.append((const char*)localMatrix, sizeof(localMatrix));
+
+    const SkString* id = fResourceBucket->findLinearGradient(key);
+    SkString newID;
+    if (!id) {
+        AutoElement defs("defs", fWriter, fResourceBucket);
+        newID = this->addLinearGradientDef(grInfo, shader, key);
+        id = &newID;
+    }
+
+    resources->fPaintServer.printf("url(#%s)", id->c_str());
 }
 
 void SkSVGDevice::AutoElement::addClipResources(const SkDraw& draw, Resources* resources) {
     SkASSERT(!draw.fClipStack->isWideOpen());
 
+    int32_t clipGenID = draw.fClipStack->getTopmostGenID();
+    if (const SkString* clipID = fResourceBucket->findClip(clipGenID)) {
+        resources->fClip.printf("url(#%s)", clipID->c_str());
+        return;
+    }
+
     SkPath clipPath;
     (void) draw.fClipStack->asPath(&clipPath);
 
-    SkString clipID = fResourceBucket->addClip();
+    SkString clipID = fResourceBucket->addClip(clipGenID);
     const char* clipRule = clipPath.getFillType() == SkPath::kEvenOdd_FillType ?
                            "evenodd" : "nonzero";
     {
         // clipPath is in device space, but since we're only pushing transform attributes
         // to the leaf nodes, so are all our elements => SVG userSpaceOnUse == device space.
-        AutoElement clipPathElement("clipPath", fWriter);
+        AutoElement defs("defs", fWriter, fResourceBucket);
+        AutoElement clipPathElement("clipPath", fWriter, fResourceBucket);
         clipPathElement.addAttribute("id", clipID);
 
         SkRect clipRect = SkRect::MakeEmpty();
         if (clipPath.isEmpty() || clipPath.isRect(&clipRect)) {
-            AutoElement rectElement("rect", fWriter);
+            AutoElement rectElement("rect", fWriter, fResourceBucket);
             rectElement.addRectAttributes(clipRect);
             rectElement.addAttribute("clip-rule", clipRule);
         } else {
-            AutoElement pathElement("path", fWriter);
+            AutoElement pathElement("path", fWriter, fResourceBucket);
             pathElement.addPathAttributes(clipPath);
             pathElement.addAttribute("clip-rule", clipRule);
         }
@@ -467,19 +704,20 @@ void SkSVGDevice::AutoElement::addClipResources(const SkDraw& draw, Resources* r
 }
 
 SkString SkSVGDevice::AutoElement::addLinearGradientDef(const SkShader::GradientInfo& info,
-                                                        const SkShader* shader) {
+                                                        const SkShader* shader,
+                                                        const SkString& key) {
     SkASSERT(fResourceBucket);
-    SkString id = fResourceBucket->addLinearGradient();
+    SkString id = fResourceBucket->addLinearGradient(key);
 
     {
-        AutoElement gradient("linearGradient", fWriter);
+        AutoElement gradient("linearGradient", fWriter, fResourceBucket);
 
         gradient.addAttribute("id", id);
         gradient.addAttribute("gradientUnits", "userSpaceOnUse");
-        gradient.addAttribute("x1", info.fPoint[0].x());
-        gradient.addAttribute("y1", info.fPoint[0].y());
-        gradient.addAttribute("x2", info.fPoint[1].x());
-        gradient.addAttribute("y2", info.fPoint[1].y());
+        gradient.addCoordAttribute("x1", info.fPoint[0].x());
+        gradient.addCoordAttribute("y1", info.fPoint[0].y());
+        gradient.addCoordAttribute("x2", info.fPoint[1].x());
+        gradient.addCoordAttribute("y2", info.fPoint[1].y());
 
         if (!shader->getLocalMatrix().isIdentity()) {
             this->addAttribute("gradientTransform", svg_transform(shader->getLocalMatrix()));
@@ -491,7 +729,7 @@ SkString SkSVGDevice::AutoElement::addLinearGradientDef(const SkShader::Gradient
             SkString colorStr(svg_color(color));
 
             {
-                AutoElement stop("stop", fWriter);
+                AutoElement stop("stop", fWriter, fResourceBucket);
                 stop.addAttribute("offset", info.fColorOffsets[i]);
                 stop.addAttribute("stop-color", colorStr.c_str());
 
@@ -508,22 +746,29 @@ SkString SkSVGDevice::AutoElement::addLinearGradientDef(const SkShader::Gradient
 void SkSVGDevice::AutoElement::addRectAttributes(const SkRect& rect) {
     // x, y default to 0
     if (rect.x() != 0) {
-        this->addAttribute("x", rect.x());
+        this->addCoordAttribute("x", rect.x());
     }
     if (rect.y() != 0) {
-        this->addAttribute("y", rect.y());
+        this->addCoordAttribute("y", rect.y());
     }
 
-    this->addAttribute("width", rect.width());
-    this->addAttribute("height", rect.height());
+    this->addCoordAttribute("width", rect.width());
+    this->addCoordAttribute("height", rect.height());
 }
 
 void SkSVGDevice::AutoElement::addPathAttributes(const SkPath& path) {
     SkString pathData;
-    SkParsePath::ToSVGString(path, &pathData);
+    SVGPathBuilder(fResourceBucket->precision(), &pathData).append(path);
     this->addAttribute("d", pathData);
 }
 
+void SkSVGDevice::AutoElement::addFillRuleAttribute(const SkPath& path) {
+    // fill-rule defaults to nonzero
+    if (SkPath::kEvenOdd_FillType == path.getFillType()) {
+        this->addAttribute("fill-rule", "evenodd");
+    }
+}
+
 void SkSVGDevice::AutoElement::addTextAttributes(const SkPaint& paint) {
     this->addAttribute("font-size", paint.getTextSize());
 
@@ -560,17 +805,17 @@ void SkSVGDevice::AutoElement::addTextAttributes(const SkPaint& paint) {
     }
 }
 
-SkBaseDevice* SkSVGDevice::Create(const SkISize& size, SkXMLWriter* writer) {
-    if (!writer) {
+SkBaseDevice* SkSVGDevice::Create(const SkISize& size, SkXMLWriter* writer, int precision) {
+    if (!writer || precision > SkSVGCanvas::kMaxPrecision) {
         return NULL;
     }
 
-    return SkNEW_ARGS(SkSVGDevice, (size, writer));
+    return SkNEW_ARGS(SkSVGDevice, (size, writer, precision));
 }
 
-SkSVGDevice::SkSVGDevice(const SkISize& size, SkXMLWriter* writer)
+SkSVGDevice::SkSVGDevice(const SkISize& size, SkXMLWriter* writer, int precision)
     : fWriter(writer)
-    , fResourceBucket(SkNEW(ResourceBucket)) {
+    , fResourceBucket(SkNEW_ARGS(ResourceBucket, (precision))) {
     SkASSERT(writer);
 
     fLegacyBitmap.setInfo(SkImageInfo::MakeUnknown(size.width(), size.height()));
@@ -578,7 +823,7 @@ SkSVGDevice::SkSVGDevice(const SkISize& size, SkXMLWriter* writer)
     fWriter->writeHeader();
 
     // The root <svg> tag gets closed by the destructor.
-    fRootElement.reset(SkNEW_ARGS(AutoElement, ("svg", fWriter)));
+    fRootElement.reset(SkNEW_ARGS(AutoElement, ("svg", fWriter, fResourceBucket)));
 
     fRootElement->addAttribute("xmlns", "http://www.w3.org/2000/svg");
     fRootElement->addAttribute("xmlns:xlink", "http://www.w3.org/1999/xlink");
@@ -616,10 +861,10 @@ void SkSVGDevice::drawRect(const SkDraw& draw, const SkRect& r, const SkPaint& p
 
 void SkSVGDevice::drawOval(const SkDraw& draw, const SkRect& oval, const SkPaint& paint) {
     AutoElement ellipse("ellipse", fWriter, fResourceBucket, draw, paint);
-    ellipse.addAttribute("cx", oval.centerX());
-    ellipse.addAttribute("cy", oval.centerY());
-    ellipse.addAttribute("rx", oval.width() / 2);
-    ellipse.addAttribute("ry", oval.height() / 2);
+    ellipse.addCoordAttribute("cx", oval.centerX());
+    ellipse.addCoordAttribute("cy", oval.centerY());
+    ellipse.addCoordAttribute("rx", oval.width() / 2);
+    ellipse.addCoordAttribute("ry", oval.height() / 2);
 }
 
 void SkSVGDevice::drawRRect(const SkDraw&, const SkRRect& rr, const SkPaint& paint) {
@@ -627,10 +872,47 @@ void SkSVGDevice::drawRRect(const SkDraw&, const SkRRect& rr, const SkPaint& pai
     SkDebugf("unsupported operation: drawRRect()\n");
 }
 
+SkString SkSVGDevice::addPathElement(const SkPath& path) {
+    SkString pathID = fResourceBucket->addPath(path);
+    AutoElement pathElement("path", fWriter, fResourceBucket);
+    pathElement.addAttribute("id", pathID);
+    pathElement.addPathAttributes(path);
+    pathElement.addFillRuleAttribute(path);
+
+    return pathID;
+}
+
+SkString SkSVGDevice::definePath(const SkPath& path) {
+    if (const SkString* pathID = fResourceBucket->findPath(path)) {
+        return *pathID;
+    }
+
+    AutoElement defs("defs", fWriter, fResourceBucket);
+    return this->addPathElement(path);
+}
+
 void SkSVGDevice::drawPath(const SkDraw& draw, const SkPath& path, const SkPaint& paint,
                            const SkMatrix* prePathMatrix, bool pathIsMutable) {
-    AutoElement elem("path", fWriter, fResourceBucket, draw, paint);
-    elem.addPathAttributes(path);
+    // vector-effect is not inherited, so a hairline needs it on its own path element.
+    if (SkPaint::kFill_Style != paint.getStyle() && 0 == paint.getStrokeWidth()) {
+        AutoElement elem("path", fWriter, fResourceBucket, draw, paint);
+        elem.addPathAttributes(path);
+        elem.addFillRuleAttribute(path);
+        return;
+    }
+
+    // The path data is only written the first time, in a <path> which holds nothing but the
+    // geometry, with the paint and transform on a <g> around it. If the path shows up again
+    // (map symbols, repeated shapes in a picture), that draw is a <use> of the first one.
+    if (const SkString* pathID = fResourceBucket->findPath(path)) {
+        const SkString href = SkStringPrintf("#%s", pathID->c_str());
+        AutoElement pathUse("use", fWriter, fResourceBucket, draw, paint);
+        pathUse.addAttribute("xlink:href", href);
+        return;
+    }
+
+    AutoElement group("g", fWriter, fResourceBucket, draw, paint);
+    this->addPathElement(path);
 }
 
 void SkSVGDevice::drawBitmapCommon(const SkDraw& draw, const SkBitmap& bm,
@@ -650,9 +932,9 @@ void SkSVGDevice::drawBitmapCommon(const SkDraw& draw, const SkBitmap& bm,
 
     SkString imageID = fResourceBucket->addImage();
     {
-        AutoElement defs("defs", fWriter);
+        AutoElement defs("defs", fWriter, fResourceBucket);
         {
-            AutoElement image("image", fWriter);
+            AutoElement image("image", fWriter, fResourceBucket);
             image.addAttribute("id", imageID);
             image.addAttribute("width", bm.width());
             image.addAttribute("height", bm.height());
@@ -738,18 +1020,10 @@ void SkSVGDevice::drawPosText(const SkDraw& draw, const void* text, size_t len,
 
 void SkSVGDevice::drawTextOnPath(const SkDraw&, const void* text, size_t len, const SkPath& path,
                                  const SkMatrix* matrix, const SkPaint& paint) {
-    SkString pathID = fResourceBucket->addPath();
-
-    {
-        AutoElement defs("defs", fWriter);
-        AutoElement pathElement("path", fWriter);
-        pathElement.addAttribute("id", pathID);
-        pathElement.addPathAttributes(path);
-
-    }
+    SkString pathID = this->definePath(path);
 
     {
-        AutoElement textElement("text", fWriter);
+        AutoElement textElement("text", fWriter, fResourceBucket);
         textElement.addTextAttributes(paint);
 
         if (matrix && !matrix->isIdentity()) {
@@ -757,7 +1031,7 @@ void SkSVGDevice::drawTextOnPath(const SkDraw&, const void* text, size_t len, co
         }
 
         {
-            AutoElement textPathElement("textPath", fWriter);
+            AutoElement textPathElement("textPath", fWriter, fResourceBucket);
             textPathElement.addAttribute("xlink:href", SkStringPrintf("#%s", pathID.c_str()));
 
             if (paint.getTextAlign() != SkPaint::kLeft_Align) {
@@ -14,7 +14,7 @@ class SkXMLWriter;
 
 class SkSVGDevice : public SkBaseDevice {
 public:
-    static SkBaseDevice* Create(const SkISize& size, SkXMLWriter* writer);
+    static SkBaseDevice* Create(const SkISize& size, SkXMLWriter* writer, int precision);
 
     virtual SkImageInfo imageInfo() const override;
 
@@ -58,10 +58,12 @@ protected:
     virtual const SkBitmap& onAccessBitmap() override;
 
 private:
-    SkSVGDevice(const SkISize& size, SkXMLWriter* writer);
+    SkSVGDevice(const SkISize& size, SkXMLWriter* writer, int precision);
     virtual ~SkSVGDevice();
 
     void drawBitmapCommon(const SkDraw& draw, const SkBitmap& bm, const SkPaint& paint);
+    SkString addPathElement(const SkPath& path);
+    SkString definePath(const SkPath& path);
 
     class AutoElement;
     class ResourceBucket;
@@ -10,10 +10,13 @@
 #include "SkPicture.h"
 #include "SkStream.h"
 #include "SkSVGCanvas.h"
+#include "SkTime.h"
 #include "SkXMLWriter.h"
 
 DEFINE_string2(input, i, "", "input skp file");
 DEFINE_string2(output, o, "", "output svg file (optional)");
+DEFINE_int32(precision, SkSVGCanvas::kFullPrecision,
+             "decimal digits kept for coordinates (-1 for full precision)");
 
 // return codes:
 static const int kSuccess     = 0;
@@ -31,6 +34,11 @@ int tool_main(int argc, char** argv) {
         return kInvalidArgs;
     }
 
+    if (FLAGS_precision > SkSVGCanvas::kMaxPrecision) {
+        SkDebugf("Precision must be at most %d\n", SkSVGCanvas::kMaxPrecision);
+        return kInvalidArgs;
+    }
+
     SkFILEStream stream(FLAGS_input[0]);
     if (!stream.isValid()) {
         SkDebugf("Couldn't open file: %s\n", FLAGS_input[0]);
@@ -44,10 +52,12 @@ int tool_main(int argc, char** argv) {
     }
 
     SkAutoTDelete<SkWStream> outStream;
+    SkFILEWStream* fileStream = NULL;
     if (FLAGS_output.count() > 0) {
-        SkFILEWStream* fileStream = SkNEW_ARGS(SkFILEWStream, (FLAGS_output[0]));
+        fileStream = SkNEW_ARGS(SkFILEWStream, (FLAGS_output[0]));
         if (!fileStream->isValid()) {
             SkDebugf("Couldn't open output file for writing: %s\n", FLAGS_output[0]);
+            SkDELETE(fileStream);
             return kIOError;
         }
         outStream.reset(fileStream);
@@ -55,10 +65,20 @@ int tool_main(int argc, char** argv) {
         outStream.reset(SkNEW(SkDebugWStream));
     }
 
-    SkAutoTDelete<SkXMLWriter> xmlWriter(SkNEW_ARGS(SkXMLStreamWriter, (outStream.get())));
-    SkAutoTUnref<SkCanvas> svgCanvas(SkSVGCanvas::Create(pic->cullRect(), xmlWriter.get()));
+    SkMSec start = SkTime::GetMSecs();
+    {
+        SkAutoTDelete<SkXMLWriter> xmlWriter(SkNEW_ARGS(SkXMLStreamWriter, (outStream.get())));
+        SkAutoTUnref<SkCanvas> svgCanvas(SkSVGCanvas::Create(pic->cullRect(), xmlWriter.get(),
+                                                             FLAGS_precision));
+        pic->playback(svgCanvas);
+        // The SVG is only complete once the canvas is gone.
+    }
 
-    pic->playback(svgCanvas);
+    if (fileStream) {
+        fileStream->flush();
+        SkDebugf("%s: %u bytes in %u ms\n", FLAGS_output[0],
+                 (unsigned)fileStream->bytesWritten(), SkTime::GetMSecs() - start);
+    }
 
     return kSuccess;
 }
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkImageDecoder.h"
+#include "SkImageEncoder.h"
+#include "SkImageGenerator.h"
+#include "SkImagePack.h"
+#include "SkMD5.h"
+#include "SkStream.h"
+
+// A pack is a header (magic, version, image count), then an index sorted by key, each entry a
+// 16 byte key, the u32 offset of the encoded image from the start of the pack and its u32 size,
+// then the encoded images.
+static const char     kPackMagic[] = { 's', 'k', 'i', 'm', 'p', 'a', 'c', 'k' };
+static const uint32_t kPackVersion = 1;
+static const size_t   kKeySize = 16;
+static const size_t   kHeaderSize = sizeof(kPackMagic) + 2 * sizeof(uint32_t);
+static const size_t   kIndexEntrySize = kKeySize + 2 * sizeof(uint32_t);
+
+// What a picture stores in place of an image: magic then the key.
+static const char     kRefMagic[] = { 'S', 'k', 'I', 'm', 'g', 'R', 'e', 'f' };
+static const size_t   kRefSize = sizeof(kRefMagic) + kKeySize;
+
+static uint32_t read_u32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+SK_DECLARE_STATIC_MUTEX(gRegisteredMutex);
+static SkTDArray<SkImagePack*> gRegistered;
+
+SkImagePack* SkImagePack::NewFromData(SkData* data) {
+    if (NULL == data || data->size() < kHeaderSize ||
+        memcmp(data->data(), kPackMagic, sizeof(kPackMagic))) {
+        return NULL;
+    }
+    const uint8_t* bytes = data->bytes();
+    const size_t size = data->size();
+    if (read_u32(bytes + sizeof(kPackMagic)) != kPackVersion) {
+        return NULL;
+    }
+    const uint32_t count = read_u32(bytes + sizeof(kPackMagic) + sizeof(uint32_t));
+    if (count > (size - kHeaderSize) / kIndexEntrySize) {
+        return NULL;
+    }
+
+    // Check the whole index up front, so lookups can trust it.
+    const uint8_t* entry = bytes + kHeaderSize;
+    for (uint32_t i = 0; i < count; ++i, entry += kIndexEntrySize) {
+        const uint32_t offset = read_u32(entry + kKeySize);
+        const uint32_t length = read_u32(entry + kKeySize + sizeof(uint32_t));
+        if (offset > size || length > size - offset ||
+            (i > 0 && memcmp(entry - kIndexEntrySize, entry, kKeySize) >= 0)) {
+            return NULL;
+        }
+    }
+    return SkNEW_ARGS(SkImagePack, (data, SkToInt(count)));
+}
+
+SkImagePack* SkImagePack::NewFromFile(const char path[]) {
+    SkAutoDataUnref data(SkData::NewFromFileName(path));
+    return NewFromData(data);
+}
+
+SkImagePack::SkImagePack(SkData* data, int count)
+    : fData(SkRef(data))
+    , fCount(count)
+    , fBitmaps(count) {}
+
+SkImagePack::~SkImagePack() {}
+
+int SkImagePack::find(const uint8_t key[]) const {
+    const uint8_t* index = fData->bytes() + kHeaderSize;
+    int lo = 0, hi = fCount - 1;
+    while (lo <= hi) {
+        const int mid = (lo + hi) >> 1;
+        const int cmp = memcmp(key, index + mid * kIndexEntrySize, kKeySize);
+        if (0 == cmp) {
+            return mid;
+        }
+        if (cmp < 0) {
+            hi = mid - 1;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return -1;
+}
+
+bool SkImagePack::installPixelRef(const void* src, size_t length, SkBitmap* dst) {
+    if (!IsReference(src, length)) {
+        return false;
+    }
+    const int i = this->find((const uint8_t*)src + sizeof(kRefMagic));
+    if (i < 0) {
+        return false;
+    }
+
+    SkAutoMutexAcquire lock(fMutex);
+    if (NULL == fBitmaps[i].pixelRef()) {
+        // Only reads the image's header; the pixels are decoded when the bitmap is first locked,
+        // and may be purged and decoded again later.
+        const uint8_t* entry = fData->bytes() + kHeaderSize + i * kIndexEntrySize;
+        SkAutoDataUnref encoded(SkData::NewSubset(fData, read_u32(entry + kKeySize),
+                                                  read_u32(entry + kKeySize + sizeof(uint32_t))));
+        if (!SkInstallDiscardablePixelRef(encoded, &fBitmaps[i])) {
+            return false;
+        }
+    }
+    *dst = fBitmaps[i];
+    return true;
+}
+
+void SkImagePack::Register(SkImagePack* pack) {
+    SkAutoMutexAcquire lock(gRegisteredMutex);
+    *gRegistered.append() = SkRef(pack);
+}
+
+void SkImagePack::Unregister(SkImagePack* pack) {
+    SkAutoMutexAcquire lock(gRegisteredMutex);
+    const int i = gRegistered.find(pack);
+    if (i >= 0) {
+        gRegistered.remove(i);
+        pack->unref();
+    }
+}
+
+bool SkImagePack::InstallPixelRef(const void* src, size_t length, SkBitmap* dst) {
+    if (!IsReference(src, length)) {
+        return SkImageDecoder::DecodeMemory(src, length, dst);
+    }
+    SkAutoMutexAcquire lock(gRegisteredMutex);
+    for (int i = 0; i < gRegistered.count(); ++i) {
+        if (gRegistered[i]->installPixelRef(src, length, dst)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SkImagePack::IsReference(const void* src, size_t length) {
+    return kRefSize == length && !memcmp(src, kRefMagic, sizeof(kRefMagic));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkImagePackWriter::SkImagePackWriter() : fReferenceCount(0) {}
+
+SkImagePackWriter::~SkImagePackWriter() {
+    for (int i = 0; i < fEntries.count(); ++i) {
+        fEntries[i].fEncoded->unref();
+    }
+}
+
+bool SkImagePackWriter::onUseEncodedData(const void*, size_t) {
+    // Always go through the pixels, so the same image is found however it was loaded.
+    return false;
+}
+
+SkData* SkImagePackWriter::onEncodePixels(const SkImageInfo& info, const void* pixels,
+                                          size_t rowBytes) {
+    if (NULL == pixels || info.isEmpty()) {
+        return NULL;
+    }
+
+    SkMD5 md5;
+    md5.write32(info.width());
+    md5.write32(info.height());
+    md5.write32(info.colorType());
+    md5.write32(info.alphaType());
+    const size_t bytesPerRow = info.minRowBytes();
+    for (int y = 0; y < info.height(); ++y) {
+        md5.write((const char*)pixels + y * rowBytes, bytesPerRow);
+    }
+    SkMD5::Digest digest;
+    md5.finish(digest);
+    SK_COMPILE_ASSERT(sizeof(digest.data) == kKeySize, key_size_matches_md5);
+
+    // Binary search for the key, or where it belongs.
+    int lo = 0, hi = fEntries.count();
+    while (lo < hi) {
+        const int mid = (lo + hi) >> 1;
+        if (memcmp(fEntries[mid].fKey, digest.data, kKeySize) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == fEntries.count() || memcmp(fEntries[lo].fKey, digest.data, kKeySize)) {
+        SkData* encoded = SkImageEncoder::EncodeData(info, pixels, rowBytes,
+                                                     SkImageEncoder::kPNG_Type, 100);
+        if (NULL == encoded) {
+            return NULL;
+        }
+        Entry* entry = fEntries.insert(lo);
+        memcpy(entry->fKey, digest.data, kKeySize);
+        entry->fEncoded = encoded;
+    }
+
+    fReferenceCount++;
+    SkData* ref = SkData::NewUninitialized(kRefSize);
+    memcpy(ref->writable_data(), kRefMagic, sizeof(kRefMagic));
+    memcpy((char*)ref->writable_data() + sizeof(kRefMagic), digest.data, kKeySize);
+    return ref;
+}
+
+bool SkImagePackWriter::write(SkWStream* stream) const {
+    if (!stream->write(kPackMagic, sizeof(kPackMagic)) ||
+        !stream->write32(kPackVersion) ||
+        !stream->write32(fEntries.count())) {
+        return false;
+    }
+    uint32_t offset = SkToU32(kHeaderSize + fEntries.count() * kIndexEntrySize);
+    for (int i = 0; i < fEntries.count(); ++i) {
+        const uint32_t size = SkToU32(fEntries[i].fEncoded->size());
+        if (!stream->write(fEntries[i].fKey, kKeySize) ||
+            !stream->write32(offset) ||
+            !stream->write32(size)) {
+            return false;
+        }
+        offset += size;
+    }
+    for (int i = 0; i < fEntries.count(); ++i) {
+        if (!stream->write(fEntries[i].fEncoded->data(), fEntries[i].fEncoded->size())) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -17,12 +17,14 @@
 #include "SkDocument.h"
 #include "SkGradientShader.h"
 #include "SkImage.h"
+#include "SkImageEncoder.h"
 #include "SkMatrix.h"
 #include "SkPaint.h"
 #include "SkPath.h"
 #include "SkPictureRecorder.h"
 #include "SkPixelRef.h"
 #include "SkRRect.h"
+#include "SkStream.h"
 #include "SkString.h"
 #include "SkSurface.h"
 #include "SkTextBlob.h"
@@ -86,6 +88,12 @@ template <typename T> T* get_obj(lua_State* L, int index) {
     return (T*)luaL_checkudata(L, index, get_mtname<T>());
 }
 
+// Like get_ref, but returns NULL instead of raising an error if the value is not a T.
+template <typename T> T* test_ref(lua_State* L, int index) {
+    T** ref = (T**)luaL_testudata(L, index, get_mtname<T>());
+    return ref ? *ref : NULL;
+}
+
 static bool lua2bool(lua_State* L, int index) {
     return !!lua_toboolean(L, index);
 }
@@ -329,6 +337,33 @@ void SkLua::pushTextBlob(const SkTextBlob* blob, const char key[]) {
     CHECK_SETFIELD(key);
 }
 
+void SkLua::pushImage(const SkImage* image, const char key[]) {
+    push_ref(fL, const_cast<SkImage*>(image));
+    CHECK_SETFIELD(key);
+}
+
+void SkLua::pushPicture(const SkPicture* pic, const char key[]) {
+    push_ref(fL, const_cast<SkPicture*>(pic));
+    CHECK_SETFIELD(key);
+}
+
+void SkLua::pushTypeface(SkTypeface* face, const char key[]) {
+    push_ref(fL, face);
+    CHECK_SETFIELD(key);
+}
+
+const SkImage* SkLua::ToImage(lua_State* L, int index) {
+    return test_ref<SkImage>(L, index);
+}
+
+const SkPicture* SkLua::ToPicture(lua_State* L, int index) {
+    return test_ref<SkPicture>(L, index);
+}
+
+SkTypeface* SkLua::ToTypeface(lua_State* L, int index) {
+    return test_ref<SkTypeface>(L, index);
+}
+
 static const char* element_type(SkClipStack::Element::Type type) {
     switch (type) {
         case SkClipStack::Element::kEmpty_Type:
@@ -1646,6 +1681,19 @@ static int limage_newShader(lua_State* L) {
     return 1;
 }
 
+// image:encodeToFile(path) returns true if the image was written as a PNG to path.
+static int limage_encodeToFile(lua_State* L) {
+    const char* path = luaL_checkstring(L, 2);
+    SkAutoDataUnref data(get_ref<SkImage>(L, 1)->encode(SkImageEncoder::kPNG_Type, 100));
+    bool success = false;
+    if (data.get()) {
+        SkFILEWStream stream(path);
+        success = stream.isValid() && stream.write(data->data(), data->size());
+    }
+    lua_pushboolean(L, success);
+    return 1;
+}
+
 static int limage_gc(lua_State* L) {
     get_ref<SkImage>(L, 1)->unref();
     return 0;
@@ -1655,6 +1703,7 @@ static const struct luaL_Reg gSkImage_Methods[] = {
     { "width", limage_width },
     { "height", limage_height },
     { "newShader", limage_newShader },
+    { "encodeToFile", limage_encodeToFile },
     { "__gc", limage_gc },
     { NULL, NULL }
 };
@@ -2002,6 +2051,21 @@ static int lsk_newRasterSurface(lua_State* L) {
     return 1;
 }
 
+static int lsk_loadPicture(lua_State* L) {
+    if (lua_gettop(L) > 0 && lua_isstring(L, 1)) {
+        const char* name = lua_tolstring(L, 1, NULL);
+        SkAutoTDelete<SkStream> stream(SkStream::NewFromFile(name));
+        if (stream.get()) {
+            SkPicture* pic = SkPicture::CreateFromStream(stream.get());
+            if (pic) {
+                push_ref(L, pic)->unref();
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
 static int lsk_loadImage(lua_State* L) {
     if (lua_gettop(L) > 0 && lua_isstring(L, 1)) {
         const char* name = lua_tolstring(L, 1, NULL);
@@ -2025,6 +2089,7 @@ static void register_Sk(lua_State* L) {
 
     setfield_function(L, "newDocumentPDF", lsk_newDocumentPDF);
     setfield_function(L, "loadImage", lsk_loadImage);
+    setfield_function(L, "loadPicture", lsk_loadPicture);
     setfield_function(L, "newBlurImageFilter", lsk_newBlurImageFilter);
     setfield_function(L, "newLinearGradient", lsk_newLinearGradient);
     setfield_function(L, "newMatrix", lsk_newMatrix);
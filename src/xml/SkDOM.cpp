@@ -9,6 +9,7 @@
 
 #include "SkDOM.h"
 #include "SkStream.h"
+#include "SkStreamPriv.h"
 #include "SkXMLWriter.h"
 
 /////////////////////////////////////////////////////////////////////////
@@ -201,7 +202,10 @@ static char* dupstr(SkChunkAlloc* chunk, const char src[])
 
 class SkDOMParser : public SkXMLParser {
 public:
-    SkDOMParser(SkChunkAlloc* chunk) : SkXMLParser(&fParserError), fAlloc(chunk)
+    // If inPlace is true, the strings passed to the callbacks outlive the DOM (they point
+    // into SkDOM::fDocument) and are referenced instead of copied.
+    SkDOMParser(SkChunkAlloc* chunk, bool inPlace = false)
+        : SkXMLParser(&fParserError), fAlloc(chunk), fInPlace(inPlace)
     {
         fAlloc->reset();
         fRoot = NULL;
@@ -241,7 +245,7 @@ protected:
         *fParentStack.push() = node;
 
         memcpy(node->attrs(), fAttrs.begin(), attrCount * sizeof(SkDOM::Attr));
-        fAttrs.reset();
+        fAttrs.rewind();
 
     }
 
@@ -252,8 +256,8 @@ protected:
 
     bool onAddAttribute(const char name[], const char value[]) override {
         SkDOM::Attr* attr = fAttrs.append();
-        attr->fName = dupstr(fAlloc, name);
-        attr->fValue = dupstr(fAlloc, value);
+        attr->fName = fInPlace ? name : dupstr(fAlloc, name);
+        attr->fValue = fInPlace ? value : dupstr(fAlloc, value);
         return false;
     }
 
@@ -281,6 +285,13 @@ protected:
     }
 
     bool onText(const char text[], int len) override {
+        if (fInPlace) {
+            SkASSERT('\0' == text[len]);
+            this->startCommon(text, SkDOM::kText_Type);
+            this->SkDOMParser::onEndElement(text);
+            return false;
+        }
+
         SkString str(text, len);
         this->startCommon(str.c_str(), SkDOM::kText_Type);
         this->SkDOMParser::onEndElement(str.c_str());
@@ -294,7 +305,7 @@ private:
             this->flushAttributes();
 
         fNeedToFlush = true;
-        fElemName = dupstr(fAlloc, elem);
+        fElemName = fInPlace ? elem : dupstr(fAlloc, elem);
         fElemType = type;
         ++fLevel;
     }
@@ -302,23 +313,36 @@ private:
     SkTDArray<SkDOM::Node*> fParentStack;
     SkChunkAlloc*           fAlloc;
     SkDOM::Node*            fRoot;
+    bool                    fInPlace;
     bool                    fNeedToFlush;
 
     // state needed for flushAttributes()
     SkTDArray<SkDOM::Attr>  fAttrs;
-    char*                   fElemName;
+    const char*             fElemName;
     SkDOM::Type             fElemType;
     int                     fLevel;
 };
 
 const SkDOM::Node* SkDOM::build(const char doc[], size_t len)
 {
-    SkDOMParser parser(&fAlloc);
-    if (!parser.parse(doc, len))
+    memcpy(fDocument.reset(len), doc, len);
+    return this->buildInPlace(len);
+}
+
+const SkDOM::Node* SkDOM::build(SkStream& docStream)
+{
+    return this->buildInPlace(SkCopyStreamToStorage(&fDocument, &docStream));
+}
+
+const SkDOM::Node* SkDOM::buildInPlace(size_t len)
+{
+    SkDOMParser parser(&fAlloc, true);
+    if (!parser.parseInPlace((char*)fDocument.get(), len))
     {
         SkDEBUGCODE(SkDebugf("xml parse error, line %d\n", parser.fParserError.getLineNumber());)
         fRoot = NULL;
         fAlloc.reset();
+        fDocument.free();
         return NULL;
     }
     fRoot = parser.getRoot();
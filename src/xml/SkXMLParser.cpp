@@ -8,6 +8,9 @@
 
 
 #include "SkXMLParser.h"
+#include "SkStream.h"
+#include "SkStreamPriv.h"
+#include "SkXMLTokenizer.h"
 
 static char const* const gErrorStrings[] = {
     "empty or missing file ",
@@ -61,17 +64,74 @@ SkXMLParser::~SkXMLParser()
 
 bool SkXMLParser::parse(SkStream& docStream)
 {
-    return false;
+    SkAutoMalloc storage;
+    size_t len = SkCopyStreamToStorage(&storage, &docStream);
+    if (0 == len) {
+        if (fError) {
+            fError->fCode = SkXMLParserError::kEmptyFile;
+        }
+        return false;
+    }
+    return this->parseInPlace((char*)storage.get(), len);
 }
 
 bool SkXMLParser::parse(const char doc[], size_t len)
 {
-    return false;
+    SkAutoSTMalloc<1024, char> storage(len);
+    memcpy(storage.get(), doc, len);
+    return this->parseInPlace(storage.get(), len);
 }
 
-void SkXMLParser::GetNativeErrorString(int error, SkString* str)
+bool SkXMLParser::parseInPlace(char doc[], size_t len)
 {
+    SkXMLTokenizer tokenizer(doc, len);
+    fParser = &tokenizer;
+
+    bool stopped = false;
+    SkXMLTokenizer::Token token;
+    while (!stopped && (token = tokenizer.next()) != SkXMLTokenizer::kEnd_Token) {
+        switch (token) {
+            case SkXMLTokenizer::kStartTag_Token: {
+                stopped = this->startElement(tokenizer.name());
+                const SkXMLTokenizer::Attr* attr = tokenizer.attrs();
+                const SkXMLTokenizer::Attr* stop = attr + tokenizer.attrCount();
+                for (; attr < stop && !stopped; ++attr) {
+                    stopped = this->addAttribute(attr->fName, attr->fValue);
+                }
+                break;
+            }
+            case SkXMLTokenizer::kEndTag_Token:
+                stopped = this->endElement(tokenizer.name());
+                break;
+            case SkXMLTokenizer::kText_Token:
+                stopped = this->text(tokenizer.name(), tokenizer.textLength());
+                break;
+            default:
+                this->reportError(fParser);
+                fParser = NULL;
+                return false;
+        }
+    }
+
+    fParser = NULL;
+    return !stopped;
+}
 
+void SkXMLParser::reportError(void* p)
+{
+    const SkXMLTokenizer* tokenizer = static_cast<const SkXMLTokenizer*>(p);
+    if (fError && tokenizer) {
+        fError->fNativeCode = tokenizer->error();
+        fError->fLineNumber = tokenizer->lineNumber();
+    }
+}
+
+void SkXMLParser::GetNativeErrorString(int error, SkString* str)
+{
+    const char* errorString = SkXMLTokenizer::GetErrorString(error);
+    if (errorString && str) {
+        str->append(errorString);
+    }
 }
 
 bool SkXMLParser::startElement(const char elem[])
@@ -7,22 +7,25 @@
  */
 #include "SkXMLParser.h"
 #include "SkStream.h"
+#include "SkStreamPriv.h"
+#include "SkXMLTokenizer.h"
 
 static void reset(SkXMLPullParser::Curr* curr)
 {
     curr->fEventType = SkXMLPullParser::ERROR;
     curr->fName = "";
+    curr->fAttrInfos = NULL;
     curr->fAttrInfoCount = 0;
     curr->fIsWhitespace = false;
 }
 
-SkXMLPullParser::SkXMLPullParser() : fStream(NULL)
+SkXMLPullParser::SkXMLPullParser() : fStream(NULL), fImpl(NULL)
 {
     fCurr.fEventType = ERROR;
     fDepth = -1;
 }
 
-SkXMLPullParser::SkXMLPullParser(SkStream* stream) : fStream(NULL)
+SkXMLPullParser::SkXMLPullParser(SkStream* stream) : fStream(NULL), fImpl(NULL)
 {
     fCurr.fEventType = ERROR;
     fDepth = 0;
@@ -37,15 +40,14 @@ SkXMLPullParser::~SkXMLPullParser()
 
 SkStream* SkXMLPullParser::setStream(SkStream* stream)
 {
-    if (fStream && !stream)
+    if (fStream)
         this->onExit();
 
-    SkRefCnt_SafeAssign(fStream, stream);
+    fStream = stream;
 
     if (fStream)
     {
-        fCurr.fEventType = START_DOCUMENT;
-        this->onInit();
+        fCurr.fEventType = this->onInit() ? START_DOCUMENT : ERROR;
     }
     else
     {
@@ -136,3 +138,63 @@ bool SkXMLPullParser::onEntityReplacement(const char name[],
     // TODO: std 5 entities here
     return false;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+// The whole document is read once into fStorage and then tokenized in place, so names,
+// attribute values and text handed out by the parser point straight into that buffer.
+struct SkXMLPullParser::Impl {
+    explicit Impl(SkStream* stream)
+        : fLength(SkCopyStreamToStorage(&fStorage, stream))
+        , fTokenizer((char*)fStorage.get(), fLength) {}
+
+    SkAutoMalloc            fStorage;
+    size_t                  fLength;
+    SkXMLTokenizer          fTokenizer;
+    SkTDArray<AttrInfo>     fAttrInfos;
+};
+
+bool SkXMLPullParser::onInit()
+{
+    fImpl = SkNEW_ARGS(Impl, (fStream));
+    return fImpl->fLength > 0;
+}
+
+SkXMLPullParser::EventType SkXMLPullParser::onNextToken()
+{
+    SkXMLTokenizer& tokenizer = fImpl->fTokenizer;
+
+    switch (tokenizer.next()) {
+    case SkXMLTokenizer::kStartTag_Token: {
+        int count = tokenizer.attrCount();
+        const SkXMLTokenizer::Attr* attrs = tokenizer.attrs();
+        fImpl->fAttrInfos.setCount(count);
+        for (int i = 0; i < count; ++i) {
+            fImpl->fAttrInfos[i].fName = attrs[i].fName;
+            fImpl->fAttrInfos[i].fValue = attrs[i].fValue;
+        }
+        fCurr.fName = tokenizer.name();
+        fCurr.fAttrInfos = fImpl->fAttrInfos.begin();
+        fCurr.fAttrInfoCount = count;
+        return START_TAG;
+    }
+    case SkXMLTokenizer::kEndTag_Token:
+        fCurr.fName = tokenizer.name();
+        return END_TAG;
+    case SkXMLTokenizer::kText_Token:
+        // whitespace-only text is dropped by the tokenizer
+        fCurr.fName = tokenizer.name();
+        fCurr.fIsWhitespace = false;
+        return TEXT;
+    case SkXMLTokenizer::kEnd_Token:
+        return END_DOCUMENT;
+    default:
+        return ERROR;
+    }
+}
+
+void SkXMLPullParser::onExit()
+{
+    SkDELETE(fImpl);
+    fImpl = NULL;
+}
@@ -0,0 +1,425 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkXMLTokenizer.h"
+#include "SkUtils.h"
+
+static const char* const gErrorStrings[] = {
+    "no error",
+    "unexpected end of document",
+    "malformed tag",
+    "malformed attribute",
+    "mismatched end tag",
+    "unknown entity",
+    "no root element",
+    "junk after root element"
+};
+
+static inline bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+static inline bool is_name_stop(char c) {
+    return is_space(c) || c == '>' || c == '/' || c == '=' || c == '<' || c == '"' || c == '\'';
+}
+
+static bool is_all_space(const char* start, const char* stop) {
+    for (; start < stop; ++start) {
+        if (!is_space(*start)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool match(const char* p, const char* stop, const char lit[], size_t len) {
+    return (size_t)(stop - p) >= len && !memcmp(p, lit, len);
+}
+
+// Returns the code point for the entity name [ent, stop) (without '&' and ';'), or -1.
+static SkUnichar lookup_entity(const char* ent, const char* stop) {
+    size_t len = stop - ent;
+    if (len > 1 && ent[0] == '#') {
+        int base = 10;
+        ++ent;
+        if (*ent == 'x') {
+            base = 16;
+            ++ent;
+        }
+        if (ent == stop) {
+            return -1;
+        }
+        SkUnichar uni = 0;
+        for (; ent < stop; ++ent) {
+            int digit;
+            if (*ent >= '0' && *ent <= '9') {
+                digit = *ent - '0';
+            } else if (16 == base && (*ent | 0x20) >= 'a' && (*ent | 0x20) <= 'f') {
+                digit = (*ent | 0x20) - 'a' + 10;
+            } else {
+                return -1;
+            }
+            uni = uni * base + digit;
+            if (uni > 0x10FFFF) {
+                return -1;
+            }
+        }
+        return uni ? uni : -1;
+    }
+
+    static const struct {
+        const char* fName;
+        size_t      fLen;
+        SkUnichar   fUni;
+    } gEntities[] = {
+        { "lt",   2, '<'  },
+        { "gt",   2, '>'  },
+        { "amp",  3, '&'  },
+        { "apos", 4, '\'' },
+        { "quot", 4, '"'  },
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gEntities); ++i) {
+        if (len == gEntities[i].fLen && !memcmp(ent, gEntities[i].fName, len)) {
+            return gEntities[i].fUni;
+        }
+    }
+    return -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkXMLTokenizer::SkXMLTokenizer(char doc[], size_t len)
+    : fCurr(doc)
+    , fStop(doc + len)
+    , fName(NULL)
+    , fTextLength(0)
+    , fLineNumber(1)
+    , fError(kNoError)
+    , fInTag(false)
+    , fPendingEnd(false)
+    , fSawRoot(false) {
+}
+
+const char* SkXMLTokenizer::GetErrorString(int error) {
+    if ((unsigned)error > kLastError) {
+        return NULL;
+    }
+    return gErrorStrings[error];
+}
+
+SkXMLTokenizer::Token SkXMLTokenizer::setError(Error error) {
+    fError = error;
+    return kError_Token;
+}
+
+char* SkXMLTokenizer::scanName(char* p) const {
+    while (p < fStop && !is_name_stop(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+// *c is the last character consumed and *p the next one to read. Skips whitespace so that
+// on return *c is the first non-space character (already consumed).
+bool SkXMLTokenizer::skipSpace(char** p, char* c) {
+    while (is_space(*c)) {
+        if ('\n' == *c) {
+            fLineNumber += 1;
+        }
+        if (*p >= fStop) {
+            this->setError(kUnexpectedEnd_Error);
+            return false;
+        }
+        *c = *(*p)++;
+    }
+    return true;
+}
+
+// Decodes entities from p up to terminator, writing the result over the source (it can only
+// shrink). Returns the position of the terminator and sets *stop to the end of the decoded
+// string, or returns NULL on error.
+char* SkXMLTokenizer::decode(char* p, char terminator, char** stop) {
+    char* dst = p;
+    while (p < fStop) {
+        char c = *p;
+        if (c == terminator) {
+            *stop = dst;
+            return p;
+        }
+        if (c != '&') {
+            if ('\n' == c) {
+                fLineNumber += 1;
+            }
+            *dst++ = c;
+            ++p;
+            continue;
+        }
+
+        char* ent = p + 1;
+        char* semi = ent;
+        while (semi < fStop && *semi != ';' && *semi != terminator) {
+            ++semi;
+        }
+        if (semi >= fStop) {
+            break;
+        }
+        SkUnichar uni = *semi == ';' ? lookup_entity(ent, semi) : -1;
+        if (uni < 0) {
+            this->setError(kUnknownEntity_Error);
+            return NULL;
+        }
+        // Every reference is at least as long as its UTF-8 encoding.
+        dst += SkUTF8_FromUnichar(uni, dst);
+        p = semi + 1;
+    }
+    this->setError(kUnexpectedEnd_Error);
+    return NULL;
+}
+
+// Returns the position just past marker, or NULL if the document ends first.
+char* SkXMLTokenizer::skipPast(char* p, const char marker[], size_t markerLen) {
+    while (p < fStop) {
+        if (*p == marker[0] && match(p, fStop, marker, markerLen)) {
+            return p + markerLen;
+        }
+        if ('\n' == *p) {
+            fLineNumber += 1;
+        }
+        ++p;
+    }
+    this->setError(kUnexpectedEnd_Error);
+    return NULL;
+}
+
+// Skips a <!DOCTYPE ...> style declaration, including any [internal subset].
+char* SkXMLTokenizer::skipDecl(char* p) {
+    int brackets = 0;
+    while (p < fStop) {
+        char c = *p++;
+        if ('\n' == c) {
+            fLineNumber += 1;
+        } else if ('[' == c) {
+            brackets += 1;
+        } else if (']' == c) {
+            brackets -= 1;
+        } else if ('>' == c && brackets <= 0) {
+            return p;
+        }
+    }
+    this->setError(kUnexpectedEnd_Error);
+    return NULL;
+}
+
+SkXMLTokenizer::Token SkXMLTokenizer::next() {
+    if (fError != kNoError) {
+        return kError_Token;
+    }
+    fAttrs.rewind();
+
+    if (fPendingEnd) {
+        fPendingEnd = false;
+        fStack.pop(&fName);
+        return kEndTag_Token;
+    }
+
+    for (;;) {
+        if (!fInTag) {
+            if (fCurr >= fStop) {
+                if (fStack.count() > 0) {
+                    return this->setError(kUnexpectedEnd_Error);
+                }
+                if (!fSawRoot) {
+                    return this->setError(kNoRootElement_Error);
+                }
+                return kEnd_Token;
+            }
+            if (*fCurr != '<') {
+                if (fStack.isEmpty()) {
+                    // Anything between top-level markup is ignored.
+                    while (fCurr < fStop && *fCurr != '<') {
+                        if ('\n' == *fCurr) {
+                            fLineNumber += 1;
+                        }
+                        ++fCurr;
+                    }
+                    continue;
+                }
+                char* text = fCurr;
+                char* end;
+                char* lt = this->decode(text, '<', &end);
+                if (NULL == lt) {
+                    return kError_Token;
+                }
+                fCurr = lt + 1;
+                fInTag = true;
+                *end = 0;   // end <= lt, whose '<' we have already accounted for
+                if (is_all_space(text, end)) {
+                    continue;
+                }
+                fName = text;
+                fTextLength = SkToInt(end - text);
+                return kText_Token;
+            }
+            fCurr += 1;
+        }
+        fInTag = false;
+
+        char* p = fCurr;
+        if (p >= fStop) {
+            return this->setError(kUnexpectedEnd_Error);
+        }
+
+        if ('?' == *p) {
+            if (NULL == (fCurr = this->skipPast(p + 1, "?>", 2))) {
+                return kError_Token;
+            }
+            continue;
+        }
+
+        if ('!' == *p) {
+            if (match(p, fStop, "!--", 3)) {
+                fCurr = this->skipPast(p + 3, "--", 2);
+                if (fCurr && (fCurr >= fStop || *fCurr++ != '>')) {
+                    return this->setError(kMalformedTag_Error);
+                }
+            } else if (match(p, fStop, "![CDATA[", 8)) {
+                if (fStack.isEmpty()) {
+                    return this->setError(kMalformedTag_Error);
+                }
+                char* text = p + 8;
+                if (NULL == (fCurr = this->skipPast(text, "]]>", 3))) {
+                    return kError_Token;
+                }
+                char* end = fCurr - 3;
+                *end = 0;
+                if (end > text) {
+                    fName = text;
+                    fTextLength = SkToInt(end - text);
+                    return kText_Token;
+                }
+            } else {
+                fCurr = this->skipDecl(p + 1);
+            }
+            if (NULL == fCurr) {
+                return kError_Token;
+            }
+            continue;
+        }
+
+        if ('/' == *p) {
+            char* name = p + 1;
+            char* end = this->scanName(name);
+            if (end >= fStop) {
+                return this->setError(kUnexpectedEnd_Error);
+            }
+            if (end == name) {
+                return this->setError(kMalformedTag_Error);
+            }
+            char c = *end;
+            *end = 0;
+            p = end + 1;
+            if (!this->skipSpace(&p, &c)) {
+                return kError_Token;
+            }
+            if (c != '>') {
+                return this->setError(kMalformedTag_Error);
+            }
+            if (fStack.isEmpty() || strcmp(fStack.top(), name)) {
+                return this->setError(kMismatchedTag_Error);
+            }
+            fStack.pop();
+            fCurr = p;
+            fName = name;
+            return kEndTag_Token;
+        }
+
+        if (fSawRoot && fStack.isEmpty()) {
+            return this->setError(kJunkAfterRoot_Error);
+        }
+
+        char* name = p;
+        char* end = this->scanName(name);
+        if (end >= fStop) {
+            return this->setError(kUnexpectedEnd_Error);
+        }
+        if (end == name) {
+            return this->setError(kMalformedTag_Error);
+        }
+        char c = *end;
+        *end = 0;
+        p = end + 1;
+
+        for (;;) {
+            if (!this->skipSpace(&p, &c)) {
+                return kError_Token;
+            }
+            if ('>' == c) {
+                break;
+            }
+            if ('/' == c) {
+                if (p >= fStop || *p != '>') {
+                    return this->setError(kMalformedTag_Error);
+                }
+                p += 1;
+                fPendingEnd = true;
+                break;
+            }
+
+            char* attrName = p - 1;
+            end = this->scanName(attrName);
+            if (end >= fStop) {
+                return this->setError(kUnexpectedEnd_Error);
+            }
+            if (end == attrName) {
+                return this->setError(kMalformedAttribute_Error);
+            }
+            c = *end;
+            *end = 0;
+            p = end + 1;
+            if (!this->skipSpace(&p, &c)) {
+                return kError_Token;
+            }
+            if (c != '=') {
+                return this->setError(kMalformedAttribute_Error);
+            }
+            if (p >= fStop) {
+                return this->setError(kUnexpectedEnd_Error);
+            }
+            c = *p++;
+            if (!this->skipSpace(&p, &c)) {
+                return kError_Token;
+            }
+            if (c != '"' && c != '\'') {
+                return this->setError(kMalformedAttribute_Error);
+            }
+
+            char* value = p;
+            char* valueEnd;
+            char* quote = this->decode(value, c, &valueEnd);
+            if (NULL == quote) {
+                return kError_Token;
+            }
+            *valueEnd = 0;
+
+            Attr* attr = fAttrs.append();
+            attr->fName = attrName;
+            attr->fValue = value;
+
+            p = quote + 1;
+            if (p >= fStop) {
+                return this->setError(kUnexpectedEnd_Error);
+            }
+            c = *p++;
+        }
+
+        *fStack.append() = name;
+        fSawRoot = true;
+        fCurr = p;
+        fName = name;
+        return kStartTag_Token;
+    }
+}
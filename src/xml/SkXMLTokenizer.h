@@ -0,0 +1,91 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkXMLTokenizer_DEFINED
+#define SkXMLTokenizer_DEFINED
+
+#include "SkTDArray.h"
+
+/**
+ *  Small non-validating XML tokenizer shared by SkXMLParser and SkXMLPullParser.
+ *
+ *  It works destructively on a caller-owned, writable buffer: element names, attribute
+ *  names/values and text are NUL-terminated (and entity-decoded) in place, so every string
+ *  it hands out points into the document and nothing is copied. The buffer must outlive
+ *  any use of those strings.
+ *
+ *  Comments, processing instructions and the DOCTYPE are skipped. CDATA sections are
+ *  reported as text. Whitespace-only text is skipped, as is anything outside the root.
+ */
+class SkXMLTokenizer {
+public:
+    enum Token {
+        kError_Token,
+        kEnd_Token,
+        kStartTag_Token,
+        kEndTag_Token,      // also synthesized after the start tag of an empty element
+        kText_Token
+    };
+
+    enum Error {
+        kNoError = 0,
+        kUnexpectedEnd_Error,
+        kMalformedTag_Error,
+        kMalformedAttribute_Error,
+        kMismatchedTag_Error,
+        kUnknownEntity_Error,
+        kNoRootElement_Error,
+        kJunkAfterRoot_Error,
+
+        kLastError = kJunkAfterRoot_Error
+    };
+
+    struct Attr {
+        const char* fName;
+        const char* fValue;
+    };
+
+    SkXMLTokenizer(char doc[], size_t len);
+
+    Token next();
+
+    /** Element name for start/end tags, or the text for kText_Token. */
+    const char* name() const { return fName; }
+    int textLength() const { return fTextLength; }
+
+    /** Attributes of the most recent kStartTag_Token. */
+    int attrCount() const { return fAttrs.count(); }
+    const Attr* attrs() const { return fAttrs.begin(); }
+
+    Error error() const { return fError; }
+    int lineNumber() const { return fLineNumber; }
+
+    static const char* GetErrorString(int error);
+
+private:
+    Token setError(Error);
+    char* scanName(char* p) const;
+    char* decode(char* p, char terminator, char** stop);
+    char* skipPast(char* p, const char marker[], size_t markerLen);
+    char* skipDecl(char* p);
+    bool skipSpace(char** p, char* c);
+
+    char*   fCurr;
+    char*   fStop;
+    const char* fName;
+    int     fTextLength;
+    int     fLineNumber;
+    Error   fError;
+    bool    fInTag;         // the '<' starting the next token was consumed (and maybe zeroed)
+    bool    fPendingEnd;    // last start tag was <empty/>
+    bool    fSawRoot;
+
+    SkTDArray<Attr>         fAttrs;
+    SkTDArray<const char*>  fStack;
+};
+
+#endif
@@ -6,9 +6,12 @@
  */
 
 #include "SkBitmap.h"
+#include "SkBlitMask.h"
+#include "SkBlitRow.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkGradientShader.h"
+#include "SkRandom.h"
 #include "SkRect.h"
 #include "Test.h"
 
@@ -262,3 +265,252 @@ DEF_TEST(BlitRow, reporter) {
     test_00_FF(reporter);
     test_diagonal(reporter);
 }
+
+#if defined(SK_CPU_X86) && !defined(SK_USE_ACCURATE_BLENDING)
+// The x86 row procs (SSE2, SSE4 and AVX2, whichever this CPU picks) must match the portable
+// math exactly, at every length and alignment, including their scalar tails.
+DEF_TEST(BlitRow_PlatformProcs, reporter) {
+    static const int kMaxCount = 80;
+    SkRandom rand;
+    SkPMColor src[kMaxCount], dst[kMaxCount + 3], expected[kMaxCount + 3];
+    uint8_t mask[kMaxCount];
+    for (int i = 0; i < kMaxCount; ++i) {
+        unsigned a = rand.nextU() & 0xFF;
+        switch (i % 5) {
+            case 0: a = 0;    break;
+            case 1: a = 0xFF; break;
+        }
+        src[i] = SkPreMultiplyARGB(a, rand.nextU() & 0xFF, rand.nextU() & 0xFF,
+                                   rand.nextU() & 0xFF);
+        mask[i] = rand.nextU() & 0xFF;
+    }
+
+    SkBlitRow::Proc32 srcOver = SkBlitRow::Factory32(SkBlitRow::kSrcPixelAlpha_Flag32);
+    SkBlitRow::Proc32 blend = SkBlitRow::Factory32(SkBlitRow::kGlobalAlpha_Flag32);
+    SkBlitRow::Proc32 srcOverBlend = SkBlitRow::Factory32(SkBlitRow::kGlobalAlpha_Flag32 |
+                                                          SkBlitRow::kSrcPixelAlpha_Flag32);
+    SkBlitRow::ColorProc color32 = SkBlitRow::ColorProcFactory();
+    const SkColor color = SkColorSetARGB(0x90, 0x20, 0xC0, 0x60);
+    const SkPMColor pmColor = SkPreMultiplyColor(color);
+    SkBlitMask::ColorProc maskProc = SkBlitMask::ColorFactory(kN32_SkColorType,
+                                                              SkMask::kA8_Format, color);
+    const unsigned colorScale = 256 - SkAlpha255To256(SkGetPackedA32(pmColor));
+    const U8CPU alpha = 0x5A;
+
+    for (int count = 1; count <= kMaxCount; ++count) {
+        for (int offset = 0; offset < 3; ++offset) {
+            for (int i = 0; i < kMaxCount + 3; ++i) {
+                dst[i] = SkPreMultiplyARGB(0xFF - i, i, 2 * i, 3 * i);
+            }
+
+            memcpy(expected, dst, sizeof(dst));
+            srcOver(dst + offset, src, count, 0xFF);
+            for (int i = 0; i < count; ++i) {
+                expected[offset + i] = SkPMSrcOver(src[i], expected[offset + i]);
+            }
+            REPORTER_ASSERT(reporter, !memcmp(dst, expected, sizeof(dst)));
+
+            blend(dst + offset, src, count, alpha);
+            for (int i = 0; i < count; ++i) {
+                expected[offset + i] = SkAlphaMulQ(src[i], SkAlpha255To256(alpha)) +
+                                       SkAlphaMulQ(expected[offset + i],
+                                                   256 - SkAlpha255To256(alpha));
+            }
+            REPORTER_ASSERT(reporter, !memcmp(dst, expected, sizeof(dst)));
+
+            srcOverBlend(dst + offset, src, count, alpha);
+            for (int i = 0; i < count; ++i) {
+                expected[offset + i] = SkBlendARGB32(src[i], expected[offset + i], alpha);
+            }
+            REPORTER_ASSERT(reporter, !memcmp(dst, expected, sizeof(dst)));
+
+            color32(dst + offset, src, count, pmColor);
+            for (int i = 0; i < count; ++i) {
+                expected[offset + i] = pmColor + SkAlphaMulQ(src[i], colorScale);
+            }
+            REPORTER_ASSERT(reporter, !memcmp(dst, expected, sizeof(dst)));
+
+            maskProc(dst + offset, count * sizeof(SkPMColor), mask, count, color, count, 1);
+            for (int i = 0; i < count; ++i) {
+                expected[offset + i] = SkBlendARGB32(pmColor, expected[offset + i], mask[i]);
+            }
+            REPORTER_ASSERT(reporter, !memcmp(dst, expected, sizeof(dst)));
+        }
+    }
+}
+#endif
+
+#if defined(SK_CPU_X86)
+#include "SkBitmapProcShader.h"
+#include "SkBlitter.h"
+#include "SkDither.h"
+
+// Portable versions of the 565 procs that have x86 specializations.
+static uint16_t blend_565(SkPMColor c, uint16_t d, int scale) {
+    return SkPackRGB16(SkAlphaBlend(SkPacked32ToR16(c), SkGetPackedR16(d), scale),
+                       SkAlphaBlend(SkPacked32ToG16(c), SkGetPackedG16(d), scale),
+                       SkAlphaBlend(SkPacked32ToB16(c), SkGetPackedB16(d), scale));
+}
+
+static uint16_t blend_dither_565(SkPMColor c, uint16_t d, int scale, int dither) {
+    int sr = SkDITHER_R32To565(SkGetPackedR32(c), dither);
+    int sg = SkDITHER_G32To565(SkGetPackedG32(c), dither);
+    int sb = SkDITHER_B32To565(SkGetPackedB32(c), dither);
+    return SkPackRGB16(SkAlphaBlend(sr, SkGetPackedR16(d), scale),
+                       SkAlphaBlend(sg, SkGetPackedG16(d), scale),
+                       SkAlphaBlend(sb, SkGetPackedB16(d), scale));
+}
+
+static uint16_t srcover_blend_dither_565(SkPMColor c, uint16_t d, int srcScale, int dither) {
+    if (!c) {
+        return d;
+    }
+    int dstScale = SkAlpha255To256(255 - SkAlphaMul(SkGetPackedA32(c), srcScale));
+    int sr = SkDITHER_R32To565(SkGetPackedR32(c), dither);
+    int sg = SkDITHER_G32To565(SkGetPackedG32(c), dither);
+    int sb = SkDITHER_B32To565(SkGetPackedB32(c), dither);
+    return SkPackRGB16((sr * srcScale + SkGetPackedR16(d) * dstScale) >> 8,
+                       (sg * srcScale + SkGetPackedG16(d) * dstScale) >> 8,
+                       (sb * srcScale + SkGetPackedB16(d) * dstScale) >> 8);
+}
+
+static void fill_dst_565(uint16_t dst[], int count) {
+    for (int i = 0; i < count; ++i) {
+        dst[i] = (uint16_t)(i * 0x9E37);
+    }
+}
+
+// The same, for the 565 row procs, the color proc, and the 565 blitters' A8 masks.
+DEF_TEST(BlitRow_PlatformProcs565, reporter) {
+    static const int kMaxCount = 80;
+    SkRandom rand;
+    SkPMColor src[kMaxCount];
+    uint16_t dst[kMaxCount + 3], expected[kMaxCount + 3];
+    uint8_t mask[kMaxCount];
+    for (int i = 0; i < kMaxCount; ++i) {
+        unsigned a = rand.nextU() & 0xFF;
+        switch (i % 5) {
+            case 0: a = 0;    break;
+            case 1: a = 0xFF; break;
+        }
+        src[i] = SkPreMultiplyARGB(a, rand.nextU() & 0xFF, rand.nextU() & 0xFF,
+                                   rand.nextU() & 0xFF);
+        mask[i] = (i % 11 < 8) ? 0 : rand.nextU() & 0xFF;   // some all-zero runs
+    }
+
+    SkBlitRow::Proc16 blend = SkBlitRow::Factory16(SkBlitRow::kGlobalAlpha_Flag);
+    SkBlitRow::Proc16 srcOverBlend = SkBlitRow::Factory16(SkBlitRow::kGlobalAlpha_Flag |
+                                                          SkBlitRow::kSrcPixelAlpha_Flag);
+    SkBlitRow::Proc16 blendDither = SkBlitRow::Factory16(SkBlitRow::kGlobalAlpha_Flag |
+                                                         SkBlitRow::kDither_Flag);
+    SkBlitRow::Proc16 srcOverBlendDither = SkBlitRow::Factory16(SkBlitRow::kGlobalAlpha_Flag |
+                                                                SkBlitRow::kSrcPixelAlpha_Flag |
+                                                                SkBlitRow::kDither_Flag);
+    const SkPMColor pmColor = SkPreMultiplyColor(SkColorSetARGB(0x90, 0x20, 0xC0, 0x60));
+    const uint32_t colorExpanded = (SkGetPackedG32(pmColor) << 24) |
+                                   (SkGetPackedR32(pmColor) << 13) |
+                                   (SkGetPackedB32(pmColor) << 2);
+    const unsigned colorScale = SkAlpha255To256(0xFF - SkGetPackedA32(pmColor)) >> 3;
+    const U8CPU alpha = 0x5A;
+    const int scale = SkAlpha255To256(alpha);
+
+    for (int count = 1; count <= kMaxCount; ++count) {
+        for (int offset = 0; offset < 3; ++offset) {
+            const int x = count + offset, y = count * 3 + offset;
+            fill_dst_565(dst, kMaxCount + 3);
+            memcpy(expected, dst, sizeof(dst));
+
+            blend(dst + offset, src, count, alpha, x, y);
+            for (int i = 0; i < count; ++i) {
+                expected[offset + i] = blend_565(src[i], expected[offset + i], scale);
+            }
+            REPORTER_ASSERT(reporter, !memcmp(dst, expected, sizeof(dst)));
+
+            srcOverBlend(dst + offset, src, count, alpha, x, y);
+            for (int i = 0; i < count; ++i) {
+                if (src[i]) {
+                    SkPMColor res = SkBlendARGB32(src[i],
+                                                  SkPixel16ToPixel32(expected[offset + i]),
+                                                  alpha);
+                    expected[offset + i] = SkPixel32ToPixel16(res);
+                }
+            }
+            REPORTER_ASSERT(reporter, !memcmp(dst, expected, sizeof(dst)));
+
+            blendDither(dst + offset, src, count, alpha, x, y);
+            {
+                int dx = x;
+                DITHER_565_SCAN(y);
+                for (int i = 0; i < count; ++i) {
+                    expected[offset + i] = blend_dither_565(src[i], expected[offset + i],
+                                                            scale, DITHER_VALUE(dx));
+                    DITHER_INC_X(dx);
+                }
+            }
+            REPORTER_ASSERT(reporter, !memcmp(dst, expected, sizeof(dst)));
+
+            srcOverBlendDither(dst + offset, src, count, alpha, x, y);
+            {
+                int dx = x;
+                DITHER_565_SCAN(y);
+                for (int i = 0; i < count; ++i) {
+                    expected[offset + i] = srcover_blend_dither_565(src[i], expected[offset + i],
+                                                                    scale, DITHER_VALUE(dx));
+                    DITHER_INC_X(dx);
+                }
+            }
+            REPORTER_ASSERT(reporter, !memcmp(dst, expected, sizeof(dst)));
+
+            const unsigned colorFlags[] = { 0, SkBlitRow::kDither_Flag };
+            for (size_t f = 0; f < SK_ARRAY_COUNT(colorFlags); ++f) {
+                SkBlitRow::ColorFactory16(colorFlags[f])(dst + offset, pmColor, count, x, y);
+                for (int i = 0; i < count; ++i) {
+                    expected[offset + i] = SkBlend32_RGB16(colorExpanded, expected[offset + i],
+                                                           colorScale);
+                }
+                REPORTER_ASSERT(reporter, !memcmp(dst, expected, sizeof(dst)));
+            }
+        }
+    }
+
+    // A8 masks through the opaque and translucent color blitters.
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::Make(kMaxCount, 1, kRGB_565_SkColorType, kOpaque_SkAlphaType));
+    SkMask m;
+    m.fImage = mask;
+    m.fFormat = SkMask::kA8_Format;
+    m.fRowBytes = kMaxCount;
+    const SkColor colors[] = {
+        SkColorSetRGB(0x20, 0xC0, 0x60),
+        SkColorSetARGB(0x90, 0x20, 0xC0, 0x60),
+    };
+    for (size_t c = 0; c < SK_ARRAY_COUNT(colors); ++c) {
+        SkPaint paint;
+        paint.setColor(colors[c]);
+        const unsigned color16 = SkPack888ToRGB16(SkColorGetR(colors[c]), SkColorGetG(colors[c]),
+                                                  SkColorGetB(colors[c]));
+        const unsigned colorAlpha256 = SkAlpha255To256(SkColorGetA(colors[c]));
+
+        SkTBlitterAllocator allocator;
+        SkBlitter* blitter = SkBlitter::Choose(bm, SkMatrix::I(), paint, &allocator);
+        for (int left = 0; left < 3; ++left) {
+            for (int right = kMaxCount - 3; right <= kMaxCount; ++right) {
+                uint16_t* pixels = bm.getAddr16(0, 0);
+                fill_dst_565(pixels, kMaxCount);
+                fill_dst_565(expected, kMaxCount);
+
+                m.fBounds.set(0, 0, kMaxCount, 1);
+                blitter->blitMask(m, SkIRect::MakeLTRB(left, 0, right, 1));
+                for (int i = left; i < right; ++i) {
+                    unsigned scale5 = SkAlpha255To256(mask[i]) * colorAlpha256 >> (8 + 3);
+                    expected[i] = SkCompact_rgb_16((SkExpand_rgb_16(color16) * scale5 +
+                                                    SkExpand_rgb_16(expected[i]) * (32 - scale5))
+                                                   >> 5);
+                }
+                REPORTER_ASSERT(reporter,
+                                !memcmp(pixels, expected, kMaxCount * sizeof(uint16_t)));
+            }
+        }
+    }
+}
+#endif
@@ -7,18 +7,25 @@
 
 #include "SkChecksum.h"
 #include "SkRandom.h"
+#include "SkTDArray.h"
 #include "Test.h"
 
 
-// Murmur3 has an optional third seed argument, so we wrap it to fit a uniform type.
+// Murmur3 and Hash have an optional third seed argument, so we wrap them to fit a uniform type.
 static uint32_t murmur_noseed(const uint32_t* d, size_t l) { return SkChecksum::Murmur3(d, l); }
+static uint32_t hash_noseed(const uint32_t* d, size_t l) { return SkChecksum::Hash(d, l); }
+static uint32_t portable_noseed(const uint32_t* d, size_t l) {
+    return SkChecksum::HashPortable(d, l);
+}
 
 #define ASSERT(x) REPORTER_ASSERT(r, x)
 
 DEF_TEST(Checksum, r) {
     // Algorithms to test.  They're currently all uint32_t(const uint32_t*, size_t).
     typedef uint32_t(*algorithmProc)(const uint32_t*, size_t);
-    const algorithmProc kAlgorithms[] = { &SkChecksum::Compute, &murmur_noseed };
+    const algorithmProc kAlgorithms[] = {
+        &SkChecksum::Compute, &murmur_noseed, &hash_noseed, &portable_noseed
+    };
 
     // Put 128 random bytes into two identical buffers.  Any multiple of 4 will do.
     const size_t kBytes = SkAlign4(128);
@@ -51,6 +58,75 @@ DEF_TEST(Checksum, r) {
     }
 }
 
+static int count_bits(uint32_t x) {
+    int n = 0;
+    for (; x; x &= x - 1) {
+        n += 1;
+    }
+    return n;
+}
+
+static uint32_t murmur3(const void* d, size_t l, uint32_t seed) {
+    return SkChecksum::Murmur3(d, l, seed);
+}
+
+DEF_TEST(Checksum_HashQuality, r) {
+    SkTDArray<SkChecksumHashProc> procs;
+    procs.push(&murmur3);
+    procs.push(&SkChecksum::HashPortable);
+    procs.push(&SkChecksum::Hash);
+    if (SkChecksumHashProc platform = SkChecksumHashGetPlatformProc()) {
+        procs.push(platform);
+    }
+
+    // Odd sizes on an odd address, straddling the 64 byte switch to the wide-lane code.
+    uint8_t storage[257];
+    uint8_t* data = storage + 1;
+    SkRandom rand;
+    for (int i = 0; i < 256; ++i) {
+        data[i] = SkToU8(rand.nextU() & 0xFF);
+    }
+    const size_t kSizes[] = { 1, 7, 12, 63, 64, 100, 255 };
+
+    for (int p = 0; p < procs.count(); ++p) {
+        const SkChecksumHashProc hash = procs[p];
+
+        for (size_t i = 0; i < SK_ARRAY_COUNT(kSizes); ++i) {
+            const size_t bytes = kSizes[i];
+            const uint32_t h = hash(data, bytes, 0);
+            ASSERT(h == hash(data, bytes, 0));
+            ASSERT(h != hash(data, bytes, 1));
+            ASSERT(h != hash(data, bytes - 1, 0));
+
+            // Flipping any single input bit should flip about half of the output bits.
+            int flipped = 0;
+            for (size_t bit = 0; bit < bytes * 8; ++bit) {
+                data[bit >> 3] ^= 1 << (bit & 7);
+                const uint32_t tweaked = hash(data, bytes, 0);
+                data[bit >> 3] ^= 1 << (bit & 7);
+                ASSERT(tweaked != h);
+                flipped += count_bits(tweaked ^ h);
+            }
+            const float avg = (float)flipped / (bytes * 8);
+            ASSERT(bytes < 8 || (avg > 14 && avg < 18));
+        }
+
+        // Keys that differ only in a counter should still fill the low bits evenly.
+        const int kBuckets = 256, kKeys = kBuckets * 64;
+        int counts[kBuckets];
+        sk_bzero(counts, sizeof(counts));
+        uint32_t key[24];
+        sk_bzero(key, sizeof(key));
+        for (int i = 0; i < kKeys; ++i) {
+            key[5] = i;
+            counts[hash(key, sizeof(key), 0) & (kBuckets - 1)] += 1;
+        }
+        for (int i = 0; i < kBuckets; ++i) {
+            ASSERT(counts[i] > 24 && counts[i] < 128);
+        }
+    }
+}
+
 DEF_TEST(GoodHash, r) {
     ASSERT(SkGoodHash(( int32_t)4) ==  614249093);  // 4 bytes.  Hits SkChecksum::Mix fast path.
     ASSERT(SkGoodHash((uint32_t)4) ==  614249093);  // (Ditto)
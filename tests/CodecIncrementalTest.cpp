@@ -0,0 +1,142 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Resources.h"
+#include "SkBitmap.h"
+#include "SkCodec.h"
+#include "SkData.h"
+#include "SkStream.h"
+#include "Test.h"
+
+// Stands in for an image being downloaded: only the first available() bytes of
+// the data have arrived, and reading past them returns short.
+class ChunkedStream : public SkStream {
+public:
+    ChunkedStream(SkData* data, size_t available)
+        : fData(SkRef(data))
+        , fAvailable(available)
+        , fOffset(0) {}
+
+    void setAvailable(size_t available) {
+        fAvailable = SkTMin(available, fData->size());
+    }
+    size_t available() const { return fAvailable; }
+
+    size_t read(void* buffer, size_t size) override {
+        size = SkTMin(size, fAvailable - fOffset);
+        if (buffer) {
+            memcpy(buffer, fData->bytes() + fOffset, size);
+        }
+        fOffset += size;
+        return size;
+    }
+
+    bool isAtEnd() const override {
+        return fOffset == fData->size();
+    }
+
+    bool rewind() override {
+        fOffset = 0;
+        return true;
+    }
+
+private:
+    SkAutoTUnref<SkData> fData;
+    size_t               fAvailable;
+    size_t               fOffset;
+};
+
+static bool rows_equal(const SkBitmap& a, const SkBitmap& b, int rows) {
+    SkAutoLockPixels alpa(a), alpb(b);
+    const size_t rowLen = a.info().minRowBytes();
+    for (int y = 0; y < rows; ++y) {
+        if (memcmp(a.getAddr(0, y), b.getAddr(0, y), rowLen)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// headerSize bytes are available when the codec is created, and chunkSize more
+// arrive before each later call.
+static void check_incremental(skiatest::Reporter* r, const char path[], size_t headerSize,
+                              size_t chunkSize) {
+    SkAutoTUnref<SkData> data(SkData::NewFromFileName(GetResourcePath(path).c_str()));
+    if (!data) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return;
+    }
+
+    SkAutoTDelete<SkCodec> fullCodec(SkCodec::NewFromData(data));
+    if (!fullCodec) {
+        // Codecs are not compiled in for every format on every platform.
+        return;
+    }
+    const SkImageInfo info = fullCodec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap expected;
+    expected.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess ==
+                    fullCodec->getPixels(info, expected.getPixels(), expected.rowBytes()));
+
+    ChunkedStream* stream = SkNEW_ARGS(ChunkedStream, (data, headerSize));
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(stream));
+    if (!codec) {
+        ERRORF(r, "Unable to create a codec for part of '%s'", path);
+        return;
+    }
+    REPORTER_ASSERT(r, SkCodec::kInvalidParameters == codec->incrementalDecode());
+
+    SkBitmap actual;
+    actual.allocPixels(info);
+    actual.eraseColor(SK_ColorYELLOW);
+    SkCodec::Result result = codec->startIncrementalDecode(info, actual.getPixels(),
+                                                           actual.rowBytes());
+    if (SkCodec::kUnimplemented == result) {
+        return;
+    }
+    REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+
+    int lastRows = 0;
+    for (;;) {
+        int rows = -1;
+        result = codec->incrementalDecode(&rows);
+        REPORTER_ASSERT(r, rows >= lastRows && rows <= info.height());
+        REPORTER_ASSERT(r, rows_equal(expected, actual, rows));
+        lastRows = rows;
+        if (SkCodec::kIncompleteInput != result || stream->available() == data->size()) {
+            break;
+        }
+        stream->setAvailable(stream->available() + chunkSize);
+    }
+    REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+    REPORTER_ASSERT(r, info.height() == lastRows);
+    REPORTER_ASSERT(r, rows_equal(expected, actual, info.height()));
+
+    // Once complete, further calls have nothing left to do.
+    int rows = 0;
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->incrementalDecode(&rows));
+    REPORTER_ASSERT(r, info.height() == rows);
+
+    // A full decode still works afterwards, and ends the incremental decode.
+    actual.eraseColor(SK_ColorYELLOW);
+    REPORTER_ASSERT(r, SkCodec::kSuccess ==
+                    codec->getPixels(info, actual.getPixels(), actual.rowBytes()));
+    REPORTER_ASSERT(r, rows_equal(expected, actual, info.height()));
+    REPORTER_ASSERT(r, SkCodec::kInvalidParameters == codec->incrementalDecode());
+}
+
+DEF_TEST(Codec_incremental, r) {
+    check_incremental(r, "mandrill_256.png", 1024, 3000);
+    check_incremental(r, "yellow_rose.png", 1024, 10000);
+    check_incremental(r, "arrow.png", 1024, 100);
+
+    // The sizes of the GIF headers include their color tables.
+    check_incremental(r, "box.gif", 250, 16);
+    check_incremental(r, "randPixels.gif", 230, 4);
+    check_incremental(r, "color_wheel.gif", 850, 100);
+    check_incremental(r, "animated_radar.gif", 300, 200);
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkDashPathEffect.h"
+#include "SkDevicePathCache.h"
+#include "SkEdge.h"
+#include "SkEdgeBuilder.h"
+#include "SkResourceCache.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+static SkPath make_curvy_path() {
+    SkPath path;
+    path.moveTo(10, 40);
+    path.cubicTo(30, -10, 60, 90, 90, 30);
+    path.quadTo(70, 80, 40, 70);
+    path.conicTo(0, 70, 10, 40, 0.7f);
+    path.close();
+    return path;
+}
+
+DEF_TEST(DevicePathCache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+    const SkPath path = make_curvy_path();
+    SkMatrix matrix;
+    matrix.setScale(2, 3);
+    matrix.postTranslate(5, 7);
+
+    SkPaint fill;
+    SkPath first, second;
+    // A path seen once costs no entry.
+    REPORTER_ASSERT(reporter, !SkDevicePathCache::Find(path, matrix, fill, 1, &first, &cache));
+    REPORTER_ASSERT(reporter, 0 == cache.getTotalBytesUsed());
+    REPORTER_ASSERT(reporter, SkDevicePathCache::Find(path, matrix, fill, 1, &first, &cache));
+    REPORTER_ASSERT(reporter, SkDevicePathCache::Find(path, matrix, fill, 1, &second, &cache));
+    // Found rather than transformed again, so the edge builder sees the same path.
+    REPORTER_ASSERT(reporter, first.getGenerationID() == second.getGenerationID());
+    SkPath expected;
+    path.transform(matrix, &expected);
+    REPORTER_ASSERT(reporter, expected == first);
+
+    // Fill types share the outline.
+    SkPath inverse(path);
+    inverse.toggleInverseFillType();
+    REPORTER_ASSERT(reporter, SkDevicePathCache::Find(inverse, matrix, fill, 1, &second, &cache));
+    REPORTER_ASSERT(reporter, second.isInverseFillType());
+    REPORTER_ASSERT(reporter, first.getGenerationID() == second.getGenerationID());
+
+    // Another matrix or stroke is another outline.
+    SkMatrix other(matrix);
+    other.postTranslate(1, 0);
+    REPORTER_ASSERT(reporter, SkDevicePathCache::Find(path, other, fill, 1, &second, &cache));
+    REPORTER_ASSERT(reporter, first.getGenerationID() != second.getGenerationID());
+
+    SkPaint stroke;
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setStrokeWidth(4);
+    REPORTER_ASSERT(reporter, SkDevicePathCache::Find(path, matrix, stroke, 1, &first, &cache));
+    stroke.getFillPath(path, &expected);
+    expected.transform(matrix);
+    REPORTER_ASSERT(reporter, expected == first);
+    stroke.setStrokeJoin(SkPaint::kRound_Join);
+    REPORTER_ASSERT(reporter, SkDevicePathCache::Find(path, matrix, stroke, 1, &second, &cache));
+    REPORTER_ASSERT(reporter, first.getGenerationID() != second.getGenerationID());
+
+    // What is not worth caching.
+    SkPath volatilePath(path);
+    volatilePath.setIsVolatile(true);
+    for (int i = 0; i < 2; ++i) {
+        REPORTER_ASSERT(reporter, !SkDevicePathCache::Find(volatilePath, matrix, fill, 1, &first,
+                                                           &cache));
+    }
+    SkPath polygon;
+    polygon.addRect(SkRect::MakeWH(10, 10));
+    for (int i = 0; i < 2; ++i) {
+        REPORTER_ASSERT(reporter, !SkDevicePathCache::Find(polygon, matrix, fill, 1, &first,
+                                                           &cache));
+    }
+    SkPaint hairline;
+    hairline.setStyle(SkPaint::kStroke_Style);
+    REPORTER_ASSERT(reporter, !SkDevicePathCache::Find(path, matrix, hairline, 1, &first,
+                                                       &cache));
+    SkPaint dashed;
+    const SkScalar intervals[] = { 4, 2 };
+    dashed.setPathEffect(SkDashPathEffect::Create(intervals, 2, 0))->unref();
+    REPORTER_ASSERT(reporter, !SkDevicePathCache::Find(path, matrix, dashed, 1, &first, &cache));
+}
+
+static bool edges_equal(SkEdge* const* a, SkEdge* const* b, int count) {
+    for (int i = 0; i < count; ++i) {
+        if (a[i]->fCurveCount != b[i]->fCurveCount) {
+            return false;
+        }
+        const size_t size = a[i]->fCurveCount > 0 ? sizeof(SkQuadraticEdge) :
+                            a[i]->fCurveCount < 0 ? sizeof(SkCubicEdge) : sizeof(SkEdge);
+        // Skip the list links, which the scan converter sets.
+        const size_t start = offsetof(SkEdge, fX);
+        if (memcmp((const char*)a[i] + start, (const char*)b[i] + start, size - start)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Edges found in the cache are the edges that would be built.
+DEF_TEST(EdgeBuilder_Cache, reporter) {
+    SkPath path = make_curvy_path();
+    path.transform(SkMatrix::MakeScale(3, 3));
+    SkPath volatilePath(path);
+    volatilePath.setIsVolatile(true);
+
+    for (int shiftUp = 0; shiftUp <= 2; shiftUp += 2) {
+        // The clip is given in supersampled coordinates.
+        const SkIRect clip = SkIRect::MakeLTRB(40 << shiftUp, 20 << shiftUp,
+                                               200 << shiftUp, 150 << shiftUp);
+        for (int clipped = 0; clipped < 2; ++clipped) {
+            const SkIRect* clipPtr = clipped ? &clip : NULL;
+            // Later builds of the path add its edges to the cache and then copy them.
+            SkEdgeBuilder expected, builders[3];
+            const int count = expected.build(volatilePath, clipPtr, shiftUp, true);
+            REPORTER_ASSERT(reporter, count > 0);
+            for (int i = 0; i < 3; ++i) {
+                REPORTER_ASSERT(reporter, count == builders[i].build(path, clipPtr, shiftUp, true));
+                REPORTER_ASSERT(reporter, edges_equal(expected.edgeList(), builders[i].edgeList(),
+                                                      count));
+            }
+        }
+    }
+}
+
+// Drawing a path again, from the caches, draws the same pixels.
+DEF_TEST(DevicePathCache_Draw, reporter) {
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRasterN32Premul(120, 120));
+    SkCanvas* canvas = surface->getCanvas();
+    const SkPath path = make_curvy_path();
+    SkPath volatilePath(path);
+    volatilePath.setIsVolatile(true);
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(120, 120);
+    actual.allocN32Pixels(120, 120);
+
+    for (int i = 0; i < 4; ++i) {
+        SkPaint paint;
+        paint.setAntiAlias(SkToBool(i & 1));
+        if (i & 2) {
+            paint.setStyle(SkPaint::kStroke_Style);
+            paint.setStrokeWidth(5);
+        }
+
+        canvas->clear(SK_ColorWHITE);
+        canvas->save();
+        canvas->clipRect(SkRect::MakeLTRB(20, 0, 120, 100));
+        canvas->rotate(10);
+        canvas->drawPath(volatilePath, paint);
+        canvas->restore();
+        canvas->readPixels(&expected, 0, 0);
+
+        // Outlines are cached the second time, and edges the third.
+        for (int j = 0; j < 4; ++j) {
+            canvas->clear(SK_ColorWHITE);
+            canvas->save();
+            canvas->clipRect(SkRect::MakeLTRB(20, 0, 120, 100));
+            canvas->rotate(10);
+            canvas->drawPath(path, paint);
+            canvas->restore();
+            canvas->readPixels(&actual, 0, 0);
+
+            SkAutoLockPixels alpe(expected), alpa(actual);
+            REPORTER_ASSERT(reporter, !memcmp(expected.getPixels(), actual.getPixels(),
+                                              expected.getSize()));
+        }
+    }
+}
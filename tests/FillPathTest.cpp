@@ -5,8 +5,14 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
 #include "SkBlitter.h"
+#include "SkDraw.h"
+#include "SkMatrix.h"
+#include "SkPaint.h"
 #include "SkPath.h"
+#include "SkRandom.h"
+#include "SkRasterClip.h"
 #include "SkRegion.h"
 #include "SkScan.h"
 #include "Test.h"
@@ -43,3 +49,111 @@ DEF_TEST(FillPathInverse, reporter) {
 
   REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+// Passes on just the rows of one band, like the blitters GrSWMaskHelper draws the bands of a
+// mask with, and counts the spans the scan converter still made outside of them.
+class BandBlitter : public SkRectClipBlitter {
+public:
+    BandBlitter(SkBlitter* blitter, const SkIRect& band) : fBand(band), fOutside(0) {
+        this->init(blitter, band);
+    }
+
+    void blitH(int x, int y, int width) override {
+        fOutside += y < fBand.fTop || y >= fBand.fBottom;
+        this->INHERITED::blitH(x, y, width);
+    }
+    void blitAntiH(int x, int y, const SkAlpha aa[], const int16_t runs[]) override {
+        fOutside += y < fBand.fTop || y >= fBand.fBottom;
+        this->INHERITED::blitAntiH(x, y, aa, runs);
+    }
+    bool getRowLimits(int* top, int* bottom) const override {
+        *top = fBand.fTop;
+        *bottom = fBand.fBottom;
+        return true;
+    }
+
+    SkIRect fBand;
+    int     fOutside;
+
+    typedef SkRectClipBlitter INHERITED;
+};
+
+static void draw_banded(skiatest::Reporter* reporter, const SkPath* path, const SkRect& rect,
+                        const SkMatrix& matrix, bool antiAlias, int bandRows) {
+    static const int kW = 200, kH = 200;
+    SkBitmap single, banded;
+    single.allocPixels(SkImageInfo::MakeA8(kW, kH));
+    banded.allocPixels(SkImageInfo::MakeA8(kW, kH));
+    single.eraseColor(0);
+    banded.eraseColor(0);
+
+    SkPaint paint;
+    paint.setAntiAlias(antiAlias);
+    SkRasterClip rc(SkIRect::MakeWH(kW, kH));
+    SkDraw draw;
+    draw.fMatrix = &matrix;
+    draw.fRC = &rc;
+    draw.fClip = &rc.bwRgn();
+
+    draw.fBitmap = &single;
+    if (path) {
+        draw.drawPath(*path, paint);
+    } else {
+        draw.drawRect(rect, paint);
+    }
+
+    draw.fBitmap = &banded;
+    for (int top = 0; top < kH; top += bandRows) {
+        SkTBlitterAllocator allocator;
+        BandBlitter blitter(SkBlitter::Choose(banded, matrix, paint, &allocator),
+                            SkIRect::MakeLTRB(0, top, kW, SkMin32(top + bandRows, kH)));
+        if (path) {
+            draw.drawPath(*path, paint, &blitter);
+        } else {
+            draw.drawRect(rect, paint, NULL, NULL, &blitter);
+        }
+        // Paths are not even scan converted outside the band. Rects are just clipped.
+        REPORTER_ASSERT(reporter, !path || 0 == blitter.fOutside);
+    }
+
+    SkAutoLockPixels singleLock(single), bandedLock(banded);
+    REPORTER_ASSERT(reporter, 0 == memcmp(single.getPixels(), banded.getPixels(),
+                                          single.getSafeSize()));
+}
+
+// Drawing a mask a band of rows at a time must give exactly the mask drawn in one pass.
+DEF_TEST(FillPathBanded, reporter) {
+    SkRandom rand;
+    SkPath paths[6];
+    for (int i = 0; i < 40; ++i) {
+        paths[0].lineTo(rand.nextRangeScalar(-10, 210), rand.nextRangeScalar(-10, 210));
+    }
+    paths[1].addCircle(100, 100, 87.3f);
+    paths[1].addCircle(110, 90, 40.6f, SkPath::kCCW_Direction);
+    paths[2].addRoundRect(SkRect::MakeLTRB(10.3f, 20.7f, 180.2f, 190.9f), 30, 30);
+    paths[3].moveTo(5, 195);
+    paths[3].cubicTo(300, -100, -100, -100, 195, 195);
+    paths[3].quadTo(100, 50, 5, 195);
+    paths[4] = paths[0];
+    paths[4].setFillType(SkPath::kEvenOdd_FillType);
+    paths[5] = paths[3];
+    paths[5].setFillType(SkPath::kInverseWinding_FillType);
+
+    SkMatrix matrices[2];
+    matrices[0].reset();
+    matrices[1].setRotate(17, 100, 100);
+
+    static const int gBandRows[] = { 1, 7, 64 };
+    for (int aa = 0; aa < 2; ++aa) {
+        for (size_t b = 0; b < SK_ARRAY_COUNT(gBandRows); ++b) {
+            for (size_t m = 0; m < SK_ARRAY_COUNT(matrices); ++m) {
+                for (size_t p = 0; p < SK_ARRAY_COUNT(paths); ++p) {
+                    draw_banded(reporter, &paths[p], SkRect::MakeEmpty(), matrices[m],
+                                SkToBool(aa), gBandRows[b]);
+                }
+                draw_banded(reporter, NULL, SkRect::MakeLTRB(20.3f, 30.6f, 170.5f, 150.25f),
+                            matrices[m], SkToBool(aa), gBandRows[b]);
+            }
+        }
+    }
+}
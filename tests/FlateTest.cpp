@@ -5,8 +5,11 @@
  * found in the LICENSE file.
  */
 
+#include "SkCanvas.h"
 #include "SkData.h"
 #include "SkFlate.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
 #include "SkStream.h"
 #include "Test.h"
 
@@ -112,3 +115,72 @@ DEF_TEST(Flate, reporter) {
     TestFlate(reporter, &fileStream, 512);
     TestFlate(reporter, &fileStream, 10240);
 }
+
+DEF_TEST(Flate_InflateStream, reporter) {
+    const size_t kSize = 100000;
+    SkAutoDataUnref testData(new_test_data(kSize));
+    SkDynamicMemoryWStream compressed;
+    {
+        SkDeflateWStream deflate(&compressed);
+        deflate.write(testData->data(), kSize);
+    }
+    SkAutoDataUnref compressedData(compressed.copyToData());
+    REPORTER_ASSERT(reporter, compressedData->size() < kSize / 10);
+
+    // Read back in uneven pieces, skipping some, to exercise the buffering.
+    SkMemoryStream src(compressedData);
+    SkInflateStream inflate(&src);
+    const uint8_t* expected = testData->bytes();
+    uint8_t buffer[3000];
+    size_t offset = 0, piece = 1;
+    while (offset < kSize) {
+        size_t n = SkTMin(piece, kSize - offset);
+        if (piece % 3 == 0) {
+            REPORTER_ASSERT(reporter, inflate.skip(n) == n);
+        } else {
+            REPORTER_ASSERT(reporter, inflate.read(buffer, n) == n);
+            REPORTER_ASSERT(reporter, 0 == memcmp(buffer, expected + offset, n));
+        }
+        offset += n;
+        piece = piece * 7 % sizeof(buffer) + 1;
+    }
+    REPORTER_ASSERT(reporter, 0 == inflate.read(buffer, 1));
+    REPORTER_ASSERT(reporter, inflate.isAtEnd());
+
+    // Truncated data stops early instead of running on.
+    SkMemoryStream truncated(compressedData->data(), compressedData->size() / 2);
+    SkInflateStream partial(&truncated);
+    SkAutoTMalloc<uint8_t> all(kSize);
+    REPORTER_ASSERT(reporter, partial.read(all.get(), kSize) < kSize);
+}
+
+// With SkFlate registered, SkPicture::serialize() can compress with zlib.
+DEF_TEST(Flate_Picture, reporter) {
+    SkFlate::RegisterStreamCodec();
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 1000);
+    SkPaint paint;
+    for (int i = 0; i < 100; ++i) {
+        paint.setColor(0xFF000000 | (i * 0x10203));
+        canvas->drawRect(SkRect::MakeXYWH(10, SkIntToScalar(i * 10), 80, 8), paint);
+    }
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    SkDynamicMemoryWStream raw, flate;
+    picture->serialize(&raw);
+    REPORTER_ASSERT(reporter, SkPicture::kCompressFlate_SerializeFlag ==
+                    picture->serialize(&flate, NULL, SkPicture::kCompressFlate_SerializeFlag |
+                                                     SkPicture::kCompressLZ4_SerializeFlag));
+    REPORTER_ASSERT(reporter, flate.getOffset() < raw.getOffset() / 2);
+
+    SkAutoTDelete<SkStreamAsset> stream(flate.detachAsStream());
+    SkAutoTUnref<SkPicture> copy(SkPicture::CreateFromStream(stream));
+    REPORTER_ASSERT(reporter, copy);
+    if (copy) {
+        SkDynamicMemoryWStream reserialized;
+        copy->serialize(&reserialized);
+        SkAutoDataUnref a(raw.copyToData()), b(reserialized.copyToData());
+        REPORTER_ASSERT(reporter, a->equals(b));
+    }
+}
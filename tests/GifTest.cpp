@@ -11,11 +11,14 @@
     (!defined(SK_BUILD_FOR_IOS)) &&             \
     (!defined(SK_BUILD_FOR_MAC))
 
+#include "Resources.h"
 #include "SkBitmap.h"
 #include "SkData.h"
 #include "SkForceLinking.h"
 #include "SkImage.h"
 #include "SkImageDecoder.h"
+#include "SkMovie.h"
+#include "SkRandom.h"
 #include "SkStream.h"
 #include "Test.h"
 
@@ -197,4 +200,50 @@ DEF_TEST(Gif, reporter) {
     // "libgif warning [interlace DGifGetLine]"
 }
 
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels lockA(a), lockB(b);
+    if (a.width() != b.width() || a.height() != b.height()) {
+        return false;
+    }
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * sizeof(uint32_t))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Seeking an animated GIF, backward or forward, must show the same frame as playing it from the
+// start.  animated_radar.gif has 24 frames, 10ms each, using every disposal method.
+DEF_TEST(Gif_MovieSeek, reporter) {
+    SkString path = GetResourcePath("animated_radar.gif");
+    SkAutoTUnref<SkMovie> movie(SkMovie::DecodeFile(path.c_str()));
+    if (!movie) {
+        SkDebugf("Missing resource '%s'\n", path.c_str());
+        return;
+    }
+    static const int kFrames = 24;
+    REPORTER_ASSERT(reporter, kFrames * 10 == movie->duration());
+
+    SkBitmap frames[kFrames];
+    for (int i = 0; i < kFrames; ++i) {
+        movie->setTime(i * 10 + 5);
+        REPORTER_ASSERT(reporter, movie->bitmap().copyTo(&frames[i]));
+    }
+
+    SkRandom rand;
+    for (int n = 0; n < 100; ++n) {
+        const int i = rand.nextULessThan(kFrames);
+        movie->setTime(i * 10 + 5);
+        REPORTER_ASSERT(reporter, same_pixels(frames[i], movie->bitmap()));
+    }
+
+    // A fresh movie jumping straight to a frame agrees too.
+    for (int i = 0; i < kFrames; i += 5) {
+        SkAutoTUnref<SkMovie> fresh(SkMovie::DecodeFile(path.c_str()));
+        fresh->setTime(i * 10 + 5);
+        REPORTER_ASSERT(reporter, same_pixels(frames[i], fresh->bitmap()));
+    }
+}
+
 #endif  // !(SK_BUILD_FOR_WIN32||SK_BUILD_FOR_IOS||SK_BUILD_FOR_MAC)
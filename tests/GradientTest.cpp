@@ -11,6 +11,7 @@
 #include "SkShader.h"
 #include "SkTemplates.h"
 #include "Test.h"
+#include "gradients/SkGradientShaderPriv.h"
 
 // https://code.google.com/p/chromium/issues/detail?id=448299
 // Giant (inverse) matrix causes overflow when converting/computing using 32.32
@@ -179,6 +180,41 @@ static void TestConstantGradient(skiatest::Reporter*) {
     }
 }
 
+static SkShader* make_shared_grad(SkColor middle) {
+    const SkPoint pts[] = { { 0, 0 }, { SkIntToScalar(16), 0 } };
+    const SkColor colors[] = { SK_ColorRED, middle, SK_ColorBLUE };
+    return SkGradientShader::CreateLinear(pts, colors, NULL, SK_ARRAY_COUNT(colors),
+                                          SkShader::kClamp_TileMode);
+}
+
+// Gradients made with the same colors share their color tables, whichever shader built them.
+// The tables are compared by address: SkResourceCache's byte totals also move with whatever
+// other tests run alongside this one.
+static void test_shared_tables(skiatest::Reporter* reporter) {
+    typedef SkGradientShaderBase::GradientShaderCache Cache;
+
+    SkAutoTUnref<SkShader> first(make_shared_grad(SK_ColorGREEN));
+    SkAutoTUnref<SkShader> again(make_shared_grad(SK_ColorGREEN));
+    SkAutoTUnref<SkShader> otherColors(make_shared_grad(SK_ColorWHITE));
+    const SkGradientShaderBase& firstBase = *static_cast<SkGradientShaderBase*>(first.get());
+    const SkGradientShaderBase& againBase = *static_cast<SkGradientShaderBase*>(again.get());
+    const SkGradientShaderBase& otherBase = *static_cast<SkGradientShaderBase*>(otherColors.get());
+
+    SkAutoTUnref<Cache> firstCache(SkNEW_ARGS(Cache, (0xFF, firstBase)));
+    SkAutoTUnref<Cache> againCache(SkNEW_ARGS(Cache, (0xFF, againBase)));
+    REPORTER_ASSERT(reporter, firstCache->getCache32() == againCache->getCache32());
+    REPORTER_ASSERT(reporter, firstCache->getCache16() == againCache->getCache16());
+
+    // The 32bit table depends on the alpha, the 16bit table does not.
+    SkAutoTUnref<Cache> otherAlpha(SkNEW_ARGS(Cache, (0x80, againBase)));
+    REPORTER_ASSERT(reporter, firstCache->getCache32() != otherAlpha->getCache32());
+    REPORTER_ASSERT(reporter, firstCache->getCache16() == otherAlpha->getCache16());
+
+    SkAutoTUnref<Cache> otherCache(SkNEW_ARGS(Cache, (0xFF, otherBase)));
+    REPORTER_ASSERT(reporter, firstCache->getCache32() != otherCache->getCache32());
+    REPORTER_ASSERT(reporter, firstCache->getCache16() != otherCache->getCache16());
+}
+
 typedef void (*GradProc)(skiatest::Reporter* reporter, const GradRec&);
 
 static void TestGradientShaders(skiatest::Reporter* reporter) {
@@ -217,4 +253,5 @@ DEF_TEST(Gradient, reporter) {
     TestGradientShaders(reporter);
     TestConstantGradient(reporter);
     test_big_grad(reporter);
+    test_shared_tables(reporter);
 }
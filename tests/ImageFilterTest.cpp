@@ -27,6 +27,7 @@
 #include "SkPicture.h"
 #include "SkPictureImageFilter.h"
 #include "SkPictureRecorder.h"
+#include "SkRandom.h"
 #include "SkReadBuffer.h"
 #include "SkRect.h"
 #include "SkRectShaderImageFilter.h"
@@ -1136,6 +1137,103 @@ DEF_TEST(ComposedImageFilterOffset, reporter) {
     REPORTER_ASSERT(reporter, offset.fX == 1 && offset.fY == 0);
 }
 
+// The direct loop over the window, clamped to the line, one channel at a time.
+static void morphology_1d(const SkBitmap& src, SkBitmap* dst, int radius, bool dilate,
+                          bool horizontal) {
+    const int width = horizontal ? src.width() : src.height();
+    for (int y = 0; y < src.height(); ++y) {
+        for (int x = 0; x < src.width(); ++x) {
+            const int pos = horizontal ? x : y;
+            const int lo = SkMax32(pos - radius, 0);
+            const int hi = SkMin32(pos + radius, width - 1);
+            unsigned result[4];
+            for (int c = 0; c < 4; ++c) {
+                result[c] = dilate ? 0 : 255;
+            }
+            for (int i = lo; i <= hi; ++i) {
+                const SkPMColor p = horizontal ? *src.getAddr32(i, y) : *src.getAddr32(x, i);
+                const unsigned channels[4] = {
+                    SkGetPackedA32(p), SkGetPackedR32(p), SkGetPackedG32(p), SkGetPackedB32(p)
+                };
+                for (int c = 0; c < 4; ++c) {
+                    result[c] = dilate ? SkMax32(result[c], channels[c])
+                                       : SkMin32(result[c], channels[c]);
+                }
+            }
+            *dst->getAddr32(x, y) = SkPackARGB32(result[0], result[1], result[2], result[3]);
+        }
+    }
+}
+
+static void make_random_premul(SkRandom* rand, SkBitmap* bitmap, int width, int height) {
+    bitmap->allocN32Pixels(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const unsigned a = rand->nextULessThan(256);
+            *bitmap->getAddr32(x, y) = SkPackARGB32(a, rand->nextULessThan(a + 1),
+                                                    rand->nextULessThan(a + 1),
+                                                    rand->nextULessThan(a + 1));
+        }
+    }
+}
+
+// Larger radii are filtered with the van Herk/Gil-Werman running max/min, and large bitmaps
+// in parallel bands. Both must match the direct loop exactly, including radii that reach past
+// the edges of the bitmap.
+DEF_TEST(MorphologyMatchesDirectLoop, reporter) {
+    SkBitmap temp;
+    temp.allocN32Pixels(100, 100);
+    SkBitmapDevice device(temp);
+    SkDeviceImageFilterProxy proxy(&device, SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType));
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeLargest(), NULL);
+
+    static const SkISize gSizes[] = { { 1, 1 }, { 37, 29 }, { 150, 131 } };
+    static const int gRadii[] = { 0, 1, 2, 7, 8, 9, 20, 36, 37, 150, 200 };
+
+    SkRandom rand;
+    for (size_t s = 0; s < SK_ARRAY_COUNT(gSizes); ++s) {
+        SkBitmap src;
+        make_random_premul(&rand, &src, gSizes[s].width(), gSizes[s].height());
+        SkBitmap pass, expected;
+        pass.allocN32Pixels(src.width(), src.height());
+        expected.allocN32Pixels(src.width(), src.height());
+
+        for (int dilate = 0; dilate < 2; ++dilate) {
+            for (size_t i = 0; i < SK_ARRAY_COUNT(gRadii); ++i) {
+                const int radiusX = gRadii[i];
+                const int radiusY = gRadii[(i + 3) % SK_ARRAY_COUNT(gRadii)];
+                if (0 == radiusX && 0 == radiusY) {
+                    continue;
+                }
+                morphology_1d(src, &pass, radiusX, SkToBool(dilate), true);
+                morphology_1d(pass, &expected, radiusY, SkToBool(dilate), false);
+
+                SkAutoTUnref<SkImageFilter> filter(dilate ?
+                        (SkImageFilter*)SkDilateImageFilter::Create(radiusX, radiusY) :
+                        (SkImageFilter*)SkErodeImageFilter::Create(radiusX, radiusY));
+                SkBitmap result;
+                SkIPoint offset;
+                REPORTER_ASSERT(reporter, filter->filterImage(&proxy, src, ctx, &result, &offset));
+                REPORTER_ASSERT(reporter, 0 == offset.fX && 0 == offset.fY);
+                REPORTER_ASSERT(reporter, result.width() == src.width() &&
+                                          result.height() == src.height());
+
+                SkAutoLockPixels alpResult(result), alpExpected(expected);
+                bool equal = true;
+                for (int y = 0; y < src.height() && equal; ++y) {
+                    equal = 0 == memcmp(result.getAddr32(0, y), expected.getAddr32(0, y),
+                                        src.width() * sizeof(SkPMColor));
+                }
+                if (!equal) {
+                    ERRORF(reporter, "%s %dx%d radius (%d, %d) differs from the direct loop",
+                           dilate ? "dilate" : "erode", src.width(), src.height(),
+                           radiusX, radiusY);
+                }
+            }
+        }
+    }
+}
+
 #if SK_SUPPORT_GPU
 const SkSurfaceProps gProps = SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType);
 
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkImageEncoder.h"
+#include "SkImagePack.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "Test.h"
+
+// Opaque, so the PNG round trip is exact.  Each call allocates new pixels, like an icon loaded
+// separately for each tile.
+static void make_sprite(SkBitmap* bm, uint32_t seed) {
+    bm->allocN32Pixels(16, 16, true);
+    SkRandom rand(seed);
+    for (int y = 0; y < 16; ++y) {
+        for (int x = 0; x < 16; ++x) {
+            *bm->getAddr32(x, y) = rand.nextU() | 0xFF000000;
+        }
+    }
+}
+
+static SkPicture* make_tile(int i) {
+    SkBitmap icon, other;
+    make_sprite(&icon, 1);
+    make_sprite(&other, 2 + (i & 1));
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(64, 64);
+    canvas->drawColor(SK_ColorWHITE);
+    canvas->drawBitmap(icon, SkIntToScalar(i * 4), 0);
+    canvas->drawBitmap(icon, 30, 40);
+    canvas->drawBitmap(other, 0, 30);
+    return recorder.endRecording();
+}
+
+static void draw(SkPicture* picture, SkBitmap* bm) {
+    bm->allocN32Pixels(64, 64);
+    SkCanvas canvas(*bm);
+    canvas.drawPicture(picture);
+}
+
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels lockA(a), lockB(b);
+    return a.getSize() == b.getSize() && !memcmp(a.getPixels(), b.getPixels(), a.getSize());
+}
+
+DEF_TEST(ImagePack, reporter) {
+    SkBitmap probe;
+    make_sprite(&probe, 1);
+    SkAutoDataUnref png(SkImageEncoder::EncodeData(probe, SkImageEncoder::kPNG_Type, 100));
+    if (!png) {
+        return;     // No PNG encoder in this build, so bitmaps stay in the pictures.
+    }
+
+    static const int kTiles = 4;
+    SkAutoTUnref<SkPicture> tiles[kTiles];
+    SkAutoDataUnref packed[kTiles];
+    size_t plainSize = 0, packedSize = 0;
+    SkImagePackWriter writer;
+    for (int i = 0; i < kTiles; ++i) {
+        tiles[i].reset(make_tile(i));
+
+        SkDynamicMemoryWStream plain, stream;
+        tiles[i]->serialize(&plain);
+        tiles[i]->serialize(&stream, &writer);
+        plainSize += plain.getOffset();
+        packedSize += stream.getOffset();
+        packed[i].reset(stream.copyToData());
+    }
+    // Three distinct images.  Each tile stores two bitmaps, as it only keeps one copy of its icon.
+    REPORTER_ASSERT(reporter, 3 == writer.count());
+    REPORTER_ASSERT(reporter, 2 * kTiles == writer.referenceCount());
+
+    SkDynamicMemoryWStream packStream;
+    REPORTER_ASSERT(reporter, writer.write(&packStream));
+    SkAutoDataUnref packData(packStream.copyToData());
+    REPORTER_ASSERT(reporter, packedSize + packData->size() < plainSize);
+
+    SkAutoTUnref<SkImagePack> pack(SkImagePack::NewFromData(packData));
+    REPORTER_ASSERT(reporter, pack);
+    if (!pack) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, 3 == pack->count());
+
+    // Unresolved references still load, with placeholders for the images.
+    {
+        SkMemoryStream stream(packed[0]);
+        SkAutoTUnref<SkPicture> picture(SkPicture::CreateFromStream(&stream,
+                                                                    &SkImagePack::InstallPixelRef));
+        REPORTER_ASSERT(reporter, picture);
+    }
+
+    SkImagePack::Register(pack);
+    for (int i = 0; i < kTiles; ++i) {
+        SkMemoryStream stream(packed[i]);
+        SkAutoTUnref<SkPicture> picture(SkPicture::CreateFromStream(&stream,
+                                                                    &SkImagePack::InstallPixelRef));
+        REPORTER_ASSERT(reporter, picture);
+        if (picture) {
+            SkBitmap expected, actual;
+            draw(tiles[i], &expected);
+            draw(picture, &actual);
+            REPORTER_ASSERT(reporter, same_pixels(expected, actual));
+        }
+    }
+    SkImagePack::Unregister(pack);
+
+    // Every reference to an image shares one pixel ref.
+    SkImagePackWriter refWriter;
+    SkAutoDataUnref ref(refWriter.encodePixels(probe.info(), probe.getPixels(), probe.rowBytes()));
+    REPORTER_ASSERT(reporter, SkImagePack::IsReference(ref->data(), ref->size()));
+    SkBitmap first, second;
+    REPORTER_ASSERT(reporter, pack->installPixelRef(ref->data(), ref->size(), &first));
+    REPORTER_ASSERT(reporter, pack->installPixelRef(ref->data(), ref->size(), &second));
+    REPORTER_ASSERT(reporter, first.pixelRef() && first.pixelRef() == second.pixelRef());
+
+    // Damaged packs are rejected.
+    SkAutoDataUnref truncated(SkData::NewSubset(packData, 0, packData->size() - 1));
+    REPORTER_ASSERT(reporter, NULL == SkImagePack::NewFromData(truncated));
+    SkAutoDataUnref header(SkData::NewSubset(packData, 0, 12));
+    REPORTER_ASSERT(reporter, NULL == SkImagePack::NewFromData(header));
+}
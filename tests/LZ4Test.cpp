@@ -0,0 +1,188 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkLZ4.h"
+#include "SkPicture.h"
+#include "SkPictureData.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "SkStreamCodec.h"
+#include "Test.h"
+
+// Text-like data: words from a small vocabulary with some noise, so there are matches at all
+// sorts of lengths and offsets.
+static void fill_test_data(uint8_t* data, size_t size, SkRandom* rand) {
+    static const char* gWords[] = {
+        "the ", "picture ", "stream ", "of ", "drawRect ", "paint ", "and ", "a ",
+    };
+    size_t i = 0;
+    while (i < size) {
+        if (rand->nextU() % 8 == 0) {
+            data[i++] = SkToU8(rand->nextU());
+            continue;
+        }
+        const char* word = gWords[rand->nextU() % SK_ARRAY_COUNT(gWords)];
+        for (; *word && i < size; ++word) {
+            data[i++] = *word;
+        }
+    }
+}
+
+static void test_block(skiatest::Reporter* reporter, const uint8_t* src, size_t size) {
+    SkAutoTMalloc<uint8_t> packed(SkLZ4::CompressBound(size));
+    const size_t packedSize = SkLZ4::Compress(src, size, packed.get());
+    REPORTER_ASSERT(reporter, packedSize <= SkLZ4::CompressBound(size));
+
+    SkAutoTMalloc<uint8_t> unpacked(size + 1);
+    REPORTER_ASSERT(reporter, SkLZ4::Decompress(packed.get(), packedSize, unpacked.get(), size));
+    REPORTER_ASSERT(reporter, 0 == memcmp(src, unpacked.get(), size));
+
+    // The output size must match exactly, and truncated input must be caught.
+    REPORTER_ASSERT(reporter,
+                    !SkLZ4::Decompress(packed.get(), packedSize, unpacked.get(), size + 1));
+    if (size > 0) {
+        REPORTER_ASSERT(reporter,
+                        !SkLZ4::Decompress(packed.get(), packedSize, unpacked.get(), size - 1));
+        REPORTER_ASSERT(reporter,
+                        !SkLZ4::Decompress(packed.get(), packedSize - 1, unpacked.get(), size));
+    }
+}
+
+DEF_TEST(LZ4_Block, reporter) {
+    SkRandom rand;
+    SkAutoTMalloc<uint8_t> data(SkLZ4::kMaxBlockSize);
+
+    // Every small size, around the minimum length worth matching.
+    for (size_t size = 0; size < 40; ++size) {
+        memset(data.get(), 'x', size);
+        test_block(reporter, data.get(), size);
+        fill_test_data(data.get(), size, &rand);
+        test_block(reporter, data.get(), size);
+    }
+
+    // Runs (overlapping matches), noise (no matches) and text.
+    memset(data.get(), 0, SkLZ4::kMaxBlockSize);
+    test_block(reporter, data.get(), SkLZ4::kMaxBlockSize);
+    for (size_t i = 0; i < SkLZ4::kMaxBlockSize; ++i) {
+        data[i] = SkToU8(rand.nextU());
+    }
+    test_block(reporter, data.get(), SkLZ4::kMaxBlockSize);
+    fill_test_data(data.get(), SkLZ4::kMaxBlockSize, &rand);
+    test_block(reporter, data.get(), SkLZ4::kMaxBlockSize);
+
+    SkAutoTMalloc<uint8_t> packed(SkLZ4::CompressBound(SkLZ4::kMaxBlockSize));
+    size_t packedSize = SkLZ4::Compress(data.get(), SkLZ4::kMaxBlockSize, packed.get());
+    REPORTER_ASSERT(reporter, packedSize < SkLZ4::kMaxBlockSize / 2);
+
+    // Garbage must never decode out of bounds.
+    SkAutoTMalloc<uint8_t> unpacked(SkLZ4::kMaxBlockSize);
+    for (int i = 0; i < 1000; ++i) {
+        packed[rand.nextULessThan(SkToU32(packedSize))] = SkToU8(rand.nextU());
+        SkLZ4::Decompress(packed.get(), packedSize, unpacked.get(), SkLZ4::kMaxBlockSize);
+    }
+}
+
+DEF_TEST(LZ4_Stream, reporter) {
+    SkRandom rand;
+    const size_t kSize = 3 * SkLZ4::kMaxBlockSize + 1234;
+    SkAutoTMalloc<uint8_t> data(kSize);
+    fill_test_data(data.get(), kSize, &rand);
+
+    SkDynamicMemoryWStream compressed;
+    {
+        SkLZ4WStream lz4(&compressed);
+        size_t offset = 0;
+        while (offset < kSize) {
+            size_t n = SkTMin<size_t>(rand.nextULessThan(20000), kSize - offset);
+            REPORTER_ASSERT(reporter, lz4.write(data.get() + offset, n));
+            offset += n;
+        }
+        REPORTER_ASSERT(reporter, lz4.bytesWritten() == kSize);
+    }
+    SkAutoDataUnref compressedData(compressed.copyToData());
+    REPORTER_ASSERT(reporter, compressedData->size() < kSize / 2);
+
+    SkMemoryStream src(compressedData);
+    SkLZ4Stream lz4(&src);
+    SkAutoTMalloc<uint8_t> buffer(20000);
+    size_t offset = 0;
+    while (offset < kSize) {
+        REPORTER_ASSERT(reporter, !lz4.isAtEnd());
+        size_t n = SkTMin<size_t>(rand.nextULessThan(20000), kSize - offset);
+        if (rand.nextBool()) {
+            REPORTER_ASSERT(reporter, lz4.skip(n) == n);
+        } else {
+            REPORTER_ASSERT(reporter, lz4.read(buffer.get(), n) == n);
+            REPORTER_ASSERT(reporter, 0 == memcmp(buffer.get(), data.get() + offset, n));
+        }
+        offset += n;
+    }
+    REPORTER_ASSERT(reporter, lz4.isAtEnd());
+    REPORTER_ASSERT(reporter, 0 == lz4.read(buffer.get(), 1));
+
+    // Truncated data stops short.
+    SkMemoryStream truncated(compressedData->data(), compressedData->size() - 10);
+    SkLZ4Stream partial(&truncated);
+    REPORTER_ASSERT(reporter, partial.read(data.get(), kSize) < kSize);
+}
+
+DEF_TEST(LZ4_Picture, reporter) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 1000);
+    SkPaint paint;
+    for (int i = 0; i < 100; ++i) {
+        paint.setColor(0xFF000000 | (i * 0x10203));
+        canvas->drawRect(SkRect::MakeXYWH(10, SkIntToScalar(i * 10), 80, 8), paint);
+        canvas->drawText("abc", 3, 10, SkIntToScalar(i * 10), paint);
+    }
+    SkAutoTUnref<SkPicture> child(recorder.endRecording());
+
+    canvas = recorder.beginRecording(100, 1000);
+    canvas->drawPicture(child);
+    canvas->drawCircle(50, 50, 20, paint);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    SkDynamicMemoryWStream raw, lz4;
+    REPORTER_ASSERT(reporter, 0 == picture->serialize(&raw));
+    REPORTER_ASSERT(reporter, SkPicture::kCompressLZ4_SerializeFlag ==
+                    picture->serialize(&lz4, NULL, SkPicture::kCompressLZ4_SerializeFlag));
+    REPORTER_ASSERT(reporter, lz4.getOffset() < raw.getOffset() / 2);
+
+    SkAutoDataUnref rawData(raw.copyToData()), lz4Data(lz4.copyToData());
+    SkMemoryStream stream(lz4Data);
+    SkPictInfo info;
+    REPORTER_ASSERT(reporter, SkPicture::InternalOnly_StreamIsSKP(&stream, &info));
+    REPORTER_ASSERT(reporter, info.fFlags & SkPictInfo::kCompressed_Flag);
+
+    stream.rewind();
+    SkAutoTUnref<SkPicture> copy(SkPicture::CreateFromStream(&stream));
+    REPORTER_ASSERT(reporter, copy);
+    if (copy) {
+        SkDynamicMemoryWStream reserialized;
+        copy->serialize(&reserialized);
+        SkAutoDataUnref reserializedData(reserialized.copyToData());
+        REPORTER_ASSERT(reporter, rawData->equals(reserializedData));
+    }
+
+    // A truncated file fails cleanly.
+    SkMemoryStream truncated(lz4Data->data(), lz4Data->size() / 2);
+    SkAutoTUnref<SkPicture> partial(SkPicture::CreateFromStream(&truncated));
+    REPORTER_ASSERT(reporter, !partial);
+
+    // Asking for flate falls back to LZ4 when flate isn't registered.
+    SkDynamicMemoryWStream probe;
+    SkAutoTDelete<SkWStream> flate(SkStreamCodec::NewCompressor(SkStreamCodec::kFlate_Type,
+                                                                &probe));
+    const uint32_t expected = flate ? SkPicture::kCompressFlate_SerializeFlag
+                                    : SkPicture::kCompressLZ4_SerializeFlag;
+    SkDynamicMemoryWStream fallback;
+    REPORTER_ASSERT(reporter, expected ==
+                    picture->serialize(&fallback, NULL, SkPicture::kCompressFlate_SerializeFlag));
+}
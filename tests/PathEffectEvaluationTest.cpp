@@ -0,0 +1,218 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Sk1DPathEffect.h"
+#include "Sk2DPathEffect.h"
+#include "SkCanvas.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkStream.h"
+#include "Test.h"
+
+static const int kSize = 200;
+
+static void draw(SkBitmap* bm, const SkPath& path, SkPathEffect* effect, SkScalar rotate = 0,
+                 SkColor color = 0xFF204080) {
+    bm->allocN32Pixels(kSize, kSize);
+    bm->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*bm);
+    canvas.translate(kSize / 2, kSize / 2);
+    canvas.rotate(rotate);
+    canvas.translate(-kSize / 2, -kSize / 2);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(color);
+    paint.setPathEffect(effect);
+    canvas.drawPath(path, paint);
+}
+
+// Returns the largest difference of any channel over pixels in bounds, and optionally the average.
+static int max_diff(const SkBitmap& a, const SkBitmap& b, const SkIRect& bounds,
+                    float* meanDiff = NULL) {
+    int diff = 0, sum = 0;
+    for (int y = bounds.fTop; y < bounds.fBottom; ++y) {
+        for (int x = bounds.fLeft; x < bounds.fRight; ++x) {
+            const SkPMColor ca = *a.getAddr32(x, y), cb = *b.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                const int d = SkAbs32(int((ca >> shift) & 0xFF) - int((cb >> shift) & 0xFF));
+                diff = SkTMax(diff, d);
+                sum += d;
+            }
+        }
+    }
+    if (meanDiff) {
+        *meanDiff = sum / (4.0f * bounds.width() * bounds.height());
+    }
+    return diff;
+}
+
+static bool any_ink(const SkBitmap& bm) {
+    for (int y = 0; y < bm.height(); ++y) {
+        for (int x = 0; x < bm.width(); ++x) {
+            if (*bm.getAddr32(x, y) != SkPreMultiplyColor(SK_ColorWHITE)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Inside the path, away from its edges, the tile draws what the geometry does, give or take
+// resampling the tile.
+DEF_TEST(PathEffect_TileEvaluation, reporter) {
+    SkMatrix lattices[2];
+    lattices[0].setScale(10, 8);
+    lattices[1].setScale(10, 8);
+    lattices[1].postRotate(30);
+    SkPath stamp;
+    stamp.addCircle(0, 0, 3);
+
+    SkPath area;
+    area.addCircle(kSize / 2, kSize / 2, 90);
+    const SkIRect inside = SkIRect::MakeLTRB(50, 50, 150, 150);
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(lattices); ++i) {
+        const SkMatrix& lattice = lattices[i];
+        SkPathEffect* effects[] = {
+            SkPath2DPathEffect::Create(lattice, stamp),
+            SkPath2DPathEffect::Create(lattice, stamp, Sk2DPathEffect::kTile_Evaluation),
+            SkLine2DPathEffect::Create(2, lattice),
+            SkLine2DPathEffect::Create(2, lattice, Sk2DPathEffect::kTile_Evaluation),
+        };
+        for (size_t j = 0; j < SK_ARRAY_COUNT(effects); j += 2) {
+            SkAutoTUnref<SkShader> shader(effects[j + 1]->refTileShader(SkPaint(),
+                                                                        SkMatrix::I()));
+            REPORTER_ASSERT(reporter, shader);
+
+            SkBitmap geometry, tile;
+            draw(&geometry, area, effects[j]);
+            draw(&tile, area, effects[j + 1]);
+            float meanDiff;
+            const int maxDiff = max_diff(geometry, tile, inside, &meanDiff);
+            if (lattice.rectStaysRect()) {
+                // Tile pixels line up with device pixels.
+                REPORTER_ASSERT(reporter, maxDiff <= 16);
+            } else {
+                REPORTER_ASSERT(reporter, meanDiff <= 8);
+            }
+
+            // Drawn again from the cached tile.
+            SkBitmap again;
+            draw(&again, area, effects[j + 1]);
+            REPORTER_ASSERT(reporter, 0 == max_diff(tile, again, SkIRect::MakeWH(kSize, kSize)));
+        }
+        for (size_t j = 0; j < SK_ARRAY_COUNT(effects); ++j) {
+            SkSafeUnref(effects[j]);
+        }
+    }
+
+    // Cells smaller than a few pixels fall back to geometry.
+    SkAutoTUnref<SkPathEffect> tiny(SkPath2DPathEffect::Create(SkMatrix::MakeScale(2, 2), stamp,
+                                                               Sk2DPathEffect::kTile_Evaluation));
+    SkAutoTUnref<SkShader> shader(tiny->refTileShader(SkPaint(), SkMatrix::I()));
+    REPORTER_ASSERT(reporter, NULL == shader);
+}
+
+// Stamps land within a fraction of a pixel of where the geometry puts them.
+DEF_TEST(PathEffect_StampEvaluation, reporter) {
+    SkPath stamp;
+    stamp.moveTo(-4, -2);
+    stamp.lineTo(4, 0);
+    stamp.lineTo(-4, 2);
+    stamp.close();
+
+    SkPath line;
+    line.moveTo(20, 30);
+    line.cubicTo(180, 20, 20, 180, 170, 170);
+
+    for (int style = SkPath1DPathEffect::kTranslate_Style;
+         style <= SkPath1DPathEffect::kRotate_Style; ++style) {
+        SkAutoTUnref<SkPathEffect> geometryEffect(SkPath1DPathEffect::Create(
+                stamp, 12, 0, (SkPath1DPathEffect::Style)style));
+        SkAutoTUnref<SkPathEffect> stampEffect(SkPath1DPathEffect::Create(
+                stamp, 12, 0, (SkPath1DPathEffect::Style)style,
+                SkPath1DPathEffect::kStamp_Evaluation));
+        SkPathEffect::StampData data;
+        REPORTER_ASSERT(reporter, stampEffect->asStamps(&data, line, SkStrokeRec(SkPaint()), NULL));
+        REPORTER_ASSERT(reporter, data.fPositions.count() > 10);
+        REPORTER_ASSERT(reporter, !geometryEffect->asStamps(NULL, line, SkStrokeRec(SkPaint()),
+                                                            NULL));
+
+        SkBitmap geometry, stamped;
+        for (SkScalar rotate = 0; rotate < 90; rotate += 37) {
+            draw(&geometry, line, geometryEffect, rotate);
+            draw(&stamped, line, stampEffect, rotate);
+            REPORTER_ASSERT(reporter, any_ink(stamped));
+            REPORTER_ASSERT(reporter,
+                            max_diff(geometry, stamped, SkIRect::MakeWH(kSize, kSize)) <= 96);
+        }
+    }
+}
+
+// Overlapping stamps would be blended twice, so translucent paints draw the geometry.
+DEF_TEST(PathEffect_StampEvaluationTranslucent, reporter) {
+    SkPath stamp;
+    stamp.addCircle(0, 0, 6);
+    SkPath line;
+    line.moveTo(20, 100);
+    line.lineTo(180, 100);
+
+    // Copies 4 apart, each 12 wide.
+    SkAutoTUnref<SkPathEffect> geometryEffect(SkPath1DPathEffect::Create(
+            stamp, 4, 0, SkPath1DPathEffect::kTranslate_Style));
+    SkAutoTUnref<SkPathEffect> stampEffect(SkPath1DPathEffect::Create(
+            stamp, 4, 0, SkPath1DPathEffect::kTranslate_Style,
+            SkPath1DPathEffect::kStamp_Evaluation));
+
+    SkBitmap geometry, stamped;
+    draw(&geometry, line, geometryEffect, 0, 0x80204080);
+    draw(&stamped, line, stampEffect, 0, 0x80204080);
+    REPORTER_ASSERT(reporter, any_ink(stamped));
+    REPORTER_ASSERT(reporter, 0 == max_diff(geometry, stamped, SkIRect::MakeWH(kSize, kSize)));
+}
+
+// The evaluation survives a trip through a picture.
+DEF_TEST(PathEffect_EvaluationSerialization, reporter) {
+    SkPath stamp;
+    stamp.addRect(-2, -2, 2, 2);
+    SkPath area;
+    area.addCircle(kSize / 2, kSize / 2, 80);
+    SkPath line;
+    line.moveTo(10, 10);
+    line.lineTo(190, 150);
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(kSize, kSize);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setPathEffect(SkPath2DPathEffect::Create(SkMatrix::MakeScale(9, 9), stamp,
+                                                   Sk2DPathEffect::kTile_Evaluation))->unref();
+    canvas->drawPath(area, paint);
+    paint.setPathEffect(SkPath1DPathEffect::Create(stamp, 7, 0,
+                                                   SkPath1DPathEffect::kTranslate_Style,
+                                                   SkPath1DPathEffect::kStamp_Evaluation))->unref();
+    canvas->drawPath(line, paint);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    SkDynamicMemoryWStream stream;
+    picture->serialize(&stream);
+    SkAutoTDelete<SkStream> input(stream.detachAsStream());
+    SkAutoTUnref<SkPicture> copy(SkPicture::CreateFromStream(input));
+    REPORTER_ASSERT(reporter, copy);
+    if (!copy) {
+        return;
+    }
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(kSize, kSize);
+    actual.allocN32Pixels(kSize, kSize);
+    expected.eraseColor(SK_ColorWHITE);
+    actual.eraseColor(SK_ColorWHITE);
+    SkCanvas(expected).drawPicture(picture);
+    SkCanvas(actual).drawPicture(copy);
+    REPORTER_ASSERT(reporter, 0 == max_diff(expected, actual, SkIRect::MakeWH(kSize, kSize)));
+}
@@ -0,0 +1,266 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkPerlinNoiseShader.h"
+#include "Test.h"
+
+// SkPerlinNoiseShader evaluates the four channels together with Sk4f. This is the scalar, one
+// channel at a time evaluation it replaced, written against the SVG feTurbulence reference
+// code: http://www.w3.org/TR/SVG11/filters.html#feTurbulenceElement
+
+static const int kBlockSize = 256;
+static const int kBlockMask = kBlockSize - 1;
+static const int kPerlinNoise = 4096;
+static const int kRandMaximum = SK_MaxS32;
+
+// Each channel may be off by this much. The Sk4f code does the same float operations in the
+// same order as the scalar code, but the compiler is free to fuse multiplies and adds in one
+// and not the other.
+static const int kTolerance = 1;
+
+namespace {
+
+struct StitchData {
+    int fWidth, fWrapX, fHeight, fWrapY;
+};
+
+class ScalarTurbulence {
+public:
+    ScalarTurbulence(bool fractalNoise, SkScalar baseFrequencyX, SkScalar baseFrequencyY,
+                     int numOctaves, SkScalar seed, const SkISize& tileSize)
+        : fFractalNoise(fractalNoise)
+        , fNumOctaves(numOctaves)
+        , fStitchTiles(!tileSize.isEmpty()) {
+        fBaseFrequency.set(baseFrequencyX, baseFrequencyY);
+        sk_bzero(&fStitchDataInit, sizeof(fStitchDataInit));
+        this->init(seed);
+        if (fStitchTiles) {
+            this->stitch(tileSize);
+        }
+    }
+
+    // The color for the pixel at (x, y), drawn with an identity matrix and an opaque paint.
+    SkPMColor shade(int x, int y) const {
+        // Noise coordinates are 1 based.
+        const SkPoint point = SkPoint::Make(SkIntToScalar(x + 1), SkIntToScalar(y + 1));
+        U8CPU rgba[4];
+        for (int channel = 3; channel >= 0; --channel) {
+            rgba[channel] = SkScalarFloorToInt(255 * this->turbulence(channel, point));
+        }
+        return SkPreMultiplyARGB(rgba[3], rgba[0], rgba[1], rgba[2]);
+    }
+
+private:
+    int random() {
+        static const int gRandAmplitude = 16807;
+        static const int gRandQ = 127773;
+        static const int gRandR = 2836;
+
+        int result = gRandAmplitude * (fSeed % gRandQ) - gRandR * (fSeed / gRandQ);
+        if (result <= 0) {
+            result += kRandMaximum;
+        }
+        fSeed = result;
+        return result;
+    }
+
+    void init(SkScalar seed) {
+        fSeed = SkScalarTruncToInt(seed);
+        if (fSeed <= 0) {
+            fSeed = -(fSeed % (kRandMaximum - 1)) + 1;
+        }
+        if (fSeed > kRandMaximum - 1) {
+            fSeed = kRandMaximum - 1;
+        }
+        int noise[4][kBlockSize][2];
+        for (int channel = 0; channel < 4; ++channel) {
+            for (int i = 0; i < kBlockSize; ++i) {
+                fLatticeSelector[i] = i;
+                noise[channel][i][0] = random() % (2 * kBlockSize);
+                noise[channel][i][1] = random() % (2 * kBlockSize);
+            }
+        }
+        for (int i = kBlockSize - 1; i > 0; --i) {
+            int k = fLatticeSelector[i];
+            int j = random() % kBlockSize;
+            fLatticeSelector[i] = fLatticeSelector[j];
+            fLatticeSelector[j] = k;
+        }
+        // The gradients are stored already permuted by the lattice.
+        const SkScalar invBlockSize = SkScalarInvert(SkIntToScalar(kBlockSize));
+        for (int channel = 0; channel < 4; ++channel) {
+            for (int i = 0; i < kBlockSize; ++i) {
+                const int* n = noise[channel][fLatticeSelector[i]];
+                fGradient[channel][i].set(SkIntToScalar(n[0] - kBlockSize) * invBlockSize,
+                                          SkIntToScalar(n[1] - kBlockSize) * invBlockSize);
+                fGradient[channel][i].normalize();
+            }
+        }
+    }
+
+    void stitch(const SkISize& tileSize) {
+        const SkScalar tileWidth = SkIntToScalar(tileSize.width());
+        const SkScalar tileHeight = SkIntToScalar(tileSize.height());
+        if (fBaseFrequency.fX) {
+            SkScalar lo = SkScalarFloorToScalar(tileWidth * fBaseFrequency.fX) / tileWidth;
+            SkScalar hi = SkScalarCeilToScalar(tileWidth * fBaseFrequency.fX) / tileWidth;
+            fBaseFrequency.fX = fBaseFrequency.fX / lo < hi / fBaseFrequency.fX ? lo : hi;
+        }
+        if (fBaseFrequency.fY) {
+            SkScalar lo = SkScalarFloorToScalar(tileHeight * fBaseFrequency.fY) / tileHeight;
+            SkScalar hi = SkScalarCeilToScalar(tileHeight * fBaseFrequency.fY) / tileHeight;
+            fBaseFrequency.fY = fBaseFrequency.fY / lo < hi / fBaseFrequency.fY ? lo : hi;
+        }
+        fStitchDataInit.fWidth = SkScalarRoundToInt(tileWidth * fBaseFrequency.fX);
+        fStitchDataInit.fWrapX = kPerlinNoise + fStitchDataInit.fWidth;
+        fStitchDataInit.fHeight = SkScalarRoundToInt(tileHeight * fBaseFrequency.fY);
+        fStitchDataInit.fWrapY = kPerlinNoise + fStitchDataInit.fHeight;
+    }
+
+    static SkScalar SmoothCurve(SkScalar t) {
+        return t * t * (3 - 2 * t);
+    }
+
+    static int Wrap(int value, bool stitch, int limit, int size) {
+        if (stitch && value >= limit) {
+            value -= size;
+        }
+        return value & kBlockMask;
+    }
+
+    SkScalar noise2D(int channel, const StitchData& stitchData, const SkPoint& vec) const {
+        const SkScalar tx = vec.fX + kPerlinNoise;
+        const SkScalar ty = vec.fY + kPerlinNoise;
+        const int ix = SkScalarFloorToInt(tx);
+        const int iy = SkScalarFloorToInt(ty);
+        const SkScalar rx = tx - SkIntToScalar(ix);
+        const SkScalar ry = ty - SkIntToScalar(iy);
+
+        const int bx0 = Wrap(ix,     fStitchTiles, stitchData.fWrapX, stitchData.fWidth);
+        const int bx1 = Wrap(ix + 1, fStitchTiles, stitchData.fWrapX, stitchData.fWidth);
+        const int by0 = Wrap(iy,     fStitchTiles, stitchData.fWrapY, stitchData.fHeight);
+        const int by1 = Wrap(iy + 1, fStitchTiles, stitchData.fWrapY, stitchData.fHeight);
+        const int i = fLatticeSelector[bx0];
+        const int j = fLatticeSelector[bx1];
+        const SkPoint* g = fGradient[channel];
+
+        const SkScalar sx = SmoothCurve(rx);
+        const SkScalar sy = SmoothCurve(ry);
+        SkScalar u = g[(i + by0) & kBlockMask].dot(SkPoint::Make(rx, ry));
+        SkScalar v = g[(j + by0) & kBlockMask].dot(SkPoint::Make(rx - 1, ry));
+        const SkScalar a = SkScalarInterp(u, v, sx);
+        v = g[(j + by1) & kBlockMask].dot(SkPoint::Make(rx - 1, ry - 1));
+        u = g[(i + by1) & kBlockMask].dot(SkPoint::Make(rx, ry - 1));
+        const SkScalar b = SkScalarInterp(u, v, sx);
+        return SkScalarInterp(a, b, sy);
+    }
+
+    SkScalar turbulence(int channel, const SkPoint& point) const {
+        StitchData stitchData = fStitchDataInit;
+        SkPoint vec = SkPoint::Make(point.fX * fBaseFrequency.fX, point.fY * fBaseFrequency.fY);
+        SkScalar sum = 0;
+        SkScalar ratio = SK_Scalar1;
+        for (int octave = 0; octave < fNumOctaves; ++octave) {
+            SkScalar noise = this->noise2D(channel, stitchData, vec);
+            sum += (fFractalNoise ? noise : SkScalarAbs(noise)) / ratio;
+            vec.fX *= 2;
+            vec.fY *= 2;
+            ratio *= 2;
+            stitchData.fWidth *= 2;
+            stitchData.fWrapX = stitchData.fWidth + kPerlinNoise;
+            stitchData.fHeight *= 2;
+            stitchData.fWrapY = stitchData.fHeight + kPerlinNoise;
+        }
+        if (fFractalNoise) {
+            sum = sum * SK_ScalarHalf + SK_ScalarHalf;
+        }
+        return SkScalarPin(sum, 0, SK_Scalar1);
+    }
+
+    const bool  fFractalNoise;
+    const int   fNumOctaves;
+    const bool  fStitchTiles;
+    SkVector    fBaseFrequency;
+    StitchData  fStitchDataInit;
+    int         fSeed;
+    int         fLatticeSelector[kBlockSize];
+    SkPoint     fGradient[4][kBlockSize];
+};
+
+} // namespace
+
+static bool within_tolerance(SkPMColor a, SkPMColor b) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        int diff = (int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF);
+        if (SkAbs32(diff) > kTolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_perlin(skiatest::Reporter* reporter, bool fractalNoise,
+                        SkScalar baseFrequencyX, SkScalar baseFrequencyY, int numOctaves,
+                        SkScalar seed, const SkISize& tileSize) {
+    static const int kWidth = 64, kHeight = 48;
+
+    SkAutoTUnref<SkShader> shader(fractalNoise ?
+        SkPerlinNoiseShader::CreateFractalNoise(baseFrequencyX, baseFrequencyY, numOctaves, seed,
+                                                &tileSize) :
+        SkPerlinNoiseShader::CreateTurbulence(baseFrequencyX, baseFrequencyY, numOctaves, seed,
+                                              &tileSize));
+    SkPaint paint;
+    paint.setShader(shader);
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(kWidth, kHeight);
+    SkCanvas canvas(bitmap);
+    canvas.clear(SK_ColorTRANSPARENT);
+    canvas.drawPaint(paint);
+
+    const ScalarTurbulence scalar(fractalNoise, baseFrequencyX, baseFrequencyY, numOctaves, seed,
+                                  tileSize);
+    int mismatches = 0;
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            if (!within_tolerance(*bitmap.getAddr32(x, y), scalar.shade(x, y))) {
+                ++mismatches;
+            }
+        }
+    }
+    if (mismatches) {
+        ERRORF(reporter, "%s freq (%g, %g) octaves %d seed %g tile %dx%d: %d pixels differ",
+               fractalNoise ? "fractal noise" : "turbulence", baseFrequencyX, baseFrequencyY,
+               numOctaves, seed, tileSize.width(), tileSize.height(), mismatches);
+    }
+}
+
+DEF_TEST(PerlinNoiseShader_MatchesScalar, reporter) {
+    static const SkISize gTileSizes[] = { { 0, 0 }, { 40, 30 } };
+    static const struct {
+        SkScalar fFreqX, fFreqY;
+        int      fOctaves;
+        SkScalar fSeed;
+    } gParams[] = {
+        { 0.05f, 0.05f, 1, 0 },
+        { 0.1f,  0.07f, 2, 1 },
+        { 0.2f,  0.3f,  4, 7 },
+        { 0.03f, 0.5f,  6, -5 },
+    };
+
+    for (int fractalNoise = 0; fractalNoise < 2; ++fractalNoise) {
+        for (size_t t = 0; t < SK_ARRAY_COUNT(gTileSizes); ++t) {
+            for (size_t i = 0; i < SK_ARRAY_COUNT(gParams); ++i) {
+                test_perlin(reporter, SkToBool(fractalNoise), gParams[i].fFreqX,
+                            gParams[i].fFreqY, gParams[i].fOctaves, gParams[i].fSeed,
+                            gTileSizes[t]);
+            }
+        }
+    }
+}
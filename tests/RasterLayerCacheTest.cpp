@@ -0,0 +1,159 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBBHFactory.h"
+#include "SkCanvas.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkResourceCache.h"
+#include "Test.h"
+
+static const int kSize = 256;
+
+// Opacity layers around groups of "labels", including a bounded layer, a nested layer, a layer
+// that resets the matrix and a layer inside a sub-picture.
+static SkPicture* make_picture() {
+    SkRTreeFactory bbhFactory;
+
+    SkAutoTUnref<SkPicture> child;
+    {
+        SkPictureRecorder recorder;
+        SkCanvas* c = recorder.beginRecording(64, 64, &bbhFactory,
+                                              SkPictureRecorder::kComputeSaveLayerInfo_RecordFlag);
+        SkPaint layerPaint;
+        layerPaint.setAlpha(0xA0);
+        c->saveLayer(NULL, &layerPaint);
+            SkPaint paint;
+            paint.setColor(SK_ColorMAGENTA);
+            c->drawRect(SkRect::MakeXYWH(8, 8, 40, 20), paint);
+            paint.setColor(SK_ColorCYAN);
+            c->drawRect(SkRect::MakeXYWH(20, 16, 30, 30), paint);
+        c->restore();
+        child.reset(recorder.endRecording());
+    }
+
+    SkPictureRecorder recorder;
+    SkCanvas* c = recorder.beginRecording(kSize, kSize, &bbhFactory,
+                                          SkPictureRecorder::kComputeSaveLayerInfo_RecordFlag);
+    SkPaint paint;
+    paint.setColor(0xFFE0E0C0);
+    c->drawRect(SkRect::MakeWH(kSize, kSize), paint);
+
+    SkPaint layerPaint;
+    layerPaint.setAlpha(0x80);
+    for (int i = 0; i < 4; ++i) {
+        c->save();
+        c->translate(SkIntToScalar(20 + i * 50), SkIntToScalar(30 + i * 40));
+        c->saveLayer(NULL, &layerPaint);
+            paint.setColor(SK_ColorBLUE);
+            c->drawRect(SkRect::MakeWH(40, 16), paint);
+            paint.setColor(SK_ColorRED);
+            c->drawRect(SkRect::MakeXYWH(10, 8, 40, 16), paint);
+        c->restore();
+        c->restore();
+    }
+
+    // Bounded, with a nested layer.
+    const SkRect bounds = SkRect::MakeXYWH(10, 180, 60, 40);
+    c->saveLayer(&bounds, &layerPaint);
+        paint.setColor(SK_ColorGREEN);
+        c->drawRect(SkRect::MakeXYWH(0, 170, 100, 60), paint);
+        c->saveLayer(NULL, &layerPaint);
+            paint.setColor(SK_ColorBLACK);
+            c->drawRect(SkRect::MakeXYWH(30, 190, 20, 20), paint);
+            c->drawRect(SkRect::MakeXYWH(40, 200, 20, 20), paint);
+        c->restore();
+    c->restore();
+
+    // Resets the matrix inside the layer.
+    c->save();
+    c->translate(150, 10);
+    c->saveLayer(NULL, &layerPaint);
+        c->resetMatrix();
+        paint.setColor(SK_ColorYELLOW);
+        c->drawRect(SkRect::MakeXYWH(160, 20, 30, 30), paint);
+    c->restore();
+    c->restore();
+
+    const SkMatrix childMatrix = SkMatrix::MakeTrans(170, 180);
+    c->drawPicture(child, &childMatrix, NULL);
+
+    return recorder.endRecording();
+}
+
+static void draw(SkBitmap* bm, const SkPicture* picture, const SkMatrix& matrix, bool cached) {
+    bm->allocN32Pixels(kSize, kSize);
+    bm->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*bm);
+    canvas.clipRect(SkRect::MakeXYWH(5, 5, kSize - 10, kSize - 10));
+    canvas.concat(matrix);
+    if (cached) {
+        canvas.drawPicture(picture);
+    } else {
+        // Skips the device, so no layers are hoisted.
+        picture->playback(&canvas);
+    }
+}
+
+static int max_diff(const SkBitmap& a, const SkBitmap& b) {
+    int diff = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            const SkPMColor ca = *a.getAddr32(x, y), cb = *b.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                diff = SkTMax(diff, SkAbs32(int((ca >> shift) & 0xFF) -
+                                            int((cb >> shift) & 0xFF)));
+            }
+        }
+    }
+    return diff;
+}
+
+DEF_TEST(RasterLayerCache, reporter) {
+    SkAutoTUnref<SkPicture> picture(make_picture());
+
+    SkMatrix matrices[4];
+    matrices[0].reset();
+    matrices[1].setTranslate(-17, 23);
+    matrices[2].setTranslate(0.5f, 0.25f);
+    matrices[3].setScale(0.75f, 1.25f);
+    matrices[3].postRotate(10);
+
+    const size_t initialBytesUsed = SkResourceCache::GetTotalBytesUsed();
+    for (size_t i = 0; i < SK_ARRAY_COUNT(matrices); ++i) {
+        SkBitmap expected, first, second;
+        draw(&expected, picture, matrices[i], false);
+        draw(&first, picture, matrices[i], true);
+        const size_t bytesUsed = SkResourceCache::GetTotalBytesUsed();
+        draw(&second, picture, matrices[i], true);
+
+        REPORTER_ASSERT(reporter, max_diff(expected, first) <= 1);
+        // The second draw comes from the cached layers, without adding any.
+        REPORTER_ASSERT(reporter, 0 == max_diff(first, second));
+        REPORTER_ASSERT(reporter, bytesUsed == SkResourceCache::GetTotalBytesUsed());
+    }
+    REPORTER_ASSERT(reporter, SkResourceCache::GetTotalBytesUsed() > initialBytesUsed);
+
+    // Whole pixel scrolling reuses the layers cached for matrices[0].
+    SkMatrix scroll;
+    scroll.setTranslate(-3, -40);
+    const size_t bytesUsed = SkResourceCache::GetTotalBytesUsed();
+    SkBitmap expected, scrolled;
+    draw(&expected, picture, scroll, false);
+    draw(&scrolled, picture, scroll, true);
+    REPORTER_ASSERT(reporter, max_diff(expected, scrolled) <= 1);
+    REPORTER_ASSERT(reporter, bytesUsed == SkResourceCache::GetTotalBytesUsed());
+
+    // Drawn from inside a picture without layer information, the layers still come from the cache.
+    SkPictureRecorder recorder;
+    SkCanvas* c = recorder.beginRecording(kSize, kSize);
+    c->drawPicture(picture);
+    SkAutoTUnref<SkPicture> plain(recorder.endRecording());
+    draw(&scrolled, plain, scroll, true);
+    REPORTER_ASSERT(reporter, max_diff(expected, scrolled) <= 1);
+    REPORTER_ASSERT(reporter, bytesUsed == SkResourceCache::GetTotalBytesUsed());
+}
@@ -9,6 +9,7 @@
 #include "SkData.h"
 #include "SkDOM.h"
 #include "SkParse.h"
+#include "SkParsePath.h"
 #include "SkStream.h"
 #include "SkSVGCanvas.h"
 #include "SkXMLWriter.h"
@@ -147,3 +148,130 @@ DEF_TEST(SVGDevice_whitespace_pos, reporter) {
         test_whitespace_pos(reporter, tests[i].tst_in, tests[i].tst_out);
     }
 }
+
+DEF_TEST(SVGDevice_path_dedup, reporter) {
+    SkPath path;
+    path.moveTo(10, 10);
+    path.lineTo(50, 10);
+    path.lineTo(30, 40);
+    path.close();
+
+    SkDOM dom;
+    {
+        SkXMLParserWriter writer(dom.beginParsing());
+        SkAutoTUnref<SkCanvas> svgCanvas(SkSVGCanvas::Create(SkRect::MakeWH(100, 100),
+                                                             &writer));
+        SkPaint paint;
+        for (int i = 0; i < 3; ++i) {
+            svgCanvas->drawPath(path, paint);
+            svgCanvas->translate(10, 10);
+        }
+        // Same points, so on most platforms the same generation ID, but another fill type.
+        path.setFillType(SkPath::kEvenOdd_FillType);
+        svgCanvas->drawPath(path, paint);
+    }
+    const SkDOM::Node* root = dom.finishParsing();
+    REPORTER_ASSERT(reporter, root);
+    if (!root) {
+        return;
+    }
+
+    // The path data is written once per fill type, each time inside a <g> with the paint, and
+    // the repeats <use> the first one.
+    REPORTER_ASSERT(reporter, dom.countChildren(root, "defs") == 0);
+    REPORTER_ASSERT(reporter, dom.countChildren(root, "path") == 0);
+    REPORTER_ASSERT(reporter, dom.countChildren(root, "g") == 2);
+    REPORTER_ASSERT(reporter, dom.countChildren(root, "use") == 2);
+
+    const SkDOM::Node* group = dom.getFirstChild(root, "g");
+    const SkDOM::Node* def = group ? dom.getFirstChild(group, "path") : NULL;
+    REPORTER_ASSERT(reporter, def);
+    if (!def) {
+        return;
+    }
+    const char* id = dom.findAttr(def, "id");
+    REPORTER_ASSERT(reporter, id);
+    REPORTER_ASSERT(reporter, dom.findAttr(def, "d"));
+    REPORTER_ASSERT(reporter, !dom.findAttr(def, "fill"));
+    REPORTER_ASSERT(reporter, !dom.findAttr(def, "fill-rule"));
+    REPORTER_ASSERT(reporter, dom.hasAttr(group, "fill", "#000000"));
+
+    SkString href = SkStringPrintf("#%s", id);
+    for (const SkDOM::Node* use = dom.getFirstChild(root, "use"); use;
+         use = dom.getNextSibling(use, "use")) {
+        REPORTER_ASSERT(reporter, dom.hasAttr(use, "xlink:href", href.c_str()));
+        REPORTER_ASSERT(reporter, dom.findAttr(use, "transform"));
+    }
+
+    const SkDOM::Node* evenOddGroup = dom.getNextSibling(group, "g");
+    const SkDOM::Node* evenOdd = evenOddGroup ? dom.getFirstChild(evenOddGroup, "path") : NULL;
+    REPORTER_ASSERT(reporter, evenOdd);
+    if (evenOdd) {
+        REPORTER_ASSERT(reporter, dom.hasAttr(evenOdd, "fill-rule", "evenodd"));
+        REPORTER_ASSERT(reporter, !dom.hasAttr(evenOdd, "id", id));
+    }
+}
+
+DEF_TEST(SVGDevice_precision, reporter) {
+    SkPath path;
+    path.moveTo(10.123f, 20.456f);
+    path.lineTo(30.5f, 20.456f);
+    path.lineTo(30.5f, 40);
+    path.lineTo(0, 0);
+    path.close();
+
+    SkDOM dom;
+    {
+        SkXMLParserWriter writer(dom.beginParsing());
+        SkAutoTUnref<SkCanvas> svgCanvas(SkSVGCanvas::Create(SkRect::MakeWH(100, 100),
+                                                             &writer, 1));
+        SkPaint paint;
+        svgCanvas->drawPath(path, paint);
+        svgCanvas->drawRect(SkRect::MakeXYWH(1.26f, 2, 3.04f, 4), paint);
+
+        SkPaint stroke;
+        stroke.setStyle(SkPaint::kStroke_Style);
+        stroke.setStrokeWidth(1.25f);
+        stroke.setAlpha(0x80);
+        svgCanvas->drawOval(SkRect::MakeXYWH(10.04f, 10, 20, 20), stroke);
+    }
+    const SkDOM::Node* root = dom.finishParsing();
+    REPORTER_ASSERT(reporter, root);
+    if (!root) {
+        return;
+    }
+
+    // Relative commands between rounded points.
+    const SkDOM::Node* group = dom.getFirstChild(root, "g");
+    const SkDOM::Node* pathElem = group ? dom.getFirstChild(group, "path") : NULL;
+    REPORTER_ASSERT(reporter, pathElem);
+    if (pathElem) {
+        const char* d = dom.findAttr(pathElem, "d");
+        REPORTER_ASSERT(reporter, d && !strcmp(d, "m10.1 20.5h20.4v19.5l-30.5-40z"));
+
+        SkPath parsed;
+        REPORTER_ASSERT(reporter, d && SkParsePath::FromSVGString(d, &parsed));
+        REPORTER_ASSERT(reporter, parsed.countPoints() == 4);
+        REPORTER_ASSERT(reporter, parsed.getPoint(3) == SkPoint::Make(0, 0));
+    }
+
+    const SkDOM::Node* rectElem = dom.getFirstChild(root, "rect");
+    REPORTER_ASSERT(reporter, rectElem);
+    if (rectElem) {
+        REPORTER_ASSERT(reporter, dom.hasAttr(rectElem, "x", "1.3"));
+        REPORTER_ASSERT(reporter, dom.hasAttr(rectElem, "width", "3"));
+    }
+
+    // Only coordinates are rounded.
+    const SkDOM::Node* ellipseElem = dom.getFirstChild(root, "ellipse");
+    REPORTER_ASSERT(reporter, ellipseElem);
+    if (ellipseElem) {
+        REPORTER_ASSERT(reporter, dom.hasAttr(ellipseElem, "cx", "20"));
+        REPORTER_ASSERT(reporter, dom.hasAttr(ellipseElem, "stroke-width", "1.25"));
+        SkScalar opacity = 0;
+        REPORTER_ASSERT(reporter, dom.findScalar(ellipseElem, "stroke-opacity", &opacity));
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(opacity, 128 / 255.f));
+    }
+
+    REPORTER_ASSERT(reporter, NULL == SkSVGCanvas::Create(SkRect::MakeWH(100, 100), NULL, 1));
+}
@@ -406,6 +406,118 @@ static void draw_something(SkCanvas* canvas) {
     canvas->drawText("Picture", 7, SkIntToScalar(kBitmapSize/2), SkIntToScalar(kBitmapSize/4), paint);
 }
 
+static void TestCompactSerialization(skiatest::Reporter* reporter) {
+    // Paths and point arrays on a grid, off it, and on it but with a -0, must all come back
+    // exactly.
+    SkPath paths[5];
+    paths[0].addRect(SkRect::MakeLTRB(10, 20, 300, 400));
+    paths[1].moveTo(0.5f, 1.25f);
+    paths[1].quadTo(100.5f, -3.75f, 60, 80);
+    paths[1].conicTo(10, 10, 20.125f, 30, 0.7f);
+    paths[1].close();
+    paths[2].moveTo(0.1f, 0.2f);
+    paths[2].cubicTo(1.3f, 2.4f, 33.3f, -4.4f, 1e20f, 7);
+    paths[3].addOval(SkRect::MakeXYWH(5, 5, 90, 60));
+    paths[4].moveTo(-0.0f, 4);
+    paths[4].lineTo(8, 16);
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(paths); ++i) {
+        const int count = paths[i].countPoints();
+        SkAutoTMalloc<SkPoint> srcPts(count), pts(count);
+        paths[i].getPoints(srcPts.get(), count);
+
+        SkWriteBuffer writer(SkWriteBuffer::kCompact_Flag);
+        writer.writePath(paths[i]);
+        writer.writePointArray(srcPts.get(), count);
+        writer.writeInt(0x1234);
+        size_t size = writer.bytesWritten();
+        SkAutoTMalloc<unsigned char> data(size);
+        writer.writeToMemory(data.get());
+
+        SkReadBuffer reader(data.get(), size);
+        reader.setFlags(SkReadBuffer::kCompact_Flag);
+        SkPath path;
+        reader.readPath(&path);
+        REPORTER_ASSERT(reporter, path == paths[i]);
+        REPORTER_ASSERT(reporter, path.isOval(NULL) == paths[i].isOval(NULL));
+        REPORTER_ASSERT(reporter, path.getBounds() == paths[i].getBounds());
+
+        REPORTER_ASSERT(reporter, reader.readPointArray(pts.get(), count));
+        REPORTER_ASSERT(reporter, !memcmp(pts.get(), srcPts.get(), count * sizeof(SkPoint)));
+        REPORTER_ASSERT(reporter, reader.readInt() == 0x1234);
+        REPORTER_ASSERT(reporter, reader.eof());
+    }
+
+    // Snapped points keep nothing the path had worked out about its old shape.
+    {
+        SkPath oval;
+        oval.addOval(SkRect::MakeLTRB(0.1f, 0.2f, 50.3f, 40.7f));
+        REPORTER_ASSERT(reporter, oval.isOval(NULL));
+        REPORTER_ASSERT(reporter, SkPath::kConvex_Convexity == oval.getConvexity());
+
+        SkWriteBuffer writer(SkWriteBuffer::kCompact_Flag | SkWriteBuffer::kQuantizePoints_Flag);
+        writer.writePath(oval);
+        size_t size = writer.bytesWritten();
+        SkAutoTMalloc<unsigned char> data(size);
+        writer.writeToMemory(data.get());
+
+        SkReadBuffer reader(data.get(), size);
+        reader.setFlags(SkReadBuffer::kCompact_Flag);
+        SkPath path;
+        reader.readPath(&path);
+        REPORTER_ASSERT(reporter, reader.eof());
+        REPORTER_ASSERT(reporter, path.countPoints() == oval.countPoints());
+        REPORTER_ASSERT(reporter, path != oval);
+        REPORTER_ASSERT(reporter, !path.isOval(NULL));
+        REPORTER_ASSERT(reporter, SkPath::kUnknown_Convexity == path.getConvexityOrUnknown());
+        REPORTER_ASSERT(reporter, path.getFillType() == oval.getFillType());
+
+        SkAutoTMalloc<SkPoint> pts(path.countPoints());
+        path.getPoints(pts.get(), path.countPoints());
+        SkRect bounds;
+        bounds.set(pts.get(), path.countPoints());
+        REPORTER_ASSERT(reporter, path.getBounds() == bounds);
+    }
+
+    // Whole pictures, including a nested one, must draw the same and take less space.
+    SkPictureRecorder recorder;
+    draw_something(recorder.beginRecording(SkIntToScalar(kBitmapSize),
+                                           SkIntToScalar(kBitmapSize), NULL, 0));
+    SkAutoTUnref<SkPicture> inner(recorder.endRecording());
+
+    SkCanvas* canvas = recorder.beginRecording(SkIntToScalar(kBitmapSize),
+                                               SkIntToScalar(kBitmapSize), NULL, 0);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setStyle(SkPaint::kStroke_Style);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(paths); ++i) {
+        canvas->drawPath(paths[i], paint);
+    }
+    canvas->drawPicture(inner);
+    SkAutoTUnref<SkPicture> pict(recorder.endRecording());
+    SkBitmap expected = draw_picture(*pict);
+
+    size_t sizes[3];
+    static const uint32_t kFlags[] = {
+        0,
+        SkPicture::kCompact_SerializeFlag,
+        SkPicture::kCompact_SerializeFlag | SkPicture::kQuantizePoints_SerializeFlag,
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kFlags); ++i) {
+        SkDynamicMemoryWStream stream;
+        pict->serialize(&stream, NULL, kFlags[i]);
+        sizes[i] = stream.bytesWritten();
+        SkAutoTDelete<SkStream> inputStream(stream.detachAsStream());
+        SkAutoTUnref<SkPicture> loaded(SkPicture::CreateFromStream(inputStream.get()));
+        REPORTER_ASSERT(reporter, loaded.get());
+        if (loaded && !(kFlags[i] & SkPicture::kQuantizePoints_SerializeFlag)) {
+            compare_bitmaps(reporter, expected, draw_picture(*loaded));
+        }
+    }
+    REPORTER_ASSERT(reporter, sizes[1] < sizes[0]);
+    REPORTER_ASSERT(reporter, sizes[2] <= sizes[1]);
+}
+
 DEF_TEST(Serialization, reporter) {
     // Test matrix serialization
     {
@@ -523,4 +635,6 @@ DEF_TEST(Serialization, reporter) {
     }
 
     TestPictureTypefaceSerialization(reporter);
+
+    TestCompactSerialization(reporter);
 }
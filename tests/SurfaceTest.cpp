@@ -401,6 +401,71 @@ static void TestSurfaceWritableAfterSnapshotRelease(skiatest::Reporter* reporter
     canvas->clear(2);  // Must not assert internally
 }
 
+// Draws a few small rects in a pattern that spans tiles, into both the surface and a reference
+// canvas, snapshotting the surface after each frame. Every snapshot must keep exactly the
+// contents the surface had when it was taken, however the surface recycles its buffers.
+static void TestSurfacePartialCopyOnWrite(skiatest::Reporter* reporter, uint32_t flags) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(300, 200);
+    const SkSurfaceProps props(flags, kUnknown_SkPixelGeometry);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRaster(info, &props));
+    SkCanvas* canvas = surface->getCanvas();
+
+    SkBitmap reference;
+    reference.allocPixels(info);
+    SkCanvas refCanvas(reference);
+
+    canvas->clear(SK_ColorWHITE);
+    refCanvas.clear(SK_ColorWHITE);
+
+    static const int kFrames = 6;
+    SkAutoTUnref<SkImage> images[kFrames];
+    SkBitmap expected[kFrames];
+    SkPaint paint;
+    for (int i = 0; i < kFrames; ++i) {
+        images[i].reset(surface->newImageSnapshot());
+        reference.copyTo(&expected[i]);
+        // Let go of every other snapshot before the next fork, so the surface can recycle it.
+        if (i & 1) {
+            images[i - 1].reset(NULL);
+        }
+
+        const SkRect r = SkRect::MakeXYWH(SkIntToScalar(37 * i), SkIntToScalar(23 * i),
+                                          SkIntToScalar(70), SkIntToScalar(50));
+        paint.setColor(SkColorSetARGB(0x80 + 0x10 * i, 0x20 * i, 0xFF - 0x20 * i, 0x40));
+        canvas->drawRect(r, paint);
+        refCanvas.drawRect(r, paint);
+        if (2 == i) {
+            // a write outside the clip must still be noticed
+            canvas->save();
+            canvas->clipRect(SkRect::MakeWH(10, 10));
+            SkPMColor pixel = SkPreMultiplyColor(SK_ColorRED);
+            SkImageInfo pixelInfo = SkImageInfo::MakeN32Premul(1, 1);
+            canvas->writePixels(pixelInfo, &pixel, sizeof(pixel), 250, 150);
+            refCanvas.writePixels(pixelInfo, &pixel, sizeof(pixel), 250, 150);
+            canvas->restore();
+        }
+    }
+
+    SkBitmap actual;
+    actual.allocPixels(info);
+    for (int i = 0; i < kFrames; ++i) {
+        if (NULL == images[i].get()) {
+            continue;
+        }
+        REPORTER_ASSERT(reporter, images[i]->readPixels(info, actual.getPixels(),
+                                                         actual.rowBytes(), 0, 0));
+        SkAutoLockPixels alp(expected[i]);
+        REPORTER_ASSERT(reporter, 0 == memcmp(actual.getPixels(), expected[i].getPixels(),
+                                              actual.getSize()));
+    }
+
+    // And the surface itself must match the final reference.
+    REPORTER_ASSERT(reporter, canvas->readPixels(&actual, 0, 0));
+    SkAutoLockPixels alp(reference);
+    REPORTER_ASSERT(reporter, 0 == memcmp(actual.getPixels(), reference.getPixels(),
+                                          actual.getSize()));
+}
+
 #if SK_SUPPORT_GPU
 static void Test_crbug263329(skiatest::Reporter* reporter,
                              SurfaceType surfaceType,
@@ -536,6 +601,8 @@ DEF_GPUTEST(Surface, reporter, factory) {
 
     TestSurfaceCopyOnWrite(reporter, kRaster_SurfaceType, NULL);
     TestSurfaceWritableAfterSnapshotRelease(reporter, kRaster_SurfaceType, NULL);
+    TestSurfacePartialCopyOnWrite(reporter, 0);
+    TestSurfacePartialCopyOnWrite(reporter, SkSurfaceProps::kReuseSnapshotPixels_Flag);
     TestSurfaceNoCanvas(reporter, kRaster_SurfaceType, NULL, SkSurface::kDiscard_ContentChangeMode);
     TestSurfaceNoCanvas(reporter, kRaster_SurfaceType, NULL, SkSurface::kRetain_ContentChangeMode);
 
@@ -274,10 +274,74 @@ DEF_TEST(Writer32_large, reporter) {
     testOverwriteT(reporter, &writer);
 }
 
+static void test_pack(skiatest::Reporter* reporter) {
+    static const float kFloats[] = {
+        0.0f, -0.0f, 1.0f, -1.0f, 0.5f, -0.0625f, 0.1f, 1234.5f, 16777215.0f, 16777216.0f,
+        1e-40f, 1e30f, SK_FloatInfinity, SK_FloatNegativeInfinity, SK_FloatNaN,
+    };
+    static const int32_t kInts[] = {
+        0, 1, -1, 63, -64, 64, (1 << 20) - 1, -(1 << 20), 1 << 20, SK_MaxS32, SK_NaN32,
+    };
+
+    SkWriter32 writer;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kFloats); ++i) {
+        writer.writeScalar(kFloats[i]);
+    }
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kInts); ++i) {
+        writer.write32(kInts[i]);
+    }
+    SkRandom rand;
+    for (int i = 0; i < 1001; ++i) {
+        writer.write32(rand.nextU() >> rand.nextULessThan(32));
+    }
+
+    const size_t size = writer.bytesWritten();
+    SkAutoMalloc original(size), unpacked(size);
+    writer.flatten(original.get());
+
+    SkAutoMalloc packed(SkWriter32::PackedSizeBound(size));
+    const size_t packedSize = SkWriter32::Pack(original.get(), size, packed.get());
+    REPORTER_ASSERT(reporter, packedSize <= SkWriter32::PackedSizeBound(size));
+    REPORTER_ASSERT(reporter, SkReader32::Unpack(packed.get(), packedSize, unpacked.get(), size));
+    REPORTER_ASSERT(reporter, !memcmp(original.get(), unpacked.get(), size));
+
+    // Truncated or mis-sized input must fail rather than read or write out of bounds.
+    REPORTER_ASSERT(reporter, !SkReader32::Unpack(packed.get(), packedSize - 1,
+                                                  unpacked.get(), size));
+    REPORTER_ASSERT(reporter, !SkReader32::Unpack(packed.get(), packedSize,
+                                                  unpacked.get(), size - 4));
+
+    // Small ints and grid floats take a byte each, plus the tags.
+    writer.reset();
+    for (int i = 0; i < 64; ++i) {
+        writer.write32(i - 32);
+        writer.writeScalar(i * 0.0625f);
+    }
+    REPORTER_ASSERT(reporter, writer.bytesWritten() == 512);
+    writer.flatten(original.get());
+    REPORTER_ASSERT(reporter, SkWriter32::Pack(original.get(), 512, packed.get()) == 128 + 32);
+
+    // Long runs of incompressible words cost two bytes per 256 groups, and survive unpacking.
+    writer.reset();
+    for (int i = 0; i < 1030 * 4 + 3; ++i) {
+        writer.writeScalar(i * 0.1f + 0.01f);
+    }
+    const size_t rawSize = writer.bytesWritten();
+    SkAutoMalloc rawOriginal(rawSize), rawUnpacked(rawSize);
+    SkAutoMalloc rawPacked(SkWriter32::PackedSizeBound(rawSize));
+    writer.flatten(rawOriginal.get());
+    const size_t rawPackedSize = SkWriter32::Pack(rawOriginal.get(), rawSize, rawPacked.get());
+    REPORTER_ASSERT(reporter, rawPackedSize == rawSize + 5 * 2 + 1);
+    REPORTER_ASSERT(reporter, SkReader32::Unpack(rawPacked.get(), rawPackedSize,
+                                                 rawUnpacked.get(), rawSize));
+    REPORTER_ASSERT(reporter, !memcmp(rawOriginal.get(), rawUnpacked.get(), rawSize));
+}
+
 DEF_TEST(Writer32_misc, reporter) {
     test_reserve(reporter);
     test_string_null(reporter);
     test_ptr(reporter);
     test_rewind(reporter);
+    test_pack(reporter);
 }
 
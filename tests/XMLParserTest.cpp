@@ -0,0 +1,222 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDOM.h"
+#include "SkStream.h"
+#include "SkXMLParser.h"
+#include "Test.h"
+
+static const char gDoc[] =
+    "<?xml version='1.0'?>\n"
+    "<!DOCTYPE svg [ <!ENTITY foo 'bar'> ]>\n"
+    "<!-- a comment -->\n"
+    "<root a='1' b = \"two words\">\n"
+    "  <elem1 c='&lt;&amp;&gt;' />\n"
+    "  <elem2 d='&#65;&#x42;&#xe9;'>some &quot;text&quot;</elem2>\n"
+    "  <elem3><![CDATA[<raw> & stuff]]></elem3>\n"
+    "</root>\n";
+
+// Records the callbacks as a string so the test can check order and contents.
+class RecordingParser : public SkXMLParser {
+public:
+    RecordingParser() : SkXMLParser(&fError) {}
+
+    SkString fLog;
+    SkXMLParserError fError;
+
+protected:
+    bool onStartElement(const char elem[]) override {
+        fLog.appendf("<%s>", elem);
+        return false;
+    }
+    bool onAddAttribute(const char name[], const char value[]) override {
+        fLog.appendf("[%s=%s]", name, value);
+        return false;
+    }
+    bool onEndElement(const char elem[]) override {
+        fLog.appendf("</%s>", elem);
+        return false;
+    }
+    bool onText(const char text[], int len) override {
+        fLog.appendf("{%.*s}", len, text);
+        return false;
+    }
+};
+
+static const char gExpectedLog[] =
+    "<root>[a=1][b=two words]"
+    "<elem1>[c=<&>]</elem1>"
+    "<elem2>[d=AB\xC3\xA9]{some \"text\"}</elem2>"
+    "<elem3>{<raw> & stuff}</elem3>"
+    "</root>";
+
+DEF_TEST(XMLParser_SAX, reporter) {
+    RecordingParser parser;
+    REPORTER_ASSERT(reporter, parser.parse(gDoc, sizeof(gDoc) - 1));
+    REPORTER_ASSERT(reporter, parser.fLog.equals(gExpectedLog));
+
+    SkMemoryStream stream(gDoc, sizeof(gDoc) - 1);
+    RecordingParser streamParser;
+    REPORTER_ASSERT(reporter, streamParser.parse(stream));
+    REPORTER_ASSERT(reporter, streamParser.fLog.equals(gExpectedLog));
+
+    // In place, the callbacks see pointers into the caller's buffer.
+    char buffer[sizeof(gDoc)];
+    memcpy(buffer, gDoc, sizeof(gDoc));
+    RecordingParser inPlaceParser;
+    REPORTER_ASSERT(reporter, inPlaceParser.parseInPlace(buffer, sizeof(gDoc) - 1));
+    REPORTER_ASSERT(reporter, inPlaceParser.fLog.equals(gExpectedLog));
+}
+
+DEF_TEST(XMLParser_Errors, reporter) {
+    static const struct {
+        const char* fDoc;
+        int         fLine;
+    } gBad[] = {
+        { "",                               1 },
+        { "<a>",                            1 },
+        { "<a>\n</b>",                      2 },
+        { "<a x=1/>",                       1 },
+        { "<a x='&nope;'/>",                1 },
+        { "<a/>\n\n<b/>",                   3 },
+        { "<a>\n<!-- unterminated </a>",    2 },
+    };
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gBad); ++i) {
+        RecordingParser parser;
+        REPORTER_ASSERT(reporter, !parser.parse(gBad[i].fDoc, strlen(gBad[i].fDoc)));
+        REPORTER_ASSERT(reporter, parser.fError.hasError());
+        REPORTER_ASSERT(reporter, parser.fError.getLineNumber() == gBad[i].fLine);
+
+        SkString str;
+        parser.fError.getErrorString(&str);
+        REPORTER_ASSERT(reporter, str.size() > 0);
+    }
+}
+
+DEF_TEST(XMLParser_DOM, reporter) {
+    SkDOM dom;
+    const SkDOM::Node* root = dom.build(gDoc, sizeof(gDoc) - 1);
+    REPORTER_ASSERT(reporter, root && dom.getRootNode() == root);
+    REPORTER_ASSERT(reporter, !strcmp(dom.getName(root), "root"));
+    REPORTER_ASSERT(reporter, !strcmp(dom.findAttr(root, "b"), "two words"));
+    REPORTER_ASSERT(reporter, dom.countChildren(root) == 3);
+
+    const SkDOM::Node* elem2 = dom.getFirstChild(root, "elem2");
+    REPORTER_ASSERT(reporter, elem2);
+    const SkDOM::Node* text = dom.getFirstChild(elem2);
+    REPORTER_ASSERT(reporter, text && dom.getType(text) == SkDOM::kText_Type);
+    REPORTER_ASSERT(reporter, !strcmp(dom.getName(text), "some \"text\""));
+
+    SkMemoryStream stream(gDoc, sizeof(gDoc) - 1);
+    SkDOM streamDOM;
+    root = streamDOM.build(stream);
+    REPORTER_ASSERT(reporter, root);
+    REPORTER_ASSERT(reporter, !strcmp(streamDOM.findAttr(streamDOM.getFirstChild(root, "elem1"),
+                                                         "c"), "<&>"));
+
+    // A copy must not depend on the source DOM's document buffer.
+    SkDOM copy;
+    {
+        SkDOM temp;
+        copy.copy(temp, temp.build(gDoc, sizeof(gDoc) - 1));
+    }
+    REPORTER_ASSERT(reporter, copy.getRootNode());
+    REPORTER_ASSERT(reporter, !strcmp(copy.findAttr(copy.getRootNode(), "a"), "1"));
+
+    REPORTER_ASSERT(reporter, NULL == dom.build("<a>", 3));
+    REPORTER_ASSERT(reporter, NULL == dom.getRootNode());
+}
+
+static size_t string_size(const char str[]) {
+    return SkAlign4(strlen(str) + 1);
+}
+
+// The space copy() takes for the strings of node and its descendants.
+static size_t copied_string_size(const SkDOM& dom, const SkDOM::Node* node) {
+    size_t size = string_size(dom.getName(node));
+    SkDOM::AttrIter iter(dom, node);
+    const char* name;
+    const char* value;
+    while ((name = iter.next(&value))) {
+        size += string_size(name) + string_size(value);
+    }
+    for (const SkDOM::Node* child = dom.getFirstChild(node); child;
+         child = dom.getNextSibling(child)) {
+        size += copied_string_size(dom, child);
+    }
+    return size;
+}
+
+// build() allocates nodes only, however many strings the document has. A copy of the DOM
+// allocates the same nodes, plus a copy of every string.
+DEF_TEST(XMLParser_DOMAllocations, reporter) {
+    SkString doc("<root>");
+    for (int i = 0; i < 100; ++i) {
+        doc.appendf("<path id='p%d' d='M%d 0 L0 %d' fill='&#x23;%06x'>title &amp; %d</path>",
+                    i, i, i, i * 0x10101, i);
+    }
+    doc.append("</root>");
+
+    SkDOM dom;
+    const SkDOM::Node* root = dom.build(doc.c_str(), doc.size());
+    REPORTER_ASSERT(reporter, root && dom.countChildren(root) == 100);
+    if (!root) {
+        return;
+    }
+
+    SkDOM copy;
+    copy.copy(dom, root);
+    const size_t stringSize = copied_string_size(dom, root);
+    REPORTER_ASSERT(reporter, stringSize > doc.size() / 2);
+    REPORTER_ASSERT(reporter, copy.getAllocatedSize() == dom.getAllocatedSize() + stringSize);
+}
+
+DEF_TEST(XMLParser_Pull, reporter) {
+    SkMemoryStream stream(gDoc, sizeof(gDoc) - 1);
+    SkXMLPullParser parser(&stream);
+    REPORTER_ASSERT(reporter, parser.getEventType() == SkXMLPullParser::START_DOCUMENT);
+
+    SkString log;
+    int maxDepth = 0;
+    SkXMLPullParser::EventType type;
+    while ((type = parser.nextToken()) != SkXMLPullParser::END_DOCUMENT) {
+        if (SkXMLPullParser::ERROR == type) {
+            break;
+        }
+        maxDepth = SkTMax(maxDepth, parser.getDepth());
+        switch (type) {
+            case SkXMLPullParser::START_TAG:
+                log.appendf("<%s>", parser.getName());
+                for (int i = 0; i < parser.getAttributeCount(); ++i) {
+                    SkXMLPullParser::AttrInfo info;
+                    parser.getAttributeInfo(i, &info);
+                    log.appendf("[%s=%s]", info.fName, info.fValue);
+                }
+                break;
+            case SkXMLPullParser::END_TAG:
+                log.appendf("</%s>", parser.getName());
+                break;
+            case SkXMLPullParser::TEXT:
+                REPORTER_ASSERT(reporter, !parser.isWhitespace());
+                log.appendf("{%s}", parser.getText());
+                break;
+            default:
+                break;
+        }
+    }
+    REPORTER_ASSERT(reporter, SkXMLPullParser::END_DOCUMENT == type);
+    REPORTER_ASSERT(reporter, log.equals(gExpectedLog));
+    REPORTER_ASSERT(reporter, 2 == maxDepth);
+
+    SkMemoryStream badStream("<a><b></a>", 10);
+    parser.setStream(&badStream);
+    do {
+        type = parser.nextToken();
+    } while (type != SkXMLPullParser::ERROR && type != SkXMLPullParser::END_DOCUMENT);
+    REPORTER_ASSERT(reporter, SkXMLPullParser::ERROR == type);
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmapScaler.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkImageGenerator.h"
+#include "Test.h"
+
+static const int kWidth = 200;
+static const int kHeight = 150;
+
+// Stands in for a JPEG: 4:2:0 planes, and the RGB image a decoder would make of them.
+class YUVGenerator : public SkImageGenerator {
+public:
+    YUVGenerator(int* rgbDecodes, int* yuvDecodes)
+        : INHERITED(SkImageInfo::MakeN32(kWidth, kHeight, kOpaque_SkAlphaType))
+        , fRGBDecodes(rgbDecodes)
+        , fYUVDecodes(yuvDecodes) {}
+
+    static uint8_t Y(int x, int y) {
+        return SkToU8(128 + 60 * sinf(x * 0.11f) * cosf(y * 0.07f));
+    }
+    // Both kept small enough for the RGB image not to clip.
+    static uint8_t U(int x, int y) { return SkToU8(96 + x / 2 + y / 4); }
+    static uint8_t V(int x, int y) { return SkToU8(150 - x / 3 - y / 3); }
+
+    // Chroma at the center of luma pixel (x, y), interpolated from the half sized planes.
+    static float Chroma(uint8_t (*proc)(int, int), int x, int y) {
+        const float cx = SkTMax(0.0f, SkTMin((x + 0.5f) / 2 - 0.5f, kWidth / 2 - 1.0f)),
+                    cy = SkTMax(0.0f, SkTMin((y + 0.5f) / 2 - 0.5f, kHeight / 2 - 1.0f));
+        const int x0 = (int)cx, y0 = (int)cy,
+                  x1 = SkTMin(x0 + 1, kWidth / 2 - 1), y1 = SkTMin(y0 + 1, kHeight / 2 - 1);
+        const float fx = cx - x0, fy = cy - y0;
+        return (proc(x0, y0) * (1 - fx) + proc(x1, y0) * fx) * (1 - fy) +
+               (proc(x0, y1) * (1 - fx) + proc(x1, y1) * fx) * fy;
+    }
+
+protected:
+    Result onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes, const Options&,
+                       SkPMColor*, int*) override {
+        ++*fRGBDecodes;
+        for (int y = 0; y < kHeight; ++y) {
+            SkPMColor* row = (SkPMColor*)((char*)pixels + y * rowBytes);
+            for (int x = 0; x < kWidth; ++x) {
+                const float yy = Y(x, y),
+                            u = Chroma(U, x, y) - 128,
+                            v = Chroma(V, x, y) - 128;
+                row[x] = SkPackARGB32(0xFF, to_byte(yy + 1.402f * v),
+                                      to_byte(yy - 0.34414f * u - 0.71414f * v),
+                                      to_byte(yy + 1.772f * u));
+            }
+        }
+        return kSuccess;
+    }
+
+    bool onGetYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBytes[3],
+                         SkYUVColorSpace* colorSpace) override {
+        sizes[0].set(kWidth, kHeight);
+        sizes[1].set(kWidth / 2, kHeight / 2);
+        sizes[2] = sizes[1];
+        if (NULL == planes || NULL == rowBytes) {
+            return true;
+        }
+        ++*fYUVDecodes;
+        for (int y = 0; y < kHeight; ++y) {
+            for (int x = 0; x < kWidth; ++x) {
+                ((uint8_t*)planes[0])[y * rowBytes[0] + x] = Y(x, y);
+                if (y < kHeight / 2 && x < kWidth / 2) {
+                    ((uint8_t*)planes[1])[y * rowBytes[1] + x] = U(x, y);
+                    ((uint8_t*)planes[2])[y * rowBytes[2] + x] = V(x, y);
+                }
+            }
+        }
+        if (colorSpace) {
+            *colorSpace = kJPEG_SkYUVColorSpace;
+        }
+        return true;
+    }
+
+private:
+    static U8CPU to_byte(float x) {
+        return SkClampMax(SkScalarRoundToInt(x), 255);
+    }
+
+    int* fRGBDecodes;
+    int* fYUVDecodes;
+
+    typedef SkImageGenerator INHERITED;
+};
+
+static int max_diff(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels alpa(a), alpb(b);
+    int diff = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            const SkPMColor ca = *a.getAddr32(x, y), cb = *b.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                diff = SkTMax(diff, SkAbs32(int((ca >> shift) & 0xFF) -
+                                            int((cb >> shift) & 0xFF)));
+            }
+        }
+    }
+    return diff;
+}
+
+// Scaling the planes matches decoding to RGB and scaling that.
+DEF_TEST(BitmapScaler_ResizeYUV, reporter) {
+    int rgbDecodes = 0, yuvDecodes = 0;
+    YUVGenerator generator(&rgbDecodes, &yuvDecodes);
+
+    SkBitmap rgb;
+    rgb.allocN32Pixels(kWidth, kHeight, true);
+    REPORTER_ASSERT(reporter, SkImageGenerator::kSuccess ==
+                    generator.getPixels(rgb.info(), rgb.getPixels(), rgb.rowBytes()));
+
+    SkISize sizes[3];
+    REPORTER_ASSERT(reporter, generator.getYUV8Planes(sizes, NULL, NULL, NULL));
+    size_t rowBytes[3];
+    SkAutoMalloc storage[3];
+    void* planes[3];
+    for (int i = 0; i < 3; ++i) {
+        rowBytes[i] = sizes[i].width() + 3;  // Padded, like a JPEG decoder's.
+        planes[i] = storage[i].reset(rowBytes[i] * sizes[i].height());
+    }
+    SkYUVColorSpace colorSpace;
+    REPORTER_ASSERT(reporter, generator.getYUV8Planes(sizes, planes, rowBytes, &colorSpace));
+
+    const SkISize destSizes[] = { { 50, 38 }, { 133, 100 }, { 37, 150 }, { 300, 225 } };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(destSizes); ++i) {
+        const float w = SkIntToScalar(destSizes[i].width()),
+                    h = SkIntToScalar(destSizes[i].height());
+        SkBitmap expected, actual;
+        REPORTER_ASSERT(reporter, SkBitmapScaler::Resize(&expected, rgb,
+                                                         SkBitmapScaler::RESIZE_BEST, w, h));
+        REPORTER_ASSERT(reporter, SkBitmapScaler::ResizeYUV(&actual, sizes, planes, rowBytes,
+                                                            colorSpace,
+                                                            SkBitmapScaler::RESIZE_BEST, w, h));
+        REPORTER_ASSERT(reporter, actual.isOpaque());
+        REPORTER_ASSERT(reporter, actual.dimensions() == expected.dimensions());
+        if (actual.dimensions() == expected.dimensions()) {
+            REPORTER_ASSERT(reporter, max_diff(expected, actual) <= 4);
+        }
+    }
+}
+
+// A high quality downscale of a lazily decoded image scales its YUV planes, without decoding
+// it to RGB, and scaling it to another size reuses the planes.
+DEF_TEST(BitmapProcState_YUVScale, reporter) {
+    int rgbDecodes = 0, yuvDecodes = 0;
+    SkBitmap lazy;
+    REPORTER_ASSERT(reporter, SkInstallDiscardablePixelRef(
+            SkNEW_ARGS(YUVGenerator, (&rgbDecodes, &yuvDecodes)), &lazy));
+
+    SkBitmap decoded;
+    decoded.allocN32Pixels(kWidth, kHeight, true);
+    {
+        int unused;
+        YUVGenerator generator(&unused, &unused);
+        generator.getPixels(decoded.info(), decoded.getPixels(), decoded.rowBytes());
+    }
+
+    SkPaint paint;
+    paint.setFilterQuality(kHigh_SkFilterQuality);
+    const SkScalar scales[] = { 0.25f, 0.4f };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(scales); ++i) {
+        SkBitmap expected, actual;
+        expected.allocN32Pixels(kWidth / 2, kHeight / 2);
+        actual.allocN32Pixels(kWidth / 2, kHeight / 2);
+        expected.eraseColor(SK_ColorWHITE);
+        actual.eraseColor(SK_ColorWHITE);
+
+        SkCanvas expectedCanvas(expected);
+        expectedCanvas.scale(scales[i], scales[i]);
+        expectedCanvas.drawBitmap(decoded, 0, 0, &paint);
+
+        SkCanvas actualCanvas(actual);
+        actualCanvas.scale(scales[i], scales[i]);
+        actualCanvas.drawBitmap(lazy, 0, 0, &paint);
+
+        REPORTER_ASSERT(reporter, max_diff(expected, actual) <= 4);
+    }
+    REPORTER_ASSERT(reporter, 0 == rgbDecodes);
+    REPORTER_ASSERT(reporter, 1 == yuvDecodes);
+}
@@ -0,0 +1,44 @@
+-- Re-renders an .skp as a grid of PNG tiles, one lua_batch job per tile.
+--
+-- lua_batch -l tools/lua/batch_tiles.lua -s "skp = 'foo.skp'; out = '/tmp/tiles'"
+
+local tile_size = 256
+
+function render_tile(pic, x, y, path)
+    local surface = Sk.newRasterSurface(tile_size, tile_size)
+    local canvas = surface:getCanvas()
+    canvas:clear()
+    canvas:translate(-x, -y)
+    canvas:drawPicture(pic)
+    return surface:newImageSnapshot():encodeToFile(path)
+end
+
+function sk_batch_main()
+    local pic = Sk.loadPicture(skp)
+    if not pic then
+        error("can't load " .. tostring(skp))
+    end
+    out = out or "."
+
+    local cols = math.ceil(pic:width() / tile_size)
+    local rows = math.ceil(pic:height() / tile_size)
+    for y = 0, rows - 1 do
+        for x = 0, cols - 1 do
+            local path = string.format("%s/tile_%d_%d.png", out, x, y)
+            Batch.submit(path, "render_tile", pic, x * tile_size, y * tile_size, path)
+        end
+    end
+
+    local slowest = nil
+    for i, job in ipairs(Batch.run()) do
+        if job.ok and not job.results[1] then
+            io.write("failed to write ", job.name, "\n")
+        end
+        if not slowest or job.ms > slowest.ms then
+            slowest = job
+        end
+    end
+    if slowest then
+        io.write(string.format("slowest tile: %s (%.2f ms)\n", slowest.name, slowest.ms))
+    end
+end
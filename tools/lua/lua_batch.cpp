@@ -0,0 +1,463 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCommandLineFlags.h"
+#include "SkData.h"
+#include "SkGraphics.h"
+#include "SkImage.h"
+#include "SkLua.h"
+#include "SkPicture.h"
+#include "SkTArray.h"
+#include "SkTaskGroup.h"
+#include "SkThread.h"
+#include "SkTypeface.h"
+#include "Timer.h"
+
+extern "C" {
+    #include "lua.h"
+    #include "lualib.h"
+    #include "lauxlib.h"
+}
+
+/*
+ *  Runs lua scripts that fan independent render jobs out over SkTaskGroup's thread pool.
+ *
+ *  Every script is loaded into a control lua_State, and into one lua_State per worker, so it
+ *  should only define functions at the top level. Once loaded, the control state calls
+ *  sk_batch_main(), which queues jobs and collects their results:
+ *
+ *      function render_tile(pic, x, y, path)
+ *          local surface = Sk.newRasterSurface(256, 256)
+ *          local canvas = surface:getCanvas()
+ *          canvas:translate(-x, -y)
+ *          canvas:drawPicture(pic)
+ *          return surface:newImageSnapshot():encodeToFile(path)
+ *      end
+ *
+ *      function sk_batch_main()
+ *          local pic = Sk.loadPicture("map.skp")
+ *          for y = 0, 3 do for x = 0, 3 do
+ *              Batch.submit("tile " .. x .. "," .. y, "render_tile", pic, x * 256, y * 256,
+ *                           "tile_" .. x .. "_" .. y .. ".png")
+ *          end end
+ *          for i, job in ipairs(Batch.run()) do ... job.ms, job.results[1] ... end
+ *      end
+ *
+ *  Job arguments and results are copied between states. Only nil, booleans, numbers and strings
+ *  are allowed, plus pictures, images and typefaces, which are immutable and shared by reference.
+ */
+
+DEFINE_string2(luaFile, l, "", "File(s) containing lua script(s) to run");
+DEFINE_int32(threads, -1, "Run jobs on this many extra threads [default is the core count]. "
+                          "0 runs them one at a time on the main thread.");
+DEFINE_string2(headCode, s, "", "Optional lua code to run in the control state before "
+                                "sk_batch_main, e.g. to pass it arguments");
+DEFINE_bool2(quiet, q, false, "Don't print per-job timings");
+
+static const char gMainFunc[] = "sk_batch_main";
+
+// A lua value that can be moved from one lua_State to another.
+class BatchValue {
+public:
+    BatchValue() : fType(kNil_Type), fNumber(0), fPicture(NULL), fImage(NULL), fTypeface(NULL) {}
+    BatchValue(const BatchValue& that)
+        : fType(that.fType), fNumber(that.fNumber), fString(that.fString)
+        , fPicture(SkSafeRef(that.fPicture))
+        , fImage(SkSafeRef(that.fImage))
+        , fTypeface(SkSafeRef(that.fTypeface)) {}
+    ~BatchValue() { this->clearRefs(); }
+
+    BatchValue& operator=(const BatchValue& that) {
+        fType = that.fType;
+        fNumber = that.fNumber;
+        fString = that.fString;
+        SkRefCnt_SafeAssign(fPicture, that.fPicture);
+        SkRefCnt_SafeAssign(fImage, that.fImage);
+        SkRefCnt_SafeAssign(fTypeface, that.fTypeface);
+        return *this;
+    }
+
+    // Returns false (and describes why in err) if the value at index can't be moved.
+    bool set(lua_State* L, int index, SkString* err) {
+        this->clearRefs();
+        switch (lua_type(L, index)) {
+            case LUA_TNIL:
+                fType = kNil_Type;
+                return true;
+            case LUA_TBOOLEAN:
+                fType = kBool_Type;
+                fNumber = lua_toboolean(L, index);
+                return true;
+            case LUA_TNUMBER:
+                fType = kNumber_Type;
+                fNumber = lua_tonumber(L, index);
+                return true;
+            case LUA_TSTRING: {
+                size_t len;
+                const char* str = lua_tolstring(L, index, &len);
+                fType = kString_Type;
+                fString.set(str, len);
+                return true;
+            }
+            default:
+                break;
+        }
+        if ((fPicture = SkSafeRef(SkLua::ToPicture(L, index)))) {
+            fType = kPicture_Type;
+        } else if ((fImage = SkSafeRef(SkLua::ToImage(L, index)))) {
+            fType = kImage_Type;
+        } else if ((fTypeface = SkSafeRef(SkLua::ToTypeface(L, index)))) {
+            fType = kTypeface_Type;
+        } else {
+            err->printf("can't pass a %s between jobs", luaL_typename(L, index));
+            return false;
+        }
+        return true;
+    }
+
+    void push(lua_State* L) const {
+        SkLua lua(L);
+        switch (fType) {
+            case kNil_Type:      lua_pushnil(L); break;
+            case kBool_Type:     lua.pushBool(fNumber != 0); break;
+            case kNumber_Type:   lua_pushnumber(L, fNumber); break;
+            case kString_Type:   lua.pushString(fString); break;
+            case kPicture_Type:  lua.pushPicture(fPicture); break;
+            case kImage_Type:    lua.pushImage(fImage); break;
+            case kTypeface_Type: lua.pushTypeface(fTypeface); break;
+        }
+    }
+
+private:
+    enum Type {
+        kNil_Type,
+        kBool_Type,
+        kNumber_Type,
+        kString_Type,
+        kPicture_Type,
+        kImage_Type,
+        kTypeface_Type,
+    };
+
+    void clearRefs() {
+        SkSafeUnref(fPicture);
+        SkSafeUnref(fImage);
+        SkSafeUnref(fTypeface);
+        fPicture = NULL;
+        fImage = NULL;
+        fTypeface = NULL;
+    }
+
+    Type                fType;
+    double              fNumber;
+    SkString            fString;
+    // At most one of these is set, matching fType.
+    const SkPicture*    fPicture;
+    const SkImage*      fImage;
+    SkTypeface*         fTypeface;
+};
+
+// Copies count values starting at stack index first into values.
+static bool get_values(lua_State* L, int first, int count, SkTArray<BatchValue>* values,
+                       SkString* err) {
+    values->reset(count);
+    for (int i = 0; i < count; ++i) {
+        if (!(*values)[i].set(L, first + i, err)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void push_values(lua_State* L, const SkTArray<BatchValue>& values) {
+    for (int i = 0; i < values.count(); ++i) {
+        values[i].push(L);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Hands out lua_States with the scripts already loaded. There's no telling which worker thread
+// a task lands on, so rather than tie states to threads we keep a free list, and grow it
+// whenever every state is busy. That settles at one state per thread actually running jobs.
+class StatePool : SkNoncopyable {
+public:
+    StatePool(const SkTArray<SkString>& scripts) : fScripts(scripts) {}
+
+    ~StatePool() {
+        for (int i = 0; i < fStates.count(); ++i) {
+            SkDELETE(fStates[i]);
+        }
+    }
+
+    // Returns NULL if the scripts fail to load into a new state.
+    SkLua* acquire() {
+        {
+            SkAutoMutexAcquire lock(fMutex);
+            if (fFree.count() > 0) {
+                SkLua* lua;
+                fFree.pop(&lua);
+                return lua;
+            }
+        }
+        // Loading the scripts may be slow, so don't block the other workers while we do it.
+        SkAutoTDelete<SkLua> lua(SkNEW(SkLua));
+        for (int i = 0; i < fScripts.count(); ++i) {
+            if (!lua->runCode(fScripts[i].c_str())) {
+                return NULL;
+            }
+        }
+        SkAutoMutexAcquire lock(fMutex);
+        *fStates.append() = lua.get();
+        return lua.detach();
+    }
+
+    void release(SkLua* lua) {
+        SkAutoMutexAcquire lock(fMutex);
+        *fFree.append() = lua;
+    }
+
+    int count() {
+        SkAutoMutexAcquire lock(fMutex);
+        return fStates.count();
+    }
+
+private:
+    const SkTArray<SkString>&   fScripts;
+    SkMutex                     fMutex;
+    SkTDArray<SkLua*>           fStates;    // all the states we own
+    SkTDArray<SkLua*>           fFree;      // the ones not running a job
+};
+
+struct BatchJob {
+    StatePool*              fPool;
+    SkString                fName;      // label for the timing output
+    SkString                fFunc;      // global function to call
+    SkTArray<BatchValue>    fArgs;
+    SkTArray<BatchValue>    fResults;
+    SkString                fError;     // empty if the job succeeded
+    double                  fMs;
+};
+
+static void run_job(BatchJob* job) {
+    job->fMs = 0;
+    SkLua* lua = job->fPool->acquire();
+    if (NULL == lua) {
+        job->fError.set("failed to load scripts");
+        return;
+    }
+    lua_State* L = lua->get();
+
+    const int top = lua_gettop(L);
+    lua_getglobal(L, job->fFunc.c_str());
+    if (!lua_isfunction(L, -1)) {
+        job->fError.printf("no function named %s", job->fFunc.c_str());
+    } else {
+        push_values(L, job->fArgs);
+        WallTimer timer;
+        timer.start();
+        int err = lua_pcall(L, job->fArgs.count(), LUA_MULTRET, 0);
+        timer.end();
+        job->fMs = timer.fWall;
+        if (err != LUA_OK) {
+            job->fError.set(lua_tostring(L, -1));
+        } else {
+            get_values(L, top + 1, lua_gettop(L) - top, &job->fResults, &job->fError);
+        }
+    }
+    lua_settop(L, top);
+    // Jobs tend to leave big surfaces behind. Reclaim them now rather than letting every
+    // state sit on its garbage until lua gets around to it.
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    job->fPool->release(lua);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+class BatchRunner : SkNoncopyable {
+public:
+    BatchRunner(const SkTArray<SkString>& scripts) : fPool(scripts) {}
+
+    ~BatchRunner() {
+        this->clearJobs();
+    }
+
+    void registerFunctions(lua_State* L) {
+        static const luaL_Reg gBatchFuncs[] = {
+            { "submit", submit },
+            { "run", run },
+            { NULL, NULL }
+        };
+        lua_newtable(L);
+        lua_pushlightuserdata(L, this);
+        luaL_setfuncs(L, gBatchFuncs, 1);
+        lua_setglobal(L, "Batch");
+    }
+
+    int pendingCount() const { return fJobs.count(); }
+
+    // Runs every queued job, prints their timings, and (if L is not NULL) pushes a table
+    // describing each one.
+    void runPending(lua_State* L) {
+        WallTimer timer;
+        timer.start();
+        SkTaskGroup tg;
+        for (int i = 0; i < fJobs.count(); ++i) {
+            tg.add(run_job, fJobs[i]);
+        }
+        tg.wait();
+        timer.end();
+
+        double sumMs = 0;
+        for (int i = 0; i < fJobs.count(); ++i) {
+            const BatchJob* job = fJobs[i];
+            sumMs += job->fMs;
+            if (!job->fError.isEmpty()) {
+                SkDebugf("%s: lua err: %s\n", job->fName.c_str(), job->fError.c_str());
+            } else if (!FLAGS_quiet) {
+                SkDebugf("%10.2f ms  %s\n", job->fMs, job->fName.c_str());
+            }
+        }
+        if (!FLAGS_quiet) {
+            SkDebugf("%d jobs on %d states: %.2f ms wall, %.2f ms total in jobs\n",
+                     fJobs.count(), fPool.count(), timer.fWall, sumMs);
+        }
+
+        if (L) {
+            SkLua lua(L);
+            lua_createtable(L, fJobs.count(), 0);
+            for (int i = 0; i < fJobs.count(); ++i) {
+                const BatchJob* job = fJobs[i];
+                lua_newtable(L);
+                lua.pushString(job->fName, "name");
+                lua_pushnumber(L, job->fMs);
+                lua_setfield(L, -2, "ms");
+                lua.pushBool(job->fError.isEmpty(), "ok");
+                if (!job->fError.isEmpty()) {
+                    lua.pushString(job->fError, "error");
+                }
+                lua_createtable(L, job->fResults.count(), 0);
+                for (int j = 0; j < job->fResults.count(); ++j) {
+                    job->fResults[j].push(L);
+                    lua_rawseti(L, -2, j + 1);
+                }
+                lua_setfield(L, -2, "results");
+                lua_rawseti(L, -2, i + 1);
+            }
+        }
+        this->clearJobs();
+    }
+
+private:
+    static BatchRunner* Get(lua_State* L) {
+        return (BatchRunner*)lua_touserdata(L, lua_upvalueindex(1));
+    }
+
+    // Batch.submit(name, funcName, ...) queues a call to funcName(...) and returns its index
+    // in the table Batch.run() will return.
+    static int submit(lua_State* L) {
+        const char* name = luaL_checkstring(L, 1);
+        const char* func = luaL_checkstring(L, 2);
+        if (!Get(L)->addJob(L, name, func)) {
+            return lua_error(L);    // addJob left the message on the stack
+        }
+        lua_pushinteger(L, Get(L)->fJobs.count());
+        return 1;
+    }
+
+    bool addJob(lua_State* L, const char name[], const char func[]) {
+        SkAutoTDelete<BatchJob> job(SkNEW(BatchJob));
+        job->fPool = &fPool;
+        job->fName.set(name);
+        job->fFunc.set(func);
+        SkString err;
+        if (!get_values(L, 3, lua_gettop(L) - 2, &job->fArgs, &err)) {
+            lua_pushfstring(L, "Batch.submit(%s): %s", name, err.c_str());
+            return false;
+        }
+        *fJobs.append() = job.detach();
+        return true;
+    }
+
+    // Batch.run() runs every job submitted since the last run, in parallel, and returns an array
+    // of { name, ms, ok, error, results } tables in submission order.
+    static int run(lua_State* L) {
+        Get(L)->runPending(L);
+        return 1;
+    }
+
+    void clearJobs() {
+        for (int i = 0; i < fJobs.count(); ++i) {
+            SkDELETE(fJobs[i]);
+        }
+        fJobs.reset();
+    }
+
+    StatePool           fPool;
+    SkTDArray<BatchJob*> fJobs;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+int tool_main(int argc, char** argv);
+int tool_main(int argc, char** argv) {
+    SkCommandLineFlags::SetUsage("run lua render jobs in parallel.");
+    SkCommandLineFlags::Parse(argc, argv);
+
+    if (FLAGS_luaFile.isEmpty()) {
+        SkDebugf("missing luaFile(s)\n");
+        return -1;
+    }
+
+    SkAutoGraphics ag;
+    SkTaskGroup::Enabler enabled(FLAGS_threads);
+
+    SkTArray<SkString> scripts;
+    for (int i = 0; i < FLAGS_luaFile.count(); ++i) {
+        SkAutoDataUnref data(SkData::NewFromFileName(FLAGS_luaFile[i]));
+        if (NULL == data.get()) {
+            SkDebugf("failed to read luaFile %s\n", FLAGS_luaFile[i]);
+            return -1;
+        }
+        scripts.push_back().set((const char*)data->data(), data->size());
+    }
+
+    BatchRunner runner(scripts);
+    SkLua L;
+    runner.registerFunctions(L.get());
+    for (int i = 0; i < scripts.count(); ++i) {
+        if (!L.runCode(scripts[i].c_str())) {
+            SkDebugf("failed to load luaFile %s\n", FLAGS_luaFile[i]);
+            return -1;
+        }
+    }
+
+    if (!FLAGS_headCode.isEmpty() && !L.runCode(FLAGS_headCode[0])) {
+        return -1;
+    }
+
+    lua_getglobal(L.get(), gMainFunc);
+    if (!lua_isfunction(L.get(), -1)) {
+        SkDebugf("missing %s function\n", gMainFunc);
+        return -1;
+    }
+    if (lua_pcall(L.get(), 0, 0, 0) != LUA_OK) {
+        SkDebugf("lua err: %s\n", lua_tostring(L.get(), -1));
+        return -1;
+    }
+    // Run anything the script queued up but didn't wait for.
+    if (runner.pendingCount() > 0) {
+        runner.runPending(NULL);
+    }
+    return 0;
+}
+
+#if !defined SK_BUILD_FOR_IOS
+int main(int argc, char * const argv[]) {
+    return tool_main(argc, (char**) argv);
+}
+#endif
@@ -10,6 +10,7 @@
 #include "SkColor.h"
 #include "SkColorPriv.h"
 #include "SkTypes.h"
+#include "SkUtils.h"
 
 /*static*/ char const * const DiffRecord::ResultNames[DiffRecord::kResultCount] = {
     "EqualBits",
@@ -175,9 +176,26 @@ void compute_diff(DiffRecord* dr, DiffMetricProc diffFunction, const int colorTh
     // # of pixels at the end.
     dr->fWeightedFraction = 0;
     for (int y = 0; y < h; y++) {
+        const SkPMColor* baseRow = dr->fBase.fBitmap.getAddr32(0, y);
+        const SkPMColor* comparisonRow = dr->fComparison.fBitmap.getAddr32(0, y);
+        SkPMColor* differenceRow = dr->fDifference.fBitmap.getAddr32(0, y);
+        SkPMColor* whiteRow = dr->fWhite.fBitmap.getAddr32(0, y);
+
+        // Identical rows contribute nothing to any of the mismatch totals.
+        if (0 == memcmp(baseRow, comparisonRow, w * sizeof(SkPMColor))) {
+            sk_bzero(differenceRow, w * sizeof(SkPMColor));
+            sk_memset32(whiteRow, PMCOLOR_BLACK, w);
+            continue;
+        }
+
         for (int x = 0; x < w; x++) {
-            SkPMColor c0 = *dr->fBase.fBitmap.getAddr32(x, y);
-            SkPMColor c1 = *dr->fComparison.fBitmap.getAddr32(x, y);
+            SkPMColor c0 = baseRow[x];
+            SkPMColor c1 = comparisonRow[x];
+            if (c0 == c1) {
+                differenceRow[x] = 0;
+                whiteRow[x] = PMCOLOR_BLACK;
+                continue;
+            }
             SkPMColor outputDifference = diffFunction(c0, c1);
             uint32_t thisA = SkAbs32(SkGetPackedA32(c0) - SkGetPackedA32(c1));
             uint32_t thisR = SkAbs32(SkGetPackedR32(c0) - SkGetPackedR32(c1));
@@ -204,11 +222,11 @@ void compute_diff(DiffRecord* dr, DiffMetricProc diffFunction, const int colorTh
             }
             if (!colors_match_thresholded(c0, c1, colorThreshold)) {
                 mismatchedPixels++;
-                *dr->fDifference.fBitmap.getAddr32(x, y) = outputDifference;
-                *dr->fWhite.fBitmap.getAddr32(x, y) = PMCOLOR_WHITE;
+                differenceRow[x] = outputDifference;
+                whiteRow[x] = PMCOLOR_WHITE;
             } else {
-                *dr->fDifference.fBitmap.getAddr32(x, y) = 0;
-                *dr->fWhite.fBitmap.getAddr32(x, y) = PMCOLOR_BLACK;
+                differenceRow[x] = 0;
+                whiteRow[x] = PMCOLOR_BLACK;
             }
         }
     }
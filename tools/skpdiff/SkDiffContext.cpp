@@ -6,6 +6,7 @@
  */
 
 #include "SkBitmap.h"
+#include "SkBitmapHasher.h"
 #include "SkImageDecoder.h"
 #include "SkOSFile.h"
 #include "SkRunnable.h"
@@ -134,6 +135,27 @@ void SkDiffContext::addDiff(const char* baselinePath, const char* testPath) {
     bitmapsToCreate.rgbDiff = !fRgbDiffDir.isEmpty();
     bitmapsToCreate.whiteDiff = !fWhiteDiffDir.isEmpty();
 
+    // Identical images need no differ at all; this is by far the most common case when diffing
+    // the output of a regression run against its baselines.
+    uint64_t baselineDigest, testDigest;
+    if (SkBitmapHasher::ComputeDigest(baselineBitmap, &baselineDigest) &&
+        SkBitmapHasher::ComputeDigest(testBitmap, &testDigest) &&
+        baselineDigest == testDigest &&
+        baselineBitmap.width() == testBitmap.width() &&
+        baselineBitmap.height() == testBitmap.height()) {
+        for (int differIndex = 0; differIndex < fDifferCount; differIndex++) {
+            DiffData& diffData = newRecord->fDiffs.push_back();
+            diffData.fDiffName = fDiffers[differIndex]->getName();
+            diffData.fResult.result = SkImageDiffer::RESULT_CORRECT;
+            diffData.fResult.poiCount = 0;
+            diffData.fResult.maxRedDiff = 0;
+            diffData.fResult.maxGreenDiff = 0;
+            diffData.fResult.maxBlueDiff = 0;
+            diffData.fResult.timeElapsed = 0;
+        }
+        return;
+    }
+
     // Perform each diff
     for (int differIndex = 0; differIndex < fDifferCount; differIndex++) {
         SkImageDiffer* differ = fDiffers[differIndex];
@@ -257,6 +279,8 @@ void SkDiffContext::diffDirectories(const char baselinePath[], const char testPa
             SkDebugf("Baseline file \"%s\" has no corresponding test file\n", baselineFile.c_str());
         }
     }
+    // The runnables must outlive the diffs they run.
+    tg.wait();
 }
 
 
@@ -292,6 +316,11 @@ void SkDiffContext::diffPatterns(const char baselinePattern[], const char testPa
     tg.wait();
 }
 
+int SkDiffContext::recordCount() {
+    SkAutoMutexAcquire lock(fRecordMutex);
+    return fRecords.count();
+}
+
 void SkDiffContext::outputRecords(SkWStream& stream, bool useJSONP) {
     SkTLList<DiffRecord>::Iter iter(fRecords, SkTLList<DiffRecord>::Iter::kHead_IterStart);
     DiffRecord* currentRecord = iter.get();
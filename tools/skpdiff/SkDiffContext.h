@@ -99,6 +99,11 @@ public:
      */
     void addDiff(const char* baselinePath, const char* testPath);
 
+    /**
+     * Returns the number of image pairs diffed so far.
+     */
+    int recordCount();
+
     /**
      * Output the records of each diff in JSON.
      *
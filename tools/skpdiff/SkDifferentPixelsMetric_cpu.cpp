@@ -10,6 +10,30 @@
 #include "SkBitmap.h"
 #include "skpdiff_util.h"
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#endif
+
+// Returns the index of the first pixel at or after x where the two rows differ, or width if the
+// remainder of the rows is identical.  Most pixels in a typical diff are unchanged, so we want to
+// skip over them as fast as possible.
+static int next_different_pixel(const uint32_t* baselineRow, const uint32_t* testRow,
+                                int x, int width) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    for (; x + 4 <= width; x += 4) {
+        __m128i baseline = _mm_loadu_si128(reinterpret_cast<const __m128i*>(baselineRow + x));
+        __m128i test     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(testRow + x));
+        if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi32(baseline, test))) {
+            break;
+        }
+    }
+#endif
+    while (x < width && baselineRow[x] == testRow[x]) {
+        x++;
+    }
+    return x;
+}
+
 const char* SkDifferentPixelsMetric::getName() const {
     return "different_pixels";
 }
@@ -56,43 +80,40 @@ bool SkDifferentPixelsMetric::diff(SkBitmap* baseline, SkBitmap* test,
     result->poiCount = 0;
     baseline->lockPixels();
     test->lockPixels();
+    const size_t rowBytes = width * sizeof(uint32_t);
     for (int y = 0; y < height; y++) {
         // Grab a row from each image for easy comparison
-        // TODO(epoger): The code below already assumes 4 bytes per pixel, so I think
-        // we could just call getAddr32() to save a little time.
-        // OR, if we want to play it safe, call ComputeBytesPerPixel instead
-        // of assuming 4 bytes per pixel.
-        uint32_t* baselineRow = static_cast<uint32_t *>(baseline->getAddr(0, y));
-        uint32_t* testRow = static_cast<uint32_t *>(test->getAddr(0, y));
-        for (int x = 0; x < width; x++) {
-            // Compare one pixel at a time so each differing pixel can be noted
-            // TODO(epoger): This loop looks like a good place to work on performance,
-            // but we should run the code through a profiler to be sure.
+        const uint32_t* baselineRow = baseline->getAddr32(0, y);
+        const uint32_t* testRow = test->getAddr32(0, y);
+        if (0 == memcmp(baselineRow, testRow, rowBytes)) {
+            continue;
+        }
+        for (int x = next_different_pixel(baselineRow, testRow, 0, width); x < width;
+                 x = next_different_pixel(baselineRow, testRow, x + 1, width)) {
+            // Each differing pixel is noted individually
             uint32_t baselinePixel = baselineRow[x];
             uint32_t testPixel = testRow[x];
-            if (baselinePixel != testPixel) {
-                result->poiCount++;
-
-                int redDiff = abs(static_cast<int>(SkColorGetR(baselinePixel) -
-                                                   SkColorGetR(testPixel)));
-                if (redDiff > maxRedDiff) {maxRedDiff = redDiff;}
-                int greenDiff = abs(static_cast<int>(SkColorGetG(baselinePixel) -
-                                                     SkColorGetG(testPixel)));
-                if (greenDiff > maxGreenDiff) {maxGreenDiff = greenDiff;}
-                int blueDiff = abs(static_cast<int>(SkColorGetB(baselinePixel) -
-                                                    SkColorGetB(testPixel)));
-                if (blueDiff > maxBlueDiff) {maxBlueDiff = blueDiff;}
-
-                if (bitmapsToCreate.alphaMask) {
-                    *result->poiAlphaMask.getAddr8(x,y) = SK_AlphaTRANSPARENT;
-                }
-                if (bitmapsToCreate.rgbDiff) {
-                    *result->rgbDiffBitmap.getAddr32(x,y) =
-                        SkColorSetRGB(redDiff, greenDiff, blueDiff);
-                }
-                if (bitmapsToCreate.whiteDiff) {
-                    *result->whiteDiffBitmap.getAddr32(x,y) = SK_ColorWHITE;
-                }
+            result->poiCount++;
+
+            int redDiff = abs(static_cast<int>(SkColorGetR(baselinePixel) -
+                                               SkColorGetR(testPixel)));
+            if (redDiff > maxRedDiff) {maxRedDiff = redDiff;}
+            int greenDiff = abs(static_cast<int>(SkColorGetG(baselinePixel) -
+                                                 SkColorGetG(testPixel)));
+            if (greenDiff > maxGreenDiff) {maxGreenDiff = greenDiff;}
+            int blueDiff = abs(static_cast<int>(SkColorGetB(baselinePixel) -
+                                                SkColorGetB(testPixel)));
+            if (blueDiff > maxBlueDiff) {maxBlueDiff = blueDiff;}
+
+            if (bitmapsToCreate.alphaMask) {
+                *result->poiAlphaMask.getAddr8(x,y) = SK_AlphaTRANSPARENT;
+            }
+            if (bitmapsToCreate.rgbDiff) {
+                *result->rgbDiffBitmap.getAddr32(x,y) =
+                    SkColorSetRGB(redDiff, greenDiff, blueDiff);
+            }
+            if (bitmapsToCreate.whiteDiff) {
+                *result->whiteDiffBitmap.getAddr32(x,y) = SK_ColorWHITE;
             }
         }
     }
@@ -2,6 +2,7 @@
 #include <math.h>
 
 #include "SkBitmap.h"
+#include "SkNx.h"
 #include "skpdiff_util.h"
 #include "SkPMetric.h"
 #include "SkPMetricUtil_generated.h"
@@ -210,6 +211,18 @@ static void lab_to_l(const ImageLAB* imageLAB, ImageL* outImageL) {
     }
 }
 
+/// Mirrors an out of range coordinate back into [0, size) so that edge pixels that the filter
+/// weighting still makes sense.
+static inline int mirror(int n, int size) {
+    if (n < 0) {
+        n = -n;
+    }
+    if (n >= size) {
+        n = size + (size - n - 1);
+    }
+    return n;
+}
+
 /// Convolves an image with the given filter in one direction and saves it to the output image
 static void convolve(const ImageL* imageL, bool vertical, ImageL* outImageL) {
     SkASSERT(imageL->width == outImageL->width);
@@ -219,52 +232,67 @@ static void convolve(const ImageL* imageL, bool vertical, ImageL* outImageL) {
     const int matrixCount = sizeof(matrix) / sizeof(float);
     const int radius = matrixCount / 2;
 
-    // Keep track of what rows are being operated on for quick access.
-    float* rowPtrs[matrixCount]; // Because matrixCount is constant, this won't create a VLA
-    for (int y = radius; y < matrixCount; y++) {
-        rowPtrs[y] = imageL->getRow(y - radius);
+    const int width = imageL->width;
+    const int height = imageL->height;
+
+    // The taps are always summed in the same order, so the vectorized interior produces exactly
+    // the same values as the scalar edges would.
+    Sk4f weights[matrixCount];
+    for (int i = 0; i < matrixCount; i++) {
+        weights[i] = Sk4f(matrix[i]);
     }
-    float* writeRow = outImageL->getRow(0);
-
-    for (int y = 0; y < imageL->height; y++) {
-        for (int x = 0; x < imageL->width; x++) {
-            float lSum = 0.0f;
-            for (int xx = -radius; xx <= radius; xx++) {
-                int nx = x;
-                int ny = y;
-
-                // We mirror at edges so that edge pixels that the filter weighting still makes
-                // sense.
-                if (vertical) {
-                    ny += xx;
-                    if (ny < 0) {
-                        ny = -ny;
-                    }
-                    if (ny >= imageL->height) {
-                        ny = imageL->height + (imageL->height - ny - 1);
-                    }
-                } else {
-                    nx += xx;
-                    if (nx < 0) {
-                        nx = -nx;
-                    }
-                    if (nx >= imageL->width) {
-                        nx = imageL->width + (imageL->width - nx - 1);
-                    }
-                }
 
-                float weight = matrix[xx + radius];
-                lSum += rowPtrs[ny - y + radius][nx] * weight;
+    for (int y = 0; y < height; y++) {
+        float* writeRow = outImageL->getRow(y);
+        if (vertical) {
+            // Every column uses the same (mirrored) source rows, so the whole row vectorizes.
+            const float* rowPtrs[matrixCount];
+            for (int i = 0; i < matrixCount; i++) {
+                rowPtrs[i] = imageL->getRow(mirror(y + i - radius, height));
+            }
+            int x = 0;
+            for (; x + 4 <= width; x += 4) {
+                Sk4f lSum(0.0f);
+                for (int i = 0; i < matrixCount; i++) {
+                    lSum += Sk4f::Load(rowPtrs[i] + x) * weights[i];
+                }
+                lSum.store(writeRow + x);
+            }
+            for (; x < width; x++) {
+                float lSum = 0.0f;
+                for (int i = 0; i < matrixCount; i++) {
+                    lSum += rowPtrs[i][x] * matrix[i];
+                }
+                writeRow[x] = lSum;
+            }
+        } else {
+            const float* readRow = imageL->getRow(y);
+            // Only the first and last radius pixels need mirroring.
+            const int interiorStart = SkTMin(radius, width);
+            const int interiorEnd = SkTMax(interiorStart, width - radius);
+            int x = 0;
+            for (; x < interiorStart; x++) {
+                float lSum = 0.0f;
+                for (int i = 0; i < matrixCount; i++) {
+                    lSum += readRow[mirror(x + i - radius, width)] * matrix[i];
+                }
+                writeRow[x] = lSum;
+            }
+            for (; x + 4 <= interiorEnd; x += 4) {
+                Sk4f lSum(0.0f);
+                for (int i = 0; i < matrixCount; i++) {
+                    lSum += Sk4f::Load(readRow + x + i - radius) * weights[i];
+                }
+                lSum.store(writeRow + x);
+            }
+            for (; x < width; x++) {
+                float lSum = 0.0f;
+                for (int i = 0; i < matrixCount; i++) {
+                    lSum += readRow[mirror(x + i - radius, width)] * matrix[i];
+                }
+                writeRow[x] = lSum;
             }
-            writeRow[x] = lSum;
-        }
-        // As we move down, scroll the row pointers down with us
-        for (int y = 0; y < matrixCount - 1; y++)
-        {
-            rowPtrs[y] = rowPtrs[y + 1];
         }
-        rowPtrs[matrixCount - 1] += imageL->width;
-        writeRow += imageL->width;
     }
 }
 
@@ -337,17 +365,22 @@ static double pmetric(const ImageLAB* baselineLAB, const ImageLAB* testLAB, int*
     }
 
     // Calculate F
+    const float** baselineRows = SkNEW_ARRAY(const float*, maxLevels);
+    const float** testRows = SkNEW_ARRAY(const float*, maxLevels);
     for (int y = 0; y < height; y++) {
+        for (int levelIndex = 0; levelIndex < maxLevels; levelIndex++) {
+            baselineRows[levelIndex] = baselineL.getLayer(levelIndex)->getRow(y);
+            testRows[levelIndex] = testL.getLayer(levelIndex)->getRow(y);
+        }
+        const LAB* baselineLABRow = baselineLAB->getRow(y);
+        const LAB* testLABRow = testLAB->getRow(y);
+
         for (int x = 0; x < width; x++) {
-            float lBaseline;
-            float lTest;
-            baselineL.getLayer(0)->readPixel(x, y, &lBaseline);
-            testL.getLayer(0)->readPixel(x, y, &lTest);
+            float lBaseline = baselineRows[0][x];
+            float lTest = testRows[0][x];
 
-            float avgLBaseline;
-            float avgLTest;
-            baselineL.getLayer(maxLevels - 1)->readPixel(x, y, &avgLBaseline);
-            testL.getLayer(maxLevels - 1)->readPixel(x, y, &avgLTest);
+            float avgLBaseline = baselineRows[maxLevels - 1][x];
+            float avgLTest = testRows[maxLevels - 1][x];
 
             float lAdapt = 0.5f * (avgLBaseline + avgLTest);
             if (lAdapt < 1e-5f) {
@@ -356,14 +389,12 @@ static double pmetric(const ImageLAB* baselineLAB, const ImageLAB* testLAB, int*
 
             float contrastSum = 0.0f;
             for (int levelIndex = 0; levelIndex < maxLevels - 2; levelIndex++) {
-                float baselineL0, baselineL1, baselineL2;
-                float testL0, testL1, testL2;
-                baselineL.getLayer(levelIndex + 0)->readPixel(x, y, &baselineL0);
-                testL.    getLayer(levelIndex + 0)->readPixel(x, y, &testL0);
-                baselineL.getLayer(levelIndex + 1)->readPixel(x, y, &baselineL1);
-                testL.    getLayer(levelIndex + 1)->readPixel(x, y, &testL1);
-                baselineL.getLayer(levelIndex + 2)->readPixel(x, y, &baselineL2);
-                testL.    getLayer(levelIndex + 2)->readPixel(x, y, &testL2);
+                float baselineL0 = baselineRows[levelIndex + 0][x];
+                float testL0     = testRows    [levelIndex + 0][x];
+                float baselineL1 = baselineRows[levelIndex + 1][x];
+                float testL1     = testRows    [levelIndex + 1][x];
+                float baselineL2 = baselineRows[levelIndex + 2][x];
+                float testL2     = testRows    [levelIndex + 2][x];
 
                 float baselineContrast1 = fabsf(baselineL0 - baselineL1);
                 float testContrast1     = fabsf(testL0 - testL1);
@@ -411,10 +442,8 @@ static double pmetric(const ImageLAB* baselineLAB, const ImageLAB* testLAB, int*
             if (fabsf(lBaseline - lTest) > F * SkPMetricUtil::get_threshold_vs_intensity(lAdapt)) {
                 isFailure = true;
             } else {
-                LAB baselineColor;
-                LAB testColor;
-                baselineLAB->readPixel(x, y, &baselineColor);
-                testLAB->readPixel(x, y, &testColor);
+                const LAB& baselineColor = baselineLABRow[x];
+                const LAB& testColor = testLABRow[x];
                 float contrastA = baselineColor.a - testColor.a;
                 float contrastB = baselineColor.b - testColor.b;
                 float colorScale = 1.0f;
@@ -435,6 +464,8 @@ static double pmetric(const ImageLAB* baselineLAB, const ImageLAB* testLAB, int*
         }
     }
 
+    SkDELETE_ARRAY(baselineRows);
+    SkDELETE_ARRAY(testRows);
     SkDELETE_ARRAY(cyclesPerDegree);
     SkDELETE_ARRAY(contrast);
     SkDELETE_ARRAY(thresholdFactorFrequency);
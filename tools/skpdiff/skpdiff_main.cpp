@@ -126,7 +126,7 @@ int tool_main(int argc, char * argv[]) {
 
     // Needed by various Skia components
     SkAutoGraphics ag;
-    SkTaskGroup::Enabler enabled;
+    SkTaskGroup::Enabler enabled(FLAGS_threads);
 
     if (FLAGS_list) {
         SkDebugf("Available Metrics:\n");
@@ -235,6 +235,8 @@ int tool_main(int argc, char * argv[]) {
         ctx.setThreadCount(FLAGS_threads);
     }
 
+    double startTime = get_seconds();
+
     // Perform a folder diff if one is requested
     if (!FLAGS_folders.isEmpty()) {
         ctx.diffDirectories(FLAGS_folders[0], FLAGS_folders[1]);
@@ -245,6 +247,11 @@ int tool_main(int argc, char * argv[]) {
         ctx.diffPatterns(FLAGS_patterns[0], FLAGS_patterns[1]);
     }
 
+    double elapsed = get_seconds() - startTime;
+    int diffCount = ctx.recordCount();
+    SkDebugf("Diffed %d image pairs in %.3f seconds (%.1f images/second)\n",
+             diffCount, elapsed, elapsed > 0 ? diffCount / elapsed : 0.0);
+
     // Output to the file specified
     if (!FLAGS_output.isEmpty()) {
         SkFILEWStream outputStream(FLAGS_output[0]);
@@ -67,6 +67,16 @@ int tool_main(int argc, char** argv) {
         SkDebugf("Flags: 0x%x\n", info.fFlags);
     }
 
+    if (info.fFlags & SkPictInfo::kCompressed_Flag) {
+        // The chunks are inside the compressed data, where we can't seek over them.
+        uint32_t codec = stream.readU32();
+        if (FLAGS_tags && !FLAGS_quiet) {
+            SkDebugf("Compressed (codec %d)\n", codec);
+            SkDebugf("Exiting early due to format limitations\n");
+        }
+        return kSuccess;
+    }
+
     if (!stream.readBool()) {
         // If we read true there's a picture playback object flattened
         // in the file; if false, there isn't a playback, so we're done